@@ -59,6 +59,7 @@ tm_event_t     *events_spawn;
 tm_event_t     *events_obit;
 int             numnodes;
 tm_task_id     *tid;
+int             nobits = 0;
 int             verbose = 0;
 sigset_t        allsigs;
 char           *id;
@@ -335,7 +336,6 @@ int wait_for_task(
   {
   int     c;
   tm_event_t  eventpolled;
-  int     nobits = 0;
   int     rc;
   int     tm_errno;
 
@@ -489,6 +489,108 @@ int wait_for_task(
 
 
 
+
+/*
+ * spawn_all - start one task on each node in [start, stop) with a single
+ * tm_spawn_multi() and register an obit for every task that started
+ *
+ * Returns TM_ENOTIMPLEMENTED when the local MOM is not mother superior,
+ * the tasks must then be spawned one at a time.
+ */
+
+int spawn_all(
+
+  int         argc,      /* I */
+  char      **argv,      /* I */
+  char      **envp,      /* I */
+  tm_node_id *nodelist,  /* I */
+  int         start,     /* I */
+  int         stop)      /* I */
+
+  {
+  int         c;
+  int         rc;
+  int         tm_errno = TM_SUCCESS;
+  int        *errors;
+  tm_event_t  event;
+  tm_event_t  eventpolled;
+
+  if ((errors = (int *)calloc(stop - start, sizeof(int))) == NULL)
+    {
+    fprintf(stderr, "%s: memory alloc of spawn errors failed\n",
+      id);
+
+    return(TM_ESYSTEM);
+    }
+
+  rc = tm_spawn_multi(argc, argv, envp, stop - start, nodelist + start, tid + start, errors, &event);
+
+  while (rc == TM_SUCCESS)
+    {
+    /* nothing else is outstanding yet */
+
+    rc = tm_poll(TM_NULL_EVENT, &eventpolled, 1, &tm_errno);
+
+    if (rc != TM_SUCCESS)
+      break;
+
+    if (eventpolled == event)
+      {
+      rc = tm_errno;
+
+      break;
+      }
+
+    if (eventpolled == TM_NULL_EVENT)
+      rc = TM_ENOTCONNECTED;
+    }
+
+  if (rc != TM_SUCCESS)
+    {
+    if (rc != TM_ENOTIMPLEMENTED)
+      {
+      fprintf(stderr, "%s: spawn failed on nodes %d-%d err %s\n",
+        id,
+        start,
+        stop - 1,
+        get_ecname(rc));
+      }
+
+    free(errors);
+
+    return(rc);
+    }
+
+  for (c = start;c < stop;c++)
+    {
+    if (errors[c - start] != TM_SUCCESS)
+      {
+      fprintf(stderr, "%s: error %d on spawn\n",
+        id,
+        errors[c - start]);
+
+      continue;
+      }
+
+    if (verbose)
+      fprintf(stderr, "%s: spawned task %d\n",
+        id,
+        c);
+
+    if ((obit_submit(c) == TM_SUCCESS) &&
+        (*(events_obit + c) != TM_NULL_EVENT) &&
+        (*(events_obit + c) != TM_ERROR_EVENT))
+      nobits++;
+    }
+
+  free(errors);
+
+  return(TM_SUCCESS);
+  }  /* END spawn_all() */
+
+
+
+
 /* ask TM for all node resc descriptions and parse the output
  * for hostnames */
 
@@ -1023,6 +1125,18 @@ int main(
 
   sigprocmask(SIG_BLOCK, &allsigs, NULL);
 
+  if ((sync == 0) && (stop - start > 1))
+    {
+    /* one request to mother superior launches every copy */
+
+    rc = spawn_all(argc - optind, argv + optind, ioenv, nodelist, start, stop);
+
+    if (rc == TM_SUCCESS)
+      start = stop;  /* all spawned, only the obits remain */
+    else if (rc != TM_ENOTIMPLEMENTED)
+      return(1);
+    }
+
   for (c = start; c < stop; ++c)
     {
     if ((rc = tm_spawn(
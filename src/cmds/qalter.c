@@ -231,11 +231,15 @@ int main(
 
         /* keep */
 
-        if ((strcmp(optarg, "o")  != 0) &&
-            (strcmp(optarg, "e")  != 0) &&
-            (strcmp(optarg, "oe") != 0) &&
-            (strcmp(optarg, "eo") != 0) &&
-            (strcmp(optarg, "n")  != 0))
+        if ((strcmp(optarg, "o")   != 0) &&
+            (strcmp(optarg, "e")   != 0) &&
+            (strcmp(optarg, "oe")  != 0) &&
+            (strcmp(optarg, "eo")  != 0) &&
+            (strcmp(optarg, "do")  != 0) &&
+            (strcmp(optarg, "de")  != 0) &&
+            (strcmp(optarg, "doe") != 0) &&
+            (strcmp(optarg, "deo") != 0) &&
+            (strcmp(optarg, "n")   != 0))
           {
           fprintf(stderr, "qalter: illegal -k value\n");
 
@@ -18,6 +18,19 @@
 #include "net_cache.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 
+static int deljob_put(
+
+  int   connect,
+  char *job_id,
+  void *extend,
+  int  *tag)
+
+  {
+  return(pbs_deljob_put(connect, job_id, (char *)extend, tag));
+  }
+
+
+
 /* qdel */
 
 int main(
@@ -30,15 +43,8 @@ int main(
   int errflg = 0;
   int any_failed = 0;
   int purge_completed = FALSE;
-  int located = FALSE;
   char *pc;
 
-  char job_id[PBS_MAXCLTJOBID]; /* from the command line */
-
-  char job_id_out[PBS_MAXCLTJOBID];
-  char server_out[MAXSERVERNAME] = "";
-  char rmt_server[MAXSERVERNAME] = "";
-
   char extend[1024];
 
 #define GETOPT_ARGS "acm:pW:t:"
@@ -184,13 +190,7 @@ int main(
       }
     }    /* END while (c) */
 
-  if (purge_completed)
-    {
-    strcpy(server_out,pbs_default());
-    goto cnt;
-    }
-
-  if ((errflg != 0) || (optind >= argc))
+  if ((errflg != 0) || ((optind >= argc) && !purge_completed))
     {
     static char usage[] = "usage: qdel [{ -a | -c | -p | -t | -W delay | -m message}] [<JOBID>[<JOBID>]|'all'|'ALL']...\n";
 
@@ -201,26 +201,13 @@ int main(
     exit(2);
     }
 
-  for (;optind < argc;optind++)
+  if (purge_completed)
     {
-    int connect;
-    int stat = 0;
-
-    /* check to see if user specified 'all' to delete all jobs */
+    /* purge the completed jobs on the default server */
+    char server_out[MAXSERVERNAME];
+    int  connect;
 
-    snprintf(job_id, sizeof(job_id), "%s", argv[optind]);
-
-    if (get_server(job_id, job_id_out, sizeof(job_id_out), server_out, sizeof(server_out)))
-      {
-      fprintf(stderr, "qdel: illegally formed job identifier: %s\n",
-              job_id);
-
-      any_failed = 1;
-
-      continue;
-      }
-
-cnt:
+    snprintf(server_out, sizeof(server_out), "%s", pbs_default());
 
     connect = cnt2server(server_out);
 
@@ -228,48 +215,25 @@ cnt:
       {
       any_failed = -1 * connect;
 
-      if(server_out[0] != 0)
-        fprintf(stderr, "qdel: cannot connect to server %s (errno=%d) %s\n",
-              server_out,
-              any_failed,
-              pbs_strerror(any_failed));
-      else
-        fprintf(stderr, "qdel: cannot connect to server %s (errno=%d) %s\n",
-              pbs_server,
-              any_failed,
-              pbs_strerror(any_failed));
-
-      continue;
-      }
-
-    stat = pbs_deljob_err(connect, job_id_out, extend, &any_failed);
-
-    if (stat &&
-        (any_failed != PBSE_UNKJOBID))
-      {
-      prt_job_err("qdel", connect, job_id_out);
+      fprintf(stderr, "qdel: cannot connect to server %s (errno=%d) %s\n",
+            server_out,
+            any_failed,
+            pbs_strerror(any_failed));
       }
-    else if (stat && 
-             (any_failed != PBSE_UNKJOBID) &&
-             !located)
+    else
       {
-      located = TRUE;
-
-      if (locate_job(job_id_out, server_out, rmt_server))
-        {
-        pbs_disconnect(connect);
-
-        strcpy(server_out, rmt_server);
+      if (pbs_deljob_err(connect, "", extend, &any_failed) &&
+          (any_failed != PBSE_UNKJOBID))
+        prt_job_err("qdel", connect, "");
 
-        goto cnt;
-        }
-
-      prt_job_err("qdel", connect, job_id_out);
+      pbs_disconnect(connect);
       }
-
-    pbs_disconnect(connect);
     }
 
+  /* jobs on the same server share a connection and are pipelined */
+  if (optind < argc)
+    any_failed = pipeline_jobs("qdel", argc - optind, argv + optind, deljob_put, extend, FALSE);
+
   exit(any_failed);
   }  /* END main() */
 
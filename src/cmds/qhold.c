@@ -19,6 +19,27 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 
+typedef struct hold_args
+  {
+  char *hold_type;
+  char *extend;
+  } hold_args;
+
+
+static int holdjob_put(
+
+  int   connect,
+  char *job_id,
+  void *arg,
+  int  *tag)
+
+  {
+  hold_args *ha = (hold_args *)arg;
+
+  return(pbs_holdjob_put(connect, job_id, ha->hold_type, ha->extend, tag));
+  }
+
+
 int main(
     
   int    argc,
@@ -31,12 +52,7 @@ int main(
   int u_cnt, o_cnt, s_cnt;
   char *pc;
   char  extend[1024];
-
-  char job_id[PBS_MAXCLTJOBID];       /* from the command line */
-
-  char job_id_out[PBS_MAXCLTJOBID];
-  char server_out[MAXSERVERNAME] = "";
-  char rmt_server[MAXSERVERNAME] = "";
+  hold_args ha;
 
 #define MAX_HOLD_TYPE_LEN 32
   char hold_type[MAX_HOLD_TYPE_LEN+1];
@@ -119,67 +135,11 @@ int main(
     exit(2);
     }
 
-  for (; optind < argc; optind++)
-    {
-    int connect;
-    int stat = 0;
-    int located = FALSE;
-
-    snprintf(job_id, sizeof(job_id), "%s", argv[optind]);
+  ha.hold_type = hold_type;
+  ha.extend = (extend[0] == '\0') ? NULL : extend;
 
-    if (get_server(job_id, job_id_out, sizeof(job_id_out), server_out, sizeof(server_out)))
-      {
-      fprintf(stderr, "qhold: illegally formed job identifier: %s\n", job_id);
-      any_failed = 1;
-      continue;
-      }
-
-cnt:
-
-    connect = cnt2server(server_out);
-
-    if (connect <= 0)
-      {
-      any_failed = -1 * connect;
-
-      if (server_out[0] != 0)
-        fprintf(stderr, "qhold: cannot connect to server %s (errno=%d) %s\n",
-              server_out, any_failed, pbs_strerror(any_failed));
-      else
-        fprintf(stderr, "qhold: cannot connect to server %s (errno=%d) %s\n",
-              pbs_server, any_failed, pbs_strerror(any_failed));
-      
-      continue;
-      }
-
-    if (extend[0] == '\0')
-      stat = pbs_holdjob_err(connect, job_id_out, hold_type, NULL, &any_failed);
-    else
-      stat = pbs_holdjob_err(connect, job_id_out, hold_type, extend, &any_failed);
-
-    if (stat &&
-        (any_failed != PBSE_UNKJOBID))
-      {
-      prt_job_err("qhold", connect, job_id_out);
-      }
-    else if (stat && 
-             (any_failed != PBSE_UNKJOBID) &&
-             !located)
-      {
-      located = TRUE;
-
-      if (locate_job(job_id_out, server_out, rmt_server))
-        {
-        pbs_disconnect(connect);
-        strcpy(server_out, rmt_server);
-        goto cnt;
-        }
-
-      prt_job_err("qhold", connect, job_id_out);
-      }
-
-    pbs_disconnect(connect);
-    }
+  /* jobs on the same server share a connection and are pipelined */
+  any_failed = pipeline_jobs("qhold", argc - optind, argv + optind, holdjob_put, &ha, FALSE);
 
   exit(any_failed);
   }
@@ -18,6 +18,28 @@
 #include "net_cache.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 
+
+typedef struct hold_args
+  {
+  char *hold_type;
+  char *extend;
+  } hold_args;
+
+
+static int rlsjob_put(
+
+  int   connect,
+  char *job_id,
+  void *arg,
+  int  *tag)
+
+  {
+  hold_args *ha = (hold_args *)arg;
+
+  return(pbs_rlsjob_put(connect, job_id, ha->hold_type, ha->extend, tag));
+  }
+
+
 int main(
 
   int    argc,  /* I */
@@ -29,13 +51,8 @@ int main(
   int any_failed = 0;
   int u_cnt, o_cnt, s_cnt;
   char *pc;
-
-  char job_id[PBS_MAXCLTJOBID];       /* from the command line */
-
-  char job_id_out[PBS_MAXCLTJOBID];
-  char server_out[MAXSERVERNAME] = "";
-  char rmt_server[MAXSERVERNAME];
   char extend[MAXPATHLEN];
+  hold_args ha;
 
 #define MAX_HOLD_TYPE_LEN 32
   char hold_type[MAX_HOLD_TYPE_LEN+1];
@@ -45,6 +62,7 @@ int main(
 #define GETOPT_ARGS "h:t:"
 
   hold_type[0] = '\0';
+  extend[0] = '\0';
 
   while ((c = getopt(argc, argv, GETOPT_ARGS)) != EOF)
     {
@@ -128,73 +146,11 @@ int main(
     exit(2);
     }
 
-  for (;optind < argc;optind++)
-    {
-    int connect;
-    int stat = 0;
-    int located = FALSE;
-
-    snprintf(job_id, sizeof(job_id), "%s", argv[optind]);
-
-    if (get_server(job_id, job_id_out, sizeof(job_id_out), server_out, sizeof(server_out)))
-      {
-      fprintf(stderr, "qrls: illegally formed job identifier: %s\n",
-              job_id);
-
-      any_failed = 1;
-
-      continue;
-      }
-
-cnt:
-
-    connect = cnt2server(server_out);
-
-    if (connect <= 0)
-      {
-      any_failed = -1 * connect;
-
-      if (server_out[0] != 0)
-        fprintf(stderr, "qrls: cannot connect to server %s (errno=%d) %s\n",
-              server_out,
-              any_failed,
-              pbs_strerror(any_failed));
-      else
-        fprintf(stderr, "qrls: cannot connect to server %s (errno=%d) %s\n",
-              pbs_server,
-              any_failed,
-              pbs_strerror(any_failed));
-
-      continue;
-      }
-
-    stat = pbs_rlsjob_err(connect, job_id_out, hold_type, extend, &any_failed);
-
-    if (stat &&
-        (any_failed != PBSE_UNKJOBID))
-      {
-      prt_job_err("qrls", connect, job_id_out);
-      }
-    else if (stat && 
-             (any_failed != PBSE_UNKJOBID) &&
-             !located)
-      {
-      located = TRUE;
-
-      if (locate_job(job_id_out, server_out, rmt_server))
-        {
-        pbs_disconnect(connect);
-
-        strcpy(server_out, rmt_server);
-
-        goto cnt;
-        }
-
-      prt_job_err("qrls", connect, job_id_out);
-      }
+  ha.hold_type = hold_type;
+  ha.extend = extend;
 
-    pbs_disconnect(connect);
-    }  /* END for () */
+  /* jobs on the same server share a connection and are pipelined */
+  any_failed = pipeline_jobs("qrls", argc - optind, argv + optind, rlsjob_put, &ha, FALSE);
 
   exit(any_failed);
 
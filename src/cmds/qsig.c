@@ -18,6 +18,19 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 
+static int sigjob_put(
+
+  int   connect,
+  char *job_id,
+  void *signal,
+  int  *tag)
+
+  {
+  return(pbs_sigjob_put(connect, job_id, (char *)signal, NULL, tag));
+  }
+
+
+
 int main(
 
   int    argc,
@@ -27,13 +40,6 @@ int main(
   int c;
   int errflg = 0;
   int any_failed = 0;
-  int runAsync = FALSE;
-
-  char job_id[PBS_MAXCLTJOBID];       /* from the command line */
-
-  char job_id_out[PBS_MAXCLTJOBID];
-  char server_out[MAXSERVERNAME] = "";
-  char rmt_server[MAXSERVERNAME];
 
 #define MAX_SIGNAL_TYPE_LEN 32
   static char sig_string[MAX_SIGNAL_TYPE_LEN+1] = "SIGTERM";
@@ -46,7 +52,8 @@ int main(
 
       case 'a':
 
-        runAsync = TRUE;
+        /* accepted for compatibility, pbs_sigjobasync() sends the same
+         * Signal Job request as pbs_sigjob() */
 
         break;
 
@@ -65,68 +72,8 @@ int main(
     exit(2);
     }
 
-  for (; optind < argc; optind++)
-    {
-    int connect;
-    int stat = 0;
-    int located = FALSE;
-
-    snprintf(job_id, sizeof(job_id), "%s", argv[optind]);
-
-    if (get_server(job_id, job_id_out, sizeof(job_id_out), server_out, sizeof(server_out)))
-      {
-      fprintf(stderr, "qsig: illegally formed job identifier: %s\n", job_id);
-      any_failed = 1;
-      continue;
-      }
-
-cnt:
-
-    connect = cnt2server(server_out);
-
-    if (connect <= 0)
-      {
-      any_failed = -1 * connect;
-
-      if (server_out[0] != 0)
-        fprintf(stderr, "qsig: cannot connect to server %s (errno=%d) %s\n",
-              server_out, any_failed, pbs_strerror(any_failed));
-      else
-        fprintf(stderr, "qsig: cannot connect to server %s (errno=%d) %s\n",
-              pbs_server, any_failed, pbs_strerror(any_failed));
-      
-      continue;
-      }
-
-    if (runAsync == TRUE)
-      {
-      stat = pbs_sigjobasync_err(connect,job_id_out,sig_string,NULL, &any_failed);
-      }
-    else
-      {
-      stat = pbs_sigjob_err(connect, job_id_out, sig_string, NULL, &any_failed);
-      }
-
-    if (stat && (any_failed != PBSE_UNKJOBID))
-      {
-      prt_job_err("qsig", connect, job_id_out);
-      }
-    else if (stat && (any_failed == PBSE_UNKJOBID) && !located)
-      {
-      located = TRUE;
-
-      if (locate_job(job_id_out, server_out, rmt_server))
-        {
-        pbs_disconnect(connect);
-        strcpy(server_out, rmt_server);
-        goto cnt;
-        }
-
-      prt_job_err("qsig", connect, job_id_out);
-      }
-
-    pbs_disconnect(connect);
-    }
+  /* jobs on the same server share a connection and are pipelined */
+  any_failed = pipeline_jobs("qsig", argc - optind, argv + optind, sigjob_put, sig_string, TRUE);
 
   exit(any_failed);
   }
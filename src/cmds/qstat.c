@@ -1345,6 +1345,47 @@ void display_statjob(
 
 
 
+
+#if (TCL_QSTAT == 0)
+/*
+ * display_statjob_stream - print jobs as the server sends them
+ *
+ * Used for the plain and -f listings of every job at a server, where
+ * collecting the whole list before printing takes memory in proportion to
+ * the number of jobs.
+ */
+
+static int display_statjob_stream(
+
+  int   connect,    /* I */
+  char *id,         /* I */
+  char *extend,     /* I (optional) */
+  int  *prtheader,  /* I/O (boolean) */
+  int   full)       /* I (boolean) */
+
+  {
+  int                  rc;
+
+  struct batch_status *p_status;
+
+  if ((rc = pbs_statjob_stream(connect, id, NULL, extend)) != PBSE_NONE)
+    return(rc);
+
+  while ((p_status = pbs_statjob_next(connect, &rc)) != NULL)
+    {
+    display_statjob(p_status, *prtheader, full);
+
+    *prtheader = FALSE;
+
+    pbs_statfree(p_status);
+    }
+
+  return(rc);
+  }  /* END display_statjob_stream() */
+#endif /* (TCL_QSTAT == 0) */
+
+
+
 #define MINNUML    3
 #define MAXNUML    5
 #define TYPEL      1
@@ -2565,6 +2606,29 @@ job_no_args:
           p_server = 0;
           }
 
+#if (TCL_QSTAT == 0)
+        if ((stat_single_job == 0) &&
+            (p_atropl == 0) &&
+            (alt_opt == 0) &&
+            (DisplayXML != TRUE))
+          {
+          /* every job at the server, print them as they arrive */
+          any_failed = display_statjob_stream(
+                         connect,
+                         job_id_out,
+                         exec_only ? EXECQUEONLY : ExtendOpt,
+                         &p_header,
+                         f_opt);
+
+          if (any_failed != PBSE_NONE)
+            prt_job_err("qstat", connect, job_id_out);
+
+          pbs_disconnect(connect);
+
+          break;
+          }
+#endif /* (TCL_QSTAT == 0) */
+
         if ((stat_single_job == 1) || (p_atropl == 0))
           {
           p_status = pbs_statjob_err(
@@ -85,6 +85,9 @@ int    P_opt = FALSE;
 
 char *checkpoint_strings = "n,c,s,u,none,shutdown,periodic,enabled,interval,depth,dir";
 
+#define BATCH_SUBMIT_CHUNK 256 /* --batch-file jobs per pbs_submit_many() call */
+int    batch_line = 0;         /* --batch-file line being processed, 0 otherwise */
+
 /* adapted from openssh */
 /* The parameter was EMsg, but was never used.
  * xauth_path was a global.  */
@@ -2662,12 +2665,16 @@ void process_opts(
 
       case 'k':
 
-        /* FORMAT:  {o|e} */
+        /* FORMAT:  {o|e}, optionally prefixed with d to write directly */
 
           if ((strcmp(optarg, "o") != 0) &&
               (strcmp(optarg, "e") != 0) &&
               (strcmp(optarg, "oe") != 0) &&
               (strcmp(optarg, "eo") != 0) &&
+              (strcmp(optarg, "do") != 0) &&
+              (strcmp(optarg, "de") != 0) &&
+              (strcmp(optarg, "doe") != 0) &&
+              (strcmp(optarg, "deo") != 0) &&
               (strcmp(optarg, "n") != 0))
             print_qsub_usage_exit("qsub: illegal -k value");
 
@@ -3871,6 +3878,11 @@ void process_config_file(
       }
     if ((param_val = get_param("HOST_NAME_SUFFIX", config_buf)) != NULL)
       host_name_suffix = param_val;
+    if ((param_val = get_param("COMPOUNDSUBMIT", config_buf)) != NULL)
+      {
+      if (!strcasecmp(param_val, "true"))
+        hash_add_or_exit(&ji->mm, &ji->client_attr, "compound_submit", "TRUE", STATIC_DATA);
+      }
     }    /* END if (load_config(config_buf,sizeof(config_buf)) == 0) */
   }
 
@@ -3894,8 +3906,12 @@ void print_qsub_usage_exit(char *error_msg)
   /* need secondary usage since there appears to be a 512 byte size limit */
 
   static char usage2[] =
-    "      [-W additional_attributes] [-v variable_list] [-V ] [-x] [-X] [-z] [script]\n";
+    "      [-W additional_attributes] [-v variable_list] [-V ] [-x] [-X] [-z] [script]\n\
+    [--batch-file file]\n";
     
+  if (batch_line > 0)
+    fprintf(stderr, "qsub: batch file line %d\n", batch_line);
+
   fprintf(stderr,"[%s]\n\n%s%s\n", error_msg, usage, usage2);
 
   exit(2);
@@ -4053,54 +4069,46 @@ void process_early_opts(
 
 
 
-/** 
- * qsub main 
+/**
+ * Build the description of one job from its command line, the script's
+ * directives, the config file and the environment, in that order of
+ * precedence.  Exits on any error.
  *
- * @see process_opts() - child
+ * @see main_func() - parent
+ * @see submit_batch_file() - parent
  */
-void main_func(
+void build_job_info(
 
-  int    argc,  /* I */
-  char **argv,  /* I */
-  char **envp)  /* I */
+  int         argc,         /* I */
+  char      **argv,         /* I */
+  char      **envp,         /* I */
+  job_info   *ji,           /* O */
+  char       *script_tmp,   /* O (copy of the script, minsize=MAXPATHLEN) */
+  char      **destination)  /* O */
 
   {
-
-  int               errflg;                         /* option error */
   char              script[MAXPATHLEN + 1] = ""; /* name of script file */
-  char              script_tmp[MAXPATHLEN + 1] = "";    /* name of script file copy */
   int               script_index;
   char             *bnp;
   FILE             *script_fp;                    /* FILE pointer to the script */
-  char             *destination = NULL;           /* Changed from global to local */
   char             *s_n_out;                      /* server part of destination */
-  int               sock_num;                     /* return from pbs_connect */
-  char             *errmsg = NULL;                /* return from pbs_geterrmsg */
-  int               local_errno = 0;
+  int               errflg;                       /* option error */
   int               job_is_interactive = FALSE;
   int               prefix_index = -1;
-
-  struct stat       statbuf;
-
-  struct sigaction  act;
-
   int               script_idx = 0;
   int               idx;
   int               have_intr_cmd = FALSE;
-  job_data         *tmp_job_info = NULL;
-  /* Allocate Memmgr */
   int               debug = FALSE;
-  job_info          ji;
+  int               local_errno = PBSE_NONE;
+  job_data         *tmp_job_info = NULL;
 
-  /**
-   * Before we go to the trouble of allocating memory, initializing structures,
-   * and setting up for ordinary workflow, check options to see if we'll be
-   * short-circuiting. If yes, then we'll exit without ever returning to main_func.
-   */
-  process_early_opts(argc, argv);
-  
-  memset(&ji, 0, sizeof(job_info));
-  if (memmgr_init(&ji.mm, 8192) != PBSE_NONE)
+  struct stat       statbuf;
+
+  J_opt = FALSE;
+  P_opt = FALSE;
+
+  memset(ji, 0, sizeof(job_info));
+  if (memmgr_init(&ji->mm, 8192) != PBSE_NONE)
     {
     printf("Error allocating memory for job submission\n");
     exit(1);
@@ -4122,24 +4130,24 @@ void main_func(
 
 
   /* (5) adds all env variables to a tmp hash */
-  set_env_opts(&ji.mm, &ji.user_attr, envp);
+  set_env_opts(&ji->mm, &ji->user_attr, envp);
   /* (6) set option default job values */
-  set_job_defaults(&ji);
+  set_job_defaults(ji);
   /* (6) Adds client default options */
-  set_client_attr_defaults(&ji.mm, &ji.client_attr);
+  set_client_attr_defaults(&ji->mm, &ji->client_attr);
   /* The following call  also replaces the functionality of set_job_env
    * up to the v_opt and V_opt sections. Those are replaced below */
   /* The names currently used differ from the actual anvironment names,
    * this adds an expected set */
-  update_job_env_names(&ji);
-  add_submit_args_to_job(&ji.mm, &ji.job_attr, argc, argv);
-  debug = hash_find(ji.job_attr, "pbsdebug", &tmp_job_info); /* Set debug state */
+  update_job_env_names(ji);
+  add_submit_args_to_job(&ji->mm, &ji->job_attr, argc, argv);
+  debug = hash_find(ji->job_attr, "pbsdebug", &tmp_job_info); /* Set debug state */
 
   /* (4) process config file options */
-  process_config_file(&ji);
+  process_config_file(ji);
 
   /* check/set submit filter_path */
-  validate_submit_filter(&ji.mm, &ji.job_attr);
+  validate_submit_filter(&ji->mm, &ji->job_attr);
 
   /* NOTE:  load config before processing opts since config may modify how opts are handled */
 
@@ -4155,14 +4163,14 @@ void main_func(
     {
     strcpy(script, argv[script_index]);
     /* store the script so it can be used later (e.g. '-x' option) */
-    hash_add_or_exit(&ji.mm, &ji.client_attr, "cmdline_script", script, CMDLINE_DATA);
+    hash_add_or_exit(&ji->mm, &ji->client_attr, "cmdline_script", script, CMDLINE_DATA);
     }
 
   if (prefix_index != -1)
-    hash_add_or_exit(&ji.mm, &ji.client_attr, "pbs_dprefix", argv[prefix_index], CMDLINE_DATA);
+    hash_add_or_exit(&ji->mm, &ji->client_attr, "pbs_dprefix", argv[prefix_index], CMDLINE_DATA);
 
   script_idx = argc - optind;
-  if (hash_find(ji.job_attr, ATTR_inter, &tmp_job_info))
+  if (hash_find(ji->job_attr, ATTR_inter, &tmp_job_info))
     {
     for (idx = 1; idx < script_idx; idx++)
       {
@@ -4174,8 +4182,11 @@ void main_func(
   /* if script is empty, get standard input */
   if (!strcmp(script, "") || !strcmp(script, "-"))
     {
-    if (hash_find(ji.job_attr, ATTR_N, &tmp_job_info) == FALSE)
-      hash_add_or_exit(&ji.mm, &ji.job_attr, ATTR_N, "STDIN", CMDLINE_DATA);
+    if (batch_line > 0)
+      print_qsub_usage_exit("qsub: each batch file line must name a job script");
+
+    if (hash_find(ji->job_attr, ATTR_N, &tmp_job_info) == FALSE)
+      hash_add_or_exit(&ji->mm, &ji->job_attr, ATTR_N, "STDIN", CMDLINE_DATA);
 
     if (job_is_interactive == FALSE)
       {
@@ -4185,7 +4196,7 @@ void main_func(
                       argv,
                       stdin,
                       script_tmp,    /* O */
-                      &ji)) != 0)
+                      ji)) != 0)
         {
         unlink(script_tmp);
 
@@ -4216,7 +4227,7 @@ void main_func(
 
     if ((script_fp = fopen(script, "r")) != NULL)
       {
-      if (hash_find(ji.job_attr, ATTR_N, &tmp_job_info) == FALSE)
+      if (hash_find(ji->job_attr, ATTR_N, &tmp_job_info) == FALSE)
         {
         if ((bnp = strrchr(script, (int)'/')))
           bnp++;
@@ -4224,7 +4235,7 @@ void main_func(
           bnp = script;
 
         if (check_job_name(bnp, 0) == 0)
-          hash_add_or_exit(&ji.mm, &ji.job_attr, ATTR_N, bnp, CMDLINE_DATA);
+          hash_add_or_exit(&ji->mm, &ji->job_attr, ATTR_N, bnp, CMDLINE_DATA);
         else
           print_qsub_usage_exit("qsub: cannot form a valid job name from the script name");
         }
@@ -4235,7 +4246,7 @@ void main_func(
                       argv,
                       script_fp,
                       script_tmp, /* O */
-                      &ji)) != 0)
+                      ji)) != 0)
         {
         unlink(script_tmp);
 
@@ -4250,17 +4261,17 @@ void main_func(
     }    /* END else (!strcmp(script,"") || !strcmp(script,"-")) */
  
   /* (2) cmdline options */
-  process_opts(argc, argv, &ji, CMDLINE_DATA);
+  process_opts(argc, argv, ji, CMDLINE_DATA);
 
-  if (((optind + 1) < argc) && (hash_find(ji.job_attr, ATTR_inter, &tmp_job_info) == FALSE))
+  if (((optind + 1) < argc) && (hash_find(ji->job_attr, ATTR_inter, &tmp_job_info) == FALSE))
     print_qsub_usage_exit("index issues");
   
-  post_check_attributes(&ji);
+  post_check_attributes(ji);
 
-  if (hash_find(ji.client_attr, "DISPLAY", &tmp_job_info))
+  if (hash_find(ji->client_attr, "DISPLAY", &tmp_job_info))
     {
     char *x11authstr;
-    hash_find(ji.client_attr, "xauth_path", &tmp_job_info);
+    hash_find(ji->client_attr, "xauth_path", &tmp_job_info);
     /* get the DISPLAY's auth proto, data, and screen number */
     if (debug)
       {
@@ -4271,7 +4282,7 @@ void main_func(
     if ((x11authstr = x11_get_proto(tmp_job_info->value, debug)) != NULL)
       {
       /* stuff this info into the job */
-      hash_add_or_exit(&ji.mm, &ji.job_attr, ATTR_forwardx11, x11authstr, ENV_DATA);
+      hash_add_or_exit(&ji->mm, &ji->job_attr, ATTR_forwardx11, x11authstr, ENV_DATA);
       
       if (debug)
         fprintf(stderr, "x11auth string: %s\n",
@@ -4283,8 +4294,8 @@ void main_func(
 
 
   /* interactive job can not be job array */
-  if (hash_find(ji.job_attr, ATTR_inter, &tmp_job_info) &&
-      hash_find(ji.job_attr, ATTR_t, &tmp_job_info))
+  if (hash_find(ji->job_attr, ATTR_inter, &tmp_job_info) &&
+      hash_find(ji->job_attr, ATTR_t, &tmp_job_info))
     {
     fprintf(stderr, "qsub: interactive job can not be job array.\n");
 
@@ -4293,7 +4304,7 @@ void main_func(
     exit(2);
     }
 
-  if (hash_find(ji.job_attr, ATTR_inter, &tmp_job_info) &&
+  if (hash_find(ji->job_attr, ATTR_inter, &tmp_job_info) &&
       ((isatty(0) == 0) || (isatty(1) == 0)))
     {
     if (have_intr_cmd)
@@ -4316,7 +4327,7 @@ void main_func(
    * the top of this function for ease of understanding */
   server_out[0] = '\0';
 
-  if (hash_find(ji.client_attr, "destination", &tmp_job_info))
+  if (hash_find(ji->client_attr, "destination", &tmp_job_info))
     {
     char *q_n_out;                      /* queue part of destination */
     if (parse_destination_id(tmp_job_info->value, &q_n_out, &s_n_out))
@@ -4328,7 +4339,7 @@ void main_func(
   
       exit(2);
       }
-    destination = tmp_job_info->value;
+    *destination = tmp_job_info->value;
     if (notNULL(s_n_out))
       {
       strcpy(server_out, s_n_out);
@@ -4338,16 +4349,16 @@ void main_func(
     {
     /* Currently if the destination is null, it is replaced downstream
      * with the server_list */
-    calloc_or_fail(&ji.mm, &destination, 2, "destination");
-    destination[0] = '\0';
+    calloc_or_fail(&ji->mm, destination, 2, "destination");
+    (*destination)[0] = '\0';
     }
 
   /* if walltime range specified, break into minwclimit and walltime */
-  set_minwclimit(&ji.mm, &ji.job_attr);
+  set_minwclimit(&ji->mm, &ji->job_attr);
 
   /* Root user submission not allowed */
   local_errno = PBSE_NONE;
-  if (hash_find(ji.job_attr, ATTR_P, &tmp_job_info) == TRUE)
+  if (hash_find(ji->job_attr, ATTR_P, &tmp_job_info) == TRUE)
     {
     if (strcmp("root", tmp_job_info->value) == 0)
       {
@@ -4362,13 +4373,31 @@ void main_func(
     {
     printf("qsub can not be run as root\n");
     unlink(script_tmp);
-    memmgr_destroy(&ji.mm);
+    memmgr_destroy(&ji->mm);
     exit(1);
     }
+  }  /* END build_job_info() */
 
-  /* connect to the server */
 
-  if (hash_find(ji.client_attr, "cnt2server_retry", &tmp_job_info))
+
+
+/**
+ * Connect to the server named in the job's destination, or to the default
+ * server, and report why if that fails.
+ *
+ * @return the connection handle, or a negated PBSE error code
+ */
+int connect_qsub_server(
+
+  job_info *ji,     /* I */
+  int       debug)  /* I */
+
+  {
+  int       sock_num;
+  int       local_errno;
+  job_data *tmp_job_info = NULL;
+
+  if (hash_find(ji->client_attr, "cnt2server_retry", &tmp_job_info))
     {
     int tmpNum = atoi(tmp_job_info->value);
     if (tmpNum > 0)
@@ -4401,9 +4430,526 @@ void main_func(
         pbs_server);
       }
 
+    }
+
+  return(sock_num);
+  }  /* END connect_qsub_server() */
+
+
+
+
+/**
+ * Return the file named with --batch-file <path> or --batch-file=<path>, or
+ * NULL if the option was not given.
+ *
+ * argv is walked the way getopt() walks it with GETOPT_ARGS, so the
+ * argument of another option (-N --batch-file, say), the script and
+ * anything after "--" are never taken for the option.
+ */
+char *get_batch_file(
+
+  int    argc,       /* I */
+  char **argv,       /* I */
+  int   *opt_index)  /* O (optional) */
+
+  {
+  char *opt;
+  char *spec;
+  int   i;
+
+  for (i = 1; i < argc; i++)
+    {
+    if (strcmp(argv[i], "--") == 0)
+      break;
+
+    /* the script or one of its arguments */
+    if ((argv[i][0] != '-') ||
+        (argv[i][1] == '\0'))
+      continue;
+
+    if (argv[i][1] == '-')
+      {
+      if (strncmp(argv[i], "--batch-file", strlen("--batch-file")) != 0)
+        continue;
+
+      switch (argv[i][strlen("--batch-file")])
+        {
+        case '=':
+
+          if (opt_index != NULL)
+            *opt_index = i;
+
+          return(argv[i] + strlen("--batch-file="));
+
+        case '\0':
+
+          if (i + 1 >= argc)
+            print_qsub_usage_exit("qsub: --batch-file requires a file name");
+
+          if (opt_index != NULL)
+            *opt_index = i;
+
+          return(argv[i + 1]);
+
+        default:
+
+          break;
+        }
+
+      continue;
+      }
+
+    /* a group of short options, the first one taking an argument ends it */
+    for (opt = argv[i] + 1; *opt != '\0'; opt++)
+      {
+      if (((spec = strchr(GETOPT_ARGS, *opt)) == NULL) ||
+          (spec[1] != ':'))
+        continue;
+
+      if (opt[1] == '\0')
+        i++;
+
+      break;
+      }
+    }
+
+  return(NULL);
+  }  /* END get_batch_file() */
+
+
+
+
+/* temporary script copies of the --batch-file jobs not yet submitted */
+static char (*batch_scripts)[MAXPATHLEN + 1] = NULL;
+static int    batch_script_count = 0;
+static int    batch_checking = FALSE; /* the lines are being built, none sent */
+
+static void remove_batch_scripts(void)
+
+  {
+  int i;
+
+  if ((batch_checking == TRUE) &&
+      (batch_line > 0))
+    fprintf(stderr, "qsub: bad job on batch file line %d, no jobs were submitted\n", batch_line);
+
+  for (i = 0; i < batch_script_count; i++)
+    {
+    if (batch_scripts[i][0] != '\0')
+      unlink(batch_scripts[i]);
+    }
+  }  /* END remove_batch_scripts() */
+
+
+
+
+/**
+ * Build the job on the next line of a batch file that is not blank or a
+ * comment.  The line's options follow the common_argc options already in
+ * job_argv.  Like build_job_info(), exits if the line is not a valid job.
+ *
+ * @return the line number of the job, or 0 at the end of the file
+ */
+static int read_batch_job(
+
+  FILE      *fp,           /* I */
+  int       *line_num,     /* I/O */
+  char     **job_argv,     /* I/O */
+  int        common_argc,  /* I */
+  char     **envp,         /* I */
+  job_info  *ji,           /* O */
+  char      *script_tmp,   /* O */
+  char     **destination)  /* O */
+
+  {
+  static char  *line_argv[MAX_ARGV_LEN + 1];
+  static char   line[65536];
+  static char   batch_server[PBS_MAXSERVERNAME + PBS_MAXPORTNUM + 2];
+  static int    have_batch_server = FALSE;
+  char         *ptr;
+  int           line_argc;
+  int           job_argc;
+  int           i;
+  job_data     *tmp_job_info = NULL;
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    (*line_num)++;
+
+    if ((ptr = strchr(line, '\n')) != NULL)
+      *ptr = '\0';
+    else if (!feof(fp))
+      {
+      fprintf(stderr, "qsub: batch file line %d is too long\n", *line_num);
+
+      exit(2);
+      }
+
+    for (ptr = line; isspace(*ptr); ptr++);
+
+    if ((*ptr == '\0') || (*ptr == '#'))
+      continue;
+
+    make_argv(&line_argc, line_argv, ptr);
+
+    job_argc = common_argc;
+
+    for (i = 1; i < line_argc; i++)
+      job_argv[job_argc++] = line_argv[i];
+
+    job_argv[job_argc] = NULL;
+
+    batch_line = *line_num;
+
+    build_job_info(job_argc, job_argv, envp, ji, script_tmp, destination);
+
+    if (hash_find(ji->job_attr, ATTR_inter, &tmp_job_info))
+      print_qsub_usage_exit("qsub: interactive jobs cannot be submitted from a batch file");
+
+    if (have_batch_server == FALSE)
+      {
+      strcpy(batch_server, server_out);
+      have_batch_server = TRUE;
+      }
+    else if (strcmp(batch_server, server_out) != 0)
+      print_qsub_usage_exit("qsub: all jobs in a batch file must go to the same server");
+
+    batch_line = 0;
+
+    return(*line_num);
+    }
+
+  return(0);
+  }  /* END read_batch_job() */
+
+
+
+
+/**
+ * Submit count jobs one at a time with the QueueJob, JobScript and Commit
+ * requests, for servers without the SubmitJob request.  Stops at the
+ * first job the connection fails on and gives the rest that error.
+ *
+ * @return PBSE_NONE unless the connection failed
+ */
+static int submit_batch_jobs_separately(
+
+  int                  sock_num,  /* I */
+  memmgr             **mm,        /* I/O */
+  int                  count,     /* I */
+  struct submit_spec  *specs)     /* I/O */
+
+  {
+  int rc = PBSE_NONE;
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+    specs[i].job_id = NULL;
+    specs[i].msg = NULL;
+
+    if (rc != PBSE_NONE)
+      {
+      specs[i].rc = rc;
+
+      continue;
+      }
+
+    specs[i].rc = pbs_submit_hash(sock_num, mm, specs[i].job_attr, specs[i].res_attr,
+                    specs[i].script, specs[i].destination, NULL, &specs[i].job_id, &specs[i].msg);
+
+    if ((specs[i].rc == PBSE_PROTOCOL) ||
+        (specs[i].rc == PBSE_EXPIRED))
+      rc = specs[i].rc;
+    }
+
+  return(rc);
+  }  /* END submit_batch_jobs_separately() */
+
+
+
+
+/**
+ * qsub --batch-file: submit one job per line of the file over a single
+ * connection.  Each line holds the options and script for one job, quoted
+ * as on a #PBS line, and the other command line options apply to every
+ * job.  Blank lines and lines starting with '#' are skipped.
+ *
+ * Every line is built (and so checked) before anything is submitted, so a
+ * bad line stops the whole batch instead of leaving part of it queued.  The
+ * built jobs are then sent BATCH_SUBMIT_CHUNK at a time.  With
+ * COMPOUNDSUBMIT set they go out pipelined as SubmitJob requests through
+ * pbs_submit_many(), falling back to one QueueJob, JobScript and Commit
+ * sequence per job if the server does not know SubmitJob; otherwise the
+ * sequence is used from the start.
+ *
+ * Prints the id of each job, or the line and error of each job that failed,
+ * and exits with the error of the first failure.
+ */
+void submit_batch_file(
+
+  int    argc,  /* I */
+  char **argv,  /* I */
+  char **envp)  /* I */
+
+  {
+  char                *batch_file;
+  char               **job_argv;
+  char                *errmsg;
+  int                  common_argc = 0;
+  int                  opt_index = 0;
+  int                  line_num = 0;
+  int                  job_count = 0;
+  int                  job_max = 0;
+  int                  first;
+  int                  count;
+  int                  sock_num = 0;
+  int                  compound;
+  int                  exit_code = PBSE_NONE;
+  int                  rc = PBSE_NONE;
+  int                  i;
+  FILE                *fp;
+  memmgr              *mm = NULL;
+  job_info            *jobs = NULL;
+  job_data            *tmp_job_info = NULL;
+  struct submit_spec  *specs;
+  int                 *lines = NULL;
+  char               **destinations = NULL;
+
+  batch_file = get_batch_file(argc, argv, &opt_index);
+
+  /* every line names its script, so standard input holds only the lines */
+  if (strcmp(batch_file, "-") == 0)
+    fp = stdin;
+  else if ((fp = fopen(batch_file, "r")) == NULL)
+    {
+    fprintf(stderr, "qsub: cannot open batch file '%s' - %s\n",
+      batch_file,
+      strerror(errno));
+
+    exit(1);
+    }
+
+  job_argv = (char **)calloc(argc + MAX_ARGV_LEN + 1, sizeof(char *));
+  specs = (struct submit_spec *)calloc(BATCH_SUBMIT_CHUNK, sizeof(struct submit_spec));
+
+  if ((job_argv == NULL) ||
+      (specs == NULL))
+    {
+    fprintf(stderr, "qsub: out of memory\n");
+
+    exit(2);
+    }
+
+  atexit(remove_batch_scripts);
+
+  /* every option but --batch-file itself applies to all jobs */
+  for (i = 0; i < argc; i++)
+    {
+    if (i == opt_index)
+      {
+      if (strchr(argv[i], '=') == NULL)
+        i++;
+
+      continue;
+      }
+
+    job_argv[common_argc++] = argv[i];
+    }
+
+  /* build every job once, exiting on the first bad line */
+
+  batch_checking = TRUE;
+
+  while (TRUE)
+    {
+    if (job_count == job_max)
+      {
+      job_max += BATCH_SUBMIT_CHUNK;
+
+      if (((jobs = (job_info *)realloc(jobs, job_max * sizeof(job_info))) == NULL) ||
+          ((lines = (int *)realloc(lines, job_max * sizeof(int))) == NULL) ||
+          ((destinations = (char **)realloc(destinations, job_max * sizeof(char *))) == NULL) ||
+          ((batch_scripts = realloc(batch_scripts, job_max * sizeof(*batch_scripts))) == NULL))
+        {
+        fprintf(stderr, "qsub: out of memory\n");
+
+        exit(2);
+        }
+      }
+
+    batch_scripts[job_count][0] = '\0';
+    batch_script_count = job_count + 1;
+
+    if ((lines[job_count] = read_batch_job(fp, &line_num, job_argv, common_argc, envp,
+                              &jobs[job_count], batch_scripts[job_count], &destinations[job_count])) == 0)
+      break;
+
+    job_count++;
+    }
+
+  batch_script_count = job_count;
+  batch_checking = FALSE;
+
+  if (fp != stdin)
+    fclose(fp);
+
+  if (job_count == 0)
+    exit(0);
+
+  if ((sock_num = connect_qsub_server(&jobs[0],
+                    hash_find(jobs[0].job_attr, "pbsdebug", &tmp_job_info))) <= 0)
+    exit(-1 * sock_num);
+
+  compound = hash_find(jobs[0].client_attr, "compound_submit", &tmp_job_info);
+
+  for (first = 0; (first < job_count) && (rc == PBSE_NONE); first += count)
+    {
+    count = job_count - first;
+
+    if (count > BATCH_SUBMIT_CHUNK)
+      count = BATCH_SUBMIT_CHUNK;
+
+    for (i = 0; i < count; i++)
+      {
+      specs[i].job_attr = jobs[first + i].job_attr;
+      specs[i].res_attr = jobs[first + i].res_attr;
+      specs[i].script = batch_scripts[first + i];
+      specs[i].destination = destinations[first + i];
+      }
+
+    if (memmgr_init(&mm, 8192) != PBSE_NONE)
+      {
+      fprintf(stderr, "qsub: out of memory\n");
+
+      exit(2);
+      }
+
+    if (compound)
+      {
+      rc = pbs_submit_many(sock_num, &mm, count, specs, NULL);
+
+      for (i = 0; i < count; i++)
+        {
+        if ((specs[i].rc == PBSE_NONE) ||
+            (specs[i].rc == PBSE_UNKREQ))
+          break;
+        }
+
+      if ((i < count) &&
+          (specs[i].rc == PBSE_UNKREQ))
+        {
+        /* the server predates SubmitJob and took none of them */
+        compound = FALSE;
+
+        pbs_disconnect(sock_num);
+
+        if ((sock_num = connect_qsub_server(&jobs[0],
+                          hash_find(jobs[0].job_attr, "pbsdebug", &tmp_job_info))) <= 0)
+          exit(-1 * sock_num);
+
+        rc = submit_batch_jobs_separately(sock_num, &mm, count, specs);
+        }
+      }
+    else
+      rc = submit_batch_jobs_separately(sock_num, &mm, count, specs);
+
+    for (i = 0; i < count; i++)
+      {
+      if (specs[i].rc == PBSE_NONE)
+        {
+        if (hash_find(jobs[first + i].client_attr, "no_jobid_out", &tmp_job_info) == FALSE)
+          printf("%s\n", specs[i].job_id);
+        }
+      else
+        {
+        if ((errmsg = specs[i].msg) == NULL)
+          errmsg = pbs_strerror(specs[i].rc);
+
+        if (errmsg != NULL)
+          fprintf(stderr, "qsub: batch file line %d: submit error (%s)\n",
+            lines[first + i],
+            errmsg);
+        else
+          fprintf(stderr, "qsub: batch file line %d: Error (%d) submitting job\n",
+            lines[first + i],
+            specs[i].rc);
+
+        if (exit_code == PBSE_NONE)
+          exit_code = specs[i].rc;
+        }
+
+      unlink(batch_scripts[first + i]);
+      batch_scripts[first + i][0] = '\0';
+      memmgr_destroy(&jobs[first + i].mm);
+      }
+
+    memmgr_destroy(&mm);
+
+    if ((rc != PBSE_NONE) &&
+        (first + count < job_count))
+      fprintf(stderr, "qsub: connection to server lost, jobs after batch file line %d were not submitted\n",
+        lines[first + count - 1]);
+    }
+
+  if (sock_num > 0)
+    pbs_disconnect(sock_num);
+
+  fflush(stdout);
+
+  exit(exit_code);
+  }  /* END submit_batch_file() */
+
+
+
+
+/** 
+ * qsub main 
+ *
+ * @see process_opts() - child
+ */
+void main_func(
+
+  int    argc,  /* I */
+  char **argv,  /* I */
+  char **envp)  /* I */
+
+  {
+
+  char              script_tmp[MAXPATHLEN + 1] = "";    /* name of script file copy */
+  char             *destination = NULL;           /* Changed from global to local */
+  int               sock_num;                     /* return from pbs_connect */
+  char             *errmsg = NULL;                /* return from pbs_geterrmsg */
+  int               local_errno = 0;
+
+  struct sigaction  act;
+
+  job_data         *tmp_job_info = NULL;
+  int               debug = FALSE;
+  job_info          ji;
+
+  /**
+   * Before we go to the trouble of allocating memory, initializing structures,
+   * and setting up for ordinary workflow, check options to see if we'll be
+   * short-circuiting. If yes, then we'll exit without ever returning to main_func.
+   */
+  process_early_opts(argc, argv);
+  
+  /* --batch-file submits every job over one connection and exits */
+  if (get_batch_file(argc, argv, NULL) != NULL)
+    submit_batch_file(argc, argv, envp);
+
+  build_job_info(argc, argv, envp, &ji, script_tmp, &destination);
+
+  debug = hash_find(ji.job_attr, "pbsdebug", &tmp_job_info);
+
+  /* connect to the server */
+
+  if ((sock_num = connect_qsub_server(&ji, debug)) <= 0)
+    {
     unlink(script_tmp);
     memmgr_destroy(&ji.mm);
-    exit(local_errno);
+    exit(-1 * sock_num);
     }
 
   /* Get required environment variables to be sent to the server.
@@ -4430,16 +4976,28 @@ void main_func(
 
   /* Send submit request to the server. */
 
-  local_errno = pbs_submit_hash(
-                  sock_num,
-                  &ji.mm,
-                  ji.job_attr,
-                  ji.res_attr,
-                  script_tmp,
-                  destination,
-                  NULL,
-                  &new_jobname,
-                  &errmsg);
+  if (hash_find(ji.client_attr, "compound_submit", &tmp_job_info))
+    local_errno = pbs_submit_compound_hash(
+                    sock_num,
+                    &ji.mm,
+                    ji.job_attr,
+                    ji.res_attr,
+                    script_tmp,
+                    destination,
+                    NULL,
+                    &new_jobname,
+                    &errmsg);
+  else
+    local_errno = pbs_submit_hash(
+                    sock_num,
+                    &ji.mm,
+                    ji.job_attr,
+                    ji.res_attr,
+                    script_tmp,
+                    destination,
+                    NULL,
+                    &new_jobname,
+                    &errmsg);
 
   if (local_errno != PBSE_NONE)
     {
@@ -245,6 +245,28 @@ void print_qsub_usage_exit(
 
 void add_submit_args_to_job(memmgr **mm, job_data **job_attr, int argc, char **argv);
 
+void build_job_info(
+    int         argc,             /* I */
+    char      **argv,             /* I */
+    char      **envp,             /* I */
+    job_info   *ji,               /* O */
+    char       *script_tmp,       /* O */
+    char      **destination);     /* O */
+
+int connect_qsub_server(
+    job_info *ji,                 /* I */
+    int       debug);             /* I */
+
+char *get_batch_file(
+    int    argc,                  /* I */
+    char **argv,                  /* I */
+    int   *opt_index);            /* O (optional) */
+
+void submit_batch_file(
+    int    argc,                  /* I */
+    char **argv,                  /* I */
+    char **envp);                 /* I */
+
 void main_func(
     int    argc,                  /* I */
     char **argv,                  /* I */
@@ -64,3 +64,15 @@ char *pbs_strerror(int err)
   fprintf(stderr, "The call to pbs_strerror needs to be mocked!!\n");
   exit(1);
   }
+
+int pipeline_jobs(char *cmd, int count, char **job_ids, int (*put)(int, char *, void *, int *), void *arg, int locate)
+  { 
+  fprintf(stderr, "The call to pipeline_jobs needs to be mocked!!\n");
+  exit(1);
+  }
+
+int pbs_sigjob_put(int c, char *jobid, char *signal, char *extend, int *tag)
+  { 
+  fprintf(stderr, "The call to pbs_sigjob_put needs to be mocked!!\n");
+  exit(1);
+  }
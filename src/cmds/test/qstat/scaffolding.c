@@ -91,6 +91,18 @@ struct batch_status *pbs_statjob_err(int c, char *id, struct attrl *attrib, char
   exit(1);
   }
 
+int pbs_statjob_stream(int c, char *id, struct attrl *attrib, char *extend)
+  { 
+  fprintf(stderr, "The call to pbs_statjob_stream needs to be mocked!!\n");
+  exit(1);
+  }
+
+struct batch_status *pbs_statjob_next(int c, int *local_errno)
+  { 
+  fprintf(stderr, "The call to pbs_statjob_next needs to be mocked!!\n");
+  exit(1);
+  }
+
 void pbs_statfree(struct batch_status *bsp)
   { 
   fprintf(stderr, "The call to pbs_statfree needs to be mocked!!\n");
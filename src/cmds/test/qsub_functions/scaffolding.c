@@ -137,6 +137,18 @@ int pbs_submit_hash(int c, memmgr **mm, job_data *job_attr, job_data *res_attr,
   exit(1);
   }
 
+int pbs_submit_compound_hash(int c, memmgr **mm, job_data *job_attr, job_data *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg)
+  {
+  fprintf(stderr, "The call to pbs_submit_compound_hash to be mocked!!\n");
+  exit(1);
+  }
+
+int pbs_submit_many(int c, memmgr **mm, int count, struct submit_spec *jobs, char *extend)
+  {
+  fprintf(stderr, "The call to pbs_submit_many to be mocked!!\n");
+  exit(1);
+  }
+
 int parse_at_list(char *list, int use_count, int abs_path)
   {
   fprintf(stderr, "The call to parse_at_list to be mocked!!\n");
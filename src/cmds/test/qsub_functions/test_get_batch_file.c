@@ -0,0 +1,57 @@
+#include "test_qsub_functions.h"
+#include "qsub_functions.h"
+#include <string.h>
+
+START_TEST(test_get_batch_file_1)
+  {
+  char *argv1[] = { (char *)"qsub", (char *)"-l", (char *)"nodes=1", (char *)"--batch-file", (char *)"jobs.txt", NULL };
+  char *argv2[] = { (char *)"qsub", (char *)"-z", (char *)"--batch-file=jobs.txt", NULL };
+  char *argv3[] = { (char *)"qsub", (char *)"-zq", (char *)"batch", (char *)"--batch-file=-", NULL };
+  int   opt_index = 0;
+
+  fail_unless(!strcmp(get_batch_file(5, argv1, &opt_index), "jobs.txt"));
+  fail_unless(opt_index == 3);
+
+  fail_unless(!strcmp(get_batch_file(3, argv2, &opt_index), "jobs.txt"));
+  fail_unless(opt_index == 2);
+
+  fail_unless(!strcmp(get_batch_file(4, argv3, NULL), "-"));
+  }
+END_TEST
+
+START_TEST(test_get_batch_file_2)
+  {
+  /* option arguments, the script's arguments and anything after -- */
+  char *argv1[] = { (char *)"qsub", (char *)"-N", (char *)"--batch-file", (char *)"job.sh", NULL };
+  char *argv2[] = { (char *)"qsub", (char *)"-v", (char *)"--batch-file=x", (char *)"job.sh", NULL };
+  char *argv3[] = { (char *)"qsub", (char *)"-zN", (char *)"--batch-file", (char *)"job.sh", NULL };
+  char *argv4[] = { (char *)"qsub", (char *)"-I", (char *)"-x", (char *)"--", (char *)"prog", (char *)"--batch-file", (char *)"f", NULL };
+
+  fail_unless(get_batch_file(4, argv1, NULL) == NULL);
+  fail_unless(get_batch_file(4, argv2, NULL) == NULL);
+  fail_unless(get_batch_file(4, argv3, NULL) == NULL);
+  fail_unless(get_batch_file(7, argv4, NULL) == NULL);
+  }
+END_TEST
+
+Suite *get_batch_file_suite(void)
+  {
+  Suite *s = suite_create("get_batch_file methods");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_get_batch_file_1);
+  tcase_add_test(tc_core, test_get_batch_file_2);
+  suite_add_tcase(s, tc_core);
+  return s;
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  sr = srunner_create(get_batch_file_suite());
+  srunner_set_log(sr, "get_batch_file_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -20,3 +20,9 @@ int start_listener(char *server_ip, int server_port, void *(*process_meth)(void
   exit(1);
   }
 
+int start_domainsocket_listener(const char *socket_name, void *(*process_meth)(void *))
+  {
+  fprintf(stderr, "The call to start_domainsocket_listener needs to be mocked!!\n");
+  exit(1);
+  }
+
@@ -29,6 +29,7 @@ extern pthread_mutex_t *job_log_mutex;
 
 extern int debug_mode;
 static int changed_msg_daem = 0;
+static void *(*unix_process_meth)(void *) = NULL;
 
 int load_config(
     char **ip,
@@ -90,11 +91,28 @@ void clean_log_init_mutex(void)
   free(job_log_mutex);
   }
 
+/*
+ * Local clients connect to trqauthd over a unix domain socket, which lets
+ * trqauthd check who they are.  Clients fall back to the TCP port if this
+ * listener is not running.
+ */
+void *start_unix_listener(void *arg)
+  {
+  int rc;
+
+  if ((rc = start_domainsocket_listener(TRQAUTHD_SOCK_NAME, unix_process_meth)) != PBSE_NONE)
+    log_err(rc, __func__, "trqauthd could not listen on its unix domain socket");
+
+  return(NULL);
+  }
+
 int daemonize_trqauthd(char *server_ip, int server_port, void *(*process_meth)(void *))
   {
   int gid;
   pid_t pid;
   int   rc;
+  pthread_t unix_tid;
+  pthread_t reaper_tid;
   char  error_buf[MAX_BUF];
   char msg_trqauthddown[MAX_BUF];
   char path_log[MAXPATHLEN + 1];
@@ -171,7 +189,19 @@ int daemonize_trqauthd(char *server_ip, int server_port, void *(*process_meth)(v
     log_open(log_file, path_log);
     pthread_mutex_unlock(log_mutex);
 
-    /* start the listener */
+    /* start the listeners */
+    unix_process_meth = process_meth;
+
+    if (pthread_create(&unix_tid, NULL, start_unix_listener, NULL) != 0)
+      log_err(errno, "daemonize_trqauthd", "could not start the unix domain socket listener");
+    else
+      pthread_detach(unix_tid);
+
+    if (pthread_create(&reaper_tid, NULL, svr_conn_reaper, NULL) != 0)
+      log_err(errno, "daemonize_trqauthd", "could not start the idle server connection reaper");
+    else
+      pthread_detach(reaper_tid);
+
     rc = start_listener(server_ip, server_port, process_meth);
     if(rc != PBSE_NONE)
       {
@@ -12,4 +12,6 @@ void clean_log_init_mutex(void);
 
 void initialize_globals_for_log(void);
 
+void *start_unix_listener(void *arg);
+
 #endif /* _TRQ_AUTH_DAEMON_H */
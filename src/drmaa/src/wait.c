@@ -35,6 +35,7 @@
 #include <compat.h>
 #include <drmaa_impl.h>
 #include <jobs.h>
+#include "pbs_error.h"
 
 #ifndef lint
 static char rcsid[]
@@ -44,6 +45,13 @@ __attribute__((unused))
 = "$Id: wait.c,v 1.13 2006/09/05 07:49:36 ciesnik Exp $";
 #endif
 
+/** Seconds between re-probes when waiting for any job of the session,
+ * so jobs submitted during the wait are noticed. */
+#define DRMAA_WATCH_RESYNC 60
+
+static int drmaa_watch_open(drmaa_session_t *c, const char *jobid);
+static bool drmaa_watch_wait(int watch_conn, time_t until);
+
 
 int
 drmaa_synchronize(
@@ -382,6 +390,9 @@ drmaa_job_wait(
   int rc                   = DRMAA_ERRNO_SUCCESS;
   int              local_errno = 0;
   bool terminated          = false;
+  int              watch_conn = -1;
+  bool             watch_failed = false;
+  int              watch_label = 0;
 
   DEBUG(("-> drmaa_job_wait(jobid=%s)", jobid));
   GET_DRMAA_SESSION(c);
@@ -546,14 +557,56 @@ drmaa_job_wait(
 
     if (!rc  &&  !terminated)
       {
-      if (time(NULL) < timeout_time)
+      time_t now = time(NULL);
+      time_t until = timeout_time;
+
+      if (now >= timeout_time)
+        {
+        SET_DRMAA_ERROR(rc = DRMAA_ERRNO_EXIT_TIMEOUT);
+        }
+      else if (watch_failed)
+        {
         sleep(1);    /* pooling interval */
+        }
       else
-        SET_DRMAA_ERROR(rc = DRMAA_ERRNO_EXIT_TIMEOUT);
+        {
+        if (jobid == NULL)
+          {
+          if (until > now + DRMAA_WATCH_RESYNC)
+            until = now + DRMAA_WATCH_RESYNC;
+
+          /* watch jobs submitted since the watch was opened as well */
+          pthread_mutex_lock(&c->jobs_mutex);
+
+          if ((watch_conn >= 0) && (watch_label != c->next_time_label))
+            {
+            pbs_disconnect(watch_conn);
+            watch_conn = -1;
+            }
+
+          watch_label = c->next_time_label;
+
+          pthread_mutex_unlock(&c->jobs_mutex);
+          }
+
+        if (watch_conn < 0)
+          watch_conn = drmaa_watch_open(c, jobid);
+
+        /* block on job events, fall back to polling if the server
+         * cannot send them */
+        if ((watch_conn < 0) || !drmaa_watch_wait(watch_conn, until))
+          {
+          watch_failed = true;
+          sleep(1);
+          }
+        }
       }
     }
   while (!(rc  ||  terminated));
 
+  if (watch_conn >= 0)
+    pbs_disconnect(watch_conn);
+
   free(attribs);
 
   RELEASE_DRMAA_SESSION(c);
@@ -565,6 +618,153 @@ drmaa_job_wait(
 
 
 
+/**
+ * Opens a connection on which the server reports state changes of
+ * @a jobid, or of every unfinished job of the session when @a jobid
+ * is @c NULL.
+ * @return Connection handle or -1 if the jobs cannot be watched
+ *   (e.g. the server predates job events).
+ */
+static int
+drmaa_watch_open(drmaa_session_t *c, const char *jobid)
+  {
+  int    conn;
+  int    count = 0;
+  int    size  = 0;
+  int    rc;
+  char **ids   = NULL;
+
+  if (jobid != NULL)
+    {
+    ids = (char**)calloc(1, sizeof(char*));
+
+    if (ids != NULL && (ids[0] = strdup(jobid)) != NULL)
+      count = 1;
+    }
+  else
+    {
+    drmaa_job_iter_t iter;
+    drmaa_job_t *job;
+
+    pthread_mutex_lock(&c->jobs_mutex);
+    drmaa_get_job_list_iter(c, &iter);
+
+    while ((job = drmaa_get_next_job(&iter)) != NULL)
+      {
+      if (job->terminated)
+        continue;
+
+      if (count == size)
+        {
+        char **tmp = (char**)realloc(ids, (size + 16) * sizeof(char*));
+
+        if (tmp == NULL)
+          break;
+
+        ids = tmp;
+        size += 16;
+        }
+
+      if ((ids[count] = strdup(job->jobid)) == NULL)
+        break;
+
+      count++;
+      }
+
+    pthread_mutex_unlock(&c->jobs_mutex);
+    }
+
+  conn = -1;
+
+  if (count > 0)
+    conn = pbs_connect(c->contact);
+
+  if (conn >= 0)
+    {
+    rc = pbs_watchjobs(conn, count, ids, NULL);
+    DEBUG(("pbs_watchjobs(%d, %d jobs)=%d", conn, count, rc));
+
+    if (rc != PBSE_NONE)
+      {
+      pbs_disconnect(conn);
+      conn = -1;
+      }
+    }
+
+  while (count > 0)
+    free(ids[--count]);
+
+  free(ids);
+
+  return conn;
+  }
+
+
+/**
+ * Blocks until a watched job terminates, leaves the server or
+ * @a until passes.
+ * @return @c false if the watch connection failed.
+ */
+static bool
+drmaa_watch_wait(int watch_conn, time_t until)
+  {
+  time_t now;
+
+  while ((now = time(NULL)) < until)
+    {
+    struct batch_status *event = NULL;
+    struct attrl *a;
+    bool terminated = false;
+    int rc;
+
+    rc = pbs_waitjobevent(watch_conn, (int)(until - now), &event);
+
+    switch (rc)
+      {
+
+      case PBSE_NONE:
+
+        for (a = event->attribs;  a != NULL;  a = a->next)
+          {
+          if (!strcmp(a->name, ATTR_state) &&
+              (a->value[0] == 'C' || a->value[0] == 'E'))
+            terminated = true;
+          }
+
+        DEBUG(("job event: %s terminated=%d", event->name, terminated));
+
+        break;
+
+      case PBSE_UNKJOBID:
+
+      case PBSE_PERM:
+
+        /* let the caller find out what happened to the job */
+        terminated = true;
+
+        break;
+
+      case PBSE_TIMEOUT:
+
+        break;
+
+      default:
+
+        return false;
+      }
+
+    if (event != NULL)
+      pbs_statfree(event);
+
+    if (terminated)
+      break;
+    }
+
+  return true;
+  }
+
+
+
 bool
 drmaa_check_empty_session(drmaa_session_t *c)
   {
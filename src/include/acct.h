@@ -105,6 +105,7 @@
 
 extern int  acct_open (char *filename);
 extern void account_record (int acctype, job *pjob, char *text);
+extern void account_record_id (int acctype, char *id, char *text);
 extern void account_jobstr (job *pjob);
 extern void account_jobend (job *pjob, char * used);
 
@@ -110,6 +110,10 @@ struct job_array
                          is restarted (cleanly) before the array is 
                          completely setup */
 
+  int    ai_bulk_ops; /* bulk operations (qdel of an array or a range) in
+                         progress. while non-zero, purged subjobs leave
+                         saving or deleting the array to the operation */
+
   pthread_mutex_t *ai_mutex;
 
   /* this info is saved in the array file */
@@ -130,6 +130,8 @@ struct rq_queuejob
   char     rq_destin[PBS_MAXDEST+1];
   char     rq_jid[PBS_MAXSVRJOBID+1];
   tlist_head    rq_attr; /* svrattrlist */
+  long          rq_scriptsz; /* SubmitJob only */
+  char         *rq_script;   /* SubmitJob only */
   };
 
 /* JobCredential */
@@ -227,6 +229,14 @@ struct rq_status
   tlist_head rq_attr;
   };
 
+/* WatchJobs */
+
+struct rq_watchjobs
+  {
+  int    rq_count;
+  char **rq_jobids;
+  };
+
 /* TrackJob */
 
 struct rq_track
@@ -335,6 +345,9 @@ struct batch_request
   int                 rq_refcount;
   void               *rq_extra; /* optional ptr to extra info  */
   int                 rq_noreply; /* Set true if no reply is required */
+  int                 rq_compound; /* step of a SubmitJob, only errors and the commit reply */
+  int                 rq_owed_conn; /* connection whose next request waits for this reply, or -1 */
+  unsigned int        rq_owed_gen; /* rq_owed_conn's generation when the reply became owed */
   char               *rq_extend; /* request "extension" data  */
   char               *rq_id;      /* the batch request's id */
   memmgr             *mm;         /* Memory manager for this batch_request */
@@ -385,6 +398,8 @@ struct batch_request
 
     struct rq_track       rq_track;
 
+    struct rq_watchjobs   rq_watchjobs;
+
     struct rq_gpuctrl     rq_gpuctrl;
 
     struct rq_cpyfile     rq_cpyfile;
@@ -455,6 +470,7 @@ extern int decode_DIS_Manage (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_MoveJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_MessageJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_QueueJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_SubmitJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Register (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ReturnFiles (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ReqExtend (struct tcp_chan *chan, struct batch_request *);
@@ -465,6 +481,7 @@ extern int decode_DIS_RunJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ShutDown (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_SignalJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Status (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_WatchJobs (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_TrackJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_replySvr (struct tcp_chan *chan, struct batch_reply *);
 extern int decode_DIS_svrattrl (struct tcp_chan *chan, tlist_head *);
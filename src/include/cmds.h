@@ -133,5 +133,13 @@ int parse_depend_list(char *, char *, int);
 int parse_stage_list(char *);
 int cnt2server_conf(long);
 
+/* requests kept in flight on one connection by pipeline_jobs() */
+#define JOB_PIPELINE_WINDOW 64
+
+/* sends the request for job_id without reading its reply, see pbs_deljob_put() */
+typedef int (*job_put_func)(int connect, char *job_id, void *arg, int *tag);
+
+int pipeline_jobs(char *cmd, int count, char **job_ids, job_put_func put, void *arg, int locate);
+
 #endif
 
@@ -122,6 +122,8 @@
 
 #define MUNGE_SIZE 256 /* I do not know what the proper size of this should be. My 
                           testing with munge shows it creates a string of 128 bytes */
+#define MUNGE_CRED_TTL 120 /* lifetime of the munge credentials clients ask for, a
+                             client reuses one for half of it */
 
 /* enums for standard job files (sync w/TJobFileType[]) */
 
@@ -159,10 +161,17 @@ struct connect_handle
   int ch_errno; /* last error on this connection */
   char *ch_errtxt; /* pointer to last server error text */
   pthread_mutex_t *ch_mutex;
+  int ch_tag_sent; /* pipelined requests sent, see pbs_get_reply() */
+  int ch_tag_done; /* pipelined replies read */
+  void   *ch_stat_reply; /* streamed status reply being handed out */
+  int ch_stat_more; /* more streamed status replies to read */
   };
 
 extern struct connect_handle connection[];
 
+/* brp_auxcode of every streamed status reply but the last, see STATSTREAM */
+#define STATUS_STREAM_MORE 1
+
 /* PBS Batch Reply Structure     */
 /* structures that make up the reply union */
 
@@ -306,6 +315,8 @@ PBSD_status_put (int c, int func, char *id, struct attrl *attrib, char *extend);
 
 struct batch_reply *PBSD_rdrpy(int *local_errno, int connect);
 
+struct batch_reply *PBSD_rdrpy_stream(int *local_errno, int connect);
+
 void PBSD_FreeReply (struct batch_reply *);
 
 struct batch_status *PBSD_status(int c, int function, int *, char *id, struct attrl *attrib, char *extend);
@@ -314,6 +325,10 @@ struct batch_status *PBSD_status_get(int *local_errno, int c);
 
 char *PBSD_queuejob (int c, int *, char *j, char *d, struct attropl *a, char *ex);
 int PBSD_QueueJob_hash(int c, char *j, char *d, memmgr **mm, job_data *ja, job_data *ra, char *ex, char **job_id, char **msg);
+int PBSD_SubmitJob_hash(int c, char *d, memmgr **mm, job_data *ja, job_data *ra, char *sb, int sl, char *ex, char **job_id, char **msg);
+int PBSD_SubmitJob_put(struct tcp_chan *chan, char *d, memmgr **mm, job_data *ja, job_data *ra, char *sb, int sl, char *ex);
+int PBSD_SubmitJob_reply(struct batch_reply *reply, int rc, memmgr **mm, char **job_id, char **msg);
+int PBSD_submitjob_get_sid(int c, long *sid, char *j, char *d, struct attropl *a, char *sb, int sl);
 
 
 extern int decode_DIS_JobId (struct tcp_chan *chan, char *jobid);
@@ -335,6 +350,7 @@ extern int encode_DIS_RunJob (struct tcp_chan *chan, char *jid, char *where, uns
 extern int encode_DIS_ShutDown (struct tcp_chan *chan, int manner);
 extern int encode_DIS_SignalJob (struct tcp_chan *chan, char *jid, char *sig);
 extern int encode_DIS_Status (struct tcp_chan *chan, char *objid, struct attrl *);
+extern int encode_DIS_WatchJobs (struct tcp_chan *chan, int count, char **job_ids);
 extern int encode_DIS_attrl (struct tcp_chan *chan, struct attrl *);
 extern int encode_DIS_attropl (struct tcp_chan *chan, struct attropl *);
 int encode_DIS_attropl_hash(struct tcp_chan *chan, memmgr **mm, job_data *job_attr, job_data *res_attr);
@@ -208,6 +208,7 @@ int   kill_job(job *, int sig, const char *killer_id_name, char *why_killed_reas
 extern void  mom_deljob(job *);
 extern void  mom_freenodes(job *);
 extern void  scan_for_exiting();
+extern void  mark_job_exiting(job *);
 extern void  scan_for_terminated();
 extern void  scan_non_child_tasks(void);
 extern int   set_job(job *, struct startjob_rtn *);
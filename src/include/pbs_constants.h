@@ -35,6 +35,7 @@
 /* pbs_auth new version */
 #define AUTH_IP "127.0.0.1"
 #define AUTH_PORT 15005
+#define TRQAUTHD_SOCK_NAME PBS_SERVER_HOME "/trqauthd-unix" /* trqauthd unix domain socket, root-owned dir */
 
 /* long long is not defined on some systems. */
 #if defined(__hpux)         /* HP-UX */
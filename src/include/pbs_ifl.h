@@ -331,6 +331,13 @@
 #define ATTR_interactivejobscanroam  "interactive_jobs_can_roam" 
 #define ATTR_crayenabled             "cray_enabled"
 #define ATTR_maxuserqueuable         "max_user_queuable"
+#define ATTR_acctfsync               "accounting_fsync"
+#define ATTR_acctjson                "accounting_json"
+#define ATTR_logfileindex            "log_file_index"
+#define ATTR_joblogbinary            "job_log_binary"
+#define ATTR_mailratelimit           "mail_rate_limit"
+#define ATTR_mailcoalescedelay       "mail_coalesce_delay"
+#define ATTR_mailqueuedepth          "mail_queue_depth"
 /* additional node "attributes" names */
 
 #define ATTR_NODE_state            "state"
@@ -372,6 +379,7 @@
 #define DELASYNC     "delasync"   /* see req_delete.c */
 #define PURGECOMP    "purgecomplete="   /* see req_delete.c */
 #define EXECQUEONLY  "exec_queue_only"   /* see req_stat.c */
+#define STATSTREAM   "stream"   /* see req_stat.c */
 #define RERUNFORCE   "force"
 
 #define USER_HOLD   "u"
@@ -573,6 +581,18 @@ struct batch_status
   char                *text;
   };
 
+/* one job for pbs_submit_many(); rc, job_id and msg are filled in per job */
+struct submit_spec
+  {
+  job_data *job_attr;
+  job_data *res_attr;
+  char     *script;      /* path of the job script, may be NULL */
+  char     *destination;
+  int       rc;          /* O */
+  char     *job_id;      /* O */
+  char     *msg;         /* O */
+  };
+
 
 
 
@@ -649,6 +669,14 @@ int pbs_sigjob_err(int connect, char *job_id, char *signal, char *extend, int *)
 int pbs_sigjobasync(int connect, char *job_id, char *signal, char *extend);
 int pbs_sigjobasync_err(int connect, char *job_id, char *signal, char *extend, int *);
 
+/* pipelined requests, replies are read in order with pbs_get_reply() */
+int pbs_deljob_put(int connect, char *job_id, char *extend, int *tag);
+int pbs_sigjob_put(int connect, char *job_id, char *signal, char *extend, int *tag);
+int pbs_holdjob_put(int connect, char *job_id, char *hold_type, char *extend, int *tag);
+int pbs_rlsjob_put(int connect, char *job_id, char *hold_type, char *extend, int *tag);
+int pbs_get_reply(int connect, int *tag);
+int pbs_pipeline_pending(int connect);
+
 extern void
   pbs_statfree(struct batch_status *stat);
 
@@ -657,6 +685,11 @@ extern struct batch_status *
 
 struct batch_status *pbs_statjob(int connect, char *id, struct attrl *attrib, char *extend);
 struct batch_status *pbs_statjob_err(int connect, char *id, struct attrl *attrib, char *extend, int *);
+int pbs_statjob_stream(int connect, char *id, struct attrl *attrib, char *extend);
+struct batch_status *pbs_statjob_next(int connect, int *local_errno);
+
+int pbs_watchjobs(int connect, int count, char **job_ids, char *extend);
+int pbs_waitjobevent(int connect, int timeout, struct batch_status **event);
 
 struct batch_status *pbs_selstat(int connect, struct attropl *select_list, char *extend);
 struct batch_status *pbs_selstat_err(int connect, struct attropl *select_list, char *extend, int *);
@@ -675,6 +708,10 @@ char *pbs_submit_err(int connect, struct attropl *attrib, char *script, char *de
 
 int pbs_submit_hash(int connect, memmgr **mm, job_data *job_attr, job_data *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg);
 
+int pbs_submit_compound_hash(int connect, memmgr **mm, job_data *job_attr, job_data *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg);
+
+int pbs_submit_many(int connect, memmgr **mm, int count, struct submit_spec *jobs, char *extend);
+
 int pbs_terminate(int connect, int manner, char *extend);
 int pbs_terminate_err(int connect, int manner, char *extend, int *);
 
@@ -452,6 +452,8 @@ typedef struct noderes
 #define MOM_HAS_NODEFILE 4 /* Mom wrote job PBS_NODEFILE */
 #define MOM_NO_PROC  8 /* no procs found for job */
 #define MOM_HAS_TMPDIR  16 /* Mom made a tmpdir */
+#define MOM_EPILOGUE_ACTIVE 64 /* sister epilogue subtask running */
+#define MOM_EPILOGUE_DONE 128 /* sister epilogue subtask returned */
 
 #ifdef USESAVEDRESOURCES
 #define MOM_JOB_RECOVERY   32  /* recovering dead job on restart */
@@ -487,6 +489,7 @@ typedef struct
   int       pipe_script[2];
 
   int       jsmpipe[2];     /* job starter to MOM for sid */
+  int       jsmpipe_watched; /* jsmpipe[0] is registered with wait_request() */
   int       upfds;
   int       mjspipe[2];     /* MOM to job starter for ack */
   int       downfds;
@@ -547,6 +550,7 @@ struct job
 #ifdef PBS_MOM    /* MOM ONLY */
 
   list_link       ji_alljobs; /* link to next job in server job list */
+  list_link       ji_exitque; /* link to jobs with newly exited tasks */
   struct grpcache *ji_grpcache; /* cache of user's groups */
   time_t  ji_checkpoint_time; /* periodic checkpoint time */
   time_t  ji_checkpoint_next; /* next checkpoint time */
@@ -600,6 +604,7 @@ struct job
   int               ji_is_array_template;    /* set to TRUE if this is a "template job" for a job array*/
   int               ji_have_nodes_request; /* set to TRUE if node spec uses keyword nodes */
   int               ji_cold_restart; /* set to TRUE if this job has been loaded through a cold restart */
+  int               ji_watched; /* set to TRUE once a client watches this job, see job_watch.c */
 
   /* these three are only used for heterogeneous jobs */
   struct job       *ji_external_clone; /* the sub-job on the external (to the cray) nodes */
@@ -698,6 +703,7 @@ typedef struct job job;
 #define MAX_RECYCLE_JOBS           5000
 #define TOO_MANY_JOBS_IN_RECYCLER -1
 #define JOBS_TO_REMOVE             1000
+#define JOB_SLAB_JOBS              32   /* jobs allocated together */
 
 
 
@@ -727,6 +733,8 @@ typedef struct job_recycler
 
 
 int   insert_into_recycler(job *);
+job  *job_slab_alloc(void);
+void  job_slab_free(job *);
 job  *get_recycled_job();
 void  update_recycler_next_id();
 void  initialize_recycler();
@@ -879,6 +887,10 @@ typedef struct job_file_delete_info
 
 #define IM_ERROR          99
 
+/* event for one node of a tm_spawn_multi(), sent to the sister as
+ * IM_SPAWN_TASK and never seen on the wire */
+#define IM_SPAWN_MULTI    98
+
 eventent *event_alloc(int  command,
                            hnodent *pnode,
                            tm_event_t event,
@@ -892,6 +904,7 @@ task *task_find(job *pjob, tm_task_id taskid);
 #define LOCUTION_SUCCESS  0
 #define LOCUTION_FAIL    -1
 #define LOCUTION_REQUEUE -2
+#define LOCUTION_RETRY   -3 /* send_job_work() will retry from a timed task */
 
 #define LOCUTION_SIZE     20
 
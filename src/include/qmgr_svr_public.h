@@ -179,3 +179,9 @@ ATTR_nomailforce,
 ATTR_crayenabled,
 ATTR_interactivejobscanroam,
 ATTR_maxuserqueuable,
+ATTR_acctfsync,
+ATTR_acctjson,
+ATTR_logfileindex,
+ATTR_joblogbinary,
+ATTR_mailratelimit,
+ATTR_mailcoalescedelay,
@@ -98,3 +98,4 @@ ATTR_status,
 ATTR_total,
 ATTR_netcounter,
 ATTR_pbsversion,
+ATTR_mailqueuedepth,
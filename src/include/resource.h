@@ -133,6 +133,20 @@ unsigned int rs_type:
   ATRTYPE; /* type of resource,see attribute.h */
   } resource_def;
 
+/*
+ * resc_vector - the entries of a resource list by their index in
+ * svr_resc_def, so comparing two lists does not search one for each
+ * entry of the other.  It points into the list, which stays the real
+ * value of the pbs_attribute; build it just before use.
+ */
+
+typedef struct resc_vector
+  {
+  pbs_attribute  *rv_attr;  /* list this indexes */
+  int             rv_size;  /* svr_resc_size when built */
+  resource      **rv_slots; /* entry for svr_resc_def[i] or NULL */
+  } resc_vector;
+
 /* the resource definition array, only the fixed resources */
 extern resource_def svr_resc_def_const[];
 
@@ -145,6 +159,9 @@ extern int         svr_resc_size;
 extern resource     *add_resource_entry(pbs_attribute *, resource_def *);
 extern resource_def *find_resc_def(resource_def *, char *, int);
 extern resource     *find_resc_entry(pbs_attribute *, resource_def *);
+extern void          resc_vector_init(resc_vector *, pbs_attribute *);
+extern resource     *resc_vector_find(resc_vector *, resource_def *);
+extern void          resc_vector_free(resc_vector *);
 
 /* END resource.h */
 #endif
@@ -201,6 +201,13 @@ enum srv_atr
   SRV_ATR_CrayEnabled,
   SRV_ATR_InteractiveJobsCanRoam,
   SRV_ATR_MaxUserQueuable,
+  SRV_ATR_AcctFsync,
+  SRV_ATR_AcctJson,
+  SRV_ATR_LogFileIndex,
+  SRV_ATR_JobLogBinary,
+  SRV_ATR_MailRateLimit,
+  SRV_ATR_MailCoalesceDelay,
+  SRV_ATR_MailQueueDepth,
 
 #include "site_svr_attr_enum.h"
   /* This must be last */
@@ -293,12 +300,14 @@ int unlock_sv_qs_mutex(pthread_mutex_t *sv_qs_mutex, const char *msg_string);
 
 typedef struct mail_info
   {
-  char *mailto;
-  char *exec_host;
-  char *jobid;
-  char *jobname;
-  char *text;        /* additional optional text */
-  int   mail_point;
+  char   *mailto;
+  char   *exec_host;
+  char   *jobid;
+  char   *jobname;
+  char   *text;        /* additional optional text */
+  int     mail_point;
+  time_t  queued;      /* when it went on the mail queue */
+  struct mail_info *next; /* mail queue link */
   } mail_info;
 
 
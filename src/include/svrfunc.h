@@ -23,6 +23,7 @@ extern void  schedule_job(void);
 extern char *site_map_user(char *, char *);
 extern int   socket_to_handle(int, int *);
 extern void  svr_disconnect(int);
+extern void  svr_disconnect_pooled(int);
 extern int   svr_get_privilege(char *, char *);
 extern int   srv_shutdown(int);
 extern void  write_node_state(void);
@@ -36,6 +37,8 @@ extern int   init_resc_defs(void);
 
 int is_svr_attr_set(int);
 int set_svr_attr(int, void *);
+void svr_attr_publish(int);
+void svr_attr_publish_all(void);
 
 #ifdef PBS_JOB_H
 extern int   set_nodes(job *, char *, int, char **, char **, char *, char *);
@@ -53,6 +56,7 @@ extern int   chk_resc_limits(pbs_attribute *, pbs_queue *, char *);
 #ifdef PBS_NET_H
 struct pbsnode;
 extern int   svr_connect(pbs_net_t, unsigned int, int *, struct pbsnode *, void *(*)(void *), enum conn_type);
+extern int   svr_connect_pooled(pbs_net_t, unsigned int, int *, int, int *);
 #endif /* PBS_NET_H */
 
 #ifdef WORK_TASK_H
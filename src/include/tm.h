@@ -66,6 +66,15 @@ int tm_spawn(int   argc,
              tm_task_id *tid,
              tm_event_t *event);
 
+int tm_spawn_multi(int   argc,
+                   char  *argv[],
+                   char  *envp[],
+                   int   count,
+                   tm_node_id *where,
+                   tm_task_id *tids,
+                   int   *errors,
+                   tm_event_t *event);
+
 int tm_kill(tm_task_id tid,
             int  sig,
             tm_event_t *event);
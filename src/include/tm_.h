@@ -118,6 +118,7 @@ typedef unsigned int tm_task_id;
 #define TM_RECONFIG 110 /* tm_register deferred reply */
 #define TM_ACK  111 /* tm_register event acknowledge */
 #define TM_FINALIZE 112 /* tm_finalize request, there is no reply */
+#define TM_SPAWN_MULTI 113 /* tm_spawn_multi request */
 #define TM_OKAY    0
 
 
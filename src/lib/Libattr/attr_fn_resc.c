@@ -90,6 +90,12 @@
 #include "attribute.h"
 #include "resource.h"
 #include "pbs_error.h"
+#include "attr_name_index.h"
+
+/* resource lists shorter than this are searched, not indexed */
+#define RESC_VECTOR_MIN  8
+
+static resource *resc_vector_add(resc_vector *, resource_def *);
 
 /*
  * This file contains functions for manipulating attributes of type
@@ -323,10 +329,13 @@ int set_resc(
   enum batch_op local_op;
   resource *newresc;
   resource *oldresc;
+  resc_vector oldvec;
   int   rc;
 
   assert(old && new);
 
+  resc_vector_init(&oldvec, old);
+
   newresc = (resource *)GET_NEXT(new->at_val.at_list);
 
   while (newresc != NULL)
@@ -335,16 +344,18 @@ int set_resc(
 
     /* search for old that has same definition as new */
 
-    oldresc = find_resc_entry(old, newresc->rs_defin);
+    oldresc = resc_vector_find(&oldvec, newresc->rs_defin);
 
     if (oldresc == NULL)
       {
       /* add new resource to list */
 
-      oldresc = add_resource_entry(old, newresc->rs_defin);
+      oldresc = resc_vector_add(&oldvec, newresc->rs_defin);
 
       if (oldresc == NULL)
         {
+        resc_vector_free(&oldvec);
+
         return(PBSE_SYSTEM);
         }
       }
@@ -363,7 +374,11 @@ int set_resc(
 
       if ((rc = oldresc->rs_defin->rs_set(&oldresc->rs_value,
                                           &newresc->rs_value, local_op)) != 0)
+        {
+        resc_vector_free(&oldvec);
+
         return (rc);
+        }
       }
     else
       {
@@ -373,6 +388,8 @@ int set_resc(
     newresc = (resource *)GET_NEXT(newresc->rs_link);
     }
 
+  resc_vector_free(&oldvec);
+
   old->at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
 
   return(0);
@@ -409,8 +426,9 @@ int comp_resc(
   pbs_attribute *with)  /* I job's current requirements/attributes */
 
   {
-  resource *atresc;
-  resource *wiresc;
+  resource    *atresc;
+  resource    *wiresc;
+  resc_vector  atvec;
   int rc;
 
   comp_resc_gt = 0;
@@ -432,6 +450,8 @@ int comp_resc(
             and the job has no value set for this resource, this routine
             will not trigger comp_resc_lt */
 
+  resc_vector_init(&atvec, attr);
+
   wiresc = (resource *)GET_NEXT(with->at_val.at_list);
 
   while (wiresc != NULL)
@@ -439,7 +459,7 @@ int comp_resc(
     if ((wiresc->rs_value.at_flags & ATR_VFLAG_SET) &&
         ((wiresc->rs_value.at_flags & ATR_VFLAG_DEFLT) == 0))
       {
-      atresc = find_resc_entry(attr, wiresc->rs_defin);
+      atresc = resc_vector_find(&atvec, wiresc->rs_defin);
 
       if (atresc != NULL)
         {
@@ -470,6 +490,8 @@ int comp_resc(
     wiresc = (resource *)GET_NEXT(wiresc->rs_link);
     }  /* END while() */
 
+  resc_vector_free(&atvec);
+
   return(0);
   }  /* END comp_resc() */
 
@@ -508,9 +530,10 @@ int comp_resc2(
   enum compare_types  type)           /* I type of comparison to detect */
 
   {
-  resource *atresc;
-  resource *wiresc;
-  int       rc;
+  resource    *atresc;
+  resource    *wiresc;
+  resc_vector  vec;
+  int          rc;
   int       comp_ret = 0;
   char     *LimitName;
 
@@ -533,13 +556,15 @@ int comp_resc2(
     {
     /* comparison is queue centric */
 
+    resc_vector_init(&vec, with);
+
     atresc = (resource *)GET_NEXT(attr->at_val.at_list);
 
     while (atresc != NULL)
       {
       if (atresc->rs_value.at_flags & ATR_VFLAG_SET)
         {
-        wiresc = find_resc_entry(with, atresc->rs_defin);
+        wiresc = resc_vector_find(&vec, atresc->rs_defin);
 
         if (wiresc != NULL)
           {
@@ -590,6 +615,8 @@ int comp_resc2(
 
       atresc = (resource *)GET_NEXT(atresc->rs_link);
       }
+
+    resc_vector_free(&vec);
     }
   else
     {
@@ -600,6 +627,8 @@ int comp_resc2(
               and the job has no value set for this resource, this routine
               will not trigger comp_resc_lt */
 
+    resc_vector_init(&vec, attr);
+
     wiresc = (resource *)GET_NEXT(with->at_val.at_list);
 
     while (wiresc != NULL)
@@ -607,7 +636,7 @@ int comp_resc2(
       if ((wiresc->rs_value.at_flags & ATR_VFLAG_SET) &&
           ((wiresc->rs_value.at_flags & ATR_VFLAG_DEFLT) == 0))
         {
-        atresc = find_resc_entry(attr, wiresc->rs_defin);
+        atresc = resc_vector_find(&vec, wiresc->rs_defin);
 
         if (atresc != NULL)
           {
@@ -657,6 +686,8 @@ int comp_resc2(
 
       wiresc = (resource *)GET_NEXT(wiresc->rs_link);
       }  /* END while() */
+
+    resc_vector_free(&vec);
     }
 
   return(comp_ret);
@@ -712,6 +743,9 @@ void free_resc(
  * find_resc_def - find the resource_def structure for a resource with
  * a given name
  *
+ * Resource names are case sensitive.  The names are hashed on first use,
+ * see attr_name_index.c.
+ *
  * Returns: pointer to the structure or NULL
  */
 
@@ -722,19 +756,12 @@ resource_def *find_resc_def(
   int           limit) /* number of members in resource_def array */
 
   {
-  while (limit--)
-    {
-    if (!strcmp(rscdf->rs_name, name))
-      {
-      /* SUCCESS */
+  int index;
 
-      return(rscdf);
-      }
+  if ((index = find_def_name(rscdf, sizeof(resource_def), name, limit, FALSE)) < 0)
+    return(NULL);
 
-    rscdf++;
-    }
-
-  return(NULL);
+  return(rscdf + index);
   }  /* END find_resc_def() */
 
 
@@ -760,7 +787,8 @@ resource *find_resc_entry(
 
   while (pr != NULL)
     {
-    if (!strcmp(pr->rs_defin->rs_name, rscdf->rs_name))
+    if ((pr->rs_defin == rscdf) ||
+        (!strcmp(pr->rs_defin->rs_name, rscdf->rs_name)))
       break;
 
     pr = (resource *)GET_NEXT(pr->rs_link);
@@ -772,6 +800,168 @@ resource *find_resc_entry(
 
 
 
+/*
+ * resc_def_index - index of a resource definition in svr_resc_def
+ *
+ * Lists built before init_resc_defs() last rebuilt svr_resc_def point at
+ * the old array, so anything outside the current one is found by name.
+ *
+ * Returns: >= 0 the index, -1 if the resource is no longer defined
+ */
+
+static int resc_def_index(
+
+  resource_def *rscdf)
+
+  {
+  resource_def *prdef;
+
+  if ((svr_resc_def == NULL) ||
+      (rscdf == NULL))
+    return(-1);
+
+  if ((rscdf >= svr_resc_def) &&
+      (rscdf < svr_resc_def + svr_resc_size))
+    return(rscdf - svr_resc_def);
+
+  if ((prdef = find_resc_def(svr_resc_def, rscdf->rs_name, svr_resc_size)) == NULL)
+    return(-1);
+
+  return(prdef - svr_resc_def);
+  }  /* END resc_def_index() */
+
+
+
+
+/*
+ * resc_vector_init - index the entries of a resource list
+ *
+ * Lists shorter than RESC_VECTOR_MIN are not worth the allocation and are
+ * left unindexed, as is any list if the slots cannot be allocated.  The
+ * vector still works, each lookup just falls back to find_resc_entry().
+ */
+
+void resc_vector_init(
+
+  resc_vector   *rv,    /* O */
+  pbs_attribute *pattr) /* I */
+
+  {
+  resource *pr;
+  int       index;
+  int       count = 0;
+
+  rv->rv_attr = pattr;
+  rv->rv_size = svr_resc_size;
+  rv->rv_slots = NULL;
+
+  if ((svr_resc_def == NULL) ||
+      (svr_resc_size <= 0))
+    return;
+
+  pr = (resource *)GET_NEXT(pattr->at_val.at_list);
+
+  while ((pr != NULL) &&
+         (count < RESC_VECTOR_MIN))
+    {
+    count++;
+
+    pr = (resource *)GET_NEXT(pr->rs_link);
+    }
+
+  if (count < RESC_VECTOR_MIN)
+    return;
+
+  if ((rv->rv_slots = calloc(svr_resc_size, sizeof(resource *))) == NULL)
+    return;
+
+  pr = (resource *)GET_NEXT(pattr->at_val.at_list);
+
+  while (pr != NULL)
+    {
+    index = resc_def_index(pr->rs_defin);
+
+    if ((index >= 0) &&
+        (rv->rv_slots[index] == NULL))
+      rv->rv_slots[index] = pr;
+
+    pr = (resource *)GET_NEXT(pr->rs_link);
+    }
+  }  /* END resc_vector_init() */
+
+
+
+
+/*
+ * resc_vector_find - the vector's version of find_resc_entry()
+ *
+ * Returns: pointer to struct resource or NULL
+ */
+
+resource *resc_vector_find(
+
+  resc_vector  *rv,    /* I */
+  resource_def *rscdf) /* I */
+
+  {
+  int index;
+
+  if ((rv->rv_slots == NULL) ||
+      (rv->rv_size != svr_resc_size))
+    return(find_resc_entry(rv->rv_attr, rscdf));
+
+  if ((index = resc_def_index(rscdf)) < 0)
+    return(find_resc_entry(rv->rv_attr, rscdf));
+
+  return(rv->rv_slots[index]);
+  }  /* END resc_vector_find() */
+
+
+
+
+/*
+ * resc_vector_add - add an entry to the list and the vector
+ *
+ * Returns: pointer to the entry or NULL if unable to add it
+ */
+
+static resource *resc_vector_add(
+
+  resc_vector  *rv,    /* I/O */
+  resource_def *rscdf) /* I */
+
+  {
+  resource *pr;
+  int       index;
+
+  if ((pr = add_resource_entry(rv->rv_attr, rscdf)) == NULL)
+    return(NULL);
+
+  if ((rv->rv_slots != NULL) &&
+      (rv->rv_size == svr_resc_size) &&
+      ((index = resc_def_index(rscdf)) >= 0))
+    rv->rv_slots[index] = pr;
+
+  return(pr);
+  }  /* END resc_vector_add() */
+
+
+
+
+void resc_vector_free(
+
+  resc_vector *rv)
+
+  {
+  if (rv->rv_slots != NULL)
+    free(rv->rv_slots);
+
+  rv->rv_slots = NULL;
+  }  /* END resc_vector_free() */
+
+
+
+
 /*
  * add_resource_entry - add and "unset" entry for a resource type to a
  * list headed in an pbs_attribute.  Just for later displaying, the
@@ -21,5 +21,11 @@ resource_def *find_resc_def(resource_def *rscdf, char *name, int limit);
 
 resource *find_resc_entry(pbs_attribute *pattr, resource_def *rscdf); 
 
+void resc_vector_init(resc_vector *rv, pbs_attribute *pattr);
+
+resource *resc_vector_find(resc_vector *rv, resource_def *rscdf);
+
+void resc_vector_free(resc_vector *rv);
+
 int action_resc(pbs_attribute *pattr, void *pobject, int actmode);
 
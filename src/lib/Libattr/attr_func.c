@@ -87,6 +87,7 @@
 #include "list_link.h"
 #include "attribute.h"
 #include "pbs_error.h"
+#include "attr_name_index.h"
 
 /*
  * This file contains general functions for manipulating attributes.
@@ -141,36 +142,12 @@ void clear_attr(
 
 
 
-/*
- * str_nc_cmp - string no-case comparision
- */
-
-static int str_nc_cmp(
-
-  char *s1,  /* I */
-  char *s2)  /* I */
-
-  {
-  do
-    {
-    if (tolower((int)*s1) != tolower((int)*s2))
-      {
-      return(-1);
-      }
-    }
-  while (*s1++ && *s2++);
-
-  return(0);
-  }  /* END str_nc_cmp() */
-
-
-
-
 /*
  * find_attr - find pbs_attribute definition by name
  *
  * Searches array of pbs_attribute definition strutures to find one
- * whose name matches the requested name.
+ * whose name matches the requested name, ignoring case.  The names are
+ * hashed on first use, see attr_name_index.c.
  *
  * Returns: >= 0 index into definition struture array
  *     -1 if didn't find matching name
@@ -183,22 +160,7 @@ int find_attr(
   int                   limit)    /* limit on size of def array */
 
   {
-  int index;
-
-  if (attr_def != NULL)
-    {
-    for (index = 0;index < limit;index++)
-      {
-      if (!str_nc_cmp(attr_def->at_name, name))
-        {
-        return(index);
-        }
-
-      attr_def++;
-      }  /* END for (index) */
-    }
-
-  return(-1);
+  return(find_def_name(attr_def, sizeof(struct attribute_def), name, limit, TRUE));
   }
 
 
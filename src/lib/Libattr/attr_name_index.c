@@ -0,0 +1,367 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * attr_name_index
+ *
+ * Hashed name lookup for the attribute_def and resource_def arrays.
+ * find_attr() and find_resc_def() used to strcasecmp/strcmp their way
+ * down the whole definition array for every name in every request, save
+ * file and status reply.  The first lookup in an array builds an open
+ * addressed table over its names; later lookups hash the name and compare
+ * against one or two candidates.
+ *
+ * The definition arrays do not change once built, so readers use the
+ * tables without locking.  The only array that is rebuilt is svr_resc_def
+ * (init_resc_defs() reallocates it when the server's extra_resc
+ * changes), which simply shows up as a new array; init_resc_defs() hands
+ * the old one to forget_name_index() so it gives up its slot.
+ */
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "attr_name_index.h"
+
+/* distinct definition arrays that get an index, the rest are scanned */
+#define NAME_INDEX_MAX  32
+
+typedef struct name_index
+  {
+  void *ni_defs;   /* the definition array this indexes */
+  int   ni_limit;  /* number of definitions indexed */
+  int   ni_nocase; /* TRUE if names compare without case */
+  int   ni_mask;   /* table size - 1, the size is a power of two */
+  int  *ni_slots;  /* index into ni_defs, -1 if the slot is empty */
+  } name_index;
+
+static name_index * volatile name_indexes[NAME_INDEX_MAX];
+static volatile int          name_index_count = 0;
+static pthread_mutex_t       name_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+
+/*
+ * def_name - the name of the index'th definition
+ *
+ * Both attribute_def and resource_def start with their name.
+ */
+
+static char *def_name(
+
+  void   *defs,
+  size_t  def_size,
+  int     index)
+
+  {
+  return(*(char **)((char *)defs + (def_size * index)));
+  }  /* END def_name() */
+
+
+
+
+/*
+ * name_hash - FNV-1a over the lower cased name
+ *
+ * Names are folded for both kinds of lookup so one hash serves either;
+ * the comparison afterwards decides whether case matters.
+ */
+
+static unsigned int name_hash(
+
+  char *name)
+
+  {
+  unsigned int hash = 2166136261U;
+
+  while (*name != '\0')
+    {
+    hash ^= (unsigned char)tolower((int)*name++);
+    hash *= 16777619U;
+    }
+
+  return(hash);
+  }  /* END name_hash() */
+
+
+
+
+static int names_match(
+
+  char *s1,
+  char *s2,
+  int   nocase)
+
+  {
+  if (nocase)
+    return(strcasecmp(s1, s2) == 0);
+
+  return(strcmp(s1, s2) == 0);
+  }  /* END names_match() */
+
+
+
+
+/*
+ * build_name_index - hash the first limit names of defs
+ *
+ * Only the first definition of a name is entered, which is the one a
+ * linear scan would have stopped at.
+ *
+ * Returns the new index or NULL if out of memory
+ */
+
+static name_index *build_name_index(
+
+  void   *defs,
+  size_t  def_size,
+  int     limit,
+  int     nocase)
+
+  {
+  name_index   *ni;
+  int           size = 16;
+  int           index;
+  unsigned int  slot;
+  char         *name;
+
+  /* keep the table at most half full */
+  while (size < (limit * 2))
+    size <<= 1;
+
+  if ((ni = calloc(1, sizeof(name_index))) == NULL)
+    return(NULL);
+
+  if ((ni->ni_slots = malloc(size * sizeof(int))) == NULL)
+    {
+    free(ni);
+
+    return(NULL);
+    }
+
+  memset(ni->ni_slots, -1, size * sizeof(int));
+
+  ni->ni_defs = defs;
+  ni->ni_limit = limit;
+  ni->ni_nocase = nocase;
+  ni->ni_mask = size - 1;
+
+  for (index = 0; index < limit; index++)
+    {
+    if ((name = def_name(defs, def_size, index)) == NULL)
+      continue;
+
+    slot = name_hash(name) & ni->ni_mask;
+
+    while (ni->ni_slots[slot] != -1)
+      {
+      if (names_match(def_name(defs, def_size, ni->ni_slots[slot]), name, nocase))
+        break;
+
+      slot = (slot + 1) & ni->ni_mask;
+      }
+
+    if (ni->ni_slots[slot] == -1)
+      ni->ni_slots[slot] = index;
+    }
+
+  return(ni);
+  }  /* END build_name_index() */
+
+
+
+
+/*
+ * get_name_index - find or build the index covering limit names of defs
+ *
+ * An index built for a larger limit serves smaller ones too.  A lookup
+ * with a larger limit than any before it replaces the index.  The old one
+ * is not freed since another thread may be probing it.
+ *
+ * Returns the index or NULL if defs should just be scanned
+ */
+
+static name_index *get_name_index(
+
+  void   *defs,
+  size_t  def_size,
+  int     limit,
+  int     nocase)
+
+  {
+  name_index *ni;
+  int         count;
+  int         found = -1;
+  int         i;
+
+  count = name_index_count;
+
+  __sync_synchronize();
+
+  for (i = 0; i < count; i++)
+    {
+    ni = name_indexes[i];
+
+    if ((ni->ni_defs == defs) &&
+        (ni->ni_nocase == nocase) &&
+        (ni->ni_limit >= limit))
+      return(ni);
+    }
+
+  pthread_mutex_lock(&name_index_mutex);
+
+  for (i = 0; i < name_index_count; i++)
+    {
+    ni = name_indexes[i];
+
+    if ((ni->ni_defs == defs) &&
+        (ni->ni_nocase == nocase))
+      {
+      if (ni->ni_limit >= limit)
+        {
+        pthread_mutex_unlock(&name_index_mutex);
+
+        return(ni);
+        }
+
+      found = i;
+
+      break;
+      }
+    }
+
+  if ((found < 0) &&
+      (name_index_count >= NAME_INDEX_MAX))
+    {
+    pthread_mutex_unlock(&name_index_mutex);
+
+    return(NULL);
+    }
+
+  if ((ni = build_name_index(defs, def_size, limit, nocase)) != NULL)
+    {
+    /* the table must be complete before another thread can see it */
+    __sync_synchronize();
+
+    if (found >= 0)
+      {
+      name_indexes[found] = ni;
+      }
+    else
+      {
+      name_indexes[name_index_count] = ni;
+
+      __sync_synchronize();
+
+      name_index_count++;
+      }
+    }
+
+  pthread_mutex_unlock(&name_index_mutex);
+
+  return(ni);
+  }  /* END get_name_index() */
+
+
+
+
+/*
+ * forget_name_index - release the index slot of a retired array
+ *
+ * The index itself is left allocated, like the array it covers, since
+ * another thread may still be probing it.
+ */
+
+void forget_name_index(
+
+  void *defs)  /* I - definition array that is no longer used */
+
+  {
+  int i;
+
+  pthread_mutex_lock(&name_index_mutex);
+
+  for (i = 0; i < name_index_count; i++)
+    {
+    if (name_indexes[i]->ni_defs != defs)
+      continue;
+
+    /* lockless readers see either entry until the count drops */
+    name_indexes[i] = name_indexes[name_index_count - 1];
+
+    __sync_synchronize();
+
+    name_index_count--;
+
+    /* look at the entry just moved here too */
+    i--;
+    }
+
+  pthread_mutex_unlock(&name_index_mutex);
+  }  /* END forget_name_index() */
+
+
+
+
+/*
+ * find_def_name - find a definition by name
+ *
+ * Looks through the first limit entries of the array of def_size byte
+ * definitions at defs, comparing names without case if nocase is TRUE.
+ *
+ * Returns: >= 0 index of the first definition with that name
+ *          -1 if there is none
+ */
+
+int find_def_name(
+
+  void   *defs,     /* I - attribute_def or resource_def array */
+  size_t  def_size, /* I - size of one definition */
+  char   *name,     /* I - name to find */
+  int     limit,    /* I - number of definitions to search */
+  int     nocase)   /* I - TRUE to ignore case */
+
+  {
+  name_index   *ni;
+  unsigned int  slot;
+  int           index;
+
+  if ((defs == NULL) ||
+      (name == NULL) ||
+      (limit <= 0))
+    return(-1);
+
+  if ((ni = get_name_index(defs, def_size, limit, nocase)) == NULL)
+    {
+    for (index = 0; index < limit; index++)
+      {
+      if ((def_name(defs, def_size, index) != NULL) &&
+          (names_match(def_name(defs, def_size, index), name, nocase)))
+        return(index);
+      }
+
+    return(-1);
+    }
+
+  slot = name_hash(name) & ni->ni_mask;
+
+  while ((index = ni->ni_slots[slot]) != -1)
+    {
+    if (names_match(def_name(defs, def_size, index), name, nocase))
+      {
+      /* the first definition of the name is past the caller's limit */
+      if (index >= limit)
+        return(-1);
+
+      return(index);
+      }
+
+    slot = (slot + 1) & ni->ni_mask;
+    }
+
+  return(-1);
+  }  /* END find_def_name() */
+
+/* END attr_name_index.c */
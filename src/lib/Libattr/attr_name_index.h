@@ -0,0 +1,10 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _ATTR_NAME_INDEX_H
+#define _ATTR_NAME_INDEX_H
+
+#include <stddef.h> /* size_t */
+
+int find_def_name(void *defs, size_t def_size, char *name, int limit, int nocase);
+void forget_name_index(void *defs);
+
+#endif /* _ATTR_NAME_INDEX_H */
@@ -1,6 +1,7 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "list_link.h" /* list_link */
 #include "resource.h" /* resource_def */
@@ -16,19 +17,38 @@ void delete_link(struct list_link *old)
 
 void insert_link(struct list_link *old, struct list_link *new, void *pobj, int position) 
   {
-  fprintf(stderr, "The call to insert_link needs to be mocked!!\n");
-  exit(1);
+  /* only LINK_INSET_BEFORE is used by add_resource_entry() */
+  new->ll_struct = pobj;
+  new->ll_next = old;
+  new->ll_prior = old->ll_prior;
+  old->ll_prior->ll_next = new;
+  old->ll_prior = new;
   } 
 
 void *get_next(list_link pl, char *file, int line)
   {
-  fprintf(stderr, "The call to get_next needs to be mocked!!\n");
-  exit(1);
+  return(pl.ll_next->ll_struct);
   } 
 
 void append_link(tlist_head *head, list_link *new, void *pobj)
  {
- fprintf(stderr, "The call to append_link needs to be mocked!!\n");
- exit(1);
+ new->ll_struct = pobj;
+ new->ll_prior = head->ll_prior;
+ new->ll_next = head;
+ head->ll_prior = new;
+ new->ll_prior->ll_next = new;
  }
 
+
+int find_def_name(void *defs, size_t def_size, char *name, int limit, int nocase)
+ {
+ int i;
+
+ for (i = 0; i < limit; i++)
+   {
+   if (!strcmp(((resource_def *)defs)[i].rs_name, name))
+     return(i);
+   }
+
+ return(-1);
+ }
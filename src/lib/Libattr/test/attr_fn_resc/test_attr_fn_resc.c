@@ -3,10 +3,74 @@
 #include "test_attr_fn_resc.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 #include "pbs_error.h"
 
+extern int comp_resc_gt;
+extern int comp_resc_eq;
+extern int comp_resc_lt;
+extern int comp_resc_nc;
+
+#define TEST_RESC_COUNT 12
+
+static int test_comp(pbs_attribute *attr, pbs_attribute *with)
+  {
+  if (attr->at_val.at_long > with->at_val.at_long)
+    return(1);
+
+  if (attr->at_val.at_long < with->at_val.at_long)
+    return(-1);
+
+  return(0);
+  }
+
+static int test_set(pbs_attribute *old, pbs_attribute *new, enum batch_op op)
+  {
+  old->at_val.at_long = new->at_val.at_long;
+  old->at_flags |= ATR_VFLAG_SET;
+
+  return(0);
+  }
+
+static void test_free(pbs_attribute *attr)
+  {
+  attr->at_val.at_long = 0;
+  attr->at_flags &= ~ATR_VFLAG_SET;
+  }
+
+/* defines TEST_RESC_COUNT resources named r00, r01, ... */
+static void init_test_defs(void)
+  {
+  char name[8];
+  int  i;
+
+  svr_resc_size = TEST_RESC_COUNT;
+  svr_resc_def = calloc(svr_resc_size, sizeof(resource_def));
+
+  for (i = 0; i < svr_resc_size; i++)
+    {
+    snprintf(name, sizeof(name), "r%02d", i);
+
+    svr_resc_def[i].rs_name = strdup(name);
+    svr_resc_def[i].rs_comp = test_comp;
+    svr_resc_def[i].rs_set = test_set;
+    svr_resc_def[i].rs_free = test_free;
+    svr_resc_def[i].rs_type = ATR_TYPE_LONG;
+    }
+  }
+
+static resource *set_test_resc(pbs_attribute *pattr, resource_def *prdef, long value)
+  {
+  resource *pr = add_resource_entry(pattr, prdef);
+
+  pr->rs_value.at_val.at_long = value;
+  pr->rs_value.at_flags |= ATR_VFLAG_SET;
+
+  return(pr);
+  }
+
 START_TEST(test_one)
   {
 
@@ -21,6 +85,112 @@ START_TEST(test_two)
   }
 END_TEST
 
+START_TEST(resc_vector_test)
+  {
+  pbs_attribute  attr;
+  resc_vector    rv;
+  resource_def   stale;
+  resource      *pr;
+  int            i;
+
+  init_test_defs();
+
+  memset(&attr, 0, sizeof(attr));
+  CLEAR_HEAD(attr.at_val.at_list);
+
+  /* too short to index, lookups search the list */
+  set_test_resc(&attr, &svr_resc_def[3], 3);
+
+  resc_vector_init(&rv, &attr);
+  fail_unless(rv.rv_slots == NULL);
+  fail_unless(resc_vector_find(&rv, &svr_resc_def[3])->rs_value.at_val.at_long == 3);
+  fail_unless(resc_vector_find(&rv, &svr_resc_def[4]) == NULL);
+  resc_vector_free(&rv);
+
+  for (i = 0; i < TEST_RESC_COUNT; i += 2)
+    set_test_resc(&attr, &svr_resc_def[i], i);
+
+  for (i = 7; i < TEST_RESC_COUNT; i += 2)
+    set_test_resc(&attr, &svr_resc_def[i], i);
+
+  resc_vector_init(&rv, &attr);
+  fail_unless(rv.rv_slots != NULL);
+
+  for (i = 0; i < TEST_RESC_COUNT; i++)
+    {
+    pr = resc_vector_find(&rv, &svr_resc_def[i]);
+
+    if ((i % 2 == 0) || (i == 3) || (i >= 7))
+      fail_unless((pr != NULL) && (pr->rs_value.at_val.at_long == i));
+    else
+      fail_unless(pr == NULL);
+    }
+
+  /* a definition from before svr_resc_def was rebuilt is found by name */
+  memcpy(&stale, &svr_resc_def[9], sizeof(stale));
+  pr = resc_vector_find(&rv, &stale);
+  fail_unless((pr != NULL) && (pr->rs_value.at_val.at_long == 9));
+
+  resc_vector_free(&rv);
+  fail_unless(rv.rv_slots == NULL);
+  }
+END_TEST
+
+START_TEST(comp_set_resc_test)
+  {
+  pbs_attribute  queue;
+  pbs_attribute  job;
+  pbs_attribute  add;
+  resource      *pr;
+  int            i;
+
+  init_test_defs();
+
+  memset(&queue, 0, sizeof(queue));
+  memset(&job, 0, sizeof(job));
+  memset(&add, 0, sizeof(add));
+  CLEAR_HEAD(queue.at_val.at_list);
+  CLEAR_HEAD(job.at_val.at_list);
+  CLEAR_HEAD(add.at_val.at_list);
+
+  /* the queue has every resource but the last, all set to 10 */
+  for (i = 0; i < TEST_RESC_COUNT - 1; i++)
+    set_test_resc(&queue, &svr_resc_def[i], 10);
+
+  set_test_resc(&job, &svr_resc_def[0], 5);
+  set_test_resc(&job, &svr_resc_def[1], 10);
+  set_test_resc(&job, &svr_resc_def[2], 15);
+  set_test_resc(&job, &svr_resc_def[5], 20);
+  set_test_resc(&job, &svr_resc_def[TEST_RESC_COUNT - 1], 1);
+
+  fail_unless(comp_resc(&queue, &job) == 0);
+  fail_unless(comp_resc_gt == 1);
+  fail_unless(comp_resc_eq == 1);
+  fail_unless(comp_resc_lt == 2);
+  fail_unless(comp_resc_nc == 1);
+
+  /* set_resc updates existing entries and adds the rest in name order */
+  set_test_resc(&add, &svr_resc_def[1], 42);
+  set_test_resc(&add, &svr_resc_def[TEST_RESC_COUNT - 1], 43);
+
+  fail_unless(set_resc(&queue, &add, SET) == 0);
+  fail_unless(find_resc_entry(&queue, &svr_resc_def[1])->rs_value.at_val.at_long == 42);
+  fail_unless(find_resc_entry(&queue, &svr_resc_def[TEST_RESC_COUNT - 1])->rs_value.at_val.at_long == 43);
+
+  i = 0;
+  pr = (resource *)GET_NEXT(queue.at_val.at_list);
+
+  while (pr != NULL)
+    {
+    fail_unless(pr->rs_defin == &svr_resc_def[i++]);
+
+    pr = (resource *)GET_NEXT(pr->rs_link);
+    }
+
+  fail_unless(i == TEST_RESC_COUNT);
+  }
+END_TEST
+
 Suite *attr_fn_resc_suite(void)
   {
   Suite *s = suite_create("attr_fn_resc_suite methods");
@@ -32,6 +202,14 @@ Suite *attr_fn_resc_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("resc_vector_test");
+  tcase_add_test(tc_core, resc_vector_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("comp_set_resc_test");
+  tcase_add_test(tc_core, comp_set_resc_test);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -15,3 +15,9 @@ void delete_link(struct list_link *old)
   fprintf(stderr, "The call to delete_link needs to be mocked!!\n");
   exit(1);
   }
+
+int find_def_name(void *defs, size_t def_size, char *name, int limit, int nocase)
+  {
+  fprintf(stderr, "The call to find_def_name needs to be mocked!!\n");
+  exit(1);
+  }
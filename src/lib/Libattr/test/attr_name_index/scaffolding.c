@@ -0,0 +1,5 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+
+/* attr_name_index.c needs nothing from the rest of the server */
@@ -0,0 +1,151 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "attr_name_index.h"
+#include "test_attr_name_index.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "attribute.h"
+#include "resource.h"
+#include "pbs_error.h"
+
+static struct attribute_def test_attr_def[] =
+  {
+    { "Job_Name" },
+    { "Job_Owner" },
+    { "job_state" },
+    { "queue" },
+    { "JOB_NAME" },  /* shadowed by Job_Name */
+    { "Resource_List" }
+  };
+
+#define TEST_ATTR_LAST (sizeof(test_attr_def) / sizeof(test_attr_def[0]))
+
+START_TEST(find_attribute_names)
+  {
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "queue", TEST_ATTR_LAST, TRUE) == 3);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "QUEUE", TEST_ATTR_LAST, TRUE) == 3);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "resource_list", TEST_ATTR_LAST, TRUE) == 5);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "Job_Names", TEST_ATTR_LAST, TRUE) == -1);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "", TEST_ATTR_LAST, TRUE) == -1);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), NULL, TEST_ATTR_LAST, TRUE) == -1);
+  fail_unless(find_def_name(NULL, sizeof(struct attribute_def), "queue", TEST_ATTR_LAST, TRUE) == -1);
+
+  /* the first definition of a name wins, as it did with a linear scan */
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "job_name", TEST_ATTR_LAST, TRUE) == 0);
+
+  /* a smaller limit is answered from the same index */
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "job_state", 3, TRUE) == 2);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "queue", 3, TRUE) == -1);
+  fail_unless(find_def_name(test_attr_def, sizeof(struct attribute_def), "Resource_List", 5, TRUE) == -1);
+  }
+END_TEST
+
+START_TEST(find_resource_names)
+  {
+  resource_def *defs;
+  char          name[32];
+  int           count = 200;
+  int           i;
+
+  defs = calloc(count, sizeof(resource_def));
+
+  for (i = 0; i < count; i++)
+    {
+    snprintf(name, sizeof(name), "resc%d", i);
+    defs[i].rs_name = strdup(name);
+    }
+
+  /* resources are case sensitive */
+  defs[count - 1].rs_name = strdup("Resc0");
+
+  /* grow the index one name at a time */
+  for (i = 1; i < count; i++)
+    {
+    snprintf(name, sizeof(name), "resc%d", i);
+
+    fail_unless(find_def_name(defs, sizeof(resource_def), name, i, FALSE) == -1);
+    fail_unless(find_def_name(defs, sizeof(resource_def), "resc0", i, FALSE) == 0);
+    }
+
+  for (i = 0; i < count - 1; i++)
+    {
+    snprintf(name, sizeof(name), "resc%d", i);
+
+    fail_unless(find_def_name(defs, sizeof(resource_def), name, count, FALSE) == i);
+    }
+
+  fail_unless(find_def_name(defs, sizeof(resource_def), "Resc0", count, FALSE) == count - 1);
+  fail_unless(find_def_name(defs, sizeof(resource_def), "RESC1", count, FALSE) == -1);
+  fail_unless(find_def_name(defs, sizeof(resource_def), "RESC1", count, TRUE) == 1);
+  }
+END_TEST
+
+START_TEST(forget_retired_arrays)
+  {
+  resource_def *defs;
+  int           i;
+
+  /* far more arrays than there are index slots, each retired in turn */
+  for (i = 0; i < 100; i++)
+    {
+    defs = calloc(2, sizeof(resource_def));
+    defs[0].rs_name = "walltime";
+    defs[1].rs_name = "nodes";
+
+    fail_unless(find_def_name(defs, sizeof(resource_def), "nodes", 2, FALSE) == 1);
+
+    forget_name_index(defs);
+    }
+
+  /* forgetting an array that was never indexed is harmless */
+  forget_name_index(defs);
+
+  defs = calloc(2, sizeof(resource_def));
+  defs[0].rs_name = "walltime";
+  defs[1].rs_name = "nodes";
+
+  fail_unless(find_def_name(defs, sizeof(resource_def), "nodes", 2, FALSE) == 1);
+
+  /* a scan would find the renamed entry, the index still has a slot for
+   * this array and so does not */
+  defs[1].rs_name = "mem";
+
+  fail_unless(find_def_name(defs, sizeof(resource_def), "mem", 2, FALSE) == -1);
+  }
+END_TEST
+
+Suite *attr_name_index_suite(void)
+  {
+  Suite *s = suite_create("attr_name_index_suite methods");
+  TCase *tc_core = tcase_create("find_attribute_names");
+  tcase_add_test(tc_core, find_attribute_names);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("find_resource_names");
+  tcase_add_test(tc_core, find_resource_names);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("forget_retired_arrays");
+  tcase_add_test(tc_core, forget_retired_arrays);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(attr_name_index_suite());
+  srunner_set_log(sr, "attr_name_index_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _ATTR_NAME_INDEX_CT_H
+#define _ATTR_NAME_INDEX_CT_H
+#include <check.h>
+
+Suite *attr_name_index_suite();
+
+#endif /* _ATTR_NAME_INDEX_CT_H */
@@ -48,6 +48,9 @@ int parse_jobid(char *job_id, char **arg_seq_number, char **arg_parent_server, c
 int parse_stage_name(char *pair, char **local, char **host, char **remote);
 int parse_stage_list(char *list);
 
+/* from file pipeline_jobs.c */
+int pipeline_jobs(char *cmd, int count, char **job_ids, int (*put)(int connect, char *job_id, void *arg, int *tag), void *arg, int locate);
+
 /* from file prepare_path.c */
 int prepare_path(char *path_in, char *path_out, char *host);
 
@@ -0,0 +1,240 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * pipeline_jobs
+ *
+ * Apply one request (delete, signal, hold, release) to a list of job ids.
+ * Consecutive jobs on the same server share one connection and up to
+ * JOB_PIPELINE_WINDOW requests are kept in flight on it, instead of a
+ * connect, request, reply and disconnect per job.  Replies are handled in
+ * command line order, so errors print as they did one job at a time.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "cmds.h"
+#include "pbs_ifl.h"
+#include "pbs_error.h"
+
+typedef struct job_pipeline
+  {
+  char          *jp_cmd;
+  job_put_func   jp_put;
+  void          *jp_arg;
+  int            jp_locate;   /* look up jobs the server does not know */
+  int            jp_connect;  /* -1 when no connection is open */
+  char           jp_server[MAXSERVERNAME];
+  int            jp_head;     /* oldest request awaiting its reply */
+  int            jp_pending;
+  char          *jp_inflight[JOB_PIPELINE_WINDOW];
+  int            jp_status;   /* result of the last job, the exit status */
+  } job_pipeline;
+
+
+
+
+/*
+ * retry_located_job - send the request for a job to the server it moved to
+ */
+
+static void retry_located_job(
+
+  job_pipeline *jp,
+  char         *job_id)
+
+  {
+  char rmt_server[MAXSERVERNAME];
+  int  connect;
+  int  tag;
+  int  rc;
+
+  if (locate_job(job_id, jp->jp_server, rmt_server) != TRUE)
+    {
+    prt_job_err(jp->jp_cmd, jp->jp_connect, job_id);
+
+    return;
+    }
+
+  if ((connect = cnt2server(rmt_server)) <= 0)
+    {
+    jp->jp_status = -1 * connect;
+
+    fprintf(stderr, "%s: cannot connect to server %s (errno=%d) %s\n",
+      jp->jp_cmd,
+      rmt_server,
+      jp->jp_status,
+      pbs_strerror(jp->jp_status));
+
+    return;
+    }
+
+  if ((rc = jp->jp_put(connect, job_id, jp->jp_arg, &tag)) == PBSE_NONE)
+    rc = pbs_get_reply(connect, &tag);
+
+  if (rc != PBSE_NONE)
+    prt_job_err(jp->jp_cmd, connect, job_id);
+
+  jp->jp_status = rc;
+
+  pbs_disconnect(connect);
+  }  /* END retry_located_job() */
+
+
+
+
+/*
+ * collect_reply - handle the reply to the oldest request in flight
+ */
+
+static void collect_reply(
+
+  job_pipeline *jp)
+
+  {
+  char *job_id = jp->jp_inflight[jp->jp_head];
+  int   tag;
+  int   rc;
+
+  rc = pbs_get_reply(jp->jp_connect, &tag);
+
+  jp->jp_head = (jp->jp_head + 1) % JOB_PIPELINE_WINDOW;
+  jp->jp_pending--;
+  jp->jp_status = rc;
+
+  if (rc == PBSE_NONE)
+    return;
+
+  if (rc != PBSE_UNKJOBID)
+    prt_job_err(jp->jp_cmd, jp->jp_connect, job_id);
+  else if (jp->jp_locate == TRUE)
+    retry_located_job(jp, job_id);
+  }  /* END collect_reply() */
+
+
+
+
+/*
+ * close_server - collect every outstanding reply and drop the connection
+ */
+
+static void close_server(
+
+  job_pipeline *jp)
+
+  {
+  while (jp->jp_pending > 0)
+    collect_reply(jp);
+
+  if (jp->jp_connect >= 0)
+    pbs_disconnect(jp->jp_connect);
+
+  jp->jp_connect = -1;
+  }  /* END close_server() */
+
+
+
+
+/*
+ * pipeline_jobs - send put's request for each of job_ids
+ *
+ * get_server() resolves each id.  Jobs the server reports unknown are
+ * looked up with locate_job() and retried on their new server when locate
+ * is TRUE, otherwise they are only counted in the exit status.
+ *
+ * Returns the result of the last job, like the one-job-at-a-time loops
+ * this replaces.
+ */
+
+int pipeline_jobs(
+
+  char          *cmd,       /* I - command name for messages */
+  int            count,     /* I */
+  char         **job_ids,   /* I */
+  job_put_func   put,       /* I */
+  void          *arg,       /* I - passed to put */
+  int            locate)    /* I */
+
+  {
+  job_pipeline  jp;
+  char          job_id_out[JOB_PIPELINE_WINDOW][PBS_MAXCLTJOBID];
+  char          server_out[MAXSERVERNAME];
+  int           slot;
+  int           tag;
+  int           rc;
+  int           i;
+
+  memset(&jp, 0, sizeof(jp));
+
+  jp.jp_cmd = cmd;
+  jp.jp_put = put;
+  jp.jp_arg = arg;
+  jp.jp_locate = locate;
+  jp.jp_connect = -1;
+
+  for (i = 0; i < count; i++)
+    {
+    if (jp.jp_pending == JOB_PIPELINE_WINDOW)
+      collect_reply(&jp);
+
+    /* the slot after the last request in flight is free */
+    slot = (jp.jp_head + jp.jp_pending) % JOB_PIPELINE_WINDOW;
+
+    if (get_server(job_ids[i], job_id_out[slot], PBS_MAXCLTJOBID, server_out, sizeof(server_out)))
+      {
+      close_server(&jp);
+
+      fprintf(stderr, "%s: illegally formed job identifier: %s\n",
+        cmd,
+        job_ids[i]);
+
+      jp.jp_status = 1;
+
+      continue;
+      }
+
+    if ((jp.jp_connect >= 0) &&
+        (strcmp(server_out, jp.jp_server) != 0))
+      close_server(&jp);
+
+    if (jp.jp_connect < 0)
+      {
+      if ((jp.jp_connect = cnt2server(server_out)) <= 0)
+        {
+        jp.jp_status = -1 * jp.jp_connect;
+        jp.jp_connect = -1;
+
+        fprintf(stderr, "%s: cannot connect to server %s (errno=%d) %s\n",
+          cmd,
+          (server_out[0] != '\0') ? server_out : pbs_server,
+          jp.jp_status,
+          pbs_strerror(jp.jp_status));
+
+        continue;
+        }
+
+      snprintf(jp.jp_server, sizeof(jp.jp_server), "%s", server_out);
+      }
+
+    if ((rc = put(jp.jp_connect, job_id_out[slot], arg, &tag)) != PBSE_NONE)
+      {
+      /* the connection is no good, report this job and start over */
+      close_server(&jp);
+
+      fprintf(stderr, "%s: %s %s\n", cmd, pbs_strerror(rc), job_id_out[slot]);
+
+      jp.jp_status = rc;
+
+      continue;
+      }
+
+    jp.jp_inflight[slot] = job_id_out[slot];
+    jp.jp_pending++;
+    }
+
+  close_server(&jp);
+
+  return(jp.jp_status);
+  }  /* END pipeline_jobs() */
+
+/* END pipeline_jobs.c */
@@ -0,0 +1,88 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pbs_error.h"
+
+char *pbs_server = NULL;
+
+/* set and inspected by the tests */
+int connects = 0;
+int outstanding = 0;
+int max_outstanding = 0;
+int errors_printed = 0;
+int unknown_job = -1;    /* tag answered with PBSE_UNKJOBID */
+int located = 0;
+int next_tag = 0;
+int next_reply = 0;
+
+int get_server(char *job_id_in, char *job_id_out, int jobid_size, char *server_out, int server_size)
+  {
+  char *at;
+
+  if (*job_id_in == '\0')
+    return(1);
+
+  snprintf(job_id_out, jobid_size, "%s", job_id_in);
+
+  if ((at = strchr(job_id_out, '@')) != NULL)
+    {
+    *at = '\0';
+    snprintf(server_out, server_size, "%s", at + 1);
+    }
+  else
+    server_out[0] = '\0';
+
+  return(0);
+  }
+
+int cnt2server(char *server)
+  {
+  connects++;
+
+  return(1);
+  }
+
+int pbs_disconnect(int connect)
+  {
+  return(0);
+  }
+
+int locate_job(char *job_id, char *parent_server, char *located_server)
+  {
+  located++;
+  strcpy(located_server, "remote");
+
+  return(1);
+  }
+
+void prt_job_err(char *cmd, int connect, char *id)
+  {
+  errors_printed++;
+  }
+
+char *pbs_strerror(int err)
+  {
+  return((char *)"error");
+  }
+
+int pbs_get_reply(int connect, int *tag)
+  {
+  outstanding--;
+  *tag = next_reply++;
+
+  return((*tag == unknown_job) ? PBSE_UNKJOBID : PBSE_NONE);
+  }
+
+int put_stub(int connect, char *job_id, void *arg, int *tag)
+  {
+  (*(int *)arg)++;
+
+  if (++outstanding > max_outstanding)
+    max_outstanding = outstanding;
+
+  *tag = next_tag++;
+
+  return(PBSE_NONE);
+  }
@@ -0,0 +1,132 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "cmds.h"
+#include "test_pipeline_jobs.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#include "pbs_error.h"
+
+extern int connects;
+extern int outstanding;
+extern int max_outstanding;
+extern int errors_printed;
+extern int unknown_job;
+extern int located;
+extern int next_tag;
+extern int next_reply;
+
+int put_stub(int connect, char *job_id, void *arg, int *tag);
+
+static void reset_stubs(void)
+  {
+  connects = 0;
+  outstanding = 0;
+  max_outstanding = 0;
+  errors_printed = 0;
+  unknown_job = -1;
+  located = 0;
+  next_tag = 0;
+  next_reply = 0;
+  }
+
+START_TEST(test_one_connection_per_server)
+  {
+  char *ids[] = {(char *)"1", (char *)"2", (char *)"3@other", (char *)"4@other", (char *)"5"};
+  int   sent = 0;
+
+  reset_stubs();
+
+  fail_unless(pipeline_jobs((char *)"qdel", 5, ids, put_stub, &sent, FALSE) == PBSE_NONE);
+  fail_unless(sent == 5);
+  fail_unless(connects == 3);
+  fail_unless(outstanding == 0);
+  }
+END_TEST
+
+START_TEST(test_window)
+  {
+  char *ids[200];
+  int   sent = 0;
+  int   i;
+
+  reset_stubs();
+
+  for (i = 0; i < 200; i++)
+    ids[i] = (char *)"1";
+
+  fail_unless(pipeline_jobs((char *)"qhold", 200, ids, put_stub, &sent, FALSE) == PBSE_NONE);
+  fail_unless(sent == 200);
+  fail_unless(connects == 1);
+  fail_unless(max_outstanding == JOB_PIPELINE_WINDOW);
+  fail_unless(outstanding == 0);
+  }
+END_TEST
+
+START_TEST(test_unknown_job)
+  {
+  char *ids[] = {(char *)"1", (char *)"2", (char *)"3"};
+  int   sent = 0;
+
+  /* without locate the job only shows up in the exit status */
+  reset_stubs();
+  unknown_job = 2;
+
+  fail_unless(pipeline_jobs((char *)"qrls", 3, ids, put_stub, &sent, FALSE) == PBSE_UNKJOBID);
+  fail_unless(errors_printed == 0);
+  fail_unless(located == 0);
+
+  /* with locate it is retried on the server it moved to */
+  reset_stubs();
+  unknown_job = 1;
+  sent = 0;
+
+  fail_unless(pipeline_jobs((char *)"qsig", 3, ids, put_stub, &sent, TRUE) == PBSE_NONE);
+  fail_unless(located == 1);
+  fail_unless(sent == 4);
+  fail_unless(connects == 2);
+
+  /* a malformed id is reported and the rest still go out */
+  reset_stubs();
+  ids[1] = (char *)"";
+  sent = 0;
+
+  fail_unless(pipeline_jobs((char *)"qdel", 3, ids, put_stub, &sent, FALSE) == PBSE_NONE);
+  fail_unless(sent == 2);
+  }
+END_TEST
+
+Suite *pipeline_jobs_suite(void)
+  {
+  Suite *s = suite_create("pipeline_jobs_suite methods");
+  TCase *tc_core = tcase_create("test_one_connection_per_server");
+  tcase_add_test(tc_core, test_one_connection_per_server);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_window");
+  tcase_add_test(tc_core, test_window);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_unknown_job");
+  tcase_add_test(tc_core, test_unknown_job);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(pipeline_jobs_suite());
+  srunner_set_log(sr, "pipeline_jobs_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
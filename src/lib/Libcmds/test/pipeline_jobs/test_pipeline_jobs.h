@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _PIPELINE_JOBS_CT_H
+#define _PIPELINE_JOBS_CT_H
+#include <check.h>
+
+Suite *pipeline_jobs_suite();
+
+#endif /* _PIPELINE_JOBS_CT_H */
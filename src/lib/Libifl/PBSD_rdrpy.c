@@ -181,6 +181,83 @@ struct batch_reply *PBSD_rdrpy(
 
 
 
+/*
+ * PBSD_rdrpy_stream - read the next reply on the connection's read channel
+ *
+ * Unlike PBSD_rdrpy() the channel is kept in ch_stream for the life of the
+ * connection, so bytes of later replies that arrived with this one stay
+ * buffered for the next call.  Use it whenever more than one reply can be
+ * outstanding.  The caller holds the connection mutex and must free the
+ * reply with PBSD_FreeReply().
+ */
+
+struct batch_reply *PBSD_rdrpy_stream(
+
+  int *local_errno, /* O */
+  int  c)           /* I */
+
+  {
+  int                 rc;
+  struct batch_reply *reply;
+  struct tcp_chan    *chan;
+  const char         *the_msg = NULL;
+
+  if (connection[c].ch_errtxt != NULL)
+    {
+    free(connection[c].ch_errtxt);
+
+    connection[c].ch_errtxt = NULL;
+    }
+
+  if ((chan = (struct tcp_chan *)connection[c].ch_stream) == NULL)
+    {
+    if ((chan = DIS_tcp_setup(connection[c].ch_socket)) == NULL)
+      {
+      connection[c].ch_errno = PBSE_MEM_MALLOC;
+      *local_errno = PBSE_MEM_MALLOC;
+
+      return(NULL);
+      }
+
+    connection[c].ch_stream = chan;
+    }
+
+  if ((reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply))) == NULL)
+    {
+    connection[c].ch_errno = PBSE_SYSTEM;
+    *local_errno = PBSE_SYSTEM;
+
+    return(NULL);
+    }
+
+  if ((rc = decode_DIS_replyCmd(chan, reply)))
+    {
+    free(reply);
+
+    *local_errno = (chan->IsTimeout == TRUE) ? PBSE_TIMEOUT : PBSE_PROTOCOL;
+    connection[c].ch_errno = *local_errno;
+
+    if ((rc >= 0) &&
+        (rc <= DIS_INVALID) &&
+        ((the_msg = dis_emsg[rc]) != NULL))
+      connection[c].ch_errtxt = strdup(the_msg);
+
+    return(NULL);
+    }
+
+  connection[c].ch_errno = reply->brp_code;
+  *local_errno = reply->brp_code;
+
+  if ((reply->brp_choice == BATCH_REPLY_CHOICE_Text) &&
+      ((the_msg = reply->brp_un.brp_txt.brp_str) != NULL))
+    connection[c].ch_errtxt = strdup(the_msg);
+
+  return(reply);
+  }  /* END PBSD_rdrpy_stream() */
+
+
+
+
 
 /*
  * PBS_FreeReply - Free a batch_reply structure allocated in PBS_rdrpy()
@@ -227,6 +227,94 @@ int PBSD_commit_get_sid(
 
 
 
+/* PBSD_submitjob_get_sid()
+
+ Sends the Queue Job attributes, the job script and the commit to a MOM as
+ one Submit Job request.  The single reply is the commit's (with the
+ session id) or the error from whichever step failed.  The script must fit
+ in one SCRIPT_CHUNK_Z buffer.
+*/
+
+int PBSD_submitjob_get_sid(
+
+  int             connect,     /* I */
+  long           *sid,         /* O */
+  char           *jobid,       /* I */
+  char           *destin,      /* I */
+  struct attropl *attrib,      /* I */
+  char           *script_buf,  /* I (may be NULL if script_len is 0) */
+  int             script_len)  /* I */
+
+  {
+  struct batch_reply *reply;
+  int                 rc;
+  int                 sock;
+  int                 local_errno = 0;
+  struct tcp_chan    *chan = NULL;
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  sock = connection[connect].ch_socket;
+  connection[connect].ch_errno = 0;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    return(PBSE_MEM_MALLOC);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubmitJob, pbs_current_user)) ||
+           (rc = encode_DIS_QueueJob(chan, jobid, destin, attrib)) ||
+           (rc = diswui(chan, script_len)) ||
+           (rc = diswcs(chan, (script_buf != NULL) ? script_buf : "", script_len)) ||
+           (rc = encode_DIS_ReqExtend(chan, NULL)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    connection[connect].ch_errtxt = strdup(dis_emsg[rc]);
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+    DIS_tcp_cleanup(chan);
+    return(PBSE_PROTOCOL);
+    }
+
+  if (DIS_tcp_wflush(chan))
+    {
+    DIS_tcp_cleanup(chan);
+    return(PBSE_PROTOCOL);
+    }
+
+  DIS_tcp_cleanup(chan);
+
+  /* PBSD_rdrpy sets connection[connect].ch_errno */
+  reply = PBSD_rdrpy(&local_errno, connect);
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  rc = connection[connect].ch_errno;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if (reply == NULL)
+    {
+    /* couldn't read a response */
+    if (rc == PBSE_NONE)
+      rc = PBSE_PROTOCOL;
+    }
+  else
+    {
+    if ((rc == PBSE_NONE) &&
+        (sid != NULL))
+      {
+      if (reply->brp_choice == BATCH_REPLY_CHOICE_Text)
+        *sid = atol(reply->brp_un.brp_txt.brp_str);
+      else
+        *sid = reply->brp_code;
+      }
+
+    PBSD_FreeReply(reply);
+    }
+
+  return(rc);
+  } /* END PBSD_submitjob_get_sid() */
+
+
+
+
 
 /* PBS_commit.c
 
@@ -651,4 +739,157 @@ int PBSD_QueueJob_hash(
   return rc;
   }  /* END PBSD_queuejob() */
 
+
+
+
+/* PBSD_SubmitJob_put()
+
+ Encode one Submit Job request onto chan without flushing it, so callers
+ can send several requests before reading any replies.
+*/
+
+int PBSD_SubmitJob_put(
+
+  struct tcp_chan *chan,        /* I */
+  char            *destin,
+  memmgr         **mm,
+  job_data        *job_attr,
+  job_data        *res_attr,
+  char            *script_buf,  /* I (script contents, may be empty) */
+  int              script_len,  /* I */
+  char            *extend)
+
+  {
+  int rc;
+
+  if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubmitJob, pbs_current_user)) ||
+      (rc = encode_DIS_QueueJob_hash(chan, "", destin, mm, job_attr, res_attr)) ||
+      (rc = diswui(chan, script_len)) ||
+      (rc = diswcs(chan, script_buf, script_len)) ||
+      (rc = encode_DIS_ReqExtend(chan, extend)))
+    {
+    return(rc);
+    }
+
+  return(PBSE_NONE);
+  }  /* END PBSD_SubmitJob_put() */
+
+
+
+
+/* PBSD_SubmitJob_reply()
+
+ Turn the reply to a Submit Job request into a return code plus the new job
+ id or the server's message.  rc is the code the reply was read with.
+*/
+
+int PBSD_SubmitJob_reply(
+
+  struct batch_reply *reply,  /* I (may be NULL) */
+  int                 rc,     /* I */
+  memmgr            **mm,
+  char              **job_id, /* O */
+  char              **msg)    /* O */
+
+  {
+  int tmp_size = 0;
+
+  if (reply == NULL)
+    {
+    if (rc == PBSE_TIMEOUT)
+      rc = PBSE_EXPIRED;
+    }
+  else if (reply->brp_choice == BATCH_REPLY_CHOICE_Text)
+    {
+    *msg = memmgr_strdup(mm, reply->brp_un.brp_txt.brp_str, &tmp_size);
+    }
+  else if (reply->brp_choice &&
+           reply->brp_choice != BATCH_REPLY_CHOICE_Commit)
+    {
+    rc = PBSE_PROTOCOL;
+    }
+  else if (reply->brp_code == 0)
+    {
+    *job_id = memmgr_strdup(mm, reply->brp_un.brp_jid, &tmp_size);
+    }
+
+  return(rc);
+  }  /* END PBSD_SubmitJob_reply() */
+
+
+
+
+/* PBSD_SubmitJob_hash()
+
+ This function sends the Queue Job attributes, the job script and the commit
+ as a single Submit Job request and reads the one reply.  Only used for
+ scripts that fit in one SCRIPT_CHUNK_Z buffer.
+*/
+
+int PBSD_SubmitJob_hash(
+
+  int             connect,     /* I */
+  char           *destin,
+  memmgr        **mm,
+  job_data       *job_attr,
+  job_data       *res_attr,
+  char           *script_buf,  /* I (script contents, may be empty) */
+  int             script_len,  /* I */
+  char           *extend,
+  char          **job_id,
+  char          **msg)
+
+  {
+  struct batch_reply *reply;
+  int                 rc = PBSE_NONE;
+  int                 sock;
+  int                 tmp_size = 0;
+  struct tcp_chan *chan = NULL;
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  sock = connection[connect].ch_socket;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    return(PBSE_PROTOCOL);
+    }
+  else if ((rc = PBSD_SubmitJob_put(chan, destin, mm, job_attr, res_attr,
+                   script_buf, script_len, extend)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if (connection[connect].ch_errtxt == NULL)
+      {
+      if ((rc >= 0) &&
+          (rc <= DIS_INVALID))
+        connection[connect].ch_errtxt = memmgr_strdup(mm, (char *)dis_emsg[rc], &tmp_size);
+      }
+    *msg = memmgr_strdup(mm, connection[connect].ch_errtxt, &tmp_size);
+
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+
+  if ((rc = DIS_tcp_wflush(chan)))
+    {
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+    
+  DIS_tcp_cleanup(chan);
+
+  /* one reply: the commit, or the error from whichever step failed */
+  reply = PBSD_rdrpy(&rc, connect);
+
+  rc = PBSD_SubmitJob_reply(reply, rc, mm, job_id, msg);
+
+  PBSD_FreeReply(reply);
+
+  return(rc);
+  }  /* END PBSD_SubmitJob_hash() */
+
 /* END PBSD_submit.c */
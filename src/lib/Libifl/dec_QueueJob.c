@@ -88,6 +88,7 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <sys/types.h>
+#include <stdlib.h>
 #include "libpbs.h"
 #include "list_link.h"
 #include "server_limits.h"
@@ -128,4 +129,54 @@ int decode_DIS_QueueJob(
 
 
 
+/*
+ * decode_DIS_SubmitJob() - decode a Submit Job Batch Request
+ *
+ * Data items are: the Queue Job items (see above)
+ *   u int size of the job script
+ *   cnt str job script
+ */
+
+int decode_DIS_SubmitJob(
+
+  struct tcp_chan *chan,
+  struct batch_request *preq)
+
+  {
+  int    rc;
+  size_t amt;
+
+  preq->rq_ind.rq_queuejob.rq_script = NULL;
+
+  if ((rc = decode_DIS_QueueJob(chan, preq)) != 0)
+    {
+    return(rc);
+    }
+
+  preq->rq_ind.rq_queuejob.rq_scriptsz = disrui(chan, &rc);
+
+  if (rc != 0)
+    {
+    return(rc);
+    }
+
+  preq->rq_ind.rq_queuejob.rq_script = disrcs(chan, &amt, &rc);
+
+  if (((long)amt != preq->rq_ind.rq_queuejob.rq_scriptsz) && (rc == 0))
+    rc = DIS_EOD;
+
+  if (rc != 0)
+    {
+    if (preq->rq_ind.rq_queuejob.rq_script != NULL)
+      free(preq->rq_ind.rq_queuejob.rq_script);
+
+    preq->rq_ind.rq_queuejob.rq_script = NULL;
+    }
+
+  return(rc);
+  }  /* END decode_DIS_SubmitJob() */
+
+
+
+
 
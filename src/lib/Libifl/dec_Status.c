@@ -90,6 +90,7 @@
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <stdlib.h>
 #include <sys/types.h>
 #include "libpbs.h"
 #include "list_link.h"
@@ -100,6 +101,9 @@
 #include "dis.h"
 #include "tcp.h" /* tcp_chan */
 
+/* upper bound on the job ids in one WatchJobs request */
+#define MAX_WATCH_JOBS 65536
+
 int decode_DIS_Status(
     
   struct tcp_chan *chan,
@@ -121,3 +125,58 @@ int decode_DIS_Status(
   }
 
 
+
+
+/*
+ * decode_DIS_WatchJobs() - decode a Watch Jobs batch request
+ *
+ * Data items are: unsigned int  count
+ *   string  job id (count times)
+ *
+ * rq_count is only advanced once a job id is read so free_br() releases
+ * exactly what was allocated if the decode fails part way.
+ */
+
+int decode_DIS_WatchJobs(
+
+  struct tcp_chan      *chan,
+  struct batch_request *preq)
+
+  {
+  int           rc;
+  int           i;
+  unsigned int  count;
+  char         *job_id;
+
+  preq->rq_ind.rq_watchjobs.rq_count = 0;
+  preq->rq_ind.rq_watchjobs.rq_jobids = NULL;
+
+  count = disrui(chan, &rc);
+
+  if (rc)
+    return(rc);
+
+  if (count > MAX_WATCH_JOBS)
+    return(DIS_PROTO);
+
+  if ((preq->rq_ind.rq_watchjobs.rq_jobids = (char **)calloc(count + 1, sizeof(char *))) == NULL)
+    return(DIS_NOMALLOC);
+
+  for (i = 0; i < (int)count; i++)
+    {
+    job_id = disrst(chan, &rc);
+
+    if (rc)
+      {
+      if (job_id != NULL)
+        free(job_id);
+
+      return(rc);
+      }
+
+    preq->rq_ind.rq_watchjobs.rq_jobids[i] = job_id;
+    preq->rq_ind.rq_watchjobs.rq_count++;
+    }
+
+  return(0);
+  }  /* END decode_DIS_WatchJobs() */
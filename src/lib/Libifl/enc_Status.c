@@ -111,6 +111,38 @@ int encode_DIS_Status(
   }  /* END encode_DIS_Status() */
 
 
+
+
+/*
+ * encode_DIS_WatchJobs() - encode a Watch Jobs Batch Request
+ *
+ * Data items are: unsigned int  count
+ *   string  job id (count times)
+ */
+
+int encode_DIS_WatchJobs(
+
+  struct tcp_chan *chan,
+  int              count,
+  char           **job_ids)
+
+  {
+  int rc;
+  int i;
+
+  if ((rc = diswui(chan, count)) != 0)
+    return(rc);
+
+  for (i = 0; i < count; i++)
+    {
+    if ((rc = diswst(chan, job_ids[i])) != 0)
+      return(rc);
+    }
+
+  return(0);
+  }  /* END encode_DIS_WatchJobs() */
+
+
 /* END enc_Status.c */
 
 
@@ -16,6 +16,11 @@ int build_request_svr(int auth_type, char *user, int sock, char **send_message);
 int parse_response_svr(int sock, char **msg);
 int build_response_client(int code, char *msg, char **send_message);
 int get_trq_server_addr(char *server_name, char **server_addr, int *server_addr_len);
+void prune_svr_conns(time_t now);
+void *svr_conn_reaper(void *arg);
+int get_svr_conn(char *server_name, int server_port, int allow_reuse, int *svr_sock, int *reused, char **error_msg);
+void release_svr_conn(char *server_name, int server_port, int svr_sock, char *user_name);
+int validate_unix_peer(int sock, char *user_name);
 void *process_svr_conn(void *sock);
 
 /* PBSD_gpuctrl2.c */
@@ -32,6 +37,7 @@ int PBSD_msg_put(int c, char *jobid, int fileopt, char *msg, char *extend);
 
 /* PBSD_rdrpy.c */
 struct batch_reply *PBSD_rdrpy(int *, int c); 
+struct batch_reply *PBSD_rdrpy_stream(int *, int c);
 void PBSD_FreeReply(struct batch_reply *reply);
 
 /* PBSD_sig2.c */
@@ -98,6 +104,8 @@ int decode_DIS_MessageJob(struct tcp_chan *chan, struct batch_request *preq);
 /* dec_QueueJob.c */
 int decode_DIS_QueueJob(struct tcp_chan *chan, struct batch_request *preq);
 
+int decode_DIS_SubmitJob(struct tcp_chan *chan, struct batch_request *preq);
+
 /* dec_Reg.c */
 int decode_DIS_Register(struct tcp_chan *chan, struct batch_request *preq);
 
@@ -125,6 +133,8 @@ int decode_DIS_SignalJob(struct tcp_chan *chan, struct batch_request *preq);
 /* dec_Status.c */
 int decode_DIS_Status(struct tcp_chan *chan, struct batch_request *preq);
 
+int decode_DIS_WatchJobs(struct tcp_chan *chan, struct batch_request *preq);
+
 /* dec_Track.c */
 int decode_DIS_TrackJob(struct tcp_chan *chan, struct batch_request *preq);
 
@@ -197,6 +207,8 @@ int encode_DIS_SignalJob(struct tcp_chan *chan, char *jobid, char *signal);
 /* enc_Status.c */
 int encode_DIS_Status(struct tcp_chan *chan, char *objid, struct attrl *pattrl);
 
+int encode_DIS_WatchJobs(struct tcp_chan *chan, int count, char **job_ids);
+
 /* enc_Track.c */
 int encode_DIS_TrackJob(struct tcp_chan *chan, struct batch_request *preq);
 
@@ -309,6 +321,14 @@ int pbs_msgjob_err(int c, char *jobid, int fileopt, char *msg, char *extend, int
 int pbs_orderjob(int c, char *job1, char *job2, char *extend);
 int pbs_orderjob_err(int c, char *job1, char *job2, char *extend, int *);
 
+/* pbsD_pipeline.c */
+int pbs_deljob_put(int c, char *jobid, char *extend, int *tag);
+int pbs_sigjob_put(int c, char *jobid, char *signal, char *extend, int *tag);
+int pbs_holdjob_put(int c, char *jobid, char *holdtype, char *extend, int *tag);
+int pbs_rlsjob_put(int c, char *jobid, char *holdtype, char *extend, int *tag);
+int pbs_pipeline_pending(int c);
+int pbs_get_reply(int c, int *tag);
+
 /* pbsD_rerunjo.c */
 int pbs_rerunjob(int c, char *jobid, char *extend);
 int pbs_rerunjob_err(int c, char *jobid, char *extend, int *);
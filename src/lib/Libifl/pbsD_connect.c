@@ -125,6 +125,9 @@
 #include "../Libnet/lib_net.h" /* socket_* */
 #include "../Libifl/lib_ifl.h" /* AUTH_TYPE_IFF, DIS_* */
 #include "pbs_constants.h" /* LOCAL_IP */
+#ifdef HAVE_LIBMUNGE
+#include <munge.h>
+#endif
 
 #define LOCAL_LOG_BUF 1024
 #define CNTRETRYDELAY 5
@@ -373,42 +376,81 @@ char *PBS_get_server(
   }  /* END PBS_get_server() */
 
 
+#ifdef MUNGE_AUTH
 /*
- * PBSD_munge_authenticate - This function will use munge to authenticate 
- * a user connection with the server. 
+ * Munge credentials are reused for MUNGE_CRED_TTL / 2 seconds, so a
+ * command that connects several times, or a daemon that connects often,
+ * only asks munged for a new one now and then.  pbs_server remembers the
+ * credentials it has decoded, munged alone would reject a reused one as
+ * a replay.
  */
-#ifdef MUNGE_AUTH
-int PBSD_munge_authenticate(
 
-  int psock,  /* I */
-  int handle) /* I */
+static pthread_mutex_t  munge_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char             munge_cache_cred[MUNGE_SIZE];
+static uid_t            munge_cache_uid;
+static time_t           munge_cache_expires = 0;
+
+
+
+
+/*
+ * munge_new_cred - ask munged for a credential with a MUNGE_CRED_TTL lifetime
+ *
+ * Linked with libmunge this is a call into the library, otherwise the
+ * munge command is run.
+ */
+
+static int munge_new_cred(
+
+  char   *cred,      /* O */
+  size_t  cred_size) /* I */
 
   {
-  int                 rc = PBSE_NONE;
+#ifdef HAVE_LIBMUNGE
+  munge_ctx_t  ctx;
+  munge_err_t  err;
+  char        *new_cred = NULL;
+
+  if ((ctx = munge_ctx_create()) == NULL)
+    return(PBSE_MEM_MALLOC);
+
+  if ((err = munge_ctx_set(ctx, MUNGE_OPT_TTL, MUNGE_CRED_TTL)) == EMUNGE_SUCCESS)
+    err = munge_encode(&new_cred, ctx, NULL, 0);
+
+  munge_ctx_destroy(ctx);
+
+  if (err != EMUNGE_SUCCESS)
+    {
+    if (getenv("PBSDEBUG"))
+      fprintf(stderr, "ERROR:  munge_encode failed: %s\n", munge_strerror(err));
 
+    if (new_cred != NULL)
+      free(new_cred);
+
+    /* munged is not running */
+    return((err == EMUNGE_SOCKET) ? PBSE_MUNGE_NOT_FOUND : -1);
+    }
+
+  snprintf(cred, cred_size, "%s", new_cred);
+
+  free(new_cred);
+
+  return(PBSE_NONE);
+#else
   int                 fd;
   FILE               *munge_pipe;
-  char                munge_buf[MUNGE_SIZE];
+  char               *ptr; /* pointer to the current place to copy data into cred */
   char                munge_command[MUNGE_SIZE];
-  char               *ptr; /* pointer to the current place to copy data into munge_buf */
   int                 bytes_read;
   int                 total_bytes_read = 0;
   int                 local_errno = 0;
-  
-  /* user id and name stuff */
-  struct passwd      *pwent;
-  uid_t               myrealuid;
-  struct batch_reply *reply;
-  unsigned short      user_port = 0;
-  struct sockaddr_in  sockname;
-  socklen_t           socknamelen = sizeof(sockname);
-  struct tcp_chan *chan = NULL;
 
   snprintf(munge_command,sizeof(munge_command),
-    "munge -n 2>/dev/null");
+    "munge -n -t %d 2>/dev/null",
+    MUNGE_CRED_TTL);
 
-  memset(munge_buf, 0, MUNGE_SIZE);
-  ptr = munge_buf; 
+  memset(cred, 0, cred_size);
+  ptr = cred; 
 
   if ((munge_pipe = popen(munge_command,"r")) == NULL)
     {
@@ -418,7 +460,7 @@ int PBSD_munge_authenticate(
 
   fd = fileno(munge_pipe);
 
-  while ((bytes_read = read(fd, ptr, MUNGE_SIZE - total_bytes_read)) > 0)
+  while ((bytes_read = read(fd, ptr, cred_size - 1 - total_bytes_read)) > 0)
     {
     total_bytes_read += bytes_read;
     ptr += bytes_read;
@@ -440,6 +482,95 @@ int PBSD_munge_authenticate(
     return(PBSE_MUNGE_NOT_FOUND);
     }
 
+  return(PBSE_NONE);
+#endif /* HAVE_LIBMUNGE */
+  } /* END munge_new_cred() */
+
+
+
+
+/*
+ * munge_get_cred - the cached credential if it is still fresh, otherwise a new one
+ */
+
+static int munge_get_cred(
+
+  char   *cred,      /* O */
+  size_t  cred_size) /* I */
+
+  {
+  int    rc = PBSE_NONE;
+  uid_t  myrealuid = getuid();
+  time_t now = time(NULL);
+
+  pthread_mutex_lock(&munge_cache_mutex);
+
+  if ((now >= munge_cache_expires) ||
+      (munge_cache_uid != myrealuid))
+    {
+    munge_cache_expires = 0;
+
+    if ((rc = munge_new_cred(munge_cache_cred, sizeof(munge_cache_cred))) == PBSE_NONE)
+      {
+      munge_cache_uid = myrealuid;
+      munge_cache_expires = now + MUNGE_CRED_TTL / 2;
+      }
+    }
+
+  if (rc == PBSE_NONE)
+    snprintf(cred, cred_size, "%s", munge_cache_cred);
+
+  pthread_mutex_unlock(&munge_cache_mutex);
+
+  return(rc);
+  } /* END munge_get_cred() */
+
+
+
+
+/*
+ * munge_forget_cred - stop reusing the cached credential
+ */
+
+static void munge_forget_cred(void)
+
+  {
+  pthread_mutex_lock(&munge_cache_mutex);
+  munge_cache_expires = 0;
+  pthread_mutex_unlock(&munge_cache_mutex);
+  } /* END munge_forget_cred() */
+
+
+
+
+/*
+ * PBSD_munge_authenticate - This function will use munge to authenticate 
+ * a user connection with the server. 
+ */
+
+int PBSD_munge_authenticate(
+
+  int psock,  /* I */
+  int handle) /* I */
+
+  {
+  int                 rc = PBSE_NONE;
+
+  char                munge_buf[MUNGE_SIZE];
+  int                 local_errno = 0;
+  
+  /* user id and name stuff */
+  struct passwd      *pwent;
+  uid_t               myrealuid;
+  struct batch_reply *reply;
+  unsigned short      user_port = 0;
+  struct sockaddr_in  sockname;
+  socklen_t           socknamelen = sizeof(sockname);
+  struct tcp_chan *chan = NULL;
+
+  if ((rc = munge_get_cred(munge_buf, sizeof(munge_buf))) != PBSE_NONE)
+    return(rc);
+
   /* We got the certificate. Now make the PBS_BATCH_AltAuthenUser request */
   myrealuid = getuid();  
   pwent = getpwuid(myrealuid);
@@ -470,9 +601,18 @@ int PBSD_munge_authenticate(
     {
     /* read the reply */
     if ((reply = PBSD_rdrpy(&local_errno, handle)) != NULL)
-      free(reply);
+      {
+      /* a server that does not remember credentials refuses a reused
+       * one, the retry gets a new credential */
+      if (reply->brp_code != PBSE_NONE)
+        {
+        munge_forget_cred();
+
+        rc = reply->brp_code;
+        }
 
-    rc = PBSE_NONE;
+      free(reply);
+      }
     }
   if (chan != NULL)
     DIS_tcp_cleanup(chan);
@@ -568,14 +708,26 @@ int validate_socket(
      * total_length|val
      */
     write_buf_len = strlen(write_buf);
-    if ((local_socket = socket_get_tcp()) <= 0)
+
+    /* prefer trqauthd's unix domain socket, then fall back to its TCP port */
+    if (socket_connect_unix(&local_socket, TRQAUTHD_SOCK_NAME, &err_msg) != PBSE_NONE)
       {
-      fprintf(stderr, "socket_get_tcp error\n");
-      rc = PBSE_SOCKET_FAULT;
+      free(err_msg);
+      err_msg = NULL;
+
+      if ((local_socket = socket_get_tcp()) <= 0)
+        {
+        fprintf(stderr, "socket_get_tcp error\n");
+        rc = PBSE_SOCKET_FAULT;
+        }
+      else if ((rc = socket_connect(&local_socket, l_server, l_server_len, AUTH_PORT, AF_INET, 0, &err_msg)) != PBSE_NONE)
+        {
+        fprintf(stderr, "socket_connect error (VERIFY THAT trqauthd IS RUNNING)\n");
+        }
       }
-    else if ((rc = socket_connect(&local_socket, l_server, l_server_len, AUTH_PORT, AF_INET, 0, &err_msg)) != PBSE_NONE)
+
+    if (rc != PBSE_NONE)
       {
-      fprintf(stderr, "socket_connect error (VERIFY THAT trqauthd IS RUNNING)\n");
       }
     else if ((rc = socket_write(local_socket, write_buf, write_buf_len)) != write_buf_len)
       {
@@ -816,6 +968,11 @@ int pbs_original_connect(
       connection[out].ch_errno  = 0;
       connection[out].ch_socket = -1;
       connection[out].ch_errtxt = NULL;
+      connection[out].ch_stream = NULL;
+      connection[out].ch_tag_sent = 0;
+      connection[out].ch_tag_done = 0;
+      connection[out].ch_stat_reply = NULL;
+      connection[out].ch_stat_more = FALSE;
 
       break;
       }
@@ -1438,6 +1595,20 @@ int pbs_disconnect(
   if (connection[connect].ch_errtxt != (char *)NULL)
     free(connection[connect].ch_errtxt);
 
+  /* read channel kept by PBSD_rdrpy_stream() */
+  if (connection[connect].ch_stream != NULL)
+    {
+    DIS_tcp_cleanup((struct tcp_chan *)connection[connect].ch_stream);
+    connection[connect].ch_stream = NULL;
+    }
+
+  if (connection[connect].ch_stat_reply != NULL)
+    {
+    PBSD_FreeReply((struct batch_reply *)connection[connect].ch_stat_reply);
+    connection[connect].ch_stat_reply = NULL;
+    }
+
+  connection[connect].ch_stat_more = FALSE;
   connection[connect].ch_errno = 0;
   connection[connect].ch_inuse = FALSE;
   pthread_mutex_unlock(connection[connect].ch_mutex);
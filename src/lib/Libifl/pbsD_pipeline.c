@@ -0,0 +1,297 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * Pipelined job requests.  The *_put() calls send a Delete, Signal, Hold or
+ * Release Job request without waiting for its reply and hand back a tag;
+ * pbs_get_reply() reads the next reply and names the tag it answers.
+ *
+ * pbs_server does not read the next request on a connection until the last
+ * one has been answered, even when the answer comes later from another
+ * thread (a delete of a job being started is retried a second later), so
+ * replies arrive in the order the requests were sent.  A tag is the
+ * request's sequence number on the connection and replies are matched to
+ * tags in order.  Nothing is added to the request on the wire, which keeps
+ * the extension field free for the options it already carries (delete
+ * delay, purge, array ranges).  Servers older than this guarantee may
+ * answer such deferred requests out of order.
+ *
+ * Replies wait in the socket until they are read, so keep the number of
+ * requests in flight bounded (see pbs_pipeline_pending()) or the server
+ * stalls writing replies while the client stalls writing requests.  Do not
+ * mix blocking calls on a connection that has replies outstanding.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libpbs.h"
+#include "dis.h"
+#include "server_limits.h" /* PBS_NET_MAX_CONNECTIONS */
+#include "lib_ifl.h"
+
+
+
+
+/*
+ * pipeline_put - encode one job request and assign it the next tag
+ *
+ * A signal of NULL sends a Manage request for function, otherwise a Signal
+ * Job request.  The connection mutex is held from the encode until the tag
+ * is taken so concurrent callers cannot reorder tags and requests.
+ */
+
+static int pipeline_put(
+
+  int             c,         /* I */
+  int             function,  /* I */
+  int             command,   /* I */
+  char           *jobid,     /* I */
+  struct attropl *aoplp,     /* I (optional) */
+  char           *signal,    /* I (optional) */
+  char           *extend,    /* I (optional) */
+  int            *tag)       /* O */
+
+  {
+  int              rc;
+  struct tcp_chan *chan;
+
+  if ((c < 0) ||
+      (c >= PBS_NET_MAX_CONNECTIONS) ||
+      (jobid == NULL) ||
+      (*jobid == '\0') ||
+      (tag == NULL))
+    return(PBSE_IVALREQ);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(connection[c].ch_socket)) == NULL)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    return(PBSE_MEM_MALLOC);
+    }
+
+  if (connection[c].ch_errtxt != NULL)
+    {
+    free(connection[c].ch_errtxt);
+
+    connection[c].ch_errtxt = NULL;
+    }
+
+  if (signal != NULL)
+    {
+    if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SignalJob, pbs_current_user)) == 0)
+      rc = encode_DIS_SignalJob(chan, jobid, signal);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, function, pbs_current_user)) == 0)
+    {
+    rc = encode_DIS_Manage(chan, command, MGR_OBJ_JOB, jobid, aoplp);
+    }
+
+  if ((rc == 0) &&
+      ((rc = encode_DIS_ReqExtend(chan, extend)) == 0))
+    rc = DIS_tcp_wflush(chan);
+
+  if (rc != 0)
+    {
+    if ((rc > 0) && (rc <= DIS_INVALID))
+      connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+
+    rc = PBSE_PROTOCOL;
+    connection[c].ch_errno = rc;
+    }
+  else
+    {
+    *tag = connection[c].ch_tag_sent++;
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  DIS_tcp_cleanup(chan);
+
+  return(rc);
+  }  /* END pipeline_put() */
+
+
+
+
+/*
+ * pbs_deljob_put - send a Delete Job request without reading its reply
+ */
+
+int pbs_deljob_put(
+
+  int   c,       /* I */
+  char *jobid,   /* I */
+  char *extend,  /* I (optional) */
+  int  *tag)     /* O */
+
+  {
+  return(pipeline_put(c, PBS_BATCH_DeleteJob, MGR_CMD_DELETE, jobid, NULL, NULL, extend, tag));
+  }  /* END pbs_deljob_put() */
+
+
+
+
+/*
+ * pbs_sigjob_put - send a Signal Job request without reading its reply
+ */
+
+int pbs_sigjob_put(
+
+  int   c,       /* I */
+  char *jobid,   /* I */
+  char *signal,  /* I */
+  char *extend,  /* I (optional) */
+  int  *tag)     /* O */
+
+  {
+  if ((signal == NULL) || (*signal == '\0'))
+    return(PBSE_IVALREQ);
+
+  return(pipeline_put(c, PBS_BATCH_SignalJob, 0, jobid, NULL, signal, extend, tag));
+  }  /* END pbs_sigjob_put() */
+
+
+
+
+/*
+ * hold_put - send a Hold or Release Job request, see pbs_holdjob_err()
+ */
+
+static int hold_put(
+
+  int   c,         /* I */
+  int   function,  /* I */
+  char *jobid,     /* I */
+  char *holdtype,  /* I (optional) */
+  char *extend,    /* I (optional) */
+  int  *tag)       /* O */
+
+  {
+  struct attropl aopl;
+
+  aopl.name = ATTR_h;
+  aopl.resource = NULL;
+
+  if ((holdtype == NULL) || (*holdtype == '\0'))
+    aopl.value = "u";
+  else
+    aopl.value = holdtype;
+
+  aopl.op = SET;
+  aopl.next = NULL;
+
+  return(pipeline_put(c, function, MGR_CMD_SET, jobid, &aopl, NULL, extend, tag));
+  }  /* END hold_put() */
+
+
+
+
+/*
+ * pbs_holdjob_put - send a Hold Job request without reading its reply
+ */
+
+int pbs_holdjob_put(
+
+  int   c,         /* I */
+  char *jobid,     /* I */
+  char *holdtype,  /* I (optional) */
+  char *extend,    /* I (optional) */
+  int  *tag)       /* O */
+
+  {
+  return(hold_put(c, PBS_BATCH_HoldJob, jobid, holdtype, extend, tag));
+  }  /* END pbs_holdjob_put() */
+
+
+
+
+/*
+ * pbs_rlsjob_put - send a Release Job request without reading its reply
+ */
+
+int pbs_rlsjob_put(
+
+  int   c,         /* I */
+  char *jobid,     /* I */
+  char *holdtype,  /* I (optional) */
+  char *extend,    /* I (optional) */
+  int  *tag)       /* O */
+
+  {
+  return(hold_put(c, PBS_BATCH_ReleaseJob, jobid, holdtype, extend, tag));
+  }  /* END pbs_rlsjob_put() */
+
+
+
+
+/*
+ * pbs_pipeline_pending - number of pipelined requests still unanswered
+ */
+
+int pbs_pipeline_pending(
+
+  int c)  /* I */
+
+  {
+  int pending;
+
+  if ((c < 0) || (c >= PBS_NET_MAX_CONNECTIONS))
+    return(0);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+  pending = connection[c].ch_tag_sent - connection[c].ch_tag_done;
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  return(pending);
+  }  /* END pbs_pipeline_pending() */
+
+
+
+
+/*
+ * pbs_get_reply - read the reply to the oldest pipelined request
+ *
+ * *tag is set to the tag the reply answers.  The server's message, if any,
+ * is available from pbs_geterrmsg() until the next call on the connection.
+ *
+ * @return the reply's code, PBSE_IVALREQ if nothing is outstanding, or
+ * PBSE_PROTOCOL/PBSE_TIMEOUT if the reply could not be read.  A read error
+ * still consumes the tag; the connection should be dropped.
+ */
+
+int pbs_get_reply(
+
+  int  c,    /* I */
+  int *tag)  /* O */
+
+  {
+  int                 rc = PBSE_NONE;
+  struct batch_reply *reply;
+
+  if ((c < 0) || (c >= PBS_NET_MAX_CONNECTIONS) || (tag == NULL))
+    return(PBSE_IVALREQ);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if (connection[c].ch_tag_done == connection[c].ch_tag_sent)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    return(PBSE_IVALREQ);
+    }
+
+  *tag = connection[c].ch_tag_done++;
+
+  if ((reply = PBSD_rdrpy_stream(&rc, c)) != NULL)
+    PBSD_FreeReply(reply);
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  return(rc);
+  }  /* END pbs_get_reply() */
+
+
+/* END pbsD_pipeline.c */
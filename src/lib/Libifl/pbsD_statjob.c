@@ -83,7 +83,15 @@
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "libpbs.h"
+#include "dis.h"
+#include "pbs_error.h"
 
 /* NOTE:
 
@@ -129,3 +137,328 @@ struct batch_status *pbs_statjob(
   return(PBSD_status(c, PBS_BATCH_StatusJob, &pbs_errno, id, attrib, extend));
   }  /* END pbs_statjob() */
 
+
+
+
+/*
+ * pbs_statjob_stream - send a Status Job request to be read one job at a time
+ *
+ * The request is pbs_statjob()'s with STATSTREAM added to extend.  When all
+ * jobs at the server are asked for, the server sends them in several
+ * replies as it walks its job list, so neither side holds the whole list.
+ * Read the jobs with pbs_statjob_next() until it returns NULL.  A server
+ * that does not stream answers with one reply, which pbs_statjob_next()
+ * hands out the same way.
+ *
+ * @return PBSE_NONE, or PBSE_IVALREQ if an earlier stream on the
+ * connection has not been read to the end.
+ */
+
+int pbs_statjob_stream(
+
+  int           c,       /* I - connection */
+  char         *id,      /* I - job or queue id (optional) */
+  struct attrl *attrib,  /* I (optional) */
+  char         *extend)  /* I (optional) */
+
+  {
+  int   rc;
+  char *stream_extend;
+  int   busy;
+
+  if (c < 0)
+    return(PBSE_IVALREQ);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+  busy = ((connection[c].ch_stat_more == TRUE) ||
+          (connection[c].ch_stat_reply != NULL));
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  if (busy)
+    return(PBSE_IVALREQ);
+
+  if ((extend == NULL) || (*extend == '\0'))
+    {
+    stream_extend = strdup(STATSTREAM);
+    }
+  else if ((stream_extend = (char *)calloc(1, strlen(extend) + strlen(STATSTREAM) + 2)) != NULL)
+    {
+    /* the server looks for its options anywhere in the extension */
+    sprintf(stream_extend, "%s,%s", extend, STATSTREAM);
+    }
+
+  if (stream_extend == NULL)
+    return(PBSE_SYSTEM);
+
+  if ((rc = PBSD_status_put(c, PBS_BATCH_StatusJob, (id == NULL) ? (char *)"" : id, attrib, stream_extend)) != PBSE_NONE)
+    {
+    rc = PBSE_PROTOCOL;
+    }
+  else
+    {
+    pthread_mutex_lock(connection[c].ch_mutex);
+    connection[c].ch_stat_more = TRUE;
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    }
+
+  free(stream_extend);
+
+  return(rc);
+  }  /* END pbs_statjob_stream() */
+
+
+
+
+/*
+ * pbs_statjob_next - the next job of a pbs_statjob_stream() request
+ *
+ * Returns one batch_status, free it with pbs_statfree().  NULL means the
+ * stream is over: *local_errno is PBSE_NONE after the last job or the
+ * server's error code (the jobs already returned stand).
+ */
+
+struct batch_status *pbs_statjob_next(
+
+  int  c,            /* I - connection */
+  int *local_errno)  /* O */
+
+  {
+  struct batch_reply  *reply;
+  struct brp_cmdstat  *stp;
+  struct batch_status *bsp = NULL;
+
+  *local_errno = PBSE_NONE;
+
+  if (c < 0)
+    {
+    *local_errno = PBSE_IVALREQ;
+
+    return(NULL);
+    }
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  while (bsp == NULL)
+    {
+    reply = (struct batch_reply *)connection[c].ch_stat_reply;
+
+    if ((reply != NULL) &&
+        ((stp = reply->brp_un.brp_statc) != NULL))
+      {
+      if ((bsp = (struct batch_status *)calloc(1, sizeof(struct batch_status))) == NULL)
+        {
+        *local_errno = PBSE_SYSTEM;
+
+        break;
+        }
+
+      reply->brp_un.brp_statc = stp->brp_stlink;
+
+      bsp->name = strdup(stp->brp_objname);
+      bsp->attribs = stp->brp_attrl;
+
+      free(stp);
+
+      break;
+      }
+
+    if (reply != NULL)
+      {
+      PBSD_FreeReply(reply);
+
+      connection[c].ch_stat_reply = NULL;
+      }
+
+    if (connection[c].ch_stat_more == FALSE)
+      break;
+
+    connection[c].ch_stat_more = FALSE;
+
+    if ((reply = PBSD_rdrpy_stream(local_errno, c)) == NULL)
+      break;
+
+    if (reply->brp_code != PBSE_NONE)
+      {
+      *local_errno = reply->brp_code;
+
+      PBSD_FreeReply(reply);
+
+      break;
+      }
+
+    if ((reply->brp_choice != BATCH_REPLY_CHOICE_NULL) &&
+        (reply->brp_choice != BATCH_REPLY_CHOICE_Status))
+      {
+      *local_errno = PBSE_PROTOCOL;
+
+      PBSD_FreeReply(reply);
+
+      break;
+      }
+
+    connection[c].ch_stat_more = (reply->brp_auxcode == STATUS_STREAM_MORE);
+
+    if (reply->brp_choice == BATCH_REPLY_CHOICE_NULL)
+      PBSD_FreeReply(reply);
+    else
+      connection[c].ch_stat_reply = reply;
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  return(bsp);
+  }  /* END pbs_statjob_next() */
+
+
+
+
+/*
+ * pbs_watchjobs - register interest in state changes of a set of jobs
+ *
+ * Once the server acknowledges the request it sends one event per job with
+ * its current state, then one event for every later state change until the
+ * job is purged.  Read the events with pbs_waitjobevent().  The connection
+ * carries only events from then on and should not be used for other
+ * requests.
+ *
+ * @return PBSE_NONE or the server's error code (PBSE_UNKREQ from a server
+ * without watch support).
+ */
+
+int pbs_watchjobs(
+
+  int    c,        /* I - connection */
+  int    count,    /* I - number of entries in job_ids */
+  char **job_ids,  /* I */
+  char  *extend)   /* I */
+
+  {
+  int                 rc = PBSE_NONE;
+  struct tcp_chan    *chan = NULL;
+  struct batch_reply *reply;
+
+  if ((c < 0) || (count <= 0) || (job_ids == NULL))
+    return(PBSE_IVALREQ);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(connection[c].ch_socket)) == NULL)
+    {
+    rc = PBSE_MEM_MALLOC;
+    }
+  else if ((encode_DIS_ReqHdr(chan, PBS_BATCH_WatchJobs, pbs_current_user)) ||
+           (encode_DIS_WatchJobs(chan, count, job_ids)) ||
+           (encode_DIS_ReqExtend(chan, extend)) ||
+           (DIS_tcp_wflush(chan)))
+    {
+    rc = PBSE_PROTOCOL;
+    }
+  else if ((reply = PBSD_rdrpy_stream(&rc, c)) != NULL)
+    {
+    PBSD_FreeReply(reply);
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  if (chan != NULL)
+    DIS_tcp_cleanup(chan);
+
+  return(rc);
+  }  /* END pbs_watchjobs() */
+
+
+
+
+/*
+ * pbs_waitjobevent - wait for the next job event on a watch connection
+ *
+ * timeout is in seconds, a negative timeout waits forever.  On return
+ * *event holds the job's name with its job_state and exit_status
+ * attributes (free it with pbs_statfree()).
+ *
+ * @return PBSE_NONE for a state change, PBSE_UNKJOBID or PBSE_PERM if the
+ * job cannot be watched (*event names the job), PBSE_TIMEOUT if no event
+ * arrived in time, or a connection error.
+ */
+
+int pbs_waitjobevent(
+
+  int                   c,        /* I - connection */
+  int                   timeout,  /* I - seconds, < 0 waits forever */
+  struct batch_status **event)    /* O */
+
+  {
+  int                  rc = PBSE_NONE;
+  struct tcp_chan     *rchan;
+  struct batch_reply  *reply;
+  struct brp_cmdstat  *stp;
+  struct pollfd        pfd;
+
+  *event = NULL;
+
+  if (c < 0)
+    return(PBSE_IVALREQ);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if ((rchan = (struct tcp_chan *)connection[c].ch_stream) == NULL)
+    {
+    rc = PBSE_IVALREQ;
+    }
+  else if (rchan->readbuf.tdis_eod == rchan->readbuf.tdis_leadp)
+    {
+    /* nothing buffered, block on the socket */
+    pfd.fd = connection[c].ch_socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    switch (poll(&pfd, 1, ((timeout < 0) || (timeout > INT_MAX / 1000)) ? -1 : timeout * 1000))
+      {
+      case 0:
+
+        rc = PBSE_TIMEOUT;
+
+        break;
+
+      case -1:
+
+        /* interrupted, let the caller check its deadline again */
+        rc = (errno == EINTR) ? PBSE_TIMEOUT : PBSE_SYSTEM;
+
+        break;
+
+      default:
+
+        break;
+      }
+    }
+
+  if (rc == PBSE_NONE)
+    {
+    if ((reply = PBSD_rdrpy_stream(&rc, c)) != NULL)
+      {
+      if ((reply->brp_choice != BATCH_REPLY_CHOICE_Status) ||
+          ((stp = reply->brp_un.brp_statc) == NULL))
+        {
+        if (rc == PBSE_NONE)
+          rc = PBSE_PROTOCOL;
+        }
+      else if ((*event = (struct batch_status *)calloc(1, sizeof(struct batch_status))) == NULL)
+        {
+        rc = PBSE_SYSTEM;
+        }
+      else
+        {
+        (*event)->name = strdup(stp->brp_objname);
+        (*event)->attribs = stp->brp_attrl;
+        stp->brp_attrl = NULL;
+        }
+
+      PBSD_FreeReply(reply);
+      }
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  return(rc);
+  }  /* END pbs_waitjobevent() */
@@ -94,6 +94,9 @@
 #include <unistd.h>
 #include "libpbs.h"
 #include "u_hash_map_structs.h"
+#include "dis.h"
+
+#define SUBMIT_MANY_WINDOW 32 /* Submit Job requests in flight per connection */
 
 int pbs_submit_hash(
 
@@ -183,4 +186,245 @@ int pbs_submit_hash(
   }  /* END pbs_submit() */
 
 
+
+
+/*
+ * read_submit_script - read a job script for a Submit Job request
+ *
+ * buf must hold SCRIPT_CHUNK_Z + 1 bytes.  One byte past the chunk size is
+ * read so callers can spot scripts that do not fit in a single request.
+ */
+
+static int read_submit_script(
+
+  char *script,  /* I (may be NULL) */
+  char *buf,     /* O */
+  int  *len)     /* O */
+
+  {
+  int cc = 0;
+  int fd;
+
+  *len = 0;
+
+  if ((script == NULL) || (*script == '\0'))
+    return(PBSE_NONE);
+
+  if ((fd = open(script, O_RDONLY, 0)) < 0)
+    return(PBSE_BADSCRIPT);
+
+  while ((*len <= SCRIPT_CHUNK_Z) &&
+         ((cc = read(fd, buf + *len, SCRIPT_CHUNK_Z + 1 - *len)) > 0))
+    *len += cc;
+
+  close(fd);
+
+  if (cc < 0)
+    return(PBSE_BADSCRIPT);
+
+  return(PBSE_NONE);
+  }  /* END read_submit_script() */
+
+
+
+
+/*
+ * pbs_submit_compound_hash - submit a job with a single Submit Job request
+ *
+ * Sends the attributes, the script and the commit in one message, which
+ * saves three round trips per job.  Servers that predate the request do not
+ * understand it, so callers opt in.  Scripts larger than SCRIPT_CHUNK_Z go
+ * through pbs_submit_hash().
+ */
+
+int pbs_submit_compound_hash(
+
+  int             socket,
+  memmgr        **mm,
+  job_data       *job_attr,
+  job_data       *res_attr,
+  char           *script,
+  char           *destination,
+  char           *extend,  /* (optional) */
+  char          **return_jobid,
+  char          **msg)
+
+  {
+  char  s_buf[SCRIPT_CHUNK_Z + 1];
+  int   len = 0;
+  int   rc;
+
+  if ((rc = read_submit_script(script, s_buf, &len)) != PBSE_NONE)
+    return(rc);
+
+  if (len > SCRIPT_CHUNK_Z)
+    {
+    return(pbs_submit_hash(socket, mm, job_attr, res_attr, script,
+             destination, extend, return_jobid, msg));
+    }
+
+  return(PBSD_SubmitJob_hash(socket, destination, mm, job_attr, res_attr,
+           s_buf, len, extend, return_jobid, msg));
+  }  /* END pbs_submit_compound_hash() */
+
+
+
+
+/*
+ * pbs_submit_many - submit a list of jobs over one connection
+ *
+ * Up to SUBMIT_MANY_WINDOW Submit Job requests are sent before the first
+ * reply is read, and each job's result is stored in its submit_spec.  Jobs
+ * whose script is larger than SCRIPT_CHUNK_Z are submitted with
+ * pbs_submit_hash() once the requests in flight have been answered.
+ *
+ * A server that predates the request answers PBSE_UNKREQ, and may close
+ * the connection; callers that see it fall back to pbs_submit_hash() on a
+ * new connection.
+ *
+ * Returns PBSE_NONE unless the connection failed, in which case every job
+ * without an answer carries that error.
+ */
+
+int pbs_submit_many(
+
+  int                  socket,
+  memmgr             **mm,
+  int                  count,
+  struct submit_spec  *jobs,     /* I/O */
+  char                *extend)   /* (optional) */
+
+  {
+  struct tcp_chan    *wchan = NULL;
+  struct tcp_chan    *rchan = NULL;
+  struct batch_reply *reply;
+  struct submit_spec *js;
+  char               *s_buf;
+  int                 inflight[SUBMIT_MANY_WINDOW];
+  int                 head = 0;      /* oldest request awaiting its reply */
+  int                 pending = 0;
+  int                 next = 0;      /* next job to send */
+  int                 draining = FALSE;
+  int                 len;
+  int                 sock;
+  int                 rc = PBSE_NONE;
+  int                 i;
+
+  for (i = 0; i < count; i++)
+    {
+    jobs[i].rc = PBSE_NONE;
+    jobs[i].job_id = NULL;
+    jobs[i].msg = NULL;
+    }
+
+  pthread_mutex_lock(connection[socket].ch_mutex);
+  sock = connection[socket].ch_socket;
+  pthread_mutex_unlock(connection[socket].ch_mutex);
+
+  /* replies share one read channel so none are lost between reads */
+  if ((s_buf = (char *)malloc(SCRIPT_CHUNK_Z + 1)) == NULL)
+    rc = PBSE_SYSTEM;
+  else if (((wchan = DIS_tcp_setup(sock)) == NULL) ||
+           ((rchan = DIS_tcp_setup(sock)) == NULL))
+    rc = PBSE_PROTOCOL;
+
+  while ((rc == PBSE_NONE) &&
+         ((next < count) || (pending > 0)))
+    {
+    if ((next < count) &&
+        (pending < SUBMIT_MANY_WINDOW) &&
+        (draining == FALSE))
+      {
+      js = &jobs[next];
+
+      if ((js->rc = read_submit_script(js->script, s_buf, &len)) != PBSE_NONE)
+        {
+        next++;
+
+        continue;
+        }
+
+      if (len <= SCRIPT_CHUNK_Z)
+        {
+        if ((rc = PBSD_SubmitJob_put(wchan, js->destination, mm, js->job_attr,
+                    js->res_attr, s_buf, len, extend)) ||
+            (rc = DIS_tcp_wflush(wchan)))
+          {
+          rc = PBSE_PROTOCOL;
+
+          break;
+          }
+
+        inflight[(head + pending) % SUBMIT_MANY_WINDOW] = next++;
+        pending++;
+
+        continue;
+        }
+
+      if (pending == 0)
+        {
+        js->rc = pbs_submit_hash(socket, mm, js->job_attr, js->res_attr,
+                   js->script, js->destination, extend, &js->job_id, &js->msg);
+        next++;
+
+        continue;
+        }
+
+      draining = TRUE;
+      }
+
+    if (pending == 0)
+      {
+      draining = FALSE;
+
+      continue;
+      }
+
+    /* collect the reply to the oldest request in flight */
+    if ((reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply))) == NULL)
+      {
+      rc = PBSE_SYSTEM;
+
+      break;
+      }
+
+    if (decode_DIS_replyCmd(rchan, reply))
+      {
+      rc = (rchan->IsTimeout == TRUE) ? PBSE_EXPIRED : PBSE_PROTOCOL;
+
+      free(reply);
+
+      break;
+      }
+
+    js = &jobs[inflight[head]];
+    js->rc = PBSD_SubmitJob_reply(reply, reply->brp_code, mm, &js->job_id, &js->msg);
+
+    PBSD_FreeReply(reply);
+
+    head = (head + 1) % SUBMIT_MANY_WINDOW;
+    pending--;
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    for (i = 0; i < pending; i++)
+      jobs[inflight[(head + i) % SUBMIT_MANY_WINDOW]].rc = rc;
+
+    for (i = next; i < count; i++)
+      jobs[i].rc = rc;
+    }
+
+  if (wchan != NULL)
+    DIS_tcp_cleanup(wchan);
+
+  if (rchan != NULL)
+    DIS_tcp_cleanup(rchan);
+
+  free(s_buf);
+
+  return(rc);
+  }  /* END pbs_submit_many() */
+
+
 /* END pbsD_submit.c */
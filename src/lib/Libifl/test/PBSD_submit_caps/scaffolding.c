@@ -88,3 +88,15 @@ int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user)
 void DIS_tcp_cleanup(struct tcp_chan *chan)
   {
   }
+
+int diswui(struct tcp_chan *chan, unsigned value)
+  {
+  fprintf(stderr, "The call to diswui needs to be mocked!!\n");
+  exit(1);
+  }
+
+int diswcs(struct tcp_chan *chan, const char *value, size_t nchars)
+  {
+  fprintf(stderr, "The call to diswcs needs to be mocked!!\n");
+  exit(1);
+  }
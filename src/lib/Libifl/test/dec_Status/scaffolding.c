@@ -17,3 +17,15 @@ int disrfst(int stream, size_t achars, char *value)
   exit(1);
   }
 
+unsigned disrui(struct tcp_chan *chan, int *retval)
+  {
+  fprintf(stderr, "The call to disrui needs to be mocked!!\n");
+  exit(1);
+  }
+
+char *disrst(struct tcp_chan *chan, int *retval)
+  {
+  fprintf(stderr, "The call to disrst needs to be mocked!!\n");
+  exit(1);
+  }
+
@@ -15,3 +15,9 @@ int diswcs(int stream, const char *value, size_t nchars)
  fprintf(stderr, "The call to diswcs needs to be mocked!!\n");
  exit(1);
  }
+
+int diswui(struct tcp_chan *chan, unsigned value)
+ {
+ fprintf(stderr, "The call to diswui needs to be mocked!!\n");
+ exit(1);
+ }
@@ -80,6 +80,12 @@ int socket_connect(int *local_socket, char *dest_addr, int dest_addr_len, int de
   exit(1);
   }
 
+int socket_connect_unix(int *local_socket, const char *sock_name, char **error_msg)
+  {
+  fprintf(stderr, "The call to socket_connect_unix needs to be mocked!!\n");
+  exit(1);
+  }
+
 int socket_write(int socket, char *data, int data_len)
   {
   fprintf(stderr, "The call to socket_write needs to be mocked!!\n");
@@ -114,3 +120,9 @@ int socket_close(int sock)
   {
   return(0);
   }
+
+void PBSD_FreeReply(struct batch_reply *reply)
+  {
+  fprintf(stderr, "The call to PBSD_FreeReply needs to be mocked!!\n");
+  exit(1);
+  }
@@ -0,0 +1,67 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h> /* fprintf */
+#include <string.h>
+
+#include "libpbs.h" /* connect_handle, batch_reply */
+#include "dis.h"
+
+struct connect_handle connection[10];
+char pbs_current_user[PBS_MAXUSER];
+const char *dis_emsg[] = {"No error", "Input value too large", NULL};
+
+/* set by the tests */
+int reply_code = 0;
+int encode_rc = 0;
+int last_request = -1;
+
+static struct tcp_chan chan_stub;
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+  {
+  return(&chan_stub);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan) {}
+
+int DIS_tcp_wflush(struct tcp_chan *chan)
+  {
+  return(0);
+  }
+
+int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user)
+  {
+  last_request = reqt;
+
+  return(encode_rc);
+  }
+
+int encode_DIS_Manage(struct tcp_chan *chan, int command, int objtype, char *objname, struct attropl *aoplp)
+  {
+  return(0);
+  }
+
+int encode_DIS_SignalJob(struct tcp_chan *chan, char *jobid, char *signal)
+  {
+  return(0);
+  }
+
+int encode_DIS_ReqExtend(struct tcp_chan *chan, char *extend)
+  {
+  return(0);
+  }
+
+struct batch_reply *PBSD_rdrpy_stream(int *local_errno, int c)
+  {
+  struct batch_reply *reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply));
+
+  reply->brp_code = reply_code;
+  *local_errno = reply_code;
+
+  return(reply);
+  }
+
+void PBSD_FreeReply(struct batch_reply *reply)
+  {
+  free(reply);
+  }
@@ -0,0 +1,116 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "lib_ifl.h"
+#include "test_pbsD_pipeline.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "libpbs.h"
+#include "pbs_error.h"
+
+extern int reply_code;
+extern int encode_rc;
+extern int last_request;
+
+static void setup_connection(
+
+  int c)
+
+  {
+  memset(&connection[c], 0, sizeof(connection[c]));
+  connection[c].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(connection[c].ch_mutex, NULL);
+  connection[c].ch_inuse = TRUE;
+  }
+
+START_TEST(test_tags_in_order)
+  {
+  int tag = -1;
+
+  setup_connection(1);
+  encode_rc = 0;
+
+  fail_unless(pbs_get_reply(1, &tag) == PBSE_IVALREQ);
+
+  fail_unless(pbs_deljob_put(1, (char *)"1.napali", NULL, &tag) == PBSE_NONE);
+  fail_unless(tag == 0);
+  fail_unless(last_request == PBS_BATCH_DeleteJob);
+
+  fail_unless(pbs_sigjob_put(1, (char *)"2.napali", (char *)"SIGTERM", NULL, &tag) == PBSE_NONE);
+  fail_unless(tag == 1);
+  fail_unless(last_request == PBS_BATCH_SignalJob);
+
+  fail_unless(pbs_holdjob_put(1, (char *)"3.napali", NULL, NULL, &tag) == PBSE_NONE);
+  fail_unless(last_request == PBS_BATCH_HoldJob);
+
+  fail_unless(pbs_rlsjob_put(1, (char *)"4.napali", (char *)"u", NULL, &tag) == PBSE_NONE);
+  fail_unless(tag == 3);
+  fail_unless(last_request == PBS_BATCH_ReleaseJob);
+
+  fail_unless(pbs_pipeline_pending(1) == 4);
+
+  reply_code = PBSE_NONE;
+  fail_unless(pbs_get_reply(1, &tag) == PBSE_NONE);
+  fail_unless(tag == 0);
+
+  reply_code = PBSE_UNKJOBID;
+  fail_unless(pbs_get_reply(1, &tag) == PBSE_UNKJOBID);
+  fail_unless(tag == 1);
+
+  fail_unless(pbs_pipeline_pending(1) == 2);
+  }
+END_TEST
+
+START_TEST(test_put_errors)
+  {
+  int tag = -1;
+
+  setup_connection(2);
+
+  fail_unless(pbs_deljob_put(2, NULL, NULL, &tag) == PBSE_IVALREQ);
+  fail_unless(pbs_deljob_put(-1, (char *)"1.napali", NULL, &tag) == PBSE_IVALREQ);
+  fail_unless(pbs_sigjob_put(2, (char *)"1.napali", NULL, NULL, &tag) == PBSE_IVALREQ);
+
+  /* a failed encode does not use up a tag */
+  encode_rc = 1;
+  fail_unless(pbs_deljob_put(2, (char *)"1.napali", NULL, &tag) == PBSE_PROTOCOL);
+  fail_unless(pbs_pipeline_pending(2) == 0);
+  fail_unless(connection[2].ch_errtxt != NULL);
+
+  encode_rc = 0;
+  fail_unless(pbs_deljob_put(2, (char *)"1.napali", NULL, &tag) == PBSE_NONE);
+  fail_unless(tag == 0);
+  }
+END_TEST
+
+Suite *pbsD_pipeline_suite(void)
+  {
+  Suite *s = suite_create("pbsD_pipeline_suite methods");
+  TCase *tc_core = tcase_create("test_tags_in_order");
+  tcase_add_test(tc_core, test_tags_in_order);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_put_errors");
+  tcase_add_test(tc_core, test_put_errors);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(pbsD_pipeline_suite());
+  srunner_set_log(sr, "pbsD_pipeline_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _PBSD_PIPELINE_CT_H
+#define _PBSD_PIPELINE_CT_H
+#include <check.h>
+
+Suite *pbsD_pipeline_suite();
+
+#endif /* _PBSD_PIPELINE_CT_H */
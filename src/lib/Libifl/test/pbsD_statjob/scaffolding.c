@@ -3,6 +3,8 @@
 #include <stdio.h> /* fprintf */
 
 #include "attribute.h" /* attrl */
+#include "libpbs.h" /* connect_handle */
+#include "pbs_error.h"
 
 int pbs_errno = 0;
 
@@ -11,3 +13,84 @@ struct batch_status *PBSD_status(int c, int function, int *local_errno, char *id
  fprintf(stderr, "The call to PBSD_manager needs to be mocked!!\n");
  exit(1);
  }
+
+struct connect_handle connection[10];
+char pbs_current_user[PBS_MAXUSER];
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+ {
+ fprintf(stderr, "The call to DIS_tcp_setup needs to be mocked!!\n");
+ exit(1);
+ }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+ {
+ fprintf(stderr, "The call to DIS_tcp_cleanup needs to be mocked!!\n");
+ exit(1);
+ }
+
+int DIS_tcp_wflush(struct tcp_chan *chan)
+ {
+ fprintf(stderr, "The call to DIS_tcp_wflush needs to be mocked!!\n");
+ exit(1);
+ }
+
+int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user)
+ {
+ fprintf(stderr, "The call to encode_DIS_ReqHdr needs to be mocked!!\n");
+ exit(1);
+ }
+
+int encode_DIS_WatchJobs(struct tcp_chan *chan, int count, char **job_ids)
+ {
+ fprintf(stderr, "The call to encode_DIS_WatchJobs needs to be mocked!!\n");
+ exit(1);
+ }
+
+int encode_DIS_ReqExtend(struct tcp_chan *chan, char *extend)
+ {
+ fprintf(stderr, "The call to encode_DIS_ReqExtend needs to be mocked!!\n");
+ exit(1);
+ }
+
+/* replies handed out by PBSD_rdrpy_stream(), in order */
+struct batch_reply *scripted_replies[10];
+int                 scripted_count = 0;
+int                 scripted_next = 0;
+char                last_extend[256];
+
+struct batch_reply *PBSD_rdrpy_stream(int *local_errno, int c)
+ {
+ struct batch_reply *reply;
+
+ if (scripted_next >= scripted_count)
+   {
+   *local_errno = PBSE_PROTOCOL;
+   return(NULL);
+   }
+
+ reply = scripted_replies[scripted_next++];
+ *local_errno = reply->brp_code;
+
+ return(reply);
+ }
+
+void PBSD_FreeReply(struct batch_reply *reply)
+ {
+ struct brp_cmdstat *stp;
+
+ while ((stp = reply->brp_un.brp_statc) != NULL)
+   {
+   reply->brp_un.brp_statc = stp->brp_stlink;
+   free(stp);
+   }
+
+ free(reply);
+ }
+
+int PBSD_status_put(int c, int function, char *id, struct attrl *attrib, char *extend)
+ {
+ snprintf(last_extend, sizeof(last_extend), "%s", (extend != NULL) ? extend : "");
+
+ return(0);
+ }
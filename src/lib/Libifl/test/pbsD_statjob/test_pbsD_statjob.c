@@ -5,19 +5,121 @@
 #include <stdio.h>
 
 
+#include <string.h>
+#include <pthread.h>
 #include "pbs_error.h"
 
+extern struct batch_reply *scripted_replies[];
+extern int                 scripted_count;
+extern int                 scripted_next;
+extern char                last_extend[];
+
+/* a status reply listing count jobs named <first>.napali, <first + 1>.napali, ... */
+struct batch_reply *status_reply(
+
+  int code,
+  int more,
+  int first,
+  int count)
+
+  {
+  struct batch_reply *reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply));
+  struct brp_cmdstat *stp;
+  int                 i;
+
+  reply->brp_code = code;
+  reply->brp_auxcode = more ? STATUS_STREAM_MORE : 0;
+  reply->brp_choice = (code == PBSE_NONE) ? BATCH_REPLY_CHOICE_Status : BATCH_REPLY_CHOICE_NULL;
+
+  for (i = count - 1; i >= 0; i--)
+    {
+    stp = (struct brp_cmdstat *)calloc(1, sizeof(struct brp_cmdstat));
+    sprintf(stp->brp_objname, "%d.napali", first + i);
+    stp->brp_stlink = reply->brp_un.brp_statc;
+    reply->brp_un.brp_statc = stp;
+    }
+
+  return(reply);
+  }
+
+void setup_connection()
+  {
+  memset(&connection[0], 0, sizeof(connection[0]));
+  connection[0].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(connection[0].ch_mutex, NULL);
+  connection[0].ch_inuse = TRUE;
+
+  scripted_count = 0;
+  scripted_next = 0;
+  }
+
 START_TEST(test_one)
   {
+  struct batch_status *bsp;
+  int                  rc;
+  int                  i;
+  char                 name[64];
 
+  setup_connection();
 
+  scripted_replies[scripted_count++] = status_reply(PBSE_NONE, TRUE, 1, 2);
+  scripted_replies[scripted_count++] = status_reply(PBSE_NONE, TRUE, 3, 0);
+  scripted_replies[scripted_count++] = status_reply(PBSE_NONE, FALSE, 3, 1);
+
+  fail_unless(pbs_statjob_stream(0, (char *)"", NULL, (char *)"summarize_arrays") == PBSE_NONE);
+  fail_unless(!strcmp(last_extend, "summarize_arrays,stream"));
+
+  /* one stream at a time */
+  fail_unless(pbs_statjob_stream(0, (char *)"", NULL, NULL) == PBSE_IVALREQ);
+
+  for (i = 1; i <= 3; i++)
+    {
+    bsp = pbs_statjob_next(0, &rc);
+
+    fail_unless(bsp != NULL);
+    fail_unless(rc == PBSE_NONE);
+
+    sprintf(name, "%d.napali", i);
+    fail_unless(!strcmp(bsp->name, name));
+
+    free(bsp->name);
+    free(bsp);
+    }
+
+  fail_unless(pbs_statjob_next(0, &rc) == NULL);
+  fail_unless(rc == PBSE_NONE);
+  fail_unless(scripted_next == 3);
+
+  /* the connection is free again */
+  fail_unless(pbs_statjob_stream(0, NULL, NULL, NULL) == PBSE_NONE);
+  fail_unless(!strcmp(last_extend, "stream"));
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  struct batch_status *bsp;
+  int                  rc;
+
+  setup_connection();
+
+  /* the server fails part way through */
+  scripted_replies[scripted_count++] = status_reply(PBSE_NONE, TRUE, 1, 1);
+  scripted_replies[scripted_count++] = status_reply(PBSE_SYSTEM, FALSE, 0, 0);
+
+  fail_unless(pbs_statjob_stream(0, (char *)"", NULL, NULL) == PBSE_NONE);
+
+  bsp = pbs_statjob_next(0, &rc);
+  fail_unless(bsp != NULL);
+  free(bsp->name);
+  free(bsp);
 
+  fail_unless(pbs_statjob_next(0, &rc) == NULL);
+  fail_unless(rc == PBSE_SYSTEM);
 
+  fail_unless(pbs_statjob_next(0, &rc) == NULL);
+  fail_unless(rc == PBSE_NONE);
+  fail_unless(scripted_next == 2);
   }
 END_TEST
 
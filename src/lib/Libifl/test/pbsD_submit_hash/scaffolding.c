@@ -33,9 +33,61 @@ int PBSD_QueueJob_hash(int connect, char *jobid, char *destin, memmgr **mm, job_
  exit(1);
  }
 
+int PBSD_SubmitJob_hash(int c, char *d, memmgr **mm, job_data *ja, job_data *ra, char *sb, int sl, char *ex, char **job_id, char **msg)
+ {
+ fprintf(stderr, "The call to PBSD_SubmitJob_hash needs to be mocked!!\n");
+ exit(1);
+ }
+
 char *memmgr_strdup(memmgr **mgr, char *value, int *size)
  {
  fprintf(stderr, "The call to memmgr_strdup needs to be mocked!!\n");
  exit(1);
  }
 
+
+ssize_t read_nonblocking_socket(int fd, void *buf, ssize_t count)
+ {
+ fprintf(stderr, "The call to read_nonblocking_socket needs to be mocked!!\n");
+ exit(1);
+ }
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+ {
+ return((struct tcp_chan *)calloc(1, sizeof(struct tcp_chan)));
+ }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+ {
+ free(chan);
+ }
+
+int DIS_tcp_wflush(struct tcp_chan *chan)
+ {
+ fprintf(stderr, "The call to DIS_tcp_wflush needs to be mocked!!\n");
+ exit(1);
+ }
+
+int PBSD_SubmitJob_put(struct tcp_chan *chan, char *d, memmgr **mm, job_data *ja, job_data *ra, char *sb, int sl, char *ex)
+ {
+ fprintf(stderr, "The call to PBSD_SubmitJob_put needs to be mocked!!\n");
+ exit(1);
+ }
+
+int PBSD_SubmitJob_reply(struct batch_reply *reply, int rc, memmgr **mm, char **job_id, char **msg)
+ {
+ fprintf(stderr, "The call to PBSD_SubmitJob_reply needs to be mocked!!\n");
+ exit(1);
+ }
+
+int decode_DIS_replyCmd(struct tcp_chan *chan, struct batch_reply *reply)
+ {
+ fprintf(stderr, "The call to decode_DIS_replyCmd needs to be mocked!!\n");
+ exit(1);
+ }
+
+void PBSD_FreeReply(struct batch_reply *reply)
+ {
+ fprintf(stderr, "The call to PBSD_FreeReply needs to be mocked!!\n");
+ exit(1);
+ }
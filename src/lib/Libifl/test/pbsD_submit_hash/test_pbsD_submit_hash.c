@@ -3,10 +3,13 @@
 #include "test_pbsD_submit_hash.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 #include "pbs_error.h"
 
+extern struct connect_handle connection[];
+
 START_TEST(test_one)
   {
 
@@ -21,6 +24,28 @@ START_TEST(test_two)
   }
 END_TEST
 
+START_TEST(test_submit_many_bad_script)
+  {
+  struct submit_spec jobs[2];
+  pthread_mutex_t    mutex;
+
+  pthread_mutex_init(&mutex, NULL);
+  connection[0].ch_mutex = &mutex;
+
+  memset(jobs, 0, sizeof(jobs));
+  jobs[0].script = (char *)"/nonexistent/script.sh";
+  jobs[1].script = (char *)"/nonexistent/other.sh";
+
+  /* unreadable scripts fail per job without touching the connection */
+  fail_unless(pbs_submit_many(0, NULL, 2, jobs, NULL) == PBSE_NONE);
+  fail_unless(jobs[0].rc == PBSE_BADSCRIPT);
+  fail_unless(jobs[1].rc == PBSE_BADSCRIPT);
+  fail_unless(jobs[0].job_id == NULL);
+
+  connection[0].ch_mutex = NULL;
+  }
+END_TEST
+
 Suite *pbsD_submit_hash_suite(void)
   {
   Suite *s = suite_create("pbsD_submit_hash_suite methods");
@@ -32,6 +57,10 @@ Suite *pbsD_submit_hash_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_submit_many_bad_script");
+  tcase_add_test(tc_core, test_submit_many_bad_script);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -3,6 +3,14 @@
 #include "test_trq_auth.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <pwd.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <time.h>
+
+extern int  closed_sock;
+extern char written[];
 
 
 #include "pbs_error.h"
@@ -21,6 +29,46 @@ START_TEST(test_two)
   }
 END_TEST
 
+START_TEST(test_svr_conn_pool)
+  {
+  int   svr_sock = -1;
+  int   reused = FALSE;
+  char *err_msg = NULL;
+
+  release_svr_conn((char *)"napali", 15001, 7, (char *)"dbeer");
+
+  fail_unless(get_svr_conn((char *)"napali", 15001, TRUE, &svr_sock, &reused, &err_msg) == PBSE_NONE);
+  fail_unless(svr_sock == 7);
+  fail_unless(reused == TRUE);
+
+  /* connections idle too long are disconnected from the server, not just closed */
+  release_svr_conn((char *)"napali", 15001, 8, (char *)"dbeer");
+
+  prune_svr_conns(time(NULL));
+  fail_unless(closed_sock == -1);
+
+  prune_svr_conns(time(NULL) + 3600);
+  fail_unless(closed_sock == 8);
+  fail_unless(!strcmp(written, "+2+22+591+5dbeer"));
+  }
+END_TEST
+
+START_TEST(test_validate_unix_peer)
+  {
+  int            socks[2];
+  struct passwd *pwent = getpwuid(getuid());
+
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, socks) == 0);
+  fail_unless(pwent != NULL);
+
+  fail_unless(validate_unix_peer(socks[0], pwent->pw_name) == PBSE_NONE);
+  fail_unless(validate_unix_peer(socks[0], (char *)"no_such_user_here") == PBSE_BADCRED);
+
+  close(socks[0]);
+  close(socks[1]);
+  }
+END_TEST
+
 Suite *trq_auth_suite(void)
   {
   Suite *s = suite_create("trq_auth_suite methods");
@@ -32,6 +80,14 @@ Suite *trq_auth_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_svr_conn_pool");
+  tcase_add_test(tc_core, test_svr_conn_pool);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_validate_unix_peer");
+  tcase_add_test(tc_core, test_validate_unix_peer);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -167,6 +167,17 @@ typedef struct event_info
 
 static event_info *event_hash[EVENT_HASH];
 
+/*
+** What a tm_spawn_multi() event fills in when its reply arrives.
+*/
+struct spawnhold
+  {
+  int         count;
+  tm_node_id *where;
+  tm_task_id *tids;
+  int        *errors;
+  };
+
 /*
 ** Find an event number or return a NULL.
 */
@@ -226,6 +237,11 @@ del_event(event_info *ep)
       free(ep->e_info);
       break;
 
+    case TM_SPAWN_MULTI:
+      free(((struct spawnhold *)ep->e_info)->where);
+      free(ep->e_info);
+      break;
+
     default:
       TM_DBPRT(("del_event: unknown event command %d\n", ep->e_mtype))
       break;
@@ -765,6 +781,61 @@ int tm_nodeinfo(
 
 
 
+/*
+** Send the argv and envp of a spawn request, followed by the empty
+** string that ends the environment.
+*/
+
+static int send_spawn_args(
+
+  struct tcp_chan  *chan,  /* I */
+  int               argc,  /* I */
+  char            **argv,  /* I */
+  char            **envp)  /* I */
+
+  {
+  char *cp;
+  int   i;
+
+  if (diswsi(chan, argc) != DIS_SUCCESS) /* send argc */
+    return(TM_ENOTCONNECTED);
+
+  /* send argv strings across */
+
+  for (i = 0;i < argc;i++)
+    {
+    cp = argv[i];
+
+    if (diswcs(chan, cp, strlen(cp)) != DIS_SUCCESS)
+      return(TM_ENOTCONNECTED);
+    }
+
+  /* send envp strings across */
+
+  if (getenv("PBSDEBUG") != NULL)
+    {
+    if (diswcs(chan, "PBSDEBUG=1", strlen("PBSDEBUG=1")) != DIS_SUCCESS)
+      return(TM_ENOTCONNECTED);
+    }
+
+  if (envp != NULL)
+    {
+    for (i = 0;(cp = envp[i]) != NULL;i++)
+      {
+      if (diswcs(chan, cp, strlen(cp)) != DIS_SUCCESS)
+        return(TM_ENOTCONNECTED);
+      }
+    }
+
+  if (diswcs(chan, "", 0) != DIS_SUCCESS)
+    return(TM_ENOTCONNECTED);
+
+  return(TM_SUCCESS);
+  }  /* END send_spawn_args() */
+
+
+
+
 /*
 ** Starts <argv>[0] with environment <envp> at <where>.
 */
@@ -780,8 +851,6 @@ int tm_spawn(
 
   {
   int rc = TM_SUCCESS;
-  char *cp;
-  int   i;
   struct tcp_chan *chan = NULL;
 
   /* NOTE: init_done is global */
@@ -809,64 +878,120 @@ int tm_spawn(
     goto tm_spawn_cleanup;
     }
 
-  if (diswsi(chan, argc) != DIS_SUCCESS) /* send argc */
+  if ((rc = send_spawn_args(chan, argc, argv, envp)) != TM_SUCCESS)
+    goto tm_spawn_cleanup;
+
+  DIS_tcp_wflush(chan);
+
+  add_event(*event, where, TM_SPAWN, (void *)tid);
+
+tm_spawn_cleanup:
+  if (chan != NULL)
+    DIS_tcp_cleanup(chan);
+  return rc;
+
+  }  /* END tm_spawn() */
+
+
+
+
+/*
+** Starts <argv>[0] with environment <envp> once on each of the <count>
+** nodes in <where>.  Mother superior launches them all and answers with
+** a single event; when it completes <tids>[i] holds the task started on
+** <where>[i], or TM_NULL_TASK with the reason in <errors>[i].
+**
+** Only mother superior's MOM accepts the request, elsewhere the event
+** completes with TM_ENOTIMPLEMENTED and tm_spawn() must be used.
+*/
+
+int tm_spawn_multi(
+
+  int          argc,   /* in  */
+  char       **argv,   /* in  */
+  char       **envp,   /* in  */
+  int          count,  /* in  */
+  tm_node_id  *where,  /* in  */
+  tm_task_id  *tids,   /* out */
+  int         *errors, /* out */
+  tm_event_t  *event)  /* out */
+
+  {
+  int rc = TM_SUCCESS;
+  int i;
+  struct spawnhold *shold;
+  struct tcp_chan  *chan = NULL;
+
+  if (!init_done)
     {
-     rc = TM_ENOTCONNECTED;
-     goto tm_spawn_cleanup;
+    return(TM_BADINIT);
     }
 
-  /* send argv strings across */
-
-  for (i = 0;i < argc;i++)
+  if ((count <= 0) || (where == NULL) || (tids == NULL) || (errors == NULL))
     {
-    cp = argv[i];
+    return(TM_ENOTFOUND);
+    }
 
-    if (diswcs(chan, cp, strlen(cp)) != DIS_SUCCESS)
-      {
-       rc = TM_ENOTCONNECTED;
-       goto tm_spawn_cleanup;
-      }
+  if ((argc <= 0) || (argv == NULL) || (argv[0] == NULL) || (*argv[0] == '\0'))
+    {
+    return(TM_ENOTFOUND);
     }
 
-  /* send envp strings across */
+  *event = new_event();
 
-  if (getenv("PBSDEBUG") != NULL)
+  if (startcom(TM_SPAWN_MULTI, *event, &chan) != DIS_SUCCESS)
     {
-    if (diswcs(chan, "PBSDEBUG=1", strlen("PBSDEBUG=1")) != DIS_SUCCESS)
-      {
-       rc = TM_ENOTCONNECTED;
-       goto tm_spawn_cleanup;
-      }
+    return(TM_ENOTCONNECTED);
     }
 
-  if (envp != NULL)
+  if (diswsi(chan, count) != DIS_SUCCESS) /* send the node list */
     {
-    for (i = 0;(cp = envp[i]) != NULL;i++)
-      {
-      if (diswcs(chan, cp, strlen(cp)) != DIS_SUCCESS)
-        {
-         rc = TM_ENOTCONNECTED;
-         goto tm_spawn_cleanup;
-        }
-      }
+    rc = TM_ENOTCONNECTED;
+    goto tm_spawn_multi_cleanup;
     }
 
-  if (diswcs(chan, "", 0) != DIS_SUCCESS)
+  for (i = 0;i < count;i++)
     {
-     rc = TM_ENOTCONNECTED;
-     goto tm_spawn_cleanup;
+    if (diswsi(chan, where[i]) != DIS_SUCCESS)
+      {
+      rc = TM_ENOTCONNECTED;
+      goto tm_spawn_multi_cleanup;
+      }
     }
 
+  if ((rc = send_spawn_args(chan, argc, argv, envp)) != TM_SUCCESS)
+    goto tm_spawn_multi_cleanup;
+
   DIS_tcp_wflush(chan);
 
-  add_event(*event, where, TM_SPAWN, (void *)tid);
+  shold = (struct spawnhold *)calloc(1, sizeof(struct spawnhold));
 
-tm_spawn_cleanup:
+  assert(shold != NULL);
+
+  shold->where = (tm_node_id *)calloc(count, sizeof(tm_node_id));
+
+  assert(shold->where != NULL);
+
+  memcpy(shold->where, where, count * sizeof(tm_node_id));
+
+  shold->count = count;
+  shold->tids = tids;
+  shold->errors = errors;
+
+  for (i = 0;i < count;i++)
+    {
+    tids[i] = TM_NULL_TASK;
+    errors[i] = TM_ESYSTEM;
+    }
+
+  add_event(*event, TM_ERROR_NODE, TM_SPAWN_MULTI, (void *)shold);
+
+tm_spawn_multi_cleanup:
   if (chan != NULL)
     DIS_tcp_cleanup(chan);
   return rc;
 
-  }  /* END tm_spawn() */
+  }  /* END tm_spawn_multi() */
 
 
 
@@ -1407,6 +1532,8 @@ int tm_poll(
   struct infohold *ihold;
 
   struct reschold *rhold;
+
+  struct spawnhold *shold;
   extern time_t pbs_tcp_timeout;
 
   if (!init_done)
@@ -1671,6 +1798,46 @@ int tm_poll(
       *tidp = new_task(tm_jobid, ep->e_node, tid);
       break;
 
+      /*
+      ** auxiliary info (
+      **  number of nodes int;
+      **  error[0] int;
+      **  taskid[0] int;
+      **  ...
+      **  error[n-1] int;
+      **  taskid[n-1] int;
+      ** )
+      */
+
+    case TM_SPAWN_MULTI:
+      shold = (struct spawnhold *)ep->e_info;
+      num = disrsi(static_chan, &ret);
+
+      if ((ret != DIS_SUCCESS) || (num != shold->count))
+        {
+        TM_DBPRT(("%s: SPAWN_MULTI failed count\n", __func__))
+        goto tm_poll_error;
+        }
+
+      for (i = 0;i < num;i++)
+        {
+        shold->errors[i] = disrsi(static_chan, &ret);
+
+        if (ret == DIS_SUCCESS)
+          tid = disrsi(static_chan, &ret);
+
+        if (ret != DIS_SUCCESS)
+          {
+          TM_DBPRT(("%s: SPAWN_MULTI failed tid %d\n", __func__, i))
+          goto tm_poll_error;
+          }
+
+        if (shold->errors[i] == TM_SUCCESS)
+          shold->tids[i] = new_task(tm_jobid, shold->where[i], tid);
+        }
+
+      break;
+
     case TM_SIGNAL:
       break;
 
@@ -1,13 +1,38 @@
 #include "license_pbs.h" /* See here for the software license */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* struct ucred */
+#endif
 #include "lib_ifl.h"
 
 #include <limits.h> /* LOGIN_NAME_MAX */
 #include <netinet/in.h> /* in_addr_t */
 #include <stdio.h> /* sprintf */
 #include <arpa/inet.h> /* inet_addr */
+#include <pthread.h> /* pthread_mutex_t */
+#include <time.h> /* time */
+#include <pwd.h> /* getpwnam_r */
+#include <sys/socket.h> /* getsockopt, SO_PEERCRED */
 #include "../Libnet/lib_net.h" /* get_hostaddr, socket_* */
 #include "../../include/log.h" /* log event types */
+#include <unistd.h> /* sleep */
 
+/* each idle connection holds a pbs_server thread, so keep few and not long */
+#define TRQ_SVR_POOL_SIZE  4   /* idle connections to pbs_server kept open */
+#define TRQ_SVR_CONN_IDLE  60  /* seconds an idle connection is kept */
+
+/* authenticated connections to pbs_server kept between validations */
+typedef struct trq_svr_conn
+  {
+  char   server_name[PBS_MAXSERVERNAME + 1];
+  int    server_port;
+  int    sock;
+  char   user_name[LOGIN_NAME_MAX + 1]; /* last user validated, for the disconnect */
+  time_t last_used;
+  } trq_svr_conn;
+
+static trq_svr_conn    svr_pool[TRQ_SVR_POOL_SIZE];
+static int             svr_pool_count = 0;
+static pthread_mutex_t svr_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 char *trq_addr = NULL;
 int trq_addr_len;
@@ -224,6 +249,225 @@ void send_svr_disconnect(int sock, char *user_name)
   free(resp_msg);
   }
 
+/*
+ * prune_svr_conns - disconnect from pbs_server on pooled connections that
+ * have been idle too long
+ *
+ * The disconnect messages are sent after the pool is unlocked.
+ */
+
+void prune_svr_conns(
+
+  time_t now)  /* I */
+
+  {
+  trq_svr_conn expired[TRQ_SVR_POOL_SIZE];
+  int          expired_count = 0;
+  int          i;
+
+  pthread_mutex_lock(&svr_pool_mutex);
+
+  for (i = svr_pool_count - 1; i >= 0; i--)
+    {
+    if (now - svr_pool[i].last_used <= TRQ_SVR_CONN_IDLE)
+      continue;
+
+    expired[expired_count++] = svr_pool[i];
+    svr_pool[i] = svr_pool[--svr_pool_count];
+    }
+
+  pthread_mutex_unlock(&svr_pool_mutex);
+
+  for (i = 0; i < expired_count; i++)
+    {
+    send_svr_disconnect(expired[i].sock, expired[i].user_name);
+    socket_close(expired[i].sock);
+    }
+  }  /* END prune_svr_conns() */
+
+
+
+
+/*
+ * svr_conn_reaper - thread that closes idle pooled connections, so they do
+ * not hold pbs_server threads while trqauthd has nothing to validate
+ */
+
+void *svr_conn_reaper(
+
+  void *arg)
+
+  {
+  while (1)
+    {
+    sleep(TRQ_SVR_CONN_IDLE);
+    prune_svr_conns(time(NULL));
+    }
+
+  return(NULL);
+  }  /* END svr_conn_reaper() */
+
+
+
+
+/*
+ * get_svr_conn - get a connection to pbs_server for a validation
+ *
+ * Takes an idle pooled connection to the server if there is one and
+ * allow_reuse is set, otherwise opens a new one from a privileged port.
+ * *reused tells the caller whether the server may have dropped the
+ * connection while it sat in the pool.
+ */
+
+int get_svr_conn(
+
+  char  *server_name,  /* I */
+  int    server_port,  /* I */
+  int    allow_reuse,  /* I */
+  int   *svr_sock,     /* O */
+  int   *reused,       /* O */
+  char **error_msg)    /* O */
+
+  {
+  int    rc = PBSE_NONE;
+  int    i;
+  char  *server_addr = NULL;
+  int    server_addr_len = 0;
+
+  *svr_sock = -1;
+  *reused = FALSE;
+
+  prune_svr_conns(time(NULL));
+
+  pthread_mutex_lock(&svr_pool_mutex);
+
+  for (i = svr_pool_count - 1; (allow_reuse == TRUE) && (i >= 0); i--)
+    {
+    if ((svr_pool[i].server_port != server_port) ||
+        (strcmp(svr_pool[i].server_name, server_name) != 0))
+      continue;
+
+    *svr_sock = svr_pool[i].sock;
+    *reused = TRUE;
+    svr_pool[i] = svr_pool[--svr_pool_count];
+    break;
+    }
+
+  pthread_mutex_unlock(&svr_pool_mutex);
+
+  if (*reused == TRUE)
+    return(PBSE_NONE);
+
+  if ((rc = get_trq_server_addr(server_name, &server_addr, &server_addr_len)) != PBSE_NONE)
+    {
+    }
+  else if ((*svr_sock = socket_get_tcp_priv()) < 0)
+    {
+    rc = PBSE_SOCKET_FAULT;
+    }
+  else if ((rc = socket_connect(svr_sock, server_addr, server_addr_len, server_port, AF_INET, 1, error_msg)) != PBSE_NONE)
+    {
+    if (*svr_sock >= 0)
+      socket_close(*svr_sock);
+    }
+
+  if (rc != PBSE_NONE)
+    *svr_sock = -1;
+
+  if (server_addr != NULL)
+    free(server_addr);
+
+  return(rc);
+  }  /* END get_svr_conn() */
+
+
+
+
+/*
+ * release_svr_conn - return a connection to pbs_server after a validation
+ *
+ * The connection goes back to the pool, or is closed if the pool is full.
+ */
+
+void release_svr_conn(
+
+  char *server_name,  /* I */
+  int   server_port,  /* I */
+  int   svr_sock,     /* I */
+  char *user_name)    /* I */
+
+  {
+  trq_svr_conn *pconn;
+
+  pthread_mutex_lock(&svr_pool_mutex);
+
+  if ((svr_pool_count < TRQ_SVR_POOL_SIZE) &&
+      (strlen(server_name) <= PBS_MAXSERVERNAME) &&
+      (strlen(user_name) <= LOGIN_NAME_MAX))
+    {
+    pconn = &svr_pool[svr_pool_count++];
+
+    strcpy(pconn->server_name, server_name);
+    pconn->server_port = server_port;
+    pconn->sock = svr_sock;
+    strcpy(pconn->user_name, user_name);
+    pconn->last_used = time(NULL);
+
+    pthread_mutex_unlock(&svr_pool_mutex);
+
+    return;
+    }
+
+  pthread_mutex_unlock(&svr_pool_mutex);
+
+  send_svr_disconnect(svr_sock, user_name);
+  socket_close(svr_sock);
+  }  /* END release_svr_conn() */
+
+
+
+
+/*
+ * validate_unix_peer - check the user named in a request on the unix socket
+ *
+ * The kernel tells us who is on the other end of a unix domain socket, so
+ * the user in the request must match it.  Requests over TCP are unchanged.
+ */
+
+int validate_unix_peer(
+
+  int   sock,       /* I */
+  char *user_name)  /* I */
+
+  {
+#ifdef SO_PEERCRED
+  struct sockaddr_storage  addr;
+  socklen_t                addr_len = sizeof(addr);
+  struct ucred             cred;
+  socklen_t                cred_len = sizeof(cred);
+  struct passwd            pwd;
+  struct passwd           *pwent = NULL;
+  char                     pwbuf[4096];
+
+  if ((getsockname(sock, (struct sockaddr *)&addr, &addr_len) != 0) ||
+      (addr.ss_family != AF_UNIX))
+    return(PBSE_NONE);
+
+  if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) != 0)
+    return(PBSE_BADCRED);
+
+  if ((getpwnam_r(user_name, &pwd, pwbuf, sizeof(pwbuf), &pwent) != 0) ||
+      (pwent == NULL) ||
+      (pwent->pw_uid != cred.uid))
+    return(PBSE_BADCRED);
+#endif /* SO_PEERCRED */
+
+  return(PBSE_NONE);
+  }  /* END validate_unix_peer() */
+
+
+
+
 void *process_svr_conn(
     
   void *sock)
@@ -239,10 +483,9 @@ void *process_svr_conn(
   char *error_msg = NULL;
   char *send_message = NULL;
   int   send_len = 0;
-  char *trq_server_addr = NULL;
-  int   trq_server_addr_len = 0;
-  int   disconnect_svr = TRUE;
-  int   svr_sock = 0;
+  int   svr_sock = -1;
+  int   reused = FALSE;
+  int   attempt;
   int   msg_len = 0;
   int   debug_mark = 0;
   int   local_socket = *(int *)sock;
@@ -266,49 +509,70 @@ void *process_svr_conn(
 
   if ((rc = parse_request_client(local_socket, &server_name, &server_port, &auth_type, &user_name, &user_sock)) != PBSE_NONE)
     {
-    disconnect_svr = FALSE;
     debug_mark = 1;
     }
-  else if ((rc = get_trq_server_addr(server_name, &trq_server_addr, &trq_server_addr_len)) != PBSE_NONE)
+  else if ((rc = validate_unix_peer(local_socket, user_name)) != PBSE_NONE)
     {
-    disconnect_svr = FALSE;
     debug_mark = 2;
     }
-  else if ((svr_sock = socket_get_tcp_priv()) < 0)
-    {
-    rc = PBSE_SOCKET_FAULT;
-    disconnect_svr = FALSE;
-    debug_mark = 3;
-    }
-  else if ((rc = socket_connect(&svr_sock, trq_server_addr, trq_server_addr_len, server_port, AF_INET, 1, &error_msg)) != PBSE_NONE)
-    {
-    disconnect_svr = FALSE;
-    debug_mark = 4;
-    socket_close(svr_sock);
-    }
   else if ((rc = build_request_svr(auth_type, user_name, user_sock, &send_message)) != PBSE_NONE)
     {
-    socket_close(svr_sock);
     debug_mark = 5;
     }
   else if ((send_len = ((send_message == NULL)?0:strlen(send_message)) ) <= 0)
     {
-    socket_close(svr_sock);
     rc = PBSE_INTERNAL;
     debug_mark = 6;
     }
-  else if ((rc = socket_write(svr_sock, send_message, send_len)) != send_len)
-    {
-    socket_close(svr_sock);
-    rc = PBSE_SOCKET_WRITE;
-    debug_mark = 7;
-    }
-  else if ((rc = parse_response_svr(svr_sock, &error_msg)) != PBSE_NONE)
+  else
     {
-    socket_close(svr_sock);
-    debug_mark = 8;
+    /* a pooled connection may have been closed by pbs_server, so a failure
+     * on one is retried once on a new connection */
+    for (attempt = 0; attempt < 2; attempt++)
+      {
+      if (error_msg != NULL)
+        {
+        free(error_msg);
+        error_msg = NULL;
+        }
+
+      if ((rc = get_svr_conn(server_name, server_port, (attempt == 0), &svr_sock, &reused, &error_msg)) != PBSE_NONE)
+        {
+        debug_mark = 4;
+        break;
+        }
+
+      if (socket_write(svr_sock, send_message, send_len) != send_len)
+        {
+        rc = PBSE_SOCKET_WRITE;
+        debug_mark = 7;
+        }
+      else if (((rc = parse_response_svr(svr_sock, &error_msg)) == PBSE_NONE) ||
+               ((rc != PBSE_PROTOCOL) && (rc != PBSE_TIMEOUT)))
+        {
+        /* pbs_server answered, so the connection is still good */
+        release_svr_conn(server_name, server_port, svr_sock, user_name);
+        svr_sock = -1;
+
+        if (rc != PBSE_NONE)
+          debug_mark = 8;
+
+        break;
+        }
+      else
+        {
+        debug_mark = 8;
+        }
+
+      socket_close(svr_sock);
+      svr_sock = -1;
+
+      if (reused == FALSE)
+        break;
+      }
     }
-  else
+
+  if (rc == PBSE_NONE)
     {
     /* Success case */
     if (send_message != NULL)
@@ -353,15 +617,6 @@ void *process_svr_conn(
   if(send_message != NULL)
     rc = socket_write(local_socket, send_message, strlen(send_message));
 
-  if (TRUE == disconnect_svr)
-    {
-    send_svr_disconnect(svr_sock, user_name);
-    socket_close(svr_sock);
-    }
-
-  if (trq_server_addr != NULL)
-    free(trq_server_addr);
-
   if (server_name != NULL)
     free(server_name);
 
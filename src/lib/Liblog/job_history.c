@@ -0,0 +1,723 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * job_history.c - the binary job history (see job_history.h)
+ *
+ * record_jobinfo() builds one record per completed job with
+ * jh_record_start() and jh_record_attr() and hands it to jh_write_record(),
+ * which appends it to the day's history file in a single write.  Nothing is
+ * formatted or escaped beyond turning values into strings, and readers
+ * (printjobhistory) map the file and skip from header to header, only
+ * looking at attributes for the records they want.
+ *
+ * Functions included are:
+ * jh_record_start()
+ * jh_record_attr()
+ * jh_write_record()
+ * jh_buf_free()
+ * jh_close()
+ * jh_map()
+ * jh_unmap()
+ * jh_first()
+ * jh_next()
+ * jh_record_id()
+ * jh_record_user()
+ * jh_record_next_attr()
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "pbs_error.h"
+#include "job_history.h"
+
+#define JH_INITIAL_SIZE 4096
+
+static int             jh_fd = -1;        /* the day's history file */
+static int             jh_index_fd = -1;  /* and its index */
+static int             jh_open_day = -1;
+static char            jh_directory[PATH_MAX];
+static off_t           jh_size;           /* where the next record goes */
+static off_t           jh_next_index;     /* index the first record at or past this */
+static pthread_mutex_t jh_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+
+static int jh_append(
+
+  jh_buf     *jb,    /* M */
+  const void *data,  /* I */
+  size_t      len)   /* I */
+
+  {
+  char   *tmp;
+  size_t  size;
+
+  if (jb->jb_used + len > jb->jb_size)
+    {
+    size = (jb->jb_size == 0) ? JH_INITIAL_SIZE : jb->jb_size;
+
+    while (jb->jb_used + len > size)
+      size *= 2;
+
+    if ((tmp = realloc(jb->jb_data, size)) == NULL)
+      return(ENOMEM);
+
+    jb->jb_data = tmp;
+    jb->jb_size = size;
+    }
+
+  memcpy(jb->jb_data + jb->jb_used, data, len);
+  jb->jb_used += len;
+
+  return(PBSE_NONE);
+  }  /* END jh_append() */
+
+
+
+
+static int jh_append_str(
+
+  jh_buf     *jb,   /* M */
+  const char *str)  /* I - may be NULL */
+
+  {
+  if (str == NULL)
+    str = "";
+
+  return(jh_append(jb, str, strlen(str) + 1));
+  }  /* END jh_append_str() */
+
+
+
+
+/*
+ * jh_record_start - begin a record for a job
+ *
+ * jb may be reused from an earlier record, its memory is kept.
+ */
+
+int jh_record_start(
+
+  jh_buf *jb,          /* M */
+  char   *jobid,       /* I */
+  char   *user,        /* I - may be NULL */
+  time_t  qtime,       /* I */
+  time_t  start,       /* I - 0 if the job never ran */
+  time_t  end,         /* I - 0 if it did not complete */
+  int     exit_status) /* I */
+
+  {
+  jh_record jr;
+
+  memset(&jr, 0, sizeof(jr));
+
+  jr.jr_magic = JH_RECORD_MAGIC;
+  jr.jr_qtime = qtime;
+  jr.jr_start = start;
+  jr.jr_end = end;
+  jr.jr_exit = exit_status;
+
+  jb->jb_used = 0;
+
+  if ((jh_append(jb, &jr, sizeof(jr)) != PBSE_NONE) ||
+      (jh_append_str(jb, jobid) != PBSE_NONE) ||
+      (jh_append_str(jb, user) != PBSE_NONE))
+    return(ENOMEM);
+
+  return(PBSE_NONE);
+  }  /* END jh_record_start() */
+
+
+
+
+/*
+ * jh_record_attr - add an attribute to the record
+ *
+ * resc is the resource name for resource list entries, NULL otherwise.
+ */
+
+int jh_record_attr(
+
+  jh_buf     *jb,     /* M */
+  const char *name,   /* I */
+  const char *resc,   /* I - may be NULL */
+  const char *value)  /* I - may be NULL */
+
+  {
+  if ((jb->jb_data == NULL) ||
+      (jb->jb_used < sizeof(jh_record)))
+    return(PBSE_IVALREQ);
+
+  if ((jh_append_str(jb, name) != PBSE_NONE) ||
+      (jh_append_str(jb, resc) != PBSE_NONE) ||
+      (jh_append_str(jb, value) != PBSE_NONE))
+    return(ENOMEM);
+
+  ((jh_record *)jb->jb_data)->jr_attrs++;
+
+  return(PBSE_NONE);
+  }  /* END jh_record_attr() */
+
+
+
+
+void jh_buf_free(
+
+  jh_buf *jb)  /* M */
+
+  {
+  free(jb->jb_data);
+
+  memset(jb, 0, sizeof(jh_buf));
+  }  /* END jh_buf_free() */
+
+
+
+
+static int jh_write_all(
+
+  int         fd,
+  const void *data,
+  size_t      len)
+
+  {
+  const char *ptr = data;
+  ssize_t     rc;
+
+  while (len > 0)
+    {
+    if ((rc = write(fd, ptr, len)) < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      return(-1);
+      }
+
+    ptr += rc;
+    len -= rc;
+    }
+
+  return(PBSE_NONE);
+  }  /* END jh_write_all() */
+
+
+
+
+/* called with jh_mutex held */
+
+static void jh_close_files(void)
+
+  {
+  if (jh_fd >= 0)
+    close(jh_fd);
+
+  if (jh_index_fd >= 0)
+    close(jh_index_fd);
+
+  jh_fd = -1;
+  jh_index_fd = -1;
+  jh_open_day = -1;
+  }  /* END jh_close_files() */
+
+
+
+
+/*
+ * jh_open_files - open today's history and index for append
+ *
+ * A history left with a partial record at the end (the server died in the
+ * middle of a write) is padded out so the next record starts on a record
+ * boundary; readers skip the damaged one.
+ *
+ * called with jh_mutex held
+ */
+
+static int jh_open_files(
+
+  char      *directory,  /* I */
+  struct tm *ptm)        /* I */
+
+  {
+  char           path[PATH_MAX];
+  char           pad[JH_ALIGN];
+  struct stat    sb;
+  jh_index_entry last;
+
+  snprintf(path, sizeof(path), "%s/%04d%02d%02d" JH_SUFFIX,
+    directory,
+    ptm->tm_year + 1900,
+    ptm->tm_mon + 1,
+    ptm->tm_mday);
+
+  if ((jh_fd = open(path, O_CREAT | O_WRONLY | O_APPEND, 0644)) < 0)
+    return(-1);
+
+  if (fstat(jh_fd, &sb) != 0)
+    {
+    jh_close_files();
+
+    return(-1);
+    }
+
+  jh_size = sb.st_size;
+
+  if (jh_size == 0)
+    {
+    if (jh_write_all(jh_fd, JH_FILE_MAGIC, JH_ALIGN) != PBSE_NONE)
+      {
+      jh_close_files();
+
+      return(-1);
+      }
+
+    jh_size = JH_ALIGN;
+    }
+  else if ((jh_size % JH_ALIGN) != 0)
+    {
+    memset(pad, 0, sizeof(pad));
+
+    if (jh_write_all(jh_fd, pad, JH_ALIGN - (jh_size % JH_ALIGN)) != PBSE_NONE)
+      {
+      jh_close_files();
+
+      return(-1);
+      }
+
+    jh_size += JH_ALIGN - (jh_size % JH_ALIGN);
+    }
+
+  strncat(path, JH_INDEX_SUFFIX, sizeof(path) - strlen(path) - 1);
+
+  jh_next_index = 0;
+
+  /* an index is only an aid, carry on without one if it will not open */
+  if ((jh_index_fd = open(path, O_CREAT | O_RDWR | O_APPEND, 0644)) >= 0)
+    {
+    if (fstat(jh_index_fd, &sb) == 0)
+      {
+      /* drop a partial entry so the next one lands on an entry boundary */
+      if ((sb.st_size % sizeof(last)) != 0)
+        {
+        sb.st_size -= sb.st_size % sizeof(last);
+
+        if (ftruncate(jh_index_fd, sb.st_size) != 0)
+          {
+          close(jh_index_fd);
+
+          jh_index_fd = -1;
+          }
+        }
+
+      if ((jh_index_fd >= 0) &&
+          (sb.st_size >= (off_t)sizeof(last)) &&
+          (pread(jh_index_fd, &last, sizeof(last), sb.st_size - sizeof(last)) == sizeof(last)))
+        {
+        jh_next_index = last.ji_offset + JH_INDEX_SPACING;
+        }
+      }
+    }
+
+  snprintf(jh_directory, sizeof(jh_directory), "%s", directory);
+
+  jh_open_day = ptm->tm_yday;
+
+  return(PBSE_NONE);
+  }  /* END jh_open_files() */
+
+
+
+
+/*
+ * jh_write_record - append a finished record to today's history
+ *
+ * Returns PBSE_NONE or -1 with errno set
+ */
+
+int jh_write_record(
+
+  jh_buf *jb,         /* M - the record is completed in place */
+  char   *directory)  /* I - the job log directory */
+
+  {
+  static char     zeros[JH_ALIGN];
+  jh_record      *jr;
+  jh_index_entry  entry;
+  time_t          now = time(NULL);
+  struct tm       tm;
+  off_t           offset;
+  int             rc = PBSE_NONE;
+
+  if ((jb->jb_data == NULL) ||
+      (jb->jb_used < sizeof(jh_record)))
+    {
+    errno = EINVAL;
+
+    return(-1);
+    }
+
+  if ((jb->jb_used % JH_ALIGN) != 0)
+    {
+    if (jh_append(jb, zeros, JH_ALIGN - (jb->jb_used % JH_ALIGN)) != PBSE_NONE)
+      {
+      errno = ENOMEM;
+
+      return(-1);
+      }
+    }
+
+  jr = (jh_record *)jb->jb_data;
+  jr->jr_length = jb->jb_used;
+  jr->jr_time = now;
+
+  localtime_r(&now, &tm);
+
+  pthread_mutex_lock(&jh_mutex);
+
+  if ((jh_fd >= 0) &&
+      ((tm.tm_yday != jh_open_day) ||
+       (strcmp(directory, jh_directory))))
+    jh_close_files();
+
+  if ((jh_fd < 0) &&
+      (jh_open_files(directory, &tm) != PBSE_NONE))
+    {
+    pthread_mutex_unlock(&jh_mutex);
+
+    return(-1);
+    }
+
+  offset = jh_size;
+
+  if (jh_write_all(jh_fd, jb->jb_data, jb->jb_used) != PBSE_NONE)
+    {
+    /* whatever made it out is padded over on the next open */
+    rc = -1;
+
+    jh_close_files();
+    }
+  else
+    {
+    jh_size += jb->jb_used;
+
+    if ((jh_index_fd >= 0) &&
+        (offset >= jh_next_index))
+      {
+      entry.ji_offset = offset;
+      entry.ji_time = now;
+
+      if (jh_write_all(jh_index_fd, &entry, sizeof(entry)) == PBSE_NONE)
+        jh_next_index = offset + JH_INDEX_SPACING;
+      }
+    }
+
+  pthread_mutex_unlock(&jh_mutex);
+
+  return(rc);
+  }  /* END jh_write_record() */
+
+
+
+
+void jh_close(void)
+
+  {
+  pthread_mutex_lock(&jh_mutex);
+
+  jh_close_files();
+
+  pthread_mutex_unlock(&jh_mutex);
+  }  /* END jh_close() */
+
+
+
+
+/*
+ * jh_map - map a history file, and its index if there is one, for reading
+ *
+ * Returns PBSE_NONE, or -1 if path is not a history file
+ */
+
+int jh_map(
+
+  char    *path,  /* I */
+  jh_file *jf)    /* O */
+
+  {
+  char        index_path[PATH_MAX];
+  struct stat sb;
+  int         fd;
+  void       *map;
+
+  memset(jf, 0, sizeof(jh_file));
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return(-1);
+
+  if ((fstat(fd, &sb) != 0) ||
+      (sb.st_size < JH_ALIGN))
+    {
+    close(fd);
+
+    return(-1);
+    }
+
+  map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if (map == MAP_FAILED)
+    return(-1);
+
+  if (memcmp(map, JH_FILE_MAGIC, JH_ALIGN))
+    {
+    munmap(map, sb.st_size);
+
+    return(-1);
+    }
+
+  jf->jf_data = map;
+  jf->jf_size = sb.st_size;
+
+  snprintf(index_path, sizeof(index_path), "%s" JH_INDEX_SUFFIX, path);
+
+  if ((fd = open(index_path, O_RDONLY)) >= 0)
+    {
+    if ((fstat(fd, &sb) == 0) &&
+        (sb.st_size >= (off_t)sizeof(jh_index_entry)))
+      {
+      map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+      if (map != MAP_FAILED)
+        {
+        jf->jf_index = map;
+        jf->jf_index_count = sb.st_size / sizeof(jh_index_entry);
+        }
+      }
+
+    close(fd);
+    }
+
+  return(PBSE_NONE);
+  }  /* END jh_map() */
+
+
+
+
+void jh_unmap(
+
+  jh_file *jf)  /* M */
+
+  {
+  if (jf->jf_data != NULL)
+    munmap(jf->jf_data, jf->jf_size);
+
+  if (jf->jf_index != NULL)
+    munmap(jf->jf_index, jf->jf_index_count * sizeof(jh_index_entry));
+
+  memset(jf, 0, sizeof(jh_file));
+  }  /* END jh_unmap() */
+
+
+
+
+/*
+ * jh_valid - is there a whole record at offset
+ *
+ * The record must end inside the file and with a NUL so walking its
+ * strings cannot run off the end.
+ */
+
+static int jh_valid(
+
+  jh_file *jf,
+  size_t   offset)
+
+  {
+  jh_record *jr;
+
+  if (offset + sizeof(jh_record) > jf->jf_size)
+    return(FALSE);
+
+  jr = (jh_record *)(jf->jf_data + offset);
+
+  if ((jr->jr_magic != JH_RECORD_MAGIC) ||
+      (jr->jr_length < sizeof(jh_record) + 2) ||
+      ((jr->jr_length % JH_ALIGN) != 0) ||
+      (jr->jr_length > jf->jf_size - offset) ||
+      (jf->jf_data[offset + jr->jr_length - 1] != '\0'))
+    return(FALSE);
+
+  return(TRUE);
+  }  /* END jh_valid() */
+
+
+
+
+/*
+ * jh_scan - the first whole record at or after offset
+ *
+ * Damaged records are stepped over a record boundary at a time.
+ */
+
+static jh_record *jh_scan(
+
+  jh_file *jf,
+  size_t   offset)
+
+  {
+  for (;offset + sizeof(jh_record) <= jf->jf_size; offset += JH_ALIGN)
+    {
+    if (jh_valid(jf, offset))
+      return((jh_record *)(jf->jf_data + offset));
+    }
+
+  return(NULL);
+  }  /* END jh_scan() */
+
+
+
+
+/*
+ * jh_first - where to start reading for records written at or after since
+ *
+ * Uses the index to skip the part of the file written before since.  Some
+ * earlier records may still come first, the caller checks jr_time.
+ */
+
+jh_record *jh_first(
+
+  jh_file *jf,     /* I */
+  time_t   since)  /* I - 0 for the whole file */
+
+  {
+  size_t offset = JH_ALIGN;
+  size_t low = 0;
+  size_t high = jf->jf_index_count;
+  size_t mid;
+
+  /* the last index entry written before since */
+  while (low < high)
+    {
+    mid = low + (high - low) / 2;
+
+    if (jf->jf_index[mid].ji_time < since)
+      low = mid + 1;
+    else
+      high = mid;
+    }
+
+  if ((low > 0) &&
+      (jf->jf_index[low - 1].ji_offset >= JH_ALIGN) &&
+      ((size_t)jf->jf_index[low - 1].ji_offset < jf->jf_size) &&
+      ((jf->jf_index[low - 1].ji_offset % JH_ALIGN) == 0))
+    offset = jf->jf_index[low - 1].ji_offset;
+
+  return(jh_scan(jf, offset));
+  }  /* END jh_first() */
+
+
+
+
+jh_record *jh_next(
+
+  jh_file   *jf,  /* I */
+  jh_record *jr)  /* I */
+
+  {
+  return(jh_scan(jf, ((char *)jr - jf->jf_data) + jr->jr_length));
+  }  /* END jh_next() */
+
+
+
+
+char *jh_record_id(
+
+  jh_record *jr)  /* I */
+
+  {
+  return((char *)(jr + 1));
+  }  /* END jh_record_id() */
+
+
+
+
+char *jh_record_user(
+
+  jh_record *jr)  /* I */
+
+  {
+  char *id = jh_record_id(jr);
+
+  return(id + strlen(id) + 1);
+  }  /* END jh_record_user() */
+
+
+
+
+/*
+ * jh_record_next_attr - step through a record's attributes
+ *
+ * *cursor must be NULL on the first call.  resc is an empty string for
+ * attributes that are not resource list entries.
+ *
+ * Returns TRUE while there are attributes
+ */
+
+int jh_record_next_attr(
+
+  jh_record  *jr,      /* I */
+  char      **cursor,  /* M */
+  char      **name,    /* O */
+  char      **resc,    /* O */
+  char      **value)   /* O */
+
+  {
+  char *end = (char *)jr + jr->jr_length;
+  char *ptr = *cursor;
+
+  if (ptr == NULL)
+    {
+    ptr = jh_record_user(jr);
+    ptr += strlen(ptr) + 1;
+    }
+
+  /* past the last attribute there is only padding */
+  if ((ptr >= end) ||
+      (*ptr == '\0'))
+    return(FALSE);
+
+  *name = ptr;
+  ptr += strlen(ptr) + 1;
+
+  if (ptr >= end)
+    return(FALSE);
+
+  *resc = ptr;
+  ptr += strlen(ptr) + 1;
+
+  if (ptr >= end)
+    return(FALSE);
+
+  *value = ptr;
+  ptr += strlen(ptr) + 1;
+
+  *cursor = ptr;
+
+  return(TRUE);
+  }  /* END jh_record_next_attr() */
+
+/* END job_history.c */
@@ -0,0 +1,85 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _JOB_HISTORY_H
+#define _JOB_HISTORY_H
+
+/*
+ * Binary job history - the compact alternative to the XML job log.
+ *
+ * Each day's history is <job log directory>/YYYYMMDD.jh:
+ *
+ *   JH_FILE_MAGIC                      8 bytes
+ *   record, record, ...                each a jh_record header followed by
+ *                                      the job id, the user and then a
+ *                                      name, resource, value triple for
+ *                                      each attribute, all NUL terminated,
+ *                                      padded to a multiple of 8 bytes
+ *
+ * Records are only ever appended, one write() each.  Every JH_INDEX_SPACING
+ * bytes or so a jh_index_entry for the record starting there is appended to
+ * YYYYMMDD.jh.idx so a reader can binary search for a time without walking
+ * the whole day.  Both files are in the server's native byte order.
+ */
+
+#include <stddef.h>    /* size_t */
+#include <stdint.h>
+#include <time.h>      /* time_t */
+
+#define JH_FILE_MAGIC     "TRQJH01\n"
+#define JH_RECORD_MAGIC   0x4a485231 /* "JHR1" */
+#define JH_SUFFIX         ".jh"
+#define JH_INDEX_SUFFIX   ".idx"
+#define JH_INDEX_SPACING  (64 * 1024)
+#define JH_ALIGN          8
+
+typedef struct jh_record
+  {
+  uint32_t jr_magic;     /* JH_RECORD_MAGIC */
+  uint32_t jr_length;    /* bytes in the record, this header and padding included */
+  int64_t  jr_time;      /* when the record was written */
+  int64_t  jr_qtime;     /* when the job was queued */
+  int64_t  jr_start;     /* when the job started, 0 if it never ran */
+  int64_t  jr_end;       /* when the job completed, 0 if it did not */
+  int32_t  jr_exit;      /* exit status */
+  uint32_t jr_attrs;     /* number of attribute triples */
+  } jh_record;
+
+typedef struct jh_index_entry
+  {
+  int64_t ji_offset;     /* of a record in the history file */
+  int64_t ji_time;       /* its jr_time */
+  } jh_index_entry;
+
+/* a record being built */
+typedef struct jh_buf
+  {
+  char   *jb_data;
+  size_t  jb_used;
+  size_t  jb_size;
+  } jh_buf;
+
+/* a mapped history file */
+typedef struct jh_file
+  {
+  char           *jf_data;
+  size_t          jf_size;
+  jh_index_entry *jf_index;
+  size_t          jf_index_count;
+  } jh_file;
+
+/* building and writing */
+int   jh_record_start(jh_buf *jb, char *jobid, char *user, time_t qtime, time_t start, time_t end, int exit_status);
+int   jh_record_attr(jh_buf *jb, const char *name, const char *resc, const char *value);
+int   jh_write_record(jh_buf *jb, char *directory);
+void  jh_buf_free(jh_buf *jb);
+void  jh_close(void);
+
+/* reading */
+int        jh_map(char *path, jh_file *jf);
+void       jh_unmap(jh_file *jf);
+jh_record *jh_first(jh_file *jf, time_t since);
+jh_record *jh_next(jh_file *jf, jh_record *jr);
+char      *jh_record_id(jh_record *jr);
+char      *jh_record_user(jh_record *jr);
+int        jh_record_next_attr(jh_record *jr, char **cursor, char **name, char **resc, char **value);
+
+#endif /* _JOB_HISTORY_H */
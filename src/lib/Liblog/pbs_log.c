@@ -88,6 +88,7 @@
  * log_close()
  * log_roll()
  * log_size()
+ * log_set_index()
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -103,6 +104,7 @@
 #include <time.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -138,6 +140,8 @@ static int      log_open_day;
 static FILE     *logfile;  /* open stream for log file */
 static char     *logpath = NULL;
 static volatile int  log_opened = 0;
+static int      log_index_enabled = 0;
+static FILE     *logindex = NULL; /* open stream for the job index */
 #if SYSLOG
 static int      syslogopen = 0;
 #endif /* SYSLOG */
@@ -175,6 +179,143 @@ static char *class_names[] =
 const char *log_get_severity_string(int);
 
 
+
+/*
+ * The job index is a sidecar file, <logfile>.idx, listing where each job
+ * record landed in the log:
+ *
+ *   #open <offset>
+ *   <job id> <offset> <length>
+ *   ...
+ *
+ * The first #open line gives the offset the index starts covering the log
+ * from; anything before it was written while indexing was off and has to be
+ * scanned.  Every record after that whose object name starts with a digit,
+ * as job ids do, is listed whatever its class (the server logs some job
+ * events under its own class), so tracejob can seek straight to a job's
+ * lines.  Whenever the log is written without the
+ * index (indexing turned off, or a daemon started with it off) the index is
+ * removed instead of being left with holes.
+ *
+ * All of these are called with log_mutex held.
+ */
+
+static void log_index_name(
+
+  char   *path,  /* I - log file path */
+  char   *buf,   /* O */
+  size_t  size)  /* I */
+
+  {
+  snprintf(buf, size, "%s.idx", path);
+  }  /* END log_index_name() */
+
+
+
+
+static void log_index_open(void)
+
+  {
+  char  buf[PATH_MAX];
+  off_t offset;
+
+  if ((logindex != NULL) ||
+      (logpath == NULL) ||
+      (log_opened != 1))
+    return;
+
+  log_index_name(logpath, buf, sizeof(buf));
+
+  if ((logindex = fopen(buf, "a")) == NULL)
+    return;
+
+  setvbuf(logindex, NULL, _IOLBF, 0); /* tracejob may read it at any time */
+
+  fflush(logfile);
+
+  offset = lseek(fileno(logfile), 0, SEEK_END);
+
+  fprintf(logindex, "#open %lld\n", (long long)offset);
+  }  /* END log_index_open() */
+
+
+
+
+static void log_index_close(void)
+
+  {
+  if (logindex != NULL)
+    {
+    fclose(logindex);
+
+    logindex = NULL;
+    }
+  }  /* END log_index_close() */
+
+
+
+
+static void log_index_remove(void)
+
+  {
+  char buf[PATH_MAX];
+
+  log_index_close();
+
+  if (logpath == NULL)
+    return;
+
+  log_index_name(logpath, buf, sizeof(buf));
+
+  unlink(buf);
+  }  /* END log_index_remove() */
+
+
+
+
+/*
+ * log_set_index - turn the job index for the log file on or off
+ *
+ * Called every time the daemon looks at its configuration (pbs_server's
+ * main loop, pbs_mom's read_config()), so it is cheap when nothing
+ * changes.  Only that thread changes log_index_enabled.
+ */
+
+void log_set_index(
+
+  int enable)  /* I (boolean) */
+
+  {
+  enable = (enable != 0);
+
+  if (enable == log_index_enabled)
+    return;
+
+  if (log_mutex == NULL)
+    {
+    /* before log_init(), log_open() picks it up */
+    log_index_enabled = enable;
+
+    return;
+    }
+
+  pthread_mutex_lock(log_mutex);
+
+  log_index_enabled = enable;
+
+  if (log_opened == 1)
+    {
+    if (enable)
+      log_index_open();
+    else
+      log_index_remove();
+    }
+
+  pthread_mutex_unlock(log_mutex);
+  }  /* END log_set_index() */
+
+
+
 /*
  * mk_log_name - make the log name used by MOM
  * based on the date: yyyymmdd
@@ -383,6 +524,11 @@ int log_open(
 
   log_opened = 1;   /* note that file is open */
 
+  if (log_index_enabled)
+    log_index_open();
+  else
+    log_index_remove();
+
   pthread_mutex_unlock(log_mutex);
   
   log_record(
@@ -773,6 +919,8 @@ void log_record(
   size_t nchars;
   int eventclass = 0;
   char time_formatted_str[64];
+  off_t  offset = -1;
+  FILE  *indexed = NULL;
 
   thr_id = syscall(SYS_gettid);
   pthread_mutex_lock(log_mutex);
@@ -809,6 +957,17 @@ void log_record(
     log_format_trq_timestamp(time_formatted_str, sizeof(time_formatted_str));
     }
 
+  if ((logindex != NULL) &&
+      (eventclass != PBS_EVENTCLASS_TRQAUTHD) &&
+      (objname != NULL) &&
+      (isdigit((unsigned char)*objname)) &&
+      (strpbrk(objname, " \t\r\n") == NULL))
+    {
+    /* the stream is flushed after every record so this is where it goes */
+    indexed = logfile;
+    offset = lseek(fileno(logfile), 0, SEEK_END);
+    }
+
   /*
    * Looking for the newline characters and splitting the output message
    * on them.  Sequence "\r\n" is mapped to the single newline.
@@ -883,6 +1042,22 @@ void log_record(
 
   fflush(logfile);
 
+  if ((offset >= 0) &&
+      (rc >= 0) &&
+      (indexed == logfile) &&
+      (logindex != NULL))
+    {
+    off_t end = lseek(fileno(logfile), 0, SEEK_END);
+
+    if (end > offset)
+      {
+      fprintf(logindex, "%s %lld %lld\n",
+        objname,
+        (long long)offset,
+        (long long)(end - offset));
+      }
+    }
+
   if (rc < 0)
     {
     rc = errno;
@@ -936,6 +1111,8 @@ void log_close(
 
     fclose(logfile);
 
+    log_index_close();
+
     log_opened = 0;
     }
 
@@ -1103,6 +1280,8 @@ void log_roll(
   int err = 0;
   char *source  = NULL;
   char *dest    = NULL;
+  char  source_index[PATH_MAX];
+  char  dest_index[PATH_MAX];
   
   pthread_mutex_lock(log_mutex);
 
@@ -1150,6 +1329,10 @@ void log_roll(
     goto done_roll;
     }
 
+  log_index_name(dest, dest_index, sizeof(dest_index));
+
+  unlink(dest_index);
+
   /* logname.max_depth is gone, so roll the rest of the log files */
 
   for (i = max_depth - 1;i >= 0;i--)
@@ -1176,6 +1359,13 @@ void log_roll(
       err = errno;
       goto done_roll;
       }
+
+    /* a job index goes with its log */
+    log_index_name(source, source_index, sizeof(source_index));
+    log_index_name(dest, dest_index, sizeof(dest_index));
+
+    if (rename(source_index, dest_index) != 0)
+      unlink(dest_index);
     }    /* END for (i) */
 
 done_roll:
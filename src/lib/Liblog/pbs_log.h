@@ -28,6 +28,8 @@ void log_roll(int max_depth);
 
 long log_size(void);
 
+void log_set_index(int enable);
+
 long job_log_size(void);
 
 void print_trace(int socknum);
@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+ssize_t write_nonblocking_socket(int fd, const void *buf, ssize_t count)
+  {
+  return(write(fd, buf, count));
+  }
@@ -0,0 +1,196 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "job_history.h"
+#include "test_job_history.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+
+#include "pbs_error.h"
+
+static char history_dir[] = "/tmp/test_job_history_XXXXXX";
+static char history_name[256];
+
+static void history_path(void)
+  {
+  time_t    now = time(NULL);
+  struct tm tm;
+
+  if (history_name[0] == '\0')
+    fail_unless(mkdtemp(history_dir) != NULL);
+
+  localtime_r(&now, &tm);
+
+  snprintf(history_name, sizeof(history_name), "%s/%04d%02d%02d" JH_SUFFIX,
+    history_dir,
+    tm.tm_year + 1900,
+    tm.tm_mon + 1,
+    tm.tm_mday);
+  }
+
+static void start_history(void)
+  {
+  char index_name[300];
+
+  history_path();
+  jh_close();
+
+  snprintf(index_name, sizeof(index_name), "%s" JH_INDEX_SUFFIX, history_name);
+  unlink(history_name);
+  unlink(index_name);
+  }
+
+static void write_job(char *jobid, char *user, int exit_status, char *value)
+  {
+  jh_buf jb;
+
+  memset(&jb, 0, sizeof(jb));
+
+  fail_unless(jh_record_start(&jb, jobid, user, 100, 200, 300, exit_status) == PBSE_NONE);
+  fail_unless(jh_record_attr(&jb, "Job_Name", "", "test") == PBSE_NONE);
+  fail_unless(jh_record_attr(&jb, "resources_used", "walltime", value) == PBSE_NONE);
+  fail_unless(jh_write_record(&jb, history_dir) == PBSE_NONE);
+
+  jh_buf_free(&jb);
+  }
+
+START_TEST(test_one)
+  {
+  jh_file    jf;
+  jh_record *jr;
+  char      *cursor = NULL;
+  char      *name;
+  char      *resc;
+  char      *value;
+
+  start_history();
+
+  write_job((char *)"1.host", (char *)"alice", 0, (char *)"00:00:10");
+  write_job((char *)"2.host", (char *)"bob", 271, (char *)"00:01:00");
+
+  fail_unless(jh_map(history_name, &jf) == PBSE_NONE);
+  fail_unless(!memcmp(jf.jf_data, JH_FILE_MAGIC, JH_ALIGN));
+
+  jr = jh_first(&jf, 0);
+  fail_unless(jr != NULL);
+  fail_unless(!strcmp(jh_record_id(jr), "1.host"));
+  fail_unless(!strcmp(jh_record_user(jr), "alice"));
+  fail_unless(jr->jr_qtime == 100);
+  fail_unless(jr->jr_start == 200);
+  fail_unless(jr->jr_end == 300);
+  fail_unless(jr->jr_attrs == 2);
+  fail_unless((jr->jr_length % JH_ALIGN) == 0);
+
+  fail_unless(jh_record_next_attr(jr, &cursor, &name, &resc, &value) == TRUE);
+  fail_unless(!strcmp(name, "Job_Name"));
+  fail_unless(!strcmp(resc, ""));
+  fail_unless(!strcmp(value, "test"));
+  fail_unless(jh_record_next_attr(jr, &cursor, &name, &resc, &value) == TRUE);
+  fail_unless(!strcmp(name, "resources_used"));
+  fail_unless(!strcmp(resc, "walltime"));
+  fail_unless(!strcmp(value, "00:00:10"));
+  fail_unless(jh_record_next_attr(jr, &cursor, &name, &resc, &value) == FALSE);
+
+  jr = jh_next(&jf, jr);
+  fail_unless(jr != NULL);
+  fail_unless(!strcmp(jh_record_id(jr), "2.host"));
+  fail_unless(jr->jr_exit == 271);
+  fail_unless(jh_next(&jf, jr) == NULL);
+
+  jh_unmap(&jf);
+
+  /* not a history */
+  fail_unless(jh_map(history_dir, &jf) != PBSE_NONE);
+  }
+END_TEST
+
+START_TEST(test_two)
+  {
+  jh_file    jf;
+  jh_record *jr;
+  char       big[8192];
+  int        fd;
+  int        i;
+  int        count;
+
+  /* a write torn part way through is skipped and padded over */
+  start_history();
+
+  write_job((char *)"1.host", (char *)"alice", 0, (char *)"00:00:10");
+  jh_close();
+
+  fail_unless((fd = open(history_name, O_WRONLY | O_APPEND)) >= 0);
+  fail_unless(write(fd, "\x31\x52\x48\x4a\x00\x01", 6) == 6);
+  close(fd);
+
+  write_job((char *)"2.host", (char *)"bob", 0, (char *)"00:00:20");
+
+  fail_unless(jh_map(history_name, &jf) == PBSE_NONE);
+  jr = jh_first(&jf, 0);
+  fail_unless(!strcmp(jh_record_id(jr), "1.host"));
+  jr = jh_next(&jf, jr);
+  fail_unless(jr != NULL);
+  fail_unless(!strcmp(jh_record_id(jr), "2.host"));
+  fail_unless(jh_next(&jf, jr) == NULL);
+  jh_unmap(&jf);
+
+  /* enough records for the index to be used */
+  start_history();
+
+  memset(big, 'x', sizeof(big) - 1);
+  big[sizeof(big) - 1] = '\0';
+
+  for (i = 0; i < 40; i++)
+    write_job((char *)"3.host", (char *)"carol", 0, big);
+
+  fail_unless(jh_map(history_name, &jf) == PBSE_NONE);
+  fail_unless(jf.jf_index_count >= 2);
+  fail_unless(jf.jf_index[0].ji_offset == JH_ALIGN);
+
+  count = 0;
+  for (jr = jh_first(&jf, 0); jr != NULL; jr = jh_next(&jf, jr))
+    count++;
+  fail_unless(count == 40);
+
+  /* everything was written before now + 1, start at the last index entry */
+  jr = jh_first(&jf, time(NULL) + 1);
+  fail_unless((char *)jr - jf.jf_data == jf.jf_index[jf.jf_index_count - 1].ji_offset);
+
+  jh_unmap(&jf);
+  jh_close();
+  }
+END_TEST
+
+Suite *job_history_suite(void)
+  {
+  Suite *s = suite_create("job_history_suite methods");
+  TCase *tc_core = tcase_create("test_one");
+  tcase_add_test(tc_core, test_one);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_two");
+  tcase_add_test(tc_core, test_two);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_history_suite());
+  srunner_set_log(sr, "job_history_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
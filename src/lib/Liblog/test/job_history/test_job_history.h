@@ -0,0 +1,11 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _JOB_HISTORY_CT_H
+#define _JOB_HISTORY_CT_H
+#include <check.h>
+
+#define JOB_HISTORY_SUITE 1
+Suite *job_history_suite();
+#define METH_2 2
+Suite *meth_2_suite();
+
+#endif /* _JOB_HISTORY_CT_H */
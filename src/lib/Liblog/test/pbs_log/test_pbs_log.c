@@ -3,21 +3,166 @@
 #include "test_pbs_log.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 
 
 #include "pbs_error.h"
 
+static char log_dir[] = "/tmp/test_pbs_log_XXXXXX";
+static char log_name[256];
+static char index_name[256];
+
+static void open_test_log(void)
+  {
+  if (log_mutex == NULL)
+    {
+    log_init(NULL, NULL);
+    fail_unless(mkdtemp(log_dir) != NULL);
+    }
+
+  snprintf(log_name, sizeof(log_name), "%s/log", log_dir);
+  snprintf(index_name, sizeof(index_name), "%s/log.idx", log_dir);
+
+  unlink(log_name);
+  unlink(index_name);
+
+  pthread_mutex_lock(log_mutex);
+  fail_unless(log_open(log_name, log_dir) == 0);
+  pthread_mutex_unlock(log_mutex);
+  }
+
+static void close_test_log(void)
+  {
+  pthread_mutex_lock(log_mutex);
+  log_close(0);
+  pthread_mutex_unlock(log_mutex);
+  }
+
+/* read length bytes at offset in the log */
+static void read_log(long offset, long length, char *buf)
+  {
+  FILE *fp = fopen(log_name, "r");
+
+  fail_unless(fp != NULL);
+  fail_unless(fseek(fp, offset, SEEK_SET) == 0);
+  fail_unless(fread(buf, 1, length, fp) == (size_t)length);
+  buf[length] = '\0';
+  fclose(fp);
+  }
+
 START_TEST(test_one)
   {
+  FILE *idx;
+  char  line[1024];
+  char  id[256];
+  char  text[1024];
+  long  offset;
+  long  length;
+  int   entries = 0;
+
+  log_set_index(TRUE);
+  open_test_log();
+
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "1.host", (char *)"queued");
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, "Svr", (char *)"not a job");
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "2.host", (char *)"exiting");
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "1.host", (char *)"running");
+  /* job events the server logs under its own class are indexed too */
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, "2.host", (char *)"obit");
+
+  close_test_log();
+
+  fail_unless((idx = fopen(index_name, "r")) != NULL);
+  fail_unless(fgets(line, sizeof(line), idx) != NULL);
+  fail_unless(!strcmp(line, "#open 0\n"));
+
+  while (fgets(line, sizeof(line), idx) != NULL)
+    {
+    fail_unless(sscanf(line, "%255s %ld %ld", id, &offset, &length) == 3);
+    fail_unless(length < (long)sizeof(text));
+
+    read_log(offset, length, text);
 
+    switch (entries++)
+      {
+      case 0:
 
+        fail_unless(!strcmp(id, "1.host"));
+        fail_unless(strstr(text, ";Job;1.host;queued\n") != NULL);
+
+        break;
+
+      case 1:
+
+        fail_unless(!strcmp(id, "2.host"));
+        fail_unless(strstr(text, ";Job;2.host;exiting\n") != NULL);
+
+        break;
+
+      case 2:
+
+        fail_unless(!strcmp(id, "1.host"));
+        fail_unless(strstr(text, ";Job;1.host;running\n") != NULL);
+
+        break;
+
+      case 3:
+
+        fail_unless(!strcmp(id, "2.host"));
+        fail_unless(strstr(text, ";Svr;2.host;obit\n") != NULL);
+
+        break;
+      }
+
+    fail_unless(text[length - 1] == '\n');
+    }
+
+  fclose(idx);
+
+  fail_unless(entries == 4, "%d index entries", entries);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  FILE *idx;
+  char  line[1024];
+  long  offset;
+  char  rolled[256];
+
+  /* a log written without the index loses it */
+  log_set_index(TRUE);
+  open_test_log();
+  close_test_log();
+  fail_unless(access(index_name, F_OK) == 0);
+
+  log_set_index(FALSE);
+  open_test_log();
+  fail_unless(access(index_name, F_OK) != 0);
+
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "3.host", (char *)"unindexed");
+
+  /* turning it on part way covers the log from there */
+  log_set_index(TRUE);
+  fail_unless((idx = fopen(index_name, "r")) != NULL);
+  fail_unless(fgets(line, sizeof(line), idx) != NULL);
+  fail_unless(sscanf(line, "#open %ld", &offset) == 1);
+  fail_unless(offset > 0);
+  fclose(idx);
+
+  /* the index rolls with its log */
+  log_roll(1);
+
+  snprintf(rolled, sizeof(rolled), "%s/log.1.idx", log_dir);
+  fail_unless(access(rolled, F_OK) == 0);
+  fail_unless(access(index_name, F_OK) == 0);
 
+  log_set_index(FALSE);
+  fail_unless(access(index_name, F_OK) != 0);
 
+  close_test_log();
   }
 END_TEST
 
@@ -36,6 +36,8 @@ int get_random_reserved_port();
 int socket_get_tcp_priv();
 int socket_connect(int *local_socket, char *dest_addr, int dest_addr_len, int dest_port, int family, int is_privileged, char **err_msg);
 int socket_connect_addr(int *local_socket, struct sockaddr *remote, size_t remote_size, int is_privileged, char **err_msg);
+int unix_socket_dir_trusted(const char *sock_name);
+int socket_connect_unix(int *local_socket, const char *sock_name, char **err_msg);
 int socket_wait_for_write(int socket);
 int socket_wait_for_xbytes(int socket, int len);
 int socket_wait_for_read(int socket);
@@ -52,6 +54,7 @@ int get_addr_info(char *name, struct sockaddr_in *sa_info, int retry);
 /* from file server_core.c */
 int start_listener(char *server_ip, int server_port, void *(*process_meth)(void *));
 int start_listener_addrinfo(char *host_name, int server_port, void *(*process_meth)(void *));
+int start_domainsocket_listener(const char *socket_name, void *(*process_meth)(void *));
 
 /* from file net_client.c */
 #ifdef __APPLE__
@@ -9,6 +9,9 @@
 #include <signal.h> /* Signals SIGPIPE, etc */
 #include <sys/types.h>
 #include <sys/socket.h> /* Socket communication */
+#include <sys/un.h> /* sockaddr_un */
+#include <sys/stat.h> /* lstat */
+#include <sys/param.h> /* MAXPATHLEN */
 #include <netdb.h> /* struct addrinfo */
 #include <netinet/in.h> /* Internet domain sockets */
 #include <arpa/inet.h> /* in_addr_t */
@@ -296,6 +299,90 @@ int socket_connect(
   return socket_connect_addr(local_socket, (struct sockaddr *)&remote, r_size, is_privileged, error_msg);
   }
 
+/*
+ * unix_socket_dir_trusted - TRUE if only root can create or replace
+ * entries in the directory holding sock_name
+ */
+
+int unix_socket_dir_trusted(
+
+  const char *sock_name)  /* I */
+
+  {
+  char        dir_name[MAXPATHLEN + 1];
+  char       *slash;
+  struct stat dir_stat;
+
+  snprintf(dir_name, sizeof(dir_name), "%s", sock_name);
+
+  if ((slash = strrchr(dir_name, '/')) == NULL)
+    return(FALSE);
+
+  if (slash == dir_name)
+    slash++;
+
+  *slash = '\0';
+
+  if ((stat(dir_name, &dir_stat) != 0) ||
+      (!S_ISDIR(dir_stat.st_mode)) ||
+      (dir_stat.st_uid != 0) ||
+      ((dir_stat.st_mode & (S_IWGRP | S_IWOTH)) != 0))
+    return(FALSE);
+
+  return(TRUE);
+  } /* END unix_socket_dir_trusted() */
+
+/*
+ * socket_connect_unix - connect a new unix domain socket to sock_name
+ *
+ * Refuses sockets that root did not create in a directory only root can
+ * write, since whoever listens there is trusted to vouch for our user.
+ */
+
+int socket_connect_unix(
+
+  int         *local_socket,  /* O */
+  const char  *sock_name,     /* I */
+  char       **error_msg)     /* O */
+
+  {
+  struct sockaddr_un addr;
+  struct stat        sock_stat;
+  char               tmp_buf[LOCAL_LOG_BUF_SIZE+1];
+
+  *local_socket = -1;
+
+  if ((unix_socket_dir_trusted(sock_name) == FALSE) ||
+      (lstat(sock_name, &sock_stat) != 0) ||
+      (!S_ISSOCK(sock_stat.st_mode)) ||
+      (sock_stat.st_uid != 0))
+    {
+    snprintf(tmp_buf, LOCAL_LOG_BUF_SIZE, "%s is missing or not owned by root", sock_name);
+    *error_msg = strdup(tmp_buf);
+
+    return(PBSE_SOCKET_FAULT);
+    }
+
+  if ((*local_socket = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+    return(PBSE_SOCKET_FAULT);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", sock_name);
+
+  if (connect(*local_socket, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+    snprintf(tmp_buf, LOCAL_LOG_BUF_SIZE, "cannot connect to %s - errno:%d %s", sock_name, errno, strerror(errno));
+    *error_msg = strdup(tmp_buf);
+    close(*local_socket);
+    *local_socket = -1;
+
+    return(PBSE_SOCKET_FAULT);
+    }
+
+  return(PBSE_NONE);
+  } /* END socket_connect_unix() */
+
 int socket_connect_addr(
     
   int              *local_socket,
@@ -4,6 +4,8 @@
 #include <unistd.h> /* close */
 #include <errno.h> /* errno, strerror */
 #include <stdio.h> /* printf */
+#include <sys/un.h> /* sockaddr_un */
+#include <sys/stat.h> /* chmod */
 
 #include "pbs_error.h" /* PBSE_NONE */
 #include "log.h" /* log_event, PBSEVENT_JOB, PBS_EVENTCLASS_JOB */
@@ -146,6 +148,123 @@ int start_listener(
   } /* END start_listener() */
 
 
+/*
+ * start_domainsocket_listener - accept local clients on a unix domain socket
+ *
+ * Works like start_listener(), but on socket_name, which any local user may
+ * connect to.  socket_name must sit in a directory only root can write, so
+ * nobody else can put their own socket there first.  Does not return until
+ * accept() fails.
+ */
+
+int start_domainsocket_listener(
+    
+  const char *socket_name,
+  void     *(*process_meth)(void *))
+
+  {
+  struct sockaddr_un  addr;
+  struct sockaddr_un  adr_client;
+  socklen_t           len_unix;
+  int                 rc = PBSE_NONE;
+  int                *new_conn_port = NULL;
+  int                 listen_socket = 0;
+  pthread_t           tid;
+  pthread_attr_t      t_attr;
+  char                msg_started[1024];
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_name);
+
+  if (unix_socket_dir_trusted(socket_name) == FALSE)
+    {
+    snprintf(msg_started, sizeof(msg_started),
+      "not listening on unix socket %s, its directory is missing or writable by users other than root",
+      socket_name);
+    log_err(-1, __func__, msg_started);
+
+    return(PBSE_PERM);
+    }
+
+  /* a socket left behind by an earlier daemon would make bind fail */
+  unlink(socket_name);
+
+  if ((listen_socket = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+    {
+    rc = PBSE_SOCKET_FAULT;
+    }
+  else if (bind(listen_socket, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+    {
+    rc = PBSE_SOCKET_FAULT;
+    }
+  else if (chmod(socket_name, 0777) == -1)
+    {
+    rc = PBSE_SOCKET_FAULT;
+    }
+  else if (listen(listen_socket, 128) == -1)
+    {
+    rc = PBSE_SOCKET_LISTEN;
+    }
+  else if ((rc = pthread_attr_init(&t_attr)) != 0)
+    {
+    rc = PBSE_THREADATTR;
+    }
+  else if ((rc = pthread_attr_setdetachstate(&t_attr, PTHREAD_CREATE_DETACHED)) != 0)
+    {
+    pthread_attr_destroy(&t_attr);
+    }
+  else
+    {
+    snprintf(msg_started, sizeof(msg_started),
+      "TORQUE authd daemon listening on unix socket %s", socket_name);
+    log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_TRQAUTHD,
+      msg_daemonname, msg_started);
+
+    while (1)
+      {
+      len_unix = sizeof(adr_client);
+
+      if ((new_conn_port = (int *)calloc(1, sizeof(int))) == NULL)
+        {
+        printf("Error allocating new connection handle on accept.\n");
+        break;
+        }
+
+      if ((*new_conn_port = accept(listen_socket, (struct sockaddr *)&adr_client, &len_unix)) == -1)
+        {
+        free(new_conn_port);
+        new_conn_port = NULL;
+
+        if (errno == EMFILE)
+          {
+          sleep(1);
+          errno = 0;
+          continue;
+          }
+
+        printf("error in accept %s\n", strerror(errno));
+        break;
+        }
+
+      if (debug_mode == TRUE)
+        process_meth((void *)new_conn_port);
+      else
+        pthread_create(&tid, &t_attr, process_meth, (void *)new_conn_port);
+      }
+
+    pthread_attr_destroy(&t_attr);
+    }
+
+  if (listen_socket >= 0)
+    close(listen_socket);
+
+  unlink(socket_name);
+
+  return(rc);
+  } /* END start_domainsocket_listener() */
+
+
 int start_listener_addrinfo(
 
   char   *host_name,
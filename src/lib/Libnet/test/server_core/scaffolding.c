@@ -49,3 +49,10 @@ int enqueue_threadpool_request(
   {
   return(0);
   }
+
+int unix_socket_dir_trusted(const char *sock_name)
+  {
+  return(0);
+  }
+
+void log_err(int errnum, const char *routine, char *text) {}
@@ -10,6 +10,7 @@
 #include <limits.h>
 #include <assert.h>
 #include <ctype.h>
+#include <fcntl.h>
 #include "dis.h"
 #include "libpbs.h"
 #include "portability.h"
@@ -58,6 +59,7 @@ extern char  *path_jobs;
 extern unsigned int default_server_port;
 extern tlist_head svr_alljobs;
 extern tlist_head mom_polljobs;
+extern tlist_head mom_exiting_jobs;
 extern int  exiting_tasks;
 extern char  *msg_daemonname;
 extern int  termin_child;
@@ -103,11 +105,16 @@ u_long getsize(resource *);
 
 void exit_mom_job(job *pjob, int mom_radix);
 
+/* socketpair used by catch_child() to wake up wait_request() */
+int   child_wakeup_fds[2] = { -1, -1 };
+pid_t child_wakeup_pid = -1;
+
 /*
  * catch_child() - the signal handler for SIGCHLD.
  *
  * To keep the signal handler simple for
- * SIGCHLD  - just indicate there was one.
+ * SIGCHLD  - just indicate there was one and poke the wakeup socketpair
+ * so the main loop handles the exit now instead of at the next timeout.
  */
 
 void catch_child(
@@ -115,14 +122,88 @@ void catch_child(
   int sig)
 
   {
+  int saved_errno = errno;
+
   termin_child = 1;
 
+  /* forked children inherit this handler, only the mom itself owns the
+   * socketpair. send() is used as write() is wrapped by pbs_config.h with
+   * write_nonblocking_socket() which retries and is not signal safe */
+  if ((child_wakeup_fds[1] >= 0) &&
+      (getpid() == child_wakeup_pid))
+    {
+    if (send(child_wakeup_fds[1], "c", 1, MSG_DONTWAIT) < 0)
+      {
+      /* buffer is full, a wakeup is already pending */
+      }
+    }
+
+  errno = saved_errno;
+
   return;
   }  /* END catch_child() */
 
 
 
 
+/*
+ * read_child_wakeup() - connection function for the read end of the
+ * SIGCHLD wakeup socketpair. The main loop does the real work, just drain it.
+ */
+
+void *read_child_wakeup(
+
+  void *new_sock)
+
+  {
+  int  sock = *(int *)new_sock;
+  char buf[64];
+
+  while (recv(sock, buf, sizeof(buf), MSG_DONTWAIT) > 0)
+    ;
+
+  return(NULL);
+  }  /* END read_child_wakeup() */
+
+
+
+
+/*
+ * init_child_wakeup() - create the SIGCHLD wakeup socketpair and add its
+ * read end to the set of descriptors watched by wait_request().
+ *
+ * @return PBSE_NONE on success, -1 if the socketpair could not be created
+ * (the main loop then falls back to noticing child exits on its timeout)
+ */
+
+int init_child_wakeup(void)
+
+  {
+  int i;
+
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, child_wakeup_fds) == -1)
+    {
+    log_err(errno, __func__, "cannot create SIGCHLD wakeup socketpair");
+
+    child_wakeup_fds[0] = -1;
+    child_wakeup_fds[1] = -1;
+
+    return(-1);
+    }
+
+  for (i = 0; i < 2; i++)
+    fcntl(child_wakeup_fds[i], F_SETFD, FD_CLOEXEC);
+
+  child_wakeup_pid = getpid();
+
+  add_conn(child_wakeup_fds[0], Primary, (pbs_net_t)0, 0, PBS_SOCK_UNIX, read_child_wakeup);
+
+  return(PBSE_NONE);
+  }  /* END init_child_wakeup() */
+
+
+
+
 
 hnodent *get_node(
 
@@ -288,7 +369,9 @@ int send_task_obit_response(
 void scan_for_exiting(void)
 
   {
+  int           scan_all_jobs = exiting_tasks;
   int           found_one = 0;
+  job          *last_queued = NULL;
   job          *nextjob;
   job          *pjob;
   task         *ptask;
@@ -346,11 +429,29 @@ void scan_for_exiting(void)
 
   clear_down_mom_servers();
 
+  /* exiting_tasks asks for a walk of every job. Otherwise only the jobs
+   * queued by mark_job_exiting() have anything to do. */
+
+  if (scan_all_jobs)
+    {
+    pjob = (job *)GET_NEXT(svr_alljobs);
+    }
+  else
+    {
+    pjob = (job *)GET_NEXT(mom_exiting_jobs);
+
+    /* jobs queued while this pass runs wait for the next pass */
+    last_queued = (job *)GET_PRIOR(mom_exiting_jobs);
+    }
+
   /* do not change this from the nextjob formal. In some cases pjob has
    * been freed by the time that the loop comes around */
-  for (pjob = (job *)GET_NEXT(svr_alljobs); pjob != NULL; pjob = nextjob)
+  for (; pjob != NULL; pjob = (pjob == last_queued) ? NULL : nextjob)
     {
-    nextjob = (job *)GET_NEXT(pjob->ji_alljobs);
+    if (scan_all_jobs)
+      nextjob = (job *)GET_NEXT(pjob->ji_alljobs);
+    else
+      nextjob = (job *)GET_NEXT(pjob->ji_exitque);
 
     /*
      * Bypass job if it is for a server that we know is down
@@ -373,6 +474,10 @@ void scan_for_exiting(void)
       continue;
       }
 
+    /* the job is being handled, it gets requeued if it changes again */
+
+    delete_link(&pjob->ji_exitque);
+
     /*
     ** If a checkpoint with aborts is active,
     ** skip it.  We don't want to report any obits
@@ -676,7 +781,7 @@ void scan_for_exiting(void)
           }
         job_save(pjob, SAVEJOB_QUICK, momport);
         
-        exiting_tasks = 1; /* Setting this to 1 will cause scan_for_exiting to execute */
+        mark_job_exiting(pjob); /* scan_for_exiting will look at this job again */
         
         }
 
@@ -778,7 +883,8 @@ void scan_for_exiting(void)
       }
     }  /* END for (pjob) */
 
-  if ((pjob == NULL) &&
+  if ((scan_all_jobs) &&
+      (pjob == NULL) &&
       (no_mom_servers_down()))
     {
     /* search finished */
@@ -793,6 +899,34 @@ void scan_for_exiting(void)
 
 
 
+
+/*
+ * mark_job_exiting() - queue a job for the next scan_for_exiting()
+ *
+ * Called whenever one of the job's tasks exits or the job moves to an
+ * exiting substate, so scan_for_exiting() only looks at jobs that changed
+ * instead of walking every job and task on the node.
+ *
+ * @param pjob - the job with newly exited tasks
+ */
+
+void mark_job_exiting(
+
+  job *pjob) /* I */
+
+  {
+  if (pjob == NULL)
+    return;
+
+  /* a job is queued at most once */
+  if (pjob->ji_exitque.ll_next != &pjob->ji_exitque)
+    return;
+
+  append_link(&mom_exiting_jobs, &pjob->ji_exitque, pjob);
+  }  /* END mark_job_exiting() */
+
+
+
  
 int run_epilogues(
     
@@ -1485,7 +1619,7 @@ void *obit_reply(
 
           pjob->ji_qs.ji_substate = JOB_SUBSTATE_EXITING;
 
-          exiting_tasks = 1;
+          mark_job_exiting(pjob);
 
           break;
 
@@ -1898,7 +2032,7 @@ void init_abort_jobs(
 
       job_save(pj, SAVEJOB_QUICK, momport);
 
-      exiting_tasks = 1;
+      mark_job_exiting(pj);
       }  /* END if ((recover != 2) && ...) */
     else if (recover == JOB_RECOV_RUNNING || recover == JOB_RECOV_DELETE)
       {
@@ -2199,6 +2333,101 @@ int send_job_obit_to_ms(
 
 
 
+/*
+ * post_sister_epilogue - called from scan_for_terminated() via ji_mompost
+ * when the epilogue subtask forked by start_sister_epilogue() exits.
+ *
+ * Puts the job back on the exiting queue so exit_mom_job() can send the
+ * obit to mother superior.
+ */
+
+int post_sister_epilogue(
+
+  job *pjob,  /* I (modified) */
+  int  ev)    /* I (exit value of the subtask) */
+
+  {
+  if (LOGLEVEL >= 3)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "epilog subtask exited with %d",
+      ev);
+
+    log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buffer);
+    }
+
+  pjob->ji_flags &= ~MOM_EPILOGUE_ACTIVE;
+  pjob->ji_flags |= MOM_EPILOGUE_DONE;
+
+  mark_job_exiting(pjob);
+
+  return(0);
+  }  /* END post_sister_epilogue() */
+
+
+
+
+/*
+ * start_sister_epilogue - run a sister's epilogues in a mom subtask so that
+ * the main loop keeps servicing other jobs while they run.
+ *
+ * @see post_sister_epilogue() - registered in ji_mompost
+ *
+ * @return TRUE if the epilogues are done, FALSE if a subtask is running them
+ */
+
+int start_sister_epilogue(
+
+  job *pjob)  /* I (modified) */
+
+  {
+  pid_t cpid;
+
+  if (pjob->ji_flags & MOM_EPILOGUE_DONE)
+    return(TRUE);
+
+  if (pjob->ji_flags & MOM_EPILOGUE_ACTIVE)
+    return(FALSE);
+
+  /* another subtask owns ji_momsubt, or we cannot fork - run them inline */
+
+  if ((pjob->ji_momsubt != 0) ||
+      ((cpid = fork_me(-1)) < 0))
+    {
+    run_epilogues(pjob, FALSE);
+
+    pjob->ji_flags |= MOM_EPILOGUE_DONE;
+
+    return(TRUE);
+    }
+
+  if (cpid == 0)
+    {
+    /* child - just run epilogues */
+    run_epilogues(pjob, FALSE);
+
+    exit(0);
+    }
+
+  pjob->ji_momsubt = cpid;
+  pjob->ji_mompost = post_sister_epilogue;
+  pjob->ji_flags |= MOM_EPILOGUE_ACTIVE;
+
+  if (LOGLEVEL >= 2)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "epilog subtask created with pid %d - registered post_sister_epilogue",
+      cpid);
+
+    log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buffer);
+    }
+
+  return(FALSE);
+  }  /* END start_sister_epilogue() */
+
+
+
+
 void exit_mom_job(
    
   job *pjob,
@@ -2217,7 +2446,9 @@ void exit_mom_job(
   if (needs_and_ready_for_reply(pjob) == FALSE)
     return;
 
-  run_epilogues(pjob, FALSE);
+  /* the obit is sent once the epilogue subtask has been reaped */
+  if (start_sister_epilogue(pjob) == FALSE)
+    return;
 
   send_job_obit_to_ms(pjob, mom_radix);
   
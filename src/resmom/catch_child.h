@@ -8,12 +8,18 @@
 
 void catch_child(int sig);
 
+void *read_child_wakeup(void *new_sock);
+
+int init_child_wakeup(void);
+
 hnodent *get_node(job *pjob, tm_node_id nodeid);
 
 int send_task_obit_response(job *pjob, hnodent *pnode, char *cookie, obitent *pobit, int exitstat);
 
 void scan_for_exiting(void);
 
+void mark_job_exiting(job *pjob);
+
 int send_job_status(job *pjob);
 
 int post_epilogue(job *pjob, int ev);
@@ -32,6 +38,10 @@ int needs_and_ready_for_reply(job *pjob);
 
 int send_job_obit_to_ms(job *pjob, int mom_radix);
 
+int post_sister_epilogue(job *pjob, int ev);
+
+int start_sister_epilogue(job *pjob);
+
 void exit_mom_job(job *pjob, int mom_radix);
 
 #endif /* _CATCH_CHILD_H */
@@ -82,7 +82,6 @@
 #include "pbs_ifl.h"
 #include "alps_functions.h"
 
-extern int exiting_tasks;
 extern int LOGLEVEL;
 extern     int             lockfds;
 extern int ForceServerUpdate;
@@ -1392,7 +1391,7 @@ void post_checkpoint(
 
   int            abort = pjob->ji_flags & MOM_CHECKPOINT_ACTIVE;
 
-  exiting_tasks = 1; /* make sure we call scan_for_exiting() */
+  mark_job_exiting(pjob); /* make sure we call scan_for_exiting() */
 
   pjob->ji_flags &= ~MOM_CHECKPOINT_ACTIVE;
 
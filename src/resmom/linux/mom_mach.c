@@ -4261,8 +4261,6 @@ void scan_non_child_tasks(void)
         {
         char buf[MAXLINE];
 
-        extern int exiting_tasks;
-
         sprintf(buf, "found exited session %d for task %d in job %s",
           task->ti_qs.ti_sid,
           task->ti_qs.ti_task,
@@ -4290,7 +4288,7 @@ void scan_non_child_tasks(void)
           }
 #endif    /* USESAVEDRESOURCES */
 
-        exiting_tasks = 1;
+        mark_job_exiting(job);
         }
       }
     }    /* END for (job = GET_NEXT(svr_alljobs)) */
@@ -101,7 +101,6 @@
 
 /* Global Variables */
 
-extern int  exiting_tasks;
 extern char  mom_host[];
 extern tlist_head svr_alljobs;
 extern int  termin_child;
@@ -470,7 +469,7 @@ void scan_for_terminated(void) /* linux */
 
     log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buffer);
 
-    exiting_tasks = 1;
+    mark_job_exiting(pjob);
     }  /* END while ((pid = waitpid(-1,&statloc,WNOHANG)) > 0) */
 
   return;
@@ -105,3 +105,5 @@ char *loadave(struct rm_attribute *attrib)
   fprintf(stderr, "The call to loadave needs to be mocked!!\n");
   exit(1);
   }
+
+void mark_job_exiting(job *pjob) {}
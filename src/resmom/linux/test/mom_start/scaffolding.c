@@ -77,3 +77,5 @@ int task_save(task *ptask)
   }
 
 void check_partition_confirm_script(char *path, char *msg) {}
+
+void mark_job_exiting(job *pjob) {}
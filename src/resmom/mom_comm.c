@@ -139,7 +139,6 @@
 
 /* Global Data Items */
 
-extern int           exiting_tasks;
 extern char         *path_jobs;
 extern char         *path_home;
 extern unsigned int  pbs_mom_port;
@@ -201,6 +200,30 @@ struct routefd
 
 fd_set readset;
 
+/*
+** A tm_spawn_multi() waiting on its sisters.  Each remote node has an
+** IM_SPAWN_MULTI event whose ee_forward names the record (fe_event,
+** fe_taskid) and the node's slot (fe_node); the task gets one reply
+** when the last of them is answered.
+*/
+
+typedef struct spawn_multi
+  {
+  char                sm_jobid[PBS_MAXSVRJOBID + 1];
+  tm_task_id          sm_fromtask;
+  tm_event_t          sm_event;        /* event of the tm_spawn_multi() call */
+  int                 sm_count;        /* nodes in the request */
+  int                 sm_outstanding;  /* sisters yet to answer */
+  int                *sm_errors;
+  tm_task_id         *sm_tids;
+  struct spawn_multi *sm_next;
+  } spawn_multi;
+
+static spawn_multi *spawn_multis = NULL;
+
+/* most nodes one tm_spawn_multi() may name */
+#define TM_SPAWN_MULTI_MAX 100000
+
 
 /* external functions */
 
@@ -1251,7 +1274,7 @@ void node_bailout(
             }
           job_save(pjob, SAVEJOB_QUICK, momport);
 
-          exiting_tasks = 1;
+          mark_job_exiting(pjob);
           }
 
         break;
@@ -1296,6 +1319,12 @@ void node_bailout(
 
         break;
 
+      case IM_SPAWN_MULTI:
+
+        spawn_multi_result(pjob, &ep->ee_forward, TM_ESYSTEM, TM_NULL_TASK);
+
+        break;
+
       case IM_POLL_JOB:
 
         /*
@@ -2575,13 +2604,10 @@ void im_kill_job_as_sister(
   
   job_save(pjob, SAVEJOB_QUICK, momport);
   
-  if ((pjob->ji_qs.ji_svrflags & JOB_SVFLG_INTERMEDIATE_MOM) &&
-      (radix == TRUE))
-    {
-    exiting_tasks = 0;
-    }
-  else
-    exiting_tasks = 1; /* Setting this to 1 will cause scan_for_exiting to execute */  
+  /* an intermediate mom waits for its sisters before exiting the job */
+  if (((pjob->ji_qs.ji_svrflags & JOB_SVFLG_INTERMEDIATE_MOM) == 0) ||
+      (radix == FALSE))
+    mark_job_exiting(pjob); /* scan_for_exiting will handle this job */
   } /* END im_kill_job_as_sister() */
 
 
@@ -3870,7 +3896,7 @@ int handle_im_kill_job_response(
 
     job_save(pjob, SAVEJOB_QUICK, momport);
     
-    exiting_tasks = 1;
+    mark_job_exiting(pjob);
     }
 
   return(IM_DONE);
@@ -3930,6 +3956,191 @@ int handle_im_spawn_task_response(
 
 
 
+
+/*
+ * send_spawn_multi_reply - answer a tm_spawn_multi() with every node's result
+ *
+ * auxiliary info (
+ *  number of nodes int;
+ *  error[0]  int;
+ *  taskid[0] int;
+ *  ...
+ * )
+ */
+
+static int send_spawn_multi_reply(
+
+  struct tcp_chan *chan,  /* I */
+  spawn_multi     *sm)    /* I */
+
+  {
+  int i;
+  int ret;
+
+  if ((ret = tm_reply(chan, TM_OKAY, sm->sm_event)) != DIS_SUCCESS)
+    return(ret);
+
+  if ((ret = diswsi(chan, sm->sm_count)) != DIS_SUCCESS)
+    return(ret);
+
+  for (i = 0;i < sm->sm_count;i++)
+    {
+    if ((ret = diswsi(chan, sm->sm_errors[i])) != DIS_SUCCESS)
+      return(ret);
+
+    if ((ret = diswsi(chan, sm->sm_tids[i])) != DIS_SUCCESS)
+      return(ret);
+    }
+
+  return(DIS_SUCCESS);
+  } /* END send_spawn_multi_reply() */
+
+
+
+
+static void free_spawn_multi(
+
+  spawn_multi *sm)
+
+  {
+  free(sm->sm_errors);
+  free(sm->sm_tids);
+  free(sm);
+  } /* END free_spawn_multi() */
+
+
+
+
+/*
+ * spawn_multi_purge - drop the tm_spawn_multi() records of a job that is
+ * going away with sister answers still outstanding
+ */
+
+void spawn_multi_purge(
+
+  job *pjob)  /* I */
+
+  {
+  spawn_multi **prev = &spawn_multis;
+  spawn_multi  *sm;
+
+  while ((sm = *prev) != NULL)
+    {
+    if (strcmp(sm->sm_jobid, pjob->ji_qs.ji_jobid))
+      {
+      prev = &sm->sm_next;
+
+      continue;
+      }
+
+    *prev = sm->sm_next;
+
+    free_spawn_multi(sm);
+    }
+  } /* END spawn_multi_purge() */
+
+
+
+
+/*
+ * spawn_multi_result - record one sister's answer to a tm_spawn_multi()
+ *
+ * efwd is the ee_forward of the node's IM_SPAWN_MULTI event.  When it is
+ * the last answer the task is sent the aggregated reply.
+ */
+
+void spawn_multi_result(
+
+  job        *pjob,    /* I */
+  fwdevent   *efwd,    /* I */
+  int         error,   /* I */
+  tm_task_id  taskid)  /* I */
+
+  {
+  spawn_multi **prev;
+  spawn_multi  *sm;
+  task         *ptask;
+
+  for (prev = &spawn_multis;(sm = *prev) != NULL;prev = &sm->sm_next)
+    {
+    if ((sm->sm_event == efwd->fe_event) &&
+        (sm->sm_fromtask == efwd->fe_taskid) &&
+        (!strcmp(sm->sm_jobid, pjob->ji_qs.ji_jobid)))
+      break;
+    }
+
+  if (sm == NULL)
+    return;
+
+  if ((efwd->fe_node >= 0) && (efwd->fe_node < sm->sm_count))
+    {
+    sm->sm_errors[efwd->fe_node] = error;
+    sm->sm_tids[efwd->fe_node] = (error == TM_SUCCESS) ? taskid : TM_NULL_TASK;
+    }
+
+  if (--sm->sm_outstanding > 0)
+    return;
+
+  *prev = sm->sm_next;
+
+  ptask = task_check(pjob, sm->sm_fromtask);
+
+  if ((ptask != NULL) &&
+      (ptask->ti_chan != NULL))
+    {
+    if (send_spawn_multi_reply(ptask->ti_chan, sm) == DIS_SUCCESS)
+      DIS_tcp_wflush(ptask->ti_chan);
+    }
+
+  free_spawn_multi(sm);
+  } /* END spawn_multi_result() */
+
+
+
+
+/*
+ * Sender is MOM responding to one node of a tm_spawn_multi().
+ *
+ * auxiliary info (
+ * task id  tm_task_id;
+ * )
+ */
+
+int handle_im_spawn_multi_response(
+
+  struct tcp_chan *chan,
+  job             *pjob,
+  fwdevent        *efwd)
+
+  {
+  int taskid;
+  int ret;
+
+  taskid = disrsi(chan, &ret);
+
+  if (ret != DIS_SUCCESS)
+    return(IM_FAILURE);
+
+  if (LOGLEVEL >= 5)
+    {
+    sprintf(log_buffer, "%s: SPAWN_TASK %s OKAY task %d (node %d of spawn event %d)\n",
+      __func__,
+      pjob->ji_qs.ji_jobid,
+      taskid,
+      efwd->fe_node,
+      efwd->fe_event);
+
+    log_record(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buffer);
+    }
+
+  spawn_multi_result(pjob, efwd, TM_SUCCESS, taskid);
+
+  return(IM_DONE);
+  } /* END handle_im_spawn_multi_response() */
+
+
+
+
 /*
  * Sender is MOM with a good signal to report.
  *
@@ -5068,6 +5279,18 @@ void im_request(
 
           break;
 
+        case IM_SPAWN_MULTI:
+          ret = handle_im_spawn_multi_response(chan,pjob,&efwd);
+          close_conn(chan->sock, FALSE);
+          chan->sock = -1;
+          if (ret == IM_FAILURE)
+            {
+            log_err(-1, __func__, "handle_im_spawn_multi_response error");
+            goto err;
+            }
+
+          break;
+
         case IM_GET_TASKS:
           ret = handle_im_get_tasks_response(chan,pjob,event_task,event);
           close_conn(chan->sock, FALSE);
@@ -5470,7 +5693,7 @@ void im_request(
               
               job_save(pjob, SAVEJOB_QUICK, momport);
               
-              exiting_tasks = 1;
+              mark_job_exiting(pjob);
               }
             }
           else if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_INTERMEDIATE_MOM)
@@ -5553,7 +5776,7 @@ void im_request(
 
               job_save(pjob, SAVEJOB_QUICK, momport);
               
-              exiting_tasks = 1;
+              mark_job_exiting(pjob);
               }
             }
           else
@@ -5719,7 +5942,7 @@ void im_request(
               }
             
             job_save(pjob, SAVEJOB_QUICK, momport);
-            exiting_tasks = 1;
+            mark_job_exiting(pjob);
             }
          
          break;
@@ -5758,6 +5981,25 @@ void im_request(
           DIS_tcp_wflush(ptask->ti_chan);
           
           break;
+
+        case IM_SPAWN_MULTI:
+
+          if (LOGLEVEL >= 7)
+            {
+            snprintf(log_buffer,sizeof(log_buffer),
+              "%s: SPAWN_TASK %s node %d of spawn event %d returned ERROR %d\n",
+              __func__,
+              jobid,
+              efwd.fe_node,
+              efwd.fe_event,
+              errcode);
+
+            log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,jobid,log_buffer);
+            }
+
+          spawn_multi_result(pjob, &efwd, errcode, TM_NULL_TASK);
+
+          break;
           
         case IM_POLL_JOB:
           
@@ -6055,9 +6297,9 @@ int tm_postinfo(
 
 
 /*
- * tm_spawn_request
+ * tm_read_spawn_args
  *
- * Spawn a task on the requested node.
+ * Read the command and environment of a spawn request.
  *
  * read (
  * argc  int;
@@ -6068,52 +6310,30 @@ int tm_postinfo(
  * ...
  * env m  string;
  * )
+ *
+ * envp is left with room for one more variable.
+ *
+ * @return the number of environment variables read or -1 on failure,
+ * with *ret still DIS_SUCCESS if the failure was not a read error.
  */
- 
-int tm_spawn_request(
-    
-  struct tcp_chan *chan,
-  job       *pjob,        /* I */
-  int        prev_error,  /* I */
-  int        event,       /* I */
-  char       *cookie,     /* I */
-  int        *reply_ptr,  /* O */
-  int        *ret,        /* O */
-  tm_task_id  fromtask,   /* I */
-  hnodent    *phost,      /* M */
-  int         nodeid)     /* I */
- 
+
+static int tm_read_spawn_args(
+
+  struct tcp_chan   *chan,   /* I */
+  char            ***argvp,  /* O */
+  char            ***envpp,  /* O */
+  int               *ret)    /* O */
+
   {
-  char         **argv = NULL;
-  char         **envp = NULL;
-  char          *jobid = pjob->ji_qs.ji_jobid;
- 
-  int            local_socket;
-  struct tcp_chan *local_chan = NULL;
-  int            numele;
-  int            i;
-  unsigned int   momport = 0;
- 
-  vnodent       *pnode;
-  tm_task_id     taskid;
-  task          *ptask;
-  eventent      *ep;
- 
-  if (LOGLEVEL >= 7)
-    {
-    snprintf(log_buffer,sizeof(log_buffer),
-      "%s: SPAWN %s on node %d\n",
-      __func__,
-      jobid,
-      nodeid);
-    
-    log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,jobid,log_buffer);
-    }
-  
+  char **argv;
+  char **envp;
+  int    numele;
+  int    i;
+
   numele = disrui(chan, ret);
   
   if (*ret != DIS_SUCCESS)
-    return(TM_DONE);
+    return(-1);
   
   argv = (char **)calloc(numele + 1, sizeof(char **));
   
@@ -6121,7 +6341,7 @@ int tm_spawn_request(
     {
     log_err(ENOMEM, __func__, "No memory available, cannot calloc!");
     
-    return(TM_ERROR);
+    return(-1);
     }
   
   for (i = 0;i < numele;i++)
@@ -6132,7 +6352,7 @@ int tm_spawn_request(
       {
       arrayfree(argv);
       
-      return(TM_DONE);
+      return(-1);
       }
     }
   
@@ -6145,8 +6365,10 @@ int tm_spawn_request(
   if (envp == NULL)
     {
     log_err(ENOMEM, __func__, "No memory available, cannot calloc!");
+
+    arrayfree(argv);
     
-    return(TM_ERROR);
+    return(-1);
     }
   
   for (i = 0;;i++)
@@ -6162,7 +6384,7 @@ int tm_spawn_request(
       arrayfree(argv);
       arrayfree(envp);
       
-      return(TM_DONE);
+      return(-1);
       }
     
     if (env == NULL)
@@ -6194,39 +6416,252 @@ int tm_spawn_request(
     
     envp[i+1] = NULL;
     }
+
+  *ret = DIS_SUCCESS;
+
+  *argvp = argv;
+  *envpp = envp;
+
+  return(i);
+  } /* END tm_read_spawn_args() */
+
+
+
+
+
+/*
+ * spawn_local_task
+ *
+ * Start a task of the job on this node for a tm spawn.
+ *
+ * @return the task, or NULL if it could not be started
+ */
+
+static task *spawn_local_task(
+
+  job         *pjob,      /* I */
+  tm_task_id   fromtask,  /* I */
+  char       **argv,      /* I */
+  char       **envp)      /* I */
+
+  {
+  task *ptask;
+
+  ptask = pbs_task_create(pjob, TM_NULL_TASK);
   
-  /* tack on PBS_VNODENUM */
+  if (ptask == NULL)
+    return(NULL);
+
+  strcpy(ptask->ti_qs.ti_parentjobid, pjob->ji_qs.ji_jobid);
   
-  envp[i] = calloc(MAXLINE, sizeof(char));
+  ptask->ti_qs.ti_parentnode = pjob->ji_nodeid;
+  ptask->ti_qs.ti_parenttask = fromtask;
   
-  if (envp[i] == NULL)
+  if (LOGLEVEL >= 6)
     {
     log_record(
       PBSEVENT_ERROR,
       PBS_EVENTCLASS_JOB,
       pjob->ji_qs.ji_jobid,
-      "cannot alloc env memory)");
- 
-    arrayfree(argv);
-    arrayfree(envp);
-    
-    return(TM_DONE);
+      "saving task (TM_SPAWN)");
     }
   
-  sprintf(envp[i], "PBS_VNODENUM=%d", nodeid);
-  
-  i++;
-  
-  envp[i] = NULL;
- 
-  *ret = DIS_SUCCESS;
-  
-  if (prev_error)
-    {
-    arrayfree(argv);
-    arrayfree(envp);
-    
-    return(TM_DONE);
+  if (task_save(ptask) == -1)
+    return(NULL);
+
+  if (start_process(ptask, argv, envp) == -1)
+    return(NULL);
+
+  return(ptask);
+  } /* END spawn_local_task() */
+
+
+
+
+
+/*
+ * send_spawn_task
+ *
+ * Send an IM_SPAWN_TASK request to a sister.  The caller has allocated
+ * the event the sister's reply will be matched to.
+ *
+ * @return a DIS code, or -1 if the sister could not be contacted
+ */
+
+static int send_spawn_task(
+
+  job         *pjob,      /* I */
+  char        *cookie,    /* I */
+  hnodent     *phost,     /* I */
+  tm_event_t   event,     /* I */
+  tm_task_id   fromtask,  /* I */
+  tm_task_id   taskid,    /* I */
+  char       **argv,      /* I */
+  char       **envp)      /* I */
+
+  {
+  int              local_socket;
+  struct tcp_chan *local_chan;
+  int              ret;
+  int              i;
+
+  local_socket = tcp_connect_sockaddr((struct sockaddr *)&phost->sock_addr,sizeof(phost->sock_addr));
+  
+  if (IS_VALID_STREAM(local_socket) == FALSE)
+    return(-1);
+  
+  if ((local_chan = DIS_tcp_setup(local_socket)) == NULL)
+    {
+    close(local_socket);
+
+    return(DIS_NOMALLOC);
+    }
+
+  if ((ret = im_compose(local_chan,pjob->ji_qs.ji_jobid,cookie,IM_SPAWN_TASK,event,fromtask)) == DIS_SUCCESS)
+    {
+    if ((ret = diswui(local_chan, pjob->ji_nodeid)) == DIS_SUCCESS)
+      {
+      if ((ret = diswui(local_chan, taskid)) == DIS_SUCCESS)
+        {
+        if ((ret = diswst(local_chan, pjob->ji_globid)) == DIS_SUCCESS)
+          {
+          for (i = 0;argv[i];i++)
+            {
+            ret = diswst(local_chan, argv[i]);
+
+            if (ret != DIS_SUCCESS)
+              break;
+            }
+
+          if (ret == DIS_SUCCESS)
+            {
+            if ((ret = diswst(local_chan, "")) == DIS_SUCCESS)
+              {
+              for (i = 0;envp[i];i++)
+                {
+                ret = diswst(local_chan, envp[i]);
+
+                if (ret != DIS_SUCCESS)
+                  break;
+                }
+
+              if (ret == DIS_SUCCESS)
+                ret = DIS_tcp_wflush(local_chan);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  if (ret != DIS_SUCCESS)
+    {
+    snprintf(log_buffer,sizeof(log_buffer),
+      "Unable to send IM_SPAWN_TASK request to node %s for job %s",
+      phost->hn_host,
+      pjob->ji_qs.ji_jobid);
+
+    log_err(-1, __func__, log_buffer);
+    }
+
+  close(local_socket);
+  DIS_tcp_cleanup(local_chan);
+
+  return(ret);
+  } /* END send_spawn_task() */
+
+
+
+
+
+/*
+ * tm_spawn_request
+ *
+ * Spawn a task on the requested node.
+ *
+ * read (
+ * argc  int;
+ * arg 0  string;
+ * ...
+ * arg argc-1 string;
+ * env 0  string;
+ * ...
+ * env m  string;
+ * )
+ */
+ 
+int tm_spawn_request(
+    
+  struct tcp_chan *chan,
+  job       *pjob,        /* I */
+  int        prev_error,  /* I */
+  int        event,       /* I */
+  char       *cookie,     /* I */
+  int        *reply_ptr,  /* O */
+  int        *ret,        /* O */
+  tm_task_id  fromtask,   /* I */
+  hnodent    *phost,      /* M */
+  int         nodeid)     /* I */
+ 
+  {
+  char         **argv = NULL;
+  char         **envp = NULL;
+  char          *jobid = pjob->ji_qs.ji_jobid;
+ 
+  int            local_socket;
+  struct tcp_chan *local_chan = NULL;
+  int            i;
+  unsigned int   momport = 0;
+ 
+  vnodent       *pnode;
+  tm_task_id     taskid;
+  task          *ptask;
+  eventent      *ep;
+ 
+  if (LOGLEVEL >= 7)
+    {
+    snprintf(log_buffer,sizeof(log_buffer),
+      "%s: SPAWN %s on node %d\n",
+      __func__,
+      jobid,
+      nodeid);
+    
+    log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,jobid,log_buffer);
+    }
+  
+  if ((i = tm_read_spawn_args(chan, &argv, &envp, ret)) < 0)
+    return((*ret != DIS_SUCCESS) ? TM_DONE : TM_ERROR);
+  
+  /* tack on PBS_VNODENUM */
+  
+  envp[i] = calloc(MAXLINE, sizeof(char));
+  
+  if (envp[i] == NULL)
+    {
+    log_record(
+      PBSEVENT_ERROR,
+      PBS_EVENTCLASS_JOB,
+      pjob->ji_qs.ji_jobid,
+      "cannot alloc env memory)");
+ 
+    arrayfree(argv);
+    arrayfree(envp);
+    
+    return(TM_DONE);
+    }
+  
+  sprintf(envp[i], "PBS_VNODENUM=%d", nodeid);
+  
+  i++;
+  
+  envp[i] = NULL;
+ 
+  if (prev_error)
+    {
+    arrayfree(argv);
+    arrayfree(envp);
+    
+    return(TM_DONE);
     }
   
   /*
@@ -6240,44 +6675,17 @@ int tm_spawn_request(
     {
     /* XXX */
  
-    i = TM_ERROR;
-    
-    ptask = pbs_task_create(pjob, TM_NULL_TASK);
-    
-    if (ptask != NULL)
-      {
-      strcpy(ptask->ti_qs.ti_parentjobid, jobid);
-      
-      ptask->ti_qs.ti_parentnode = pjob->ji_nodeid;
-      ptask->ti_qs.ti_parenttask = fromtask;
-      
-      if (LOGLEVEL >= 6)
-         {
-        log_record(
-          PBSEVENT_ERROR,
-          PBS_EVENTCLASS_JOB,
-          pjob->ji_qs.ji_jobid,
-          "saving task (TM_SPAWN)");
-         }
-      
-      if (task_save(ptask) != -1)
-        {
-        *ret = start_process(ptask, argv, envp);
- 
-        if (*ret != -1)
-          i = TM_OKAY;
-        }
-      }
+    ptask = spawn_local_task(pjob, fromtask, argv, envp);
     
     arrayfree(argv);
     arrayfree(envp);
     
-    *ret = tm_reply(chan, i, event);
+    *ret = tm_reply(chan, (ptask == NULL) ? TM_ERROR : TM_OKAY, event);
     
     if (*ret != DIS_SUCCESS)
       return(TM_DONE);
     
-    *ret = diswsi(chan, ((i == TM_ERROR) ?  TM_ESYSTEM : ptask->ti_qs.ti_task));
+    *ret = diswsi(chan, ((ptask == NULL) ?  TM_ESYSTEM : ptask->ti_qs.ti_task));
     
     return(TM_DONE);
     }  /* END if ((pjob->ji_nodeid == 0) && (pjob->ji_nodeid == nodeid)) */
@@ -6343,84 +6751,267 @@ int tm_spawn_request(
     }
   
   job_save(pjob, SAVEJOB_FULL, momport);
-  
-  local_socket = tcp_connect_sockaddr((struct sockaddr *)&phost->sock_addr,sizeof(phost->sock_addr));
-  
-  if (IS_VALID_STREAM(local_socket) == FALSE)
+
+  i = send_spawn_task(pjob, cookie, phost, event, fromtask, taskid, argv, envp);
+
+  arrayfree(argv);
+  arrayfree(envp);
+
+  if (i != DIS_SUCCESS)
+    {
+    /* the sister will never answer, fail the spawn now */
+
+    delete_link(&ep->ee_next);
+    free(ep);
+
+    if ((*ret = tm_reply(chan, TM_ERROR, event)) == DIS_SUCCESS)
+      *ret = diswsi(chan, TM_ENOTCONNECTED);
+
     return(TM_DONE);
-  
-  if ((local_chan = DIS_tcp_setup(local_socket)) == NULL)
+    }
+
+  *reply_ptr = FALSE;
+ 
+  return(TM_DONE);
+  } /* END tm_spawn_request() */
+
+
+
+
+
+/*
+ * tm_spawn_multi_request
+ *
+ * Spawn a task on each node of a list and answer with every node's result
+ * at once.  Only mother superior handles the request: local nodes are
+ * started directly and each sister gets its IM_SPAWN_TASK without waiting
+ * for the others, the reply goes out when the last sister has answered.
+ *
+ * read (
+ * count  int;
+ * node 0  int;
+ * ...
+ * node count-1 int;
+ * argc  int;
+ * arg 0  string;
+ * ...
+ * env m  string;
+ * )
+ */
+
+int tm_spawn_multi_request(
+
+  struct tcp_chan *chan,
+  job        *pjob,        /* I */
+  int         event,       /* I */
+  char       *cookie,      /* I */
+  int        *reply_ptr,   /* O */
+  int        *ret,         /* O */
+  tm_task_id  fromtask)    /* I */
+
+  {
+  char          **argv = NULL;
+  char          **envp = NULL;
+  char           *jobid = pjob->ji_qs.ji_jobid;
+  int             count;
+  int             envc;
+  int             i;
+  int             j;
+  unsigned int    momport = 0;
+  tm_node_id     *nodes;
+  hnodent       **hosts;
+  spawn_multi    *sm;
+  task           *ptask;
+  eventent       *ep;
+
+  count = disrsi(chan, ret);
+
+  if (*ret != DIS_SUCCESS)
+    return(TM_DONE);
+
+  if ((count <= 0) || (count > TM_SPAWN_MULTI_MAX))
     {
+    sprintf(log_buffer, "bad node count %d in SPAWN_MULTI for job %s",
+      count,
+      jobid);
+
+    log_err(-1, __func__, log_buffer);
+
+    return(TM_ERROR);
+    }
+
+  if (LOGLEVEL >= 7)
+    {
+    snprintf(log_buffer,sizeof(log_buffer),
+      "%s: SPAWN_MULTI %s on %d nodes\n",
+      __func__,
+      jobid,
+      count);
+    
+    log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,jobid,log_buffer);
+    }
+
+  nodes = (tm_node_id *)calloc(count, sizeof(tm_node_id));
+  hosts = (hnodent **)calloc(count, sizeof(hnodent *));
+  sm = (spawn_multi *)calloc(1, sizeof(spawn_multi));
+
+  if ((nodes == NULL) ||
+      (hosts == NULL) ||
+      (sm == NULL) ||
+      ((sm->sm_errors = (int *)calloc(count, sizeof(int))) == NULL) ||
+      ((sm->sm_tids = (tm_task_id *)calloc(count, sizeof(tm_task_id))) == NULL))
+    {
+    log_err(ENOMEM, __func__, "No memory available, cannot calloc!");
+
+    if (sm != NULL)
+      free_spawn_multi(sm);
+
+    free(nodes);
+    free(hosts);
+
+    return(TM_ERROR);
+    }
+
+  snprintf(sm->sm_jobid, sizeof(sm->sm_jobid), "%s", jobid);
+  sm->sm_fromtask = fromtask;
+  sm->sm_event = event;
+  sm->sm_count = count;
+
+  for (i = 0;i < count;i++)
+    {
+    nodes[i] = disrsi(chan, ret);
+
+    if (*ret != DIS_SUCCESS)
+      break;
+    }
+
+  if ((i < count) ||
+      ((envc = tm_read_spawn_args(chan, &argv, &envp, ret)) < 0) ||
+      ((envp[envc] = calloc(MAXLINE, sizeof(char))) == NULL))
+    {
+    if (envp != NULL)
+      {
+      arrayfree(argv);
+      arrayfree(envp);
+      }
+
+    free_spawn_multi(sm);
+    free(nodes);
+    free(hosts);
+
+    return((*ret != DIS_SUCCESS) ? TM_DONE : TM_ERROR);
     }
-  else if ((*ret = im_compose(local_chan,jobid,cookie,IM_SPAWN_TASK,event,fromtask)) != DIS_SUCCESS)
+
+  envp[envc + 1] = NULL;
+
+  if (pjob->ji_nodeid != 0)
     {
+    /* sisters do not know the other nodes' tasks, only MS can do this */
+
+    if ((*ret = tm_reply(chan, TM_ERROR, event)) == DIS_SUCCESS)
+      *ret = diswsi(chan, TM_ENOTIMPLEMENTED);
     }
   else
     {
-    if (*ret == DIS_SUCCESS)
+    /* find every node and number the remote tasks before anything starts */
+
+    for (i = 0;i < count;i++)
       {
-      if ((*ret = diswui(local_chan, pjob->ji_nodeid)) == DIS_SUCCESS)
+      for (j = 0;j < pjob->ji_numvnod;j++)
         {
-        if ((*ret = diswui(local_chan, taskid)) == DIS_SUCCESS)
-          {
-          if ((*ret = diswst(local_chan, pjob->ji_globid)) == DIS_SUCCESS)
-            {
-            for (i = 0;argv[i];i++)
-              {
-              *ret = diswst(local_chan, argv[i]);
+        if (pjob->ji_vnods[j].vn_node == nodes[i])
+          break;
+        }
 
-              if (*ret != DIS_SUCCESS)
-                break;
-              }
+      if (j == pjob->ji_numvnod)
+        {
+        sm->sm_errors[i] = TM_ENOTFOUND;
 
-            if (*ret == DIS_SUCCESS)
-              {
-              if ((*ret = diswst(local_chan, "")) == DIS_SUCCESS)
-                {
-                for (i = 0;envp[i];i++)
-                  {
-                  *ret = diswst(local_chan, envp[i]);
+        continue;
+        }
 
-                  if (*ret != DIS_SUCCESS)
-                    break;
-                  }
+      sm->sm_errors[i] = TM_SUCCESS;
 
-                if (*ret == DIS_SUCCESS)
-                  *ret = DIS_tcp_wflush(local_chan);
+#ifndef NUMA_SUPPORT
+      if (nodes[i] != 0)
+        {
+        hosts[i] = pjob->ji_vnods[j].vn_host;
+        sm->sm_tids[i] = pjob->ji_taskid++;
+        }
+#endif /* ndef NUMA_SUPPORT */
+      }
 
-                *reply_ptr = FALSE;
-                }
-              }
-            }
-          }
+    if (multi_mom)
+      {
+      momport = pbs_rm_port;
+      }
+
+    job_save(pjob, SAVEJOB_FULL, momport);
+
+    for (i = 0;i < count;i++)
+      {
+      if (sm->sm_errors[i] != TM_SUCCESS)
+        continue;
+
+      sprintf(envp[envc], "PBS_VNODENUM=%d", nodes[i]);
+
+      if (hosts[i] == NULL)
+        {
+        if ((ptask = spawn_local_task(pjob, fromtask, argv, envp)) != NULL)
+          sm->sm_tids[i] = ptask->ti_qs.ti_task;
+        else
+          sm->sm_errors[i] = TM_ESYSTEM;
+
+        continue;
         }
+
+      ep = event_alloc(IM_SPAWN_MULTI, hosts[i], TM_NULL_EVENT, fromtask);
+
+      ep->ee_forward.fe_node = i;
+      ep->ee_forward.fe_event = event;
+      ep->ee_forward.fe_taskid = fromtask;
+
+      if (send_spawn_task(pjob, cookie, hosts[i], ep->ee_event, fromtask, sm->sm_tids[i], argv, envp) != DIS_SUCCESS)
+        {
+        delete_link(&ep->ee_next);
+        free(ep);
+
+        sm->sm_errors[i] = TM_ENOTCONNECTED;
+        sm->sm_tids[i] = TM_NULL_TASK;
+
+        continue;
+        }
+
+      sm->sm_outstanding++;
       }
-    }
 
-  if (*ret != DIS_SUCCESS)
-    {
-    snprintf(log_buffer,sizeof(log_buffer),
-      "Unable to send IM_SPAWN_TASK request to node %s for job %s",
-      phost->hn_host,
-      pjob->ji_qs.ji_jobid);
+    if (sm->sm_outstanding > 0)
+      {
+      /* the last sister's answer sends the reply */
 
-    log_err(-1, __func__, log_buffer);
+      sm->sm_next = spawn_multis;
+      spawn_multis = sm;
+      sm = NULL;
 
-    /* NYI: shouldn't we kill the job here instead of letting it run forever?? */
+      *reply_ptr = FALSE;
+      }
+    else
+      {
+      *ret = send_spawn_multi_reply(chan, sm);
+      }
     }
-  
-  close(local_socket);
-  if (local_chan != NULL)
-    DIS_tcp_cleanup(local_chan);
-  
-  if (argv != NULL)
-    arrayfree(argv);
- 
-  if (envp != NULL)
-    arrayfree(envp);
- 
+
+  arrayfree(argv);
+  arrayfree(envp);
+
+  if (sm != NULL)
+    free_spawn_multi(sm);
+
+  free(nodes);
+  free(hosts);
+
   return(TM_DONE);
-  } /* END tm_spawn_request() */
+  } /* END tm_spawn_multi_request() */
 
 
 
@@ -7335,6 +7926,21 @@ int tm_request(
  
       break;
  
+    case TM_SPAWN_MULTI:
+
+      /* carries its own list of nodes */
+
+      rc = tm_spawn_multi_request(ptask->ti_chan,pjob,event,cookie,&reply,&ret,fromtask);
+
+      if (rc == TM_ERROR)
+        goto err;
+
+      goto tm_req_finish;
+
+      /*NOTREACHED*/
+
+      break;
+ 
     case TM_FINALIZE:
  
       DIS_tcp_wflush(ptask->ti_chan);
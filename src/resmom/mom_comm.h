@@ -82,6 +82,12 @@ int handle_im_kill_job_response(struct tcp_chan *chan, job *pjob, hnodent *np, i
 
 int handle_im_spawn_task_response(struct tcp_chan *chan, job *pjob, tm_task_id event_task, tm_event_t event);
 
+void spawn_multi_purge(job *pjob);
+
+void spawn_multi_result(job *pjob, fwdevent *efwd, int error, tm_task_id taskid);
+
+int handle_im_spawn_multi_response(struct tcp_chan *chan, job *pjob, fwdevent *efwd);
+
 int handle_im_signal_task_response(job *pjob, tm_task_id event_task, tm_event_t event);
 
 int handle_im_get_tasks_response(struct tcp_chan *chan, job *pjob, tm_task_id event_task, tm_event_t event);
@@ -106,6 +112,8 @@ int tm_postinfo(char *name, char *info, char *jobid, int fromtask, int prev_erro
 
 int tm_spawn_request(struct tcp_chan *chan, job *pjob, int prev_error, int event, char *cookie, int *reply_ptr, int *ret, tm_task_id fromtask, hnodent *phost, int nodeid);
 
+int tm_spawn_multi_request(struct tcp_chan *chan, job *pjob, int event, char *cookie, int *reply_ptr, int *ret, tm_task_id fromtask);
+
 int tm_tasks_request(struct tcp_chan *chan, job *pjob, int prev_error, int event, char *cookie, int *reply_ptr, int *ret, tm_task_id fromtask, hnodent *phost, int nodeid);
 
 int tm_signal_request(struct tcp_chan *chan, job *pjob, int prev_error, int event, char *cookie, tm_task_id fromtask, int *ret, int *reply_ptr, hnodent *phost, int nodeid);
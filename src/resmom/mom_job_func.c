@@ -135,6 +135,7 @@
 #include "threadpool.h"
 #include "alps_functions.h"
 #include "dis.h"
+#include "mom_comm.h" /* spawn_multi_purge */
 
 #ifndef TRUE
 #define TRUE 1
@@ -493,6 +494,7 @@ job *job_alloc(void)
 
   CLEAR_LINK(pj->ji_alljobs);
   CLEAR_LINK(pj->ji_jobque);
+  CLEAR_LINK(pj->ji_exitque);
 
   CLEAR_HEAD(pj->ji_tasks);
   pj->ji_taskid = TM_NULL_TASK + 1;
@@ -861,9 +863,13 @@ void mom_job_purge(
   else
     delete_job_files(jfdi);
 
+  /* tm_spawn_multi() calls still waiting on sisters will never be answered */
+  spawn_multi_purge(pjob);
+
   /* remove this job from the global queue */
   delete_link(&pjob->ji_jobque);
   delete_link(&pjob->ji_alljobs);
+  delete_link(&pjob->ji_exitque);
 
   if (LOGLEVEL >= 6)
     {
@@ -181,6 +181,7 @@ uid_t pbsuser;
 unsigned int pbs_mom_port = 0;
 unsigned int pbs_rm_port = 0;
 tlist_head mom_polljobs; /* jobs that must have resource limits polled */
+tlist_head mom_exiting_jobs; /* jobs with newly exited tasks, see mark_job_exiting() */
 tlist_head svr_newjobs; /* jobs being sent to MOM */
 tlist_head svr_alljobs; /* all jobs under MOM's control */
 tlist_head mom_varattrs; /* variable attributes */
@@ -194,6 +195,7 @@ extern struct var_table vtable; /* see start_exec.c */
 double  wallfactor = 1.00;
 long  log_file_max_size = 0;
 long  log_file_roll_depth = 1;
+int   log_file_index = FALSE;
 
 time_t          last_log_check;
 char           *nodefile_suffix = NULL;    /* suffix to append to each host listed in job host file */
@@ -369,6 +371,7 @@ static unsigned long setcheckpolltime(char *);
 static unsigned long settmpdir(char *);
 static unsigned long setlogfilemaxsize(char *);
 static unsigned long setlogfilerolldepth(char *);
+static unsigned long setlogfileindex(char *);
 static unsigned long setlogfilesuffix(char *);
 static unsigned long setlogdirectory(char *);
 static unsigned long setlogkeepdays(char *);
@@ -448,6 +451,7 @@ static struct specials
   { "log_directory",       setlogdirectory },
   { "log_file_max_size",   setlogfilemaxsize },
   { "log_file_roll_depth", setlogfilerolldepth },
+  { "log_file_index",      setlogfileindex },
   { "log_file_suffix",     setlogfilesuffix },
   { "log_keep_days",       setlogkeepdays },
   { "varattr",             setvarattr },
@@ -518,7 +522,7 @@ int                     DEBUGMODE = 0;
 int                     DOBACKGROUND = 1;
 char                    DEFAULT_UMASK[1024];
 char                    PRE_EXEC[1024];
-long                    TJobStartBlockTime = 5; /* seconds to wait for job to launch before backgrounding */
+long                    TJobStartBlockTime = 0; /* seconds to wait for job to launch before backgrounding */
 long                    TJobStartTimeout = 300; /* seconds to wait for job to launch before purging */
 
 
@@ -661,11 +665,13 @@ extern void dep_cleanup(void);
 /* External Functions */
 
 extern void catch_child(int);
+extern int init_child_wakeup(void);
 extern void init_abort_jobs(int);
 extern void scan_for_exiting();
 extern void scan_for_terminated();
 extern int TMomCheckJobChild(pjobexec_t *, int, int *, int *);
 extern int TMomFinalizeJob3(pjobexec_t *, int, int, int *);
+extern void close_job_start_pipe(pjobexec_t *);
 extern void exec_bail(job *, int);
 extern void check_state(int);
 
@@ -2892,6 +2898,23 @@ static unsigned long setlogfilerolldepth(
 
 
 
+static unsigned long setlogfileindex(
+
+  char *value)  /* I */
+
+  {
+  int enable;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, "log_file_index", value);
+
+  if ((enable = setbool(value)) != -1)
+    log_file_index = enable;
+
+  return(1);
+  }  /* END setlogfileindex() */
+
+
+
 static unsigned long setlogdirectory(
 
   char *value)  /* I */
@@ -3761,6 +3784,8 @@ int read_config(
       }
     }
 
+  log_set_index(log_file_index);
+
   return(rc);
   }  /* END read_config() */
 
@@ -4238,6 +4263,7 @@ static void process_hup(void)
   pthread_mutex_unlock(log_mutex);
   log_file_max_size = 0;
   log_file_roll_depth = 1;
+  log_file_index = FALSE;
 #ifdef PENABLE_LINUX26_CPUSETS
   memory_pressure_threshold = 0;
   memory_pressure_duration  = 0;
@@ -6504,6 +6530,7 @@ void initialize_globals(void)
   CLEAR_HEAD(svr_newjobs);
   CLEAR_HEAD(svr_alljobs);
   CLEAR_HEAD(mom_polljobs);
+  CLEAR_HEAD(mom_exiting_jobs);
   CLEAR_HEAD(svr_requests);
   CLEAR_HEAD(mom_varattrs);
 
@@ -7380,6 +7407,11 @@ int setup_program_environment(void)
 
 #endif /* DEBUG */
 
+  /* wake up wait_request() as soon as a child exits. This is done after
+   * going into the background so the pid catch_child() checks is ours */
+
+  init_child_wakeup();
+
   /* write MOM's pid into lockfile */
 
   if (ftruncate(lockfds, (off_t)0) != 0)
@@ -7837,7 +7869,9 @@ int TMOMScanForStarting(void)
 
       /* check if job is ready */
 
-      if (TMomCheckJobChild(TJE, 1, &Count, &RC) == FAILURE)
+      /* the starter pipe wakes wait_request(), so never block here */
+
+      if (TMomCheckJobChild(TJE, 0, &Count, &RC) == FAILURE)
         {
         long STime;
 
@@ -7869,6 +7903,8 @@ int TMOMScanForStarting(void)
             pjob->ji_qs.ji_jobid,
             log_buffer);
 
+          close_job_start_pipe(TJE);
+
           memset(TJE, 0, sizeof(pjobexec_t));
 
           exec_bail(pjob, JOB_EXEC_RETRY);
@@ -8092,7 +8128,7 @@ void examine_all_running_jobs(void)
 
           task_save(ptask);
 
-          exiting_tasks = 1;
+          mark_job_exiting(pjob);
           }  /* END if ((kill == -1) && ...) */
         }    /* END while (ptask != NULL) */
       }      /* END if (pjob->ji_flags & MOM_NO_PROC) */
@@ -8222,7 +8258,8 @@ void kill_all_running_jobs(void)
 #endif
     scan_for_terminated();
 
-  if (exiting_tasks)
+  if ((exiting_tasks) ||
+      (GET_NEXT(mom_exiting_jobs) != NULL))
     scan_for_exiting();
 
   return;
@@ -8423,7 +8460,8 @@ void main_loop(void)
       recover = JOB_RECOV_RUNNING;
       }
 
-    if (exiting_tasks)
+    if ((exiting_tasks) ||
+        (GET_NEXT(mom_exiting_jobs) != NULL))
       scan_for_exiting();
 
     check_exiting_jobs();
@@ -8437,14 +8475,24 @@ void main_loop(void)
 
     time_now = time((time_t *)0);
 
-    tmpTime = MIN(wait_time, time_now - (LastServerUpdateTime + ServerStatUpdateInterval));
+    if ((GET_NEXT(svr_alljobs) != NULL) ||
+        (things_to_resend->num > 0) ||
+        (LastServerUpdateTime == 0))
+      {
+      /* starting jobs, exiting jobs and resends are still polled */
+      tmpTime = 1;
+      }
+    else
+      {
+      /* idle - sleep until the next status update is due. Child exits
+       * and incoming requests wake wait_request() up early. */
 
-    tmpTime = MIN(tmpTime, time_now - (last_poll_time + CheckPollTime));
+      tmpTime = MIN(wait_time, (LastServerUpdateTime + ServerStatUpdateInterval) - time_now);
 
-    tmpTime = MAX(1, tmpTime);
+      tmpTime = MIN(tmpTime, (last_log_check + PBS_LOG_CHECK_RATE) - time_now);
 
-    if (LastServerUpdateTime == 0)
-      tmpTime = 1;
+      tmpTime = MAX(1, tmpTime);
+      }
 
     resend_things();
 
@@ -95,6 +95,7 @@ void req_jobcredential(struct batch_request *preq);
 void req_jobscript(struct batch_request *preq);
 void req_rdytocommit(struct batch_request *preq);
 void req_commit(struct batch_request *preq);
+int  req_submitjob(struct batch_request *preq);
 void mom_req_holdjob(struct batch_request *preq);
 void req_deletejob(struct batch_request *preq);
 void req_rerunjob(struct batch_request *preq);
@@ -345,6 +346,15 @@ void mom_dispatch_request(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      net_add_close_func(sfds, close_quejob);
+
+      if (req_submitjob(request) == PBSE_NONE)
+        net_add_close_func(sfds, NULL);
+
+      break;
+
     case PBS_BATCH_DeleteJob:
 
       req_deletejob(request);
@@ -595,6 +605,15 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      free_attrlist(&preq->rq_ind.rq_queuejob.rq_attr);
+
+      if (preq->rq_ind.rq_queuejob.rq_script)
+        free(preq->rq_ind.rq_queuejob.rq_script);
+
+      break;
+
     case PBS_BATCH_JobCred:
 
       if (preq->rq_ind.rq_jobcred.rq_data)
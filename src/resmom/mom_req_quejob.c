@@ -1122,6 +1122,187 @@ void req_commit(
 
 
 
+/*
+ * alloc_submit_step - allocate the request for one step of a SubmitJob
+ */
+
+static struct batch_request *alloc_submit_step(
+
+  struct batch_request *preq,  /* I */
+  int                   type)  /* I */
+
+  {
+  struct batch_request *pstep;
+
+  if ((pstep = alloc_br(type)) == NULL)
+    return(NULL);
+
+  pstep->rq_perm     = preq->rq_perm;
+  pstep->rq_fromsvr  = preq->rq_fromsvr;
+  pstep->rq_conn     = preq->rq_conn;
+  pstep->rq_orgconn  = preq->rq_orgconn;
+  pstep->rq_compound = TRUE;
+
+  strcpy(pstep->rq_user, preq->rq_user);
+  strcpy(pstep->rq_host, preq->rq_host);
+
+  return(pstep);
+  }  /* END alloc_submit_step() */
+
+
+
+
+/*
+ * finish_submit_step - answer a step of a SubmitJob if it failed
+ *
+ * The step's handler has filled in the reply but left the request to us.
+ * A failed step is answered (and ends the SubmitJob), a successful one is
+ * only freed.
+ *
+ * Returns the step's reply code
+ */
+
+static int finish_submit_step(
+
+  struct batch_request *pstep)  /* I (freed) */
+
+  {
+  int rc = pstep->rq_reply.brp_code;
+
+  if (rc != PBSE_NONE)
+    {
+    pstep->rq_compound = FALSE;
+
+    reply_send_mom(pstep);
+    }
+  else
+    {
+    free_br(pstep);
+    }
+
+  return(rc);
+  }  /* END finish_submit_step() */
+
+
+
+
+/*
+ * req_submitjob - start a job sent by pbs_server as one SubmitJob request
+ *
+ * Queue Job, Job Script, Ready To Commit and Commit in one request.  Each
+ * step goes through its usual handler and only the commit reply (or the
+ * first failure) is sent back, so a job start costs the server a single
+ * round trip.
+ *
+ * Returns PBSE_NONE if the job was committed
+ */
+
+int req_submitjob(
+
+  struct batch_request *preq)  /* I (freed) */
+
+  {
+  struct batch_request *preq_script;
+  struct batch_request *preq_rdy;
+  struct batch_request *preq_commit;
+  char                  job_id[PBS_MAXSVRJOBID + 1];
+  int                   rc;
+
+  snprintf(job_id, sizeof(job_id), "%s", preq->rq_ind.rq_queuejob.rq_jid);
+
+  preq_script = alloc_submit_step(preq, PBS_BATCH_jobscript);
+  preq_rdy    = alloc_submit_step(preq, PBS_BATCH_RdytoCommit);
+  preq_commit = alloc_submit_step(preq, PBS_BATCH_Commit);
+
+  if ((preq_script == NULL) ||
+      (preq_rdy == NULL) ||
+      (preq_commit == NULL))
+    {
+    if (preq_script != NULL)
+      free_br(preq_script);
+
+    if (preq_rdy != NULL)
+      free_br(preq_rdy);
+
+    if (preq_commit != NULL)
+      free_br(preq_commit);
+
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+
+    return(PBSE_SYSTEM);
+    }
+
+  /* hand the script to the Job Script step before the request is freed */
+
+  preq_script->rq_ind.rq_jobfile.rq_type = JScript;
+  preq_script->rq_ind.rq_jobfile.rq_size = preq->rq_ind.rq_queuejob.rq_scriptsz;
+  preq_script->rq_ind.rq_jobfile.rq_data = preq->rq_ind.rq_queuejob.rq_script;
+  snprintf(preq_script->rq_ind.rq_jobfile.rq_jobid,
+    sizeof(preq_script->rq_ind.rq_jobfile.rq_jobid), "%s", job_id);
+
+  preq->rq_ind.rq_queuejob.rq_script = NULL;
+
+  snprintf(preq_rdy->rq_ind.rq_rdytocommit,
+    sizeof(preq_rdy->rq_ind.rq_rdytocommit), "%s", job_id);
+  snprintf(preq_commit->rq_ind.rq_commit,
+    sizeof(preq_commit->rq_ind.rq_commit), "%s", job_id);
+
+  /* the request itself becomes the Queue Job step */
+
+  preq->rq_type = PBS_BATCH_QueueJob;
+  preq->rq_compound = TRUE;
+
+  req_quejob(preq);
+
+  if ((rc = finish_submit_step(preq)) == PBSE_NONE)
+    {
+    if (preq_script->rq_ind.rq_jobfile.rq_size > 0)
+      {
+      req_jobscript(preq_script);
+
+      rc = finish_submit_step(preq_script);
+      }
+    else
+      free_br(preq_script);
+
+    preq_script = NULL;
+
+    if (rc == PBSE_NONE)
+      {
+      req_rdytocommit(preq_rdy);
+
+      rc = finish_submit_step(preq_rdy);
+
+      preq_rdy = NULL;
+
+      if (rc == PBSE_NONE)
+        {
+        /* the commit always answers the server */
+
+        preq_commit->rq_compound = FALSE;
+
+        req_commit(preq_commit);
+
+        preq_commit = NULL;
+        }
+      }
+    }
+
+  if (preq_script != NULL)
+    free_br(preq_script);
+
+  if (preq_rdy != NULL)
+    free_br(preq_rdy);
+
+  if (preq_commit != NULL)
+    free_br(preq_commit);
+
+  return(rc);
+  }  /* END req_submitjob() */
+
+
+
+
 /*
  * locate_new_job - locate a "new" job which has been set up req_quejob on
  * the servers new job list.
@@ -90,6 +90,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <grp.h>
+#include <time.h>
 #include "libpbs.h"
 #include "list_link.h"
 #include "server_limits.h"
@@ -415,6 +416,8 @@ int run_pelog(
 
   char             *ptr;
 
+  time_t            pelog_start;
+
   int               moabenvcnt = 14;  /* # of entries in moabenvs */
   static char      *moabenvs[] = {
       "MOAB_NODELIST",
@@ -681,6 +684,8 @@ int run_pelog(
 
   run_exit = 0;
 
+  pelog_start = time(NULL);
+
   child = fork();
 
   if (child > 0)
@@ -1277,6 +1282,17 @@ int run_pelog(
     exit(255);
     }  /* END else () */
 
+  /* report per-script wall time so slow prologues/epilogues can be found */
+
+  snprintf(log_buffer, sizeof(log_buffer),
+    "%s script '%s' completed in %ld seconds (rc=%d)",
+    PPEType[which],
+    pelog,
+    (long)(time(NULL) - pelog_start),
+    run_exit);
+
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buffer);
+
   switch (run_exit)
     {
     case 0:
@@ -145,6 +145,7 @@ extern int mkdirtree(
     mode_t mode);
 
 extern int TMOMJobGetStartInfo(job *, pjobexec_t **) ;
+extern void close_job_start_pipe(pjobexec_t *);
 
 #endif /* HAVE_WORDEXP */
 
@@ -157,7 +158,6 @@ int resetgpuecc(char *, int, int);
 
 extern unsigned int alarm_time;
 extern unsigned int default_server_port;
-extern int  exiting_tasks;
 extern tlist_head svr_alljobs;
 extern char  mom_host[];
 extern char            *msg_err_unlink;
@@ -1142,6 +1142,9 @@ void req_deletejob(
      */
     if (TMOMJobGetStartInfo(pjob, &TJE) == SUCCESS)
       {
+      if ((TJE->jsmpipe_watched == TRUE) || (TJE->jsmpipe[0] >= 0))
+        close_job_start_pipe(TJE);
+
       memset(TJE, 0, sizeof(pjobexec_t));
       }
 
@@ -2246,7 +2249,7 @@ void req_signaljob(
     
     job_save(pjob, SAVEJOB_QUICK, momport);
 
-    exiting_tasks = 1;
+    mark_job_exiting(pjob);
     }
 
   reply_ack(preq);
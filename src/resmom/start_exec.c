@@ -189,7 +189,6 @@ extern int            attempttomakedir;
 extern int            spoolasfinalname;
 extern int            num_var_env;
 extern char         **environ;
-extern int            exiting_tasks;
 extern int            lockfds;
 extern tlist_head     mom_polljobs;
 extern char          *path_jobs;
@@ -311,6 +310,8 @@ int expand_path(job *,char *,int,char *);
 int TMomFinalizeChild(pjobexec_t *);
 
 int TMomCheckJobChild(pjobexec_t *, int, int *, int *);
+void *job_start_ready(void *);
+void close_job_start_pipe(pjobexec_t *);
 
 int InitUserEnv(job *,task *,char **,struct passwd *pwdp,char *);
 int mkdirtree(char *,mode_t);
@@ -587,7 +588,7 @@ void exec_bail(
 
   job_save(pjob, SAVEJOB_QUICK, momport);
 
-  exiting_tasks = 1;
+  mark_job_exiting(pjob);
 
   if (pjob->ji_stdout > 0)
     close(pjob->ji_stdout);
@@ -1879,6 +1880,8 @@ int TMomFinalizeJob1(
   memset(TJE, 0, sizeof(pjobexec_t));
   
   TJE->ptc = -1;
+
+  TJE->jsmpipe[0] = -1;
   
   TJE->pjob = (void *)pjob;
   
@@ -2062,7 +2065,7 @@ int TMomFinalizeJob1(
       
       pjob->ji_qs.ji_substate = JOB_SUBSTATE_EXITING;
       
-      exiting_tasks = 1;
+      mark_job_exiting(pjob);
       
       sprintf(log_buffer, "Restart failed, error %d (%s)",
         errno, pbs_strerror(errno));
@@ -2309,6 +2312,19 @@ int TMomFinalizeJob2(
 
   if (TJE->ptc >= 0)
     close(TJE->ptc);
+
+  /* wake the main loop as soon as the starter reports instead of blocking */
+
+  TJE->jsmpipe_watched = FALSE;
+
+  if (add_conn(
+        TJE->jsmpipe[0],
+        Primary,
+        (pbs_net_t)0,
+        0,
+        PBS_SOCK_UNIX,
+        job_start_ready) == PBSE_NONE)
+    TJE->jsmpipe_watched = TRUE;
   
   strcpy(buf, path_jobs);
   
@@ -4298,7 +4314,7 @@ int TMomFinalizeJob3(
 
   memcpy(&sjr, TJE->sjr, sizeof(sjr));
 
-  close(TJE->jsmpipe[0]);
+  close_job_start_pipe(TJE);
 
   if (ReadSize != sizeof(sjr))
     {
@@ -6521,6 +6537,7 @@ char *std_file_name(
   char        *pd;
   char        *suffix;
   char        *jobpath = NULL;
+  int          write_direct;
 #ifdef QSUB_KEEP_NO_OVERRIDE
   char        *pt;
   char         endpath[MAXPATHLEN + 1];
@@ -6568,6 +6585,18 @@ char *std_file_name(
     return(NULL);
     }
 
+  /* a job may opt in to writing a stream directly to its final destination
+   * by adding 'd' to its keep list along with the stream (qsub -k doe). The
+   * server skips the end of job copy for streams in the keep list. */
+
+  write_direct = spoolasfinalname;
+
+  if (((which == StdOut) || (which == StdErr)) &&
+      (pjob->ji_wattr[JOB_ATR_keep].at_flags & ATR_VFLAG_SET) &&
+      (strchr(pjob->ji_wattr[JOB_ATR_keep].at_val.at_str, 'd') != NULL) &&
+      (strchr(pjob->ji_wattr[JOB_ATR_keep].at_val.at_str, (which == StdOut) ? 'o' : 'e') != NULL))
+    write_direct = TRUE;
+
   switch (which)
     {
 
@@ -6580,16 +6609,20 @@ char *std_file_name(
         {
         jobpath = pjob->ji_wattr[JOB_ATR_outpath].at_val.at_str;
 
-        if (spoolasfinalname == TRUE)
+        if (write_direct == TRUE)
           {
           remove_leading_hostname(&jobpath);
 
+          snprintf(path, sizeof(path), "%s", jobpath);
+
           if (expand_path(pjob, jobpath, sizeof(path), path) != SUCCESS)
             {
             return(NULL);
             }
           }
         }
+      else
+        write_direct = spoolasfinalname;
 
       break;
 
@@ -6602,16 +6635,20 @@ char *std_file_name(
         {
         jobpath = pjob->ji_wattr[JOB_ATR_errpath].at_val.at_str;
 
-        if (spoolasfinalname == TRUE)
+        if (write_direct == TRUE)
           {
           remove_leading_hostname(&jobpath);
 
+          snprintf(path, sizeof(path), "%s", jobpath);
+
           if (expand_path(pjob,jobpath,sizeof(path),path) != SUCCESS)
             {
             return(NULL);
             }
           }
         }
+      else
+        write_direct = spoolasfinalname;
 
       break;
 
@@ -6625,8 +6662,9 @@ char *std_file_name(
       break;
     }   /* END switch (which) */
 
-  /* everything that changes the path here is ignored if spoolasfinalname is set
-   * to true. spoolasfinalname specifies directly spooling as the output file */
+  /* everything that changes the path here is ignored if write_direct is set
+   * to true. write_direct (spoolasfinalname or a 'd' in the keep list)
+   * specifies directly spooling as the output file */
 
   /* Is file to be kept?, if so, place the stderr/stdout files in the
    * path specified by the user. The path must be local to the execution node,
@@ -6639,7 +6677,7 @@ char *std_file_name(
     {
     /* yes, it is to be kept */
 
-    if (spoolasfinalname == FALSE)
+    if (write_direct == FALSE)
       {
       strcpy(path, pjob->ji_grpcache->gc_homedir);
 
@@ -6700,7 +6738,7 @@ char *std_file_name(
         *(path + len++) = *pd++;
 
       *(path + len) = '\0';
-      } /* END if (spoolasfinalname == FALSE) */
+      } /* END if (write_direct == FALSE) */
 
     *keeping = 1;
     }
@@ -6731,7 +6769,7 @@ char *std_file_name(
 
 #if NO_SPOOL_OUTPUT == 1
 
-    if (spoolasfinalname == FALSE)
+    if (write_direct == FALSE)
       {
       /* force all output to user's HOME */
       snprintf(path, sizeof(path), "%s", pjob->ji_grpcache->gc_homedir);
@@ -6758,11 +6796,11 @@ char *std_file_name(
 
       *keeping = 1;
 
-      } /* END if (spoolasfinalname == FALSE) */
+      } /* END if (write_direct == FALSE) */
 
 #else /* NO_SPOOL_OUTPUT */
 
-    if (spoolasfinalname == FALSE)
+    if (write_direct == FALSE)
       {
       if ((TNoSpoolDirList[0] != NULL))
         {
@@ -6828,12 +6866,12 @@ char *std_file_name(
         strncat(path, "/", sizeof(path) - strlen(path) - 1);
         }
 
-      } /* END if (spoolasfinalname == FALSE) */
+      } /* END if (write_direct == FALSE) */
 
     *keeping = 0;
 
 #endif /* NO_SPOOL_OUTPUT */
-    if (spoolasfinalname == FALSE)
+    if (write_direct == FALSE)
       {
       strncat(path, pjob->ji_qs.ji_fileprefix, (sizeof(path) - strlen(path) - 1));
 
@@ -6848,7 +6886,7 @@ char *std_file_name(
 
         log_ext(-1, __func__, log_buffer, LOG_DEBUG);
         }
-      } /* END if (spoolasfinalname == FALSE) */
+      } /* END if (write_direct == FALSE) */
     }     /* END else ((pjob->ji_wattr[JOB_ATR_keep].at_flags & ...)) */
 
   return(path);
@@ -7615,6 +7653,53 @@ static int search_env_and_open(
 
 
 
+/*
+ * job_start_ready - wait_request() callback for a job starter pipe
+ *
+ * Only wakes the main loop: the pipe is dropped from the select set so a
+ * short or EOF'd pipe cannot spin wait_request(), and TMOMScanForStarting()
+ * reads the start report on the same pass.
+ */
+
+void *job_start_ready(
+
+  void *new_sock)  /* I */
+
+  {
+  globalset_del_sock(*(int *)new_sock);
+
+  return(NULL);
+  }  /* END job_start_ready() */
+
+
+
+
+/*
+ * close_job_start_pipe - close the MOM side of the job starter pipe
+ *
+ * Releases the wait_request() slot as well when TMomFinalizeJob2() managed
+ * to register the pipe.
+ */
+
+void close_job_start_pipe(
+
+  pjobexec_t *TJE)  /* I (modified) */
+
+  {
+  if (TJE->jsmpipe_watched == TRUE)
+    {
+    close_conn(TJE->jsmpipe[0], FALSE);
+
+    TJE->jsmpipe_watched = FALSE;
+    }
+  else
+    close(TJE->jsmpipe[0]);
+
+  TJE->jsmpipe[0] = -1;
+  }  /* END close_job_start_pipe() */
+
+
+
 int TMomCheckJobChild(
 
   pjobexec_t *TJE,       /* I */
@@ -8301,6 +8386,9 @@ int exec_job_on_ms(
 
     if (SC != 0)
       {
+      if ((TJE->jsmpipe_watched == TRUE) || (TJE->jsmpipe[0] >= 0))
+        close_job_start_pipe(TJE);
+
       memset(TJE, 0, sizeof(pjobexec_t));
 
       exec_bail(pjob, SC);
@@ -8309,12 +8397,15 @@ int exec_job_on_ms(
     return(SC);
     }
 
-  /* TMomFinalizeJob2() blocks until job is fully launched */
+  /* TMomFinalizeJob2() forks the job starter and watches its report pipe */
 
   if (TMomFinalizeJob2(TJE, &SC) == FAILURE)
     {
     if (SC != 0)
       {
+      if ((TJE->jsmpipe_watched == TRUE) || (TJE->jsmpipe[0] >= 0))
+        close_job_start_pipe(TJE);
+
       memset(TJE, 0, sizeof(pjobexec_t));
 
       exec_bail(pjob, SC);
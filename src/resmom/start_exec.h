@@ -100,6 +100,10 @@ int init_groups(char *pwname, int pwgrp, int groupsize, int *groups);
 
 int TMomCheckJobChild(pjobexec_t *TJE, int Timeout, int *Count, int *RC);
 
+void *job_start_ready(void *new_sock);
+
+void close_job_start_pipe(pjobexec_t *TJE);
+
 #ifdef USEJOBCREATE
 uint64_t get_jobid(char* pbs_jobid);
 #endif /* USEJOBCREATE */
@@ -22,5 +22,7 @@ Suite *preobit_reply_suite();
 Suite *scan_for_exiting_suite();
 #define EXIT_MOM_JOB 9
 Suite *exit_mom_job_suite();
+#define MARK_JOB_EXITING 10
+Suite *mark_job_exiting_suite();
 
 #endif /* _CATCH_CHILD_CT_H */
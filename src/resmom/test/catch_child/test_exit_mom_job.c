@@ -65,6 +65,35 @@ START_TEST(test_exit_mom_job_momradix3)
   }
 END_TEST
 
+START_TEST(test_exit_mom_job_sister_epilogue)
+  {
+  job *pjob = (job *)calloc(1, sizeof(job));
+  int mom_radix = 0;
+  func_num = EXIT_MOM_JOB;
+  tc = 4;
+  LOGLEVEL = 6;
+  pjob->ji_hosts = (hnodent *)calloc(2, sizeof(hnodent));
+  pjob->ji_hosts[0].hn_stream = 1;
+  pjob->ji_obit = TM_TASKS;
+
+  /* first pass forks the epilogue subtask and does not send the obit */
+  exit_mom_job(pjob, mom_radix);
+  fail_unless(pjob->ji_momsubt == 1);
+  fail_unless(pjob->ji_mompost == post_sister_epilogue);
+  fail_unless((pjob->ji_flags & MOM_EPILOGUE_ACTIVE) != 0);
+
+  /* a second pass while the subtask runs must not fork again */
+  pjob->ji_momsubt = 2;
+  fail_unless(start_sister_epilogue(pjob) == FALSE);
+  fail_unless(pjob->ji_momsubt == 2);
+
+  fail_unless(post_sister_epilogue(pjob, 0) == 0);
+  fail_unless((pjob->ji_flags & MOM_EPILOGUE_ACTIVE) == 0);
+  fail_unless((pjob->ji_flags & MOM_EPILOGUE_DONE) != 0);
+  fail_unless(start_sister_epilogue(pjob) == TRUE);
+  }
+END_TEST
+
 Suite *exit_mom_job_suite(void)
   {
   Suite *s = suite_create("exit_mom_job methods");
@@ -73,6 +102,7 @@ Suite *exit_mom_job_suite(void)
   tcase_add_test(tc_core, test_exit_mom_job_tmnullevent);
   tcase_add_test(tc_core, test_exit_mom_job_atrvflag);
   tcase_add_test(tc_core, test_exit_mom_job_momradix3);
+  tcase_add_test(tc_core, test_exit_mom_job_sister_epilogue);
   suite_add_tcase(s, tc_core);
   return s;
   }
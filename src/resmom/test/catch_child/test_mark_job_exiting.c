@@ -0,0 +1,141 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "test_catch_child.h"
+#include "catch_child.h"
+#include <stdlib.h>
+
+extern int tc;
+extern int func_num;
+extern int exiting_tasks;
+extern int jobs_examined;
+extern int LOGLEVEL;
+extern tlist_head svr_alljobs;
+extern tlist_head mom_exiting_jobs;
+
+#define RESIDENT_JOBS 1000
+
+job *resident_jobs[RESIDENT_JOBS];
+
+/* put RESIDENT_JOBS idle jobs on the mom, none of them exiting */
+void setup_resident_jobs(void)
+  {
+  int i;
+
+  func_num = MARK_JOB_EXITING;
+  tc = 0;
+  LOGLEVEL = 0;
+  exiting_tasks = 0;
+  jobs_examined = 0;
+
+  CLEAR_HEAD(svr_alljobs);
+  CLEAR_HEAD(mom_exiting_jobs);
+
+  for (i = 0; i < RESIDENT_JOBS; i++)
+    {
+    resident_jobs[i] = (job *)calloc(1, sizeof(job));
+
+    CLEAR_LINK(resident_jobs[i]->ji_alljobs);
+    CLEAR_LINK(resident_jobs[i]->ji_exitque);
+
+    append_link(&svr_alljobs, &resident_jobs[i]->ji_alljobs, resident_jobs[i]);
+    }
+  }
+
+int count_queued_jobs(void)
+  {
+  int  count = 0;
+  job *pjob;
+
+  for (pjob = (job *)GET_NEXT(mom_exiting_jobs);
+       pjob != NULL;
+       pjob = (job *)GET_NEXT(pjob->ji_exitque))
+    count++;
+
+  return(count);
+  }
+
+START_TEST(test_mark_job_exiting_once)
+  {
+  setup_resident_jobs();
+
+  mark_job_exiting(resident_jobs[10]);
+  mark_job_exiting(resident_jobs[10]);
+  mark_job_exiting(resident_jobs[20]);
+  mark_job_exiting(NULL);
+
+  fail_unless(count_queued_jobs() == 2, "a job must only be queued once");
+  fail_unless(GET_NEXT(mom_exiting_jobs) == resident_jobs[10]);
+  }
+END_TEST
+
+START_TEST(test_scan_for_exiting_queued_cost)
+  {
+  setup_resident_jobs();
+
+  mark_job_exiting(resident_jobs[RESIDENT_JOBS / 2]);
+
+  scan_for_exiting();
+
+  fail_unless(jobs_examined == 1,
+    "scan_for_exiting looked at %d of %d jobs, expected only the queued one",
+    jobs_examined, RESIDENT_JOBS);
+  fail_unless(count_queued_jobs() == 0, "queued job was not removed");
+  }
+END_TEST
+
+START_TEST(test_scan_for_exiting_nothing_queued)
+  {
+  setup_resident_jobs();
+
+  scan_for_exiting();
+
+  fail_unless(jobs_examined == 0,
+    "scan_for_exiting looked at %d jobs with nothing queued", jobs_examined);
+  }
+END_TEST
+
+START_TEST(test_scan_for_exiting_all_jobs)
+  {
+  setup_resident_jobs();
+
+  mark_job_exiting(resident_jobs[0]);
+
+  /* exiting_tasks still requests a walk of every job */
+  exiting_tasks = 1;
+
+  scan_for_exiting();
+
+  fail_unless(jobs_examined == RESIDENT_JOBS,
+    "scan_for_exiting looked at %d of %d jobs", jobs_examined, RESIDENT_JOBS);
+  fail_unless(exiting_tasks == 0, "full scan did not finish");
+  fail_unless(count_queued_jobs() == 0, "queued job was not removed");
+  }
+END_TEST
+
+Suite *mark_job_exiting_suite(void)
+  {
+  Suite *s = suite_create("mark_job_exiting methods");
+  TCase *tc_core = tcase_create("Core");
+  tcase_add_test(tc_core, test_mark_job_exiting_once);
+  tcase_add_test(tc_core, test_scan_for_exiting_queued_cost);
+  tcase_add_test(tc_core, test_scan_for_exiting_nothing_queued);
+  tcase_add_test(tc_core, test_scan_for_exiting_all_jobs);
+  suite_add_tcase(s, tc_core);
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(mark_job_exiting_suite());
+  srunner_set_log(sr, "mark_job_exiting_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -272,3 +272,5 @@ int write_attr_to_file(
   {
   return(0);
   }
+
+void mark_job_exiting(job *pjob) {}
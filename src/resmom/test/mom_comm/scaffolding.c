@@ -1,6 +1,8 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
+#include <unistd.h>
 #include <stdio.h>
+#include <string.h> /* strdup */
 #include <netinet/in.h> /* sockaddr_in */
 
 #include "mom_server.h" /* mom_server */
@@ -37,6 +39,17 @@ tlist_head svr_alljobs; /* mom_main.c */
 int LOGLEVEL = 0; /* mom_main.c/pbsd_main.c */
 int maxupdatesbeforesending = 0;
 
+/* what the dis mocks read and write, set up by the tests */
+int   dis_int_reads[32];
+int   dis_int_read_count = 0;
+char *dis_str_reads[8];
+int   dis_str_read_count = 0;
+int   dis_int_writes[32];
+int   dis_int_write_count = 0;
+
+/* set by the spawn_multi test: a sister connection that takes every write */
+int   spawn_multi_sister_ok = 0;
+
 int insert_thing(resizable_array *ra, void *thing)
   {
   fprintf(stderr, "The call to insert_thing needs to be mocked!!\n");
@@ -52,8 +65,7 @@ unsigned short disrus(int stream, int *retval)
 
 int job_save(job *pjob, int updatetype, int mom_port)
   {
-  fprintf(stderr, "The call to job_save needs to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 void mom_job_purge(job *pjob)
@@ -195,10 +207,18 @@ size_t write_nonblocking_socket(int fd, const void *buf, ssize_t count)
   exit(1);
   }
 
-void DIS_tcp_setup(int fd)
+struct tcp_chan *DIS_tcp_setup(int fd)
   {
-  fprintf(stderr, "The call to DIS_tcp_setup needs to be mocked!!\n");
-  exit(1);
+  static struct tcp_chan chan;
+
+  if (!spawn_multi_sister_ok)
+    {
+    fprintf(stderr, "The call to DIS_tcp_setup needs to be mocked!!\n");
+    exit(1);
+    }
+
+  chan.sock = fd;
+  return(&chan);
   }
 
 int find_attr(struct attribute_def *attr_def, char *name, int limit)
@@ -210,8 +230,8 @@ int find_attr(struct attribute_def *attr_def, char *name, int limit)
 #undef disrui
 unsigned disrui(int stream, int *retval)
   {
-  fprintf(stderr, "The call to disrui needs to be mocked!!\n");
-  exit(1);
+  *retval = 0; /* DIS_SUCCESS */
+  return(dis_int_reads[dis_int_read_count++]);
   }
 
 int AVL_is_in_tree_no_port_compare(u_long key, uint16_t port, AvlTree tree)
@@ -234,14 +254,24 @@ int get_value_hash(hash_table_t *ht, void *key)
 
 int DIS_tcp_wflush(int fd)
   {
-  fprintf(stderr, "The call to DIS_tcp_wflush needs to be mocked!!\n");
-  exit(1);
+  if (!spawn_multi_sister_ok)
+    {
+    fprintf(stderr, "The call to DIS_tcp_wflush needs to be mocked!!\n");
+    exit(1);
+    }
+
+  return(0);
   }
 
 int diswcs(int stream, const char *value, size_t nchars)
   {
-  fprintf(stderr, "The call to diswcs needs to be mocked!!\n");
-  exit(1);
+  if (!spawn_multi_sister_ok)
+    {
+    fprintf(stderr, "The call to diswcs needs to be mocked!!\n");
+    exit(1);
+    }
+
+  return(0);
   }
 
 unsigned long getsize(resource *pres)
@@ -264,8 +294,13 @@ int add_host_to_sister_list(char *hostname, unsigned short port, struct radix_bu
 
 int diswui(int stream, unsigned value)
   {
-  fprintf(stderr, "The call to diswui needs to be mocked!!\n");
-  exit(1);
+  if (!spawn_multi_sister_ok)
+    {
+    fprintf(stderr, "The call to diswui needs to be mocked!!\n");
+    exit(1);
+    }
+
+  return(0);
   }
 
 char *disrcs(int stream, size_t *nchars, int *retval)
@@ -324,20 +359,28 @@ struct radix_buf **allocate_sister_list(int radix)
 
 char *disrst(int stream, int *retval)
   {
-  fprintf(stderr, "The call to disrst needs to be mocked!!\n");
-  exit(1);
+  *retval = 0; /* DIS_SUCCESS */
+  return(strdup(dis_str_reads[dis_str_read_count++]));
   }
 
 int tcp_connect_sockaddr(struct sockaddr *sa, size_t sa_size)
   {
-  fprintf(stderr, "The call to tcp_connect_sockaddr needs to be mocked!!\n");
-  exit(1);
+  if (!spawn_multi_sister_ok)
+    {
+    fprintf(stderr, "The call to tcp_connect_sockaddr needs to be mocked!!\n");
+    exit(1);
+    }
+
+  return(dup(2));
   }
 
 void append_link(tlist_head *head, list_link *new, void *pobj)
   {
-  fprintf(stderr, "The call to append_link needs to be mocked!!\n");
-  exit(1);
+  if (!spawn_multi_sister_ok)
+    {
+    fprintf(stderr, "The call to append_link needs to be mocked!!\n");
+    exit(1);
+    }
   }
 
 void sister_job_nodes(job *pjob, char *radix_hosts, char *radix_ports )
@@ -397,8 +440,8 @@ job *mom_find_job(char *jobid)
 #undef diswsi
 int diswsi(int stream, int value)
   {
-  fprintf(stderr, "The call to diswsi needs to be mocked!!\n");
-  exit(1);
+  dis_int_writes[dis_int_write_count++] = value;
+  return(0); /* DIS_SUCCESS */
   }
 
 job *job_alloc(void )
@@ -409,8 +452,8 @@ job *job_alloc(void )
 
 int disrsi(int stream, int *retval)
   {
-  fprintf(stderr, "The call to disrsi needs to be mocked!!\n");
-  exit(1);
+  *retval = 0; /* DIS_SUCCESS */
+  return(dis_int_reads[dis_int_read_count++]);
   }
 
 int timeval_subtract(struct timeval *result, struct timeval *x, struct timeval *y)
@@ -459,3 +502,5 @@ void DIS_tcp_close(struct tcp_chan *chan) {}
 void DIS_tcp_cleanup(struct tcp_chan *chan) {}
 
 void free_dynamic_string(dynamic_string *ds) {}
+
+void mark_job_exiting(job *pjob) {}
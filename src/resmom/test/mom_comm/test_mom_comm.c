@@ -3,21 +3,127 @@
 #include "test_mom_comm.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 #include "pbs_error.h"
+#include "tm_.h"
+#include "dis.h"
+
+extern int   dis_int_reads[];
+extern int   dis_int_read_count;
+extern char *dis_str_reads[];
+extern int   dis_str_read_count;
+extern int   dis_int_writes[];
+extern int   dis_int_write_count;
+extern int   spawn_multi_sister_ok;
+
+/* a tm_spawn_multi() of "hostname" on nodes 3 and 4 */
+static void setup_spawn_multi(void)
+  {
+  dis_int_read_count = 0;
+  dis_str_read_count = 0;
+  dis_int_write_count = 0;
+
+  dis_int_reads[0] = 2;  /* count */
+  dis_int_reads[1] = 3;
+  dis_int_reads[2] = 4;
+  dis_int_reads[3] = 1;  /* argc */
+  dis_str_reads[0] = "hostname";
+  dis_str_reads[1] = "";
+  }
 
 START_TEST(test_one)
   {
+  job       pjob;
+  int       reply = TRUE;
+  int       ret;
 
+  /* a sister cannot spawn on other nodes */
+  memset(&pjob, 0, sizeof(pjob));
+  pjob.ji_nodeid = 1;
+  setup_spawn_multi();
 
+  fail_unless(tm_spawn_multi_request(NULL, &pjob, 7, "cookie", &reply, &ret, 1) == TM_DONE);
+  fail_unless(ret == DIS_SUCCESS);
+  fail_unless(reply == TRUE);
+  fail_unless(dis_int_write_count == 5);
+  fail_unless(dis_int_writes[2] == TM_ERROR);
+  fail_unless(dis_int_writes[3] == 7);
+  fail_unless(dis_int_writes[4] == TM_ENOTIMPLEMENTED);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  job       pjob;
+  int       reply = TRUE;
+  int       ret;
+  fwdevent  efwd;
+
+  /* nodes that are not in the job fail on their own, in one reply */
+  memset(&pjob, 0, sizeof(pjob));
+  setup_spawn_multi();
+
+  fail_unless(tm_spawn_multi_request(NULL, &pjob, 7, "cookie", &reply, &ret, 1) == TM_DONE);
+  fail_unless(ret == DIS_SUCCESS);
+  fail_unless(reply == TRUE);
+  fail_unless(dis_int_write_count == 9);
+  fail_unless(dis_int_writes[2] == TM_OKAY);
+  fail_unless(dis_int_writes[3] == 7);
+  fail_unless(dis_int_writes[4] == 2);
+  fail_unless(dis_int_writes[5] == TM_ENOTFOUND);
+  fail_unless(dis_int_writes[6] == TM_NULL_TASK);
+  fail_unless(dis_int_writes[7] == TM_ENOTFOUND);
+  fail_unless(dis_int_writes[8] == TM_NULL_TASK);
+
+  /* an answer for a spawn nobody is waiting on is dropped */
+  efwd.fe_node = 0;
+  efwd.fe_event = 7;
+  efwd.fe_taskid = 1;
+  dis_int_write_count = 0;
+  spawn_multi_result(&pjob, &efwd, TM_SUCCESS, 10);
+  fail_unless(dis_int_write_count == 0);
+  }
+END_TEST
+
+START_TEST(test_spawn_multi_purge)
+  {
+  job       pjob;
+  int       reply = TRUE;
+  int       ret;
+  vnodent   vnods[2];
+  hnodent   sister;
+  fwdevent  efwd;
 
+  /* node 3 is a sister, node 4 is not in the job */
+  memset(&pjob, 0, sizeof(pjob));
+  memset(vnods, 0, sizeof(vnods));
+  memset(&sister, 0, sizeof(sister));
+  strcpy(pjob.ji_qs.ji_jobid, "1.napali");
+  CLEAR_HEAD(sister.hn_events);
+  sister.hn_host = "sister";
+  vnods[1].vn_node = 3;
+  vnods[1].vn_host = &sister;
+  pjob.ji_vnods = vnods;
+  pjob.ji_numvnod = 2;
+  setup_spawn_multi();
 
+  spawn_multi_sister_ok = 1;
+  fail_unless(tm_spawn_multi_request(NULL, &pjob, 7, "cookie", &reply, &ret, 1) == TM_DONE);
+  spawn_multi_sister_ok = 0;
+  fail_unless(reply == FALSE);
+
+  /* the job goes away before the sister answers, so the late answer
+   * finds no record and never looks for the (freed) task */
+  spawn_multi_purge(&pjob);
+
+  efwd.fe_node = 0;
+  efwd.fe_event = 7;
+  efwd.fe_taskid = 1;
+  dis_int_write_count = 0;
+  spawn_multi_result(&pjob, &efwd, TM_SUCCESS, 10);
+  fail_unless(dis_int_write_count == 0);
   }
 END_TEST
 
@@ -32,6 +138,10 @@ Suite *mom_comm_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_spawn_multi_purge");
+  tcase_add_test(tc_core, test_spawn_multi_purge);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
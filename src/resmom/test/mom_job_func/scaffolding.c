@@ -146,3 +146,5 @@ int is_present(
   {
   return(0);
   }
+
+void spawn_multi_purge(job *pjob) {}
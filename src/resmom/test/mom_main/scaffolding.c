@@ -502,6 +502,10 @@ long log_size(void)
   exit(1);
   }
 
+void log_set_index(int enable)
+  {
+  }
+
 int task_save(task *ptask)
   {
   fprintf(stderr, "The call to task_save needs to be mocked!!\n");
@@ -682,3 +686,12 @@ int insert_thing_after(resizable_array *ra, void *thing, int i)
   {
   return(0);
   }
+
+int init_child_wakeup(void)
+  {
+  return(0);
+  }
+
+void mark_job_exiting(job *pjob) {}
+
+void close_job_start_pipe(pjobexec_t *TJE) {}
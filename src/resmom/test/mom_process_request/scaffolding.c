@@ -128,6 +128,12 @@ void req_commit(struct batch_request *preq)
   exit(1);
   }
 
+int req_submitjob(struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_submitjob needs to be mocked!!\n");
+  exit(1);
+  }
+
 void reply_free(struct batch_reply *prep)
   {
   fprintf(stderr, "The call to reply_free needs to be mocked!!\n");
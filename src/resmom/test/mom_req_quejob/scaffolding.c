@@ -58,6 +58,18 @@ struct passwd *check_pwd(job *pjob)
   exit(1);
   }
 
+struct batch_request *alloc_br(int type)
+  {
+  fprintf(stderr, "The call to alloc_br needs to be mocked!!\n");
+  exit(1);
+  }
+
+void free_br(struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to free_br needs to be mocked!!\n");
+  exit(1);
+  }
+
 int reply_send_mom(struct batch_request *request_mom)
   {
   fprintf(stderr, "The call to reply_send_mom needs to be mocked!!\n");
@@ -17,6 +17,7 @@
 #include "tm_.h" /* tm_task_id, tm_event_t */
 #include "mom_mach.h" /* startjob_rtn */
 #include "mom_func.h" /* var_table */
+#include "net_connect.h" /* conn_type, pbs_net_t */
 
 int exec_with_exec;
 int is_login_node = 0;
@@ -470,3 +471,14 @@ int create_alps_reservation(
   {
   return(0);
   }
+
+void mark_job_exiting(job *pjob) {}
+
+int add_conn(int sock, enum conn_type type, pbs_net_t addr, unsigned int port, unsigned int socktype, void *(*func)(void *))
+  {
+  return(0);
+  }
+
+void close_conn(int sd, int has_mutex) {}
+
+void globalset_del_sock(int sock) {}
@@ -83,6 +83,11 @@
  * acct_open()
  * acct_record()
  * acct_close()
+ *
+ * Records are formatted by the thread that makes them and queued; a single
+ * writer thread appends them to the accounting file (and, with the server's
+ * accounting_json set, to a JSON lines copy) in batches, so no thread
+ * waits on the file while it handles a request.
  */
 
 
@@ -96,6 +101,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "list_link.h"
 #include "attribute.h"
 #include "server_limits.h"
@@ -113,11 +121,36 @@
 /* Local Data */
 
 static FILE         *acctfile;  /* open stream for log file */
+static FILE         *acctjson;  /* open stream for the JSON copy */
+static char          acct_filename[_POSIX_PATH_MAX];
 static volatile int  acct_opened = 0;
 static int           acct_opened_day;
 static int           acct_auto_switch = 0;
 pthread_mutex_t     *acctfile_mutex;
 
+/* a formatted record waiting for the writer */
+typedef struct acct_rec
+  {
+  struct acct_rec *ar_next;
+  time_t           ar_time;   /* when the record was made */
+  int              ar_yday;   /* its day of the year */
+  char            *ar_json;   /* JSON line or NULL, in the same allocation */
+  char             ar_line[1];
+  } acct_rec;
+
+/* queued records beyond this make account_record_id() wait for the writer */
+#define ACCT_QUEUE_MAX (64 * 1024 * 1024)
+
+static acct_rec        *acct_queue_head = NULL;
+static acct_rec        *acct_queue_tail = NULL;
+static acct_rec        *acct_held = NULL;  /* taken while the file was closed */
+static long             acct_queued_bytes = 0;
+static int              acct_writing = FALSE;
+static pid_t            acct_writer_pid = 0;
+static pthread_mutex_t  acct_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   acct_queue_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   acct_drained_cond = PTHREAD_COND_INITIALIZER;
+
 /* Global Data */
 
 extern attribute_def job_attr_def[];
@@ -306,6 +339,125 @@ int acct_job(
 
 
 
+/*
+ * acct_default_name - the dated accounting file for the day of when
+ */
+
+static void acct_default_name(
+
+  time_t  when,
+  char   *filen,
+  size_t  size)
+
+  {
+  struct tm *ptm;
+  struct tm  tmpPtm;
+
+  ptm = localtime_r(&when, &tmpPtm);
+
+  snprintf(filen, size, "%s%04d%02d%02d",
+    path_acct,
+    ptm->tm_year + 1900,
+    ptm->tm_mon + 1,
+    ptm->tm_mday);
+
+  acct_opened_day = ptm->tm_yday;
+  }  /* END acct_default_name() */
+
+
+
+
+/*
+ * acct_open_file - open filename and make it the accounting file
+ *
+ * The old file is closed only if the new one opens.
+ */
+
+static int acct_open_file(
+
+  char *filename)
+
+  {
+  char  logmsg[_POSIX_PATH_MAX + 80];
+  FILE *newacct;
+
+  if ((newacct = fopen(filename, "a")) == NULL)
+    {
+    log_err(errno, __func__, filename);
+
+    return(-1);
+    }
+
+  /* the writer flushes after each batch */
+
+  pthread_mutex_lock(acctfile_mutex);
+  if (acct_opened > 0)          /* if acct was open, close it */
+    fclose(acctfile);
+
+  if (acctjson != NULL)
+    {
+    fclose(acctjson);
+    acctjson = NULL;
+    }
+
+  acctfile = newacct;
+  snprintf(acct_filename, sizeof(acct_filename), "%s", filename);
+  pthread_mutex_unlock(acctfile_mutex);
+
+  acct_opened = 1;  /* note that file is open */
+
+  sprintf(logmsg, "Account file %s opened",
+          filename);
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, "Act", logmsg);
+
+  return(0);
+  }  /* END acct_open_file() */
+
+
+
+
+/*
+ * acct_hold - keep records the writer took while the file was closed
+ *
+ * They go back on the queue, ahead of anything newer, once a file is open
+ * again.  Called with acct_queue_mutex held.
+ */
+
+static void acct_hold(
+
+  acct_rec *list)  /* I */
+
+  {
+  acct_rec *tail;
+
+  if (list == NULL)
+    return;
+
+  for (tail = list;tail->ar_next != NULL;tail = tail->ar_next)
+    ;
+
+  if (acct_opened == 1)
+    {
+    /* reopened while the writer had them */
+    tail->ar_next = acct_queue_head;
+    acct_queue_head = list;
+
+    if (acct_queue_tail == NULL)
+      acct_queue_tail = tail;
+
+    pthread_cond_signal(&acct_queue_cond);
+
+    return;
+    }
+
+  tail->ar_next = acct_held;
+  acct_held = list;
+  }  /* END acct_hold() */
+
+
+
+
 /*
  * acct_open() - open the acct file for append.
  *
@@ -319,33 +471,18 @@ int acct_open(
   char *filename)  /* abs pathname or NULL */
 
   {
-  char  filen[_POSIX_PATH_MAX];
-  char  logmsg[_POSIX_PATH_MAX + 80];
-  FILE *newacct;
-  time_t now;
-
-  struct tm *ptm;
-  struct tm tmpPtm;
+  char      filen[_POSIX_PATH_MAX];
+  acct_rec *held;
 
   if (filename == NULL)
     {
     /* go with default */
 
-    now = time(0);
-
-    ptm = localtime_r(&now,&tmpPtm);
-
-    sprintf(filen, "%s%04d%02d%02d",
-            path_acct,
-            ptm->tm_year + 1900,
-            ptm->tm_mon + 1,
-            ptm->tm_mday);
+    acct_default_name(time(NULL), filen, sizeof(filen));
 
     filename = filen;
 
     acct_auto_switch = 1;
-
-    acct_opened_day = ptm->tm_yday;
     }
   else if (*filename == '\0')
     {
@@ -360,28 +497,17 @@ int acct_open(
     return(-1);
     }
 
-  if ((newacct = fopen(filename, "a")) == NULL)
-    {
-    log_err(errno, __func__, filename);
-
+  if (acct_open_file(filename) != 0)
     return(-1);
-    }
-
-  setbuf(newacct, NULL);        /* set no buffering */
-
-  pthread_mutex_lock(acctfile_mutex);
-  if (acct_opened > 0)          /* if acct was open, close it */
-    fclose(acctfile);
 
-  acctfile = newacct;
-  pthread_mutex_unlock(acctfile_mutex);
+  pthread_mutex_lock(&acct_queue_mutex);
 
-  acct_opened = 1;  /* note that file is open */
+  held = acct_held;
+  acct_held = NULL;
 
-  sprintf(logmsg, "Account file %s opened",
-          filename);
+  acct_hold(held);
 
-  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, "Act", logmsg);
+  pthread_mutex_unlock(&acct_queue_mutex);
 
   return(0);
   }  /* END acct_open() */
@@ -391,10 +517,10 @@ int acct_open(
 
 
 /*
- * acct_close - close the current open log file
+ * acct_close_files - close the accounting file and its JSON copy
  */
 
-void acct_close(void)
+static void acct_close_files(void)
 
   {
   pthread_mutex_lock(acctfile_mutex);
@@ -404,7 +530,285 @@ void acct_close(void)
 
     acct_opened = 0;
     }
+
+  if (acctjson != NULL)
+    {
+    fclose(acctjson);
+    acctjson = NULL;
+    }
   pthread_mutex_unlock(acctfile_mutex);
+  }  /* END acct_close_files() */
+
+
+
+
+/*
+ * acct_write_batch - append a batch of queued records and free them
+ *
+ * Called without acct_queue_mutex.  The file lock is released to switch to
+ * the file for a record's day.
+ *
+ * Returns the records not written because the file is closed, for
+ * acct_hold()
+ */
+
+static acct_rec *acct_write_batch(
+
+  acct_rec *list)  /* I (freed) */
+
+  {
+  acct_rec *rec;
+  long      json = FALSE;
+  long      sync = FALSE;
+  char      jsonname[_POSIX_PATH_MAX + 8];
+  char      filen[_POSIX_PATH_MAX];
+
+  get_svr_attr_l(SRV_ATR_AcctJson, &json);
+  get_svr_attr_l(SRV_ATR_AcctFsync, &sync);
+
+  while ((rec = list) != NULL)
+    {
+    if ((acct_auto_switch != 0) &&
+        (acct_opened == 1) &&
+        (acct_opened_day != rec->ar_yday))
+      {
+      acct_default_name(rec->ar_time, filen, sizeof(filen));
+
+      acct_open_file(filen);
+      }
+
+    pthread_mutex_lock(acctfile_mutex);
+
+    if (acct_opened != 1)
+      {
+      pthread_mutex_unlock(acctfile_mutex);
+
+      break;
+      }
+
+    list = rec->ar_next;
+
+    fputs(rec->ar_line, acctfile);
+
+    if ((json == TRUE) &&
+        (rec->ar_json != NULL))
+      {
+      if (acctjson == NULL)
+        {
+        snprintf(jsonname, sizeof(jsonname), "%s.json", acct_filename);
+
+        if ((acctjson = fopen(jsonname, "a")) == NULL)
+          log_err(errno, __func__, jsonname);
+        }
+
+      if (acctjson != NULL)
+        fputs(rec->ar_json, acctjson);
+      }
+
+    pthread_mutex_unlock(acctfile_mutex);
+
+    free(rec);
+    }
+
+  pthread_mutex_lock(acctfile_mutex);
+
+  if (acct_opened == 1)
+    {
+    fflush(acctfile);
+
+    if (sync == TRUE)
+      fsync(fileno(acctfile));
+    }
+
+  if (acctjson != NULL)
+    {
+    fflush(acctjson);
+
+    if (sync == TRUE)
+      fsync(fileno(acctjson));
+    }
+
+  pthread_mutex_unlock(acctfile_mutex);
+
+  return(list);
+  }  /* END acct_write_batch() */
+
+
+
+
+/*
+ * acct_take_batch - take everything queued, acct_queue_mutex held
+ */
+
+static acct_rec *acct_take_batch(void)
+
+  {
+  acct_rec *list = acct_queue_head;
+
+  acct_queue_head = NULL;
+  acct_queue_tail = NULL;
+  acct_queued_bytes = 0;
+
+  acct_writing = TRUE;
+
+  /* wake anyone waiting for room in the queue */
+  pthread_cond_broadcast(&acct_drained_cond);
+
+  return(list);
+  }  /* END acct_take_batch() */
+
+
+
+
+/*
+ * acct_writer - the thread that writes the queued accounting records
+ */
+
+static void *acct_writer(
+
+  void *vp)
+
+  {
+  acct_rec *list;
+
+  pthread_mutex_lock(&acct_queue_mutex);
+
+  while (TRUE)
+    {
+    while (acct_queue_head == NULL)
+      pthread_cond_wait(&acct_queue_cond, &acct_queue_mutex);
+
+    list = acct_take_batch();
+
+    pthread_mutex_unlock(&acct_queue_mutex);
+
+    list = acct_write_batch(list);
+
+    pthread_mutex_lock(&acct_queue_mutex);
+
+    acct_hold(list);
+
+    acct_writing = FALSE;
+
+    if (acct_queue_head == NULL)
+      pthread_cond_broadcast(&acct_drained_cond);
+    }
+
+  /*NOTREACHED*/
+  return(NULL);
+  }  /* END acct_writer() */
+
+
+
+
+/*
+ * acct_writer_running - start the writer if this process does not have one
+ *
+ * The writer is started on first use rather than at acct_open(), which
+ * happens before pbs_server forks into the background.  Called with
+ * acct_queue_mutex held.
+ *
+ * Returns TRUE if there is a writer
+ */
+
+static int acct_writer_running(void)
+
+  {
+  pthread_t      tid;
+  pthread_attr_t attr;
+  int            rc;
+
+  if (acct_writer_pid == getpid())
+    return(TRUE);
+
+  if (pthread_attr_init(&attr) != 0)
+    return(FALSE);
+
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  rc = pthread_create(&tid, &attr, acct_writer, NULL);
+
+  pthread_attr_destroy(&attr);
+
+  if (rc != 0)
+    {
+    log_err(rc, __func__, "cannot start the accounting writer, writing records inline");
+
+    return(FALSE);
+    }
+
+  acct_writing = FALSE;
+  acct_writer_pid = getpid();
+
+  return(TRUE);
+  }  /* END acct_writer_running() */
+
+
+
+
+/*
+ * acct_drain - write everything queued, acct_queue_mutex held
+ */
+
+static void acct_drain(void)
+
+  {
+  acct_rec *list;
+
+  if (acct_writer_pid != getpid())
+    {
+    /* no writer, write what is queued here */
+    if ((list = acct_take_batch()) != NULL)
+      acct_hold(acct_write_batch(list));
+
+    acct_writing = FALSE;
+    }
+  else
+    {
+    while ((acct_queue_head != NULL) ||
+           (acct_writing == TRUE))
+      pthread_cond_wait(&acct_drained_cond, &acct_queue_mutex);
+    }
+  }  /* END acct_drain() */
+
+
+
+
+/*
+ * acct_flush - wait until every queued record has been written
+ */
+
+void acct_flush(void)
+
+  {
+  pthread_mutex_lock(&acct_queue_mutex);
+
+  acct_drain();
+
+  pthread_mutex_unlock(&acct_queue_mutex);
+  }  /* END acct_flush() */
+
+
+
+
+/*
+ * acct_close - close the current open log file
+ *
+ * Records already queued are written first.  The queue stays locked until
+ * the file is closed so nothing can be queued in between; a record the
+ * writer takes after that is held for the next acct_open().
+ */
+
+void acct_close(void)
+
+  {
+  pthread_mutex_lock(&acct_queue_mutex);
+
+  acct_drain();
+
+  acct_close_files();
+
+  pthread_mutex_unlock(&acct_queue_mutex);
 
   return;
   }  /* END acct_close() */
@@ -412,21 +816,201 @@ void acct_close(void)
 
 
 
+/*
+ * json_append - append s to *pos as the body of a JSON string
+ */
+
+static void json_append(
+
+  char **pos, /* M */
+  char  *s,   /* I */
+  int    len) /* I - bytes of s, -1 for all of it */
+
+  {
+  char *out = *pos;
+
+  for (;(len != 0) && (*s != '\0');s++, len--)
+    {
+    switch (*s)
+      {
+      case '"':
+      case '\\':
+
+        *out++ = '\\';
+        *out++ = *s;
+
+        break;
+
+      case '\n':
+
+        *out++ = '\\';
+        *out++ = 'n';
+
+        break;
+
+      case '\t':
+
+        *out++ = '\\';
+        *out++ = 't';
+
+        break;
+
+      default:
+
+        if ((unsigned char)*s < 0x20)
+          out += sprintf(out, "\\u%04x", (unsigned char)*s);
+        else
+          *out++ = *s;
+
+        break;
+      }
+    }
+
+  *pos = out;
+  }  /* END json_append() */
+
+
+
 
 /*
- * account_record - write basic accounting record
+ * acct_json_size - room needed by acct_format_json() for id and text
  */
 
-void account_record(
+static size_t acct_json_size(
+
+  char *id,
+  char *text)
+
+  {
+  size_t len = strlen(text);
+
+  /* every byte may become a \u escape, every other one may start a field */
+  return(128 + (6 * strlen(id)) + (6 * len) + (8 * (len / 2 + 1)));
+  }  /* END acct_json_size() */
+
+
+
+
+/*
+ * acct_format_json - write a record as one line of JSON
+ *
+ * The text's key=value pairs become members in the order they appear, with
+ * words that are not a key=value pair added to the value before them.
+ * buf must have acct_json_size() bytes.
+ */
+
+static void acct_format_json(
+
+  char      *buf,     /* O */
+  time_t     when,    /* I */
+  char      *date,    /* I - date and time as in the classic record */
+  int        acctype, /* I */
+  char      *id,      /* I */
+  char      *text)    /* I */
+
+  {
+  char *out = buf;
+  char *word;
+  char *end;
+  char *eq;
+  char *ptr;
+  int   in_value = FALSE;
+
+  out += sprintf(out, "{\"time\":%ld,\"date\":\"%s\",\"type\":\"%c\",\"id\":\"",
+           (long)when, date, (char)acctype);
+
+  json_append(&out, id, -1);
+
+  *out++ = '"';
+
+  for (word = text;*word != '\0';word = end)
+    {
+    while (*word == ' ')
+      word++;
+
+    if (*word == '\0')
+      break;
+
+    for (end = word;(*end != '\0') && (*end != ' ');end++);
+
+    eq = NULL;
+
+    for (ptr = word;ptr < end;ptr++)
+      {
+      if (*ptr == '=')
+        {
+        eq = ptr;
+        break;
+        }
+
+      if ((!isalnum((unsigned char)*ptr)) &&
+          (*ptr != '.') &&
+          (*ptr != '_') &&
+          (*ptr != '-'))
+        break;
+      }
+
+    if ((eq != NULL) &&
+        (eq != word))
+      {
+      /* a new member */
+      if (in_value == TRUE)
+        *out++ = '"';
+
+      *out++ = ',';
+      *out++ = '"';
+      json_append(&out, word, eq - word);
+      out += sprintf(out, "\":\"");
+      json_append(&out, eq + 1, end - eq - 1);
+
+      in_value = TRUE;
+      }
+    else if (in_value == TRUE)
+      {
+      *out++ = ' ';
+      json_append(&out, word, end - word);
+      }
+    else
+      {
+      out += sprintf(out, ",\"text\":\"");
+      json_append(&out, word, end - word);
+
+      in_value = TRUE;
+      }
+    }
+
+  if (in_value == TRUE)
+    *out++ = '"';
+
+  *out++ = '}';
+  *out++ = '\n';
+  *out = '\0';
+  }  /* END acct_format_json() */
+
+
+
+
+/*
+ * account_record_id - write basic accounting record for a job or array id
+ *
+ * The record is formatted here and queued for the writer thread.
+ */
+
+void account_record_id(
 
   int   acctype, /* accounting record type */
-  job  *pjob,
+  char *id,
   char *text)  /* text to log, may be null */
 
   {
   time_t     time_now = time(NULL);
   struct tm *ptm;
   struct tm  tmpPtm;
+  char       date[80];
+  long       json = FALSE;
+  size_t     line_len;
+  size_t     json_len = 0;
+  acct_rec  *rec;
 
   if (acct_opened == 0)
     {
@@ -437,32 +1021,100 @@ void account_record(
 
   ptm = localtime_r(&time_now,&tmpPtm);
 
-  /* Do we need to switch files */
+  if (text == NULL)
+    text = "";
+
+  snprintf(date, sizeof(date), "%02d/%02d/%04d %02d:%02d:%02d",
+    ptm->tm_mon + 1,
+    ptm->tm_mday,
+    ptm->tm_year + 1900,
+    ptm->tm_hour,
+    ptm->tm_min,
+    ptm->tm_sec);
+
+  get_svr_attr_l(SRV_ATR_AcctJson, &json);
 
-  if ((acct_auto_switch != 0) && (acct_opened_day != ptm->tm_yday))
+  /* date;type;id;text\n */
+  line_len = strlen(date) + strlen(id) + strlen(text) + 6;
+
+  if (json == TRUE)
+    json_len = acct_json_size(id, text);
+
+  if ((rec = calloc(1, sizeof(acct_rec) + line_len + json_len)) == NULL)
     {
-    acct_close();
+    log_err(ENOMEM, __func__, "cannot queue accounting record");
 
-    acct_open(NULL);
+    return;
     }
 
-  if (text == NULL)
-    text = "";
+  rec->ar_time = time_now;
+  rec->ar_yday = ptm->tm_yday;
 
-  pthread_mutex_lock(acctfile_mutex);
-  fprintf(acctfile, "%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
-          ptm->tm_mon + 1,
-          ptm->tm_mday,
-          ptm->tm_year + 1900,
-          ptm->tm_hour,
-          ptm->tm_min,
-          ptm->tm_sec,
-          (char)acctype,
-          pjob->ji_qs.ji_jobid,
-          text);
-  pthread_mutex_unlock(acctfile_mutex);
+  sprintf(rec->ar_line, "%s;%c;%s;%s\n",
+    date,
+    (char)acctype,
+    id,
+    text);
+
+  if (json == TRUE)
+    {
+    rec->ar_json = rec->ar_line + line_len;
+
+    acct_format_json(rec->ar_json, time_now, date, acctype, id, text);
+    }
+
+  pthread_mutex_lock(&acct_queue_mutex);
+
+  if (acct_writer_running() == FALSE)
+    {
+    /* no writer, do it here as before */
+    pthread_mutex_unlock(&acct_queue_mutex);
+
+    rec = acct_write_batch(rec);
+
+    pthread_mutex_lock(&acct_queue_mutex);
+
+    acct_hold(rec);
+
+    pthread_mutex_unlock(&acct_queue_mutex);
+
+    return;
+    }
+
+  while (acct_queued_bytes > ACCT_QUEUE_MAX)
+    pthread_cond_wait(&acct_drained_cond, &acct_queue_mutex);
+
+  if (acct_queue_tail != NULL)
+    acct_queue_tail->ar_next = rec;
+  else
+    acct_queue_head = rec;
+
+  acct_queue_tail = rec;
+  acct_queued_bytes += line_len + json_len;
+
+  pthread_cond_signal(&acct_queue_cond);
+
+  pthread_mutex_unlock(&acct_queue_mutex);
 
   return;
+  }  /* END account_record_id() */
+
+
+
+
+
+/*
+ * account_record - write basic accounting record
+ */
+
+void account_record(
+
+  int   acctype, /* accounting record type */
+  job  *pjob,
+  char *text)  /* text to log, may be null */
+
+  {
+  account_record_id(acctype, pjob->ji_qs.ji_jobid, text);
   }  /* END account_record() */
 
 
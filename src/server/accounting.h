@@ -10,8 +10,12 @@ int acct_open(char *filename);
 
 void acct_close(void);
 
+void acct_flush(void);
+
 void account_record(int acctype, job *pjob, char *text);
 
+void account_record_id(int acctype, char *id, char *text);
+
 void account_jobstr(job *pjob);
 
 void account_jobend(job *pjob, char *used);
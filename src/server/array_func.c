@@ -1074,6 +1074,159 @@ int parse_array_request(
 
 
 
+/*
+ * subjob_can_purge()
+ *
+ * A subjob that is only queued, held or waiting has nothing at a mom and
+ * nothing left to report.  When completed jobs are not kept it can be
+ * purged on the spot instead of being marked complete, saved, and handed
+ * to a work task that purges it.
+ *
+ * @param pjob - the subjob (locked)
+ * @return TRUE if the subjob can be purged right away
+ */
+
+static int subjob_can_purge(
+
+  job *pjob) /* I */
+
+  {
+  long keep_seconds = 0;
+  long must_report = FALSE;
+
+  if (((pjob->ji_qs.ji_state != JOB_STATE_QUEUED) &&
+       (pjob->ji_qs.ji_state != JOB_STATE_HELD) &&
+       (pjob->ji_qs.ji_state != JOB_STATE_WAITING)) ||
+      (pjob->ji_qs.ji_substate == JOB_SUBSTATE_PRERUN) ||
+      ((pjob->ji_qs.ji_svrflags & (JOB_SVFLG_CHECKPOINT_FILE | JOB_SVFLG_StagedIn)) != 0) ||
+      (pjob->ji_qhdr == NULL))
+    return(FALSE);
+
+  if ((get_svr_attr_l(SRV_ATR_JobMustReport, &must_report) == PBSE_NONE) &&
+      (must_report > 0))
+    return(FALSE);
+
+  /* the queue attribute is read without the queue lock, a queue is
+   * not freed while it holds jobs */
+  pthread_mutex_lock(server.sv_attr_mutex);
+  keep_seconds = attr_ifelse_long(
+    &pjob->ji_qhdr->qu_attr[QE_ATR_KeepCompleted],
+    &server.sv_attr[SRV_ATR_KeepCompleted],
+    0);
+  pthread_mutex_unlock(server.sv_attr_mutex);
+
+  return(keep_seconds <= 0);
+  } /* END subjob_can_purge() */
+
+
+
+
+/*
+ * delete_array_subjob()
+ *
+ * deletes the subjob at index for delete_array_range() and
+ * delete_whole_array().  pa->ai_mutex is held on entry and exit but
+ * released while the subjob is deleted.
+ *
+ * @param pa - the array
+ * @param index - the subjob's index
+ * @param num_skipped - incremented if the subjob could not be deleted
+ * @param num_deleted - incremented if the subjob is gone for good
+ * @return TRUE if the subjob existed
+ */
+
+static int delete_array_subjob(
+
+  job_array *pa,          /* I */
+  int        index,       /* I */
+  int       *num_skipped, /* O */
+  int       *num_deleted) /* O */
+
+  {
+  job *pjob;
+  int  deleted;
+  int  running;
+
+  if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
+    {
+    free(pa->job_ids[index]);
+    pa->job_ids[index] = NULL;
+
+    return(FALSE);
+    }
+
+  if (pjob->ji_qs.ji_state >= JOB_STATE_EXITING)
+    {
+    /* invalid state for request,  skip */
+    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+
+    return(TRUE);
+    }
+
+  running = (pjob->ji_qs.ji_state == JOB_STATE_RUNNING);
+
+  pthread_mutex_unlock(pa->ai_mutex);
+
+  if (subjob_can_purge(pjob) == TRUE)
+    {
+    /* svr_job_purge always unlocks the job */
+    svr_job_purge(pjob);
+
+    deleted = TRUE;
+    }
+  else if ((deleted = attempt_delete(pjob)) == FALSE)
+    {
+    /* if the job was deleted, this mutex would be taked care of elsewhere. When it fails,
+     * release it here */
+    unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
+    }
+
+  if (deleted == FALSE)
+    (*num_skipped)++;
+  else if (running == FALSE)
+    {
+    /* running jobs will increase the deleted count when their obit is reported */
+    (*num_deleted)++;
+    }
+
+  pthread_mutex_lock(pa->ai_mutex);
+
+  return(TRUE);
+  } /* END delete_array_subjob() */
+
+
+
+
+/*
+ * end_array_bulk_op()
+ *
+ * finishes a bulk operation started by incrementing pa->ai_bulk_ops.
+ * Subjobs purged meanwhile left the array file and the array's own
+ * removal to the bulk operation (see svr_job_purge()), so the array is
+ * saved once here.
+ *
+ * @return TRUE if every subjob is purged and the caller should delete the array
+ */
+
+static int end_array_bulk_op(
+
+  job_array *pa) /* I/O */
+
+  {
+  if (--pa->ai_bulk_ops > 0)
+    return(FALSE);
+
+  if (pa->ai_qs.num_purged >= pa->ai_qs.num_jobs)
+    return(TRUE);
+
+  array_save(pa);
+
+  return(FALSE);
+  } /* END end_array_bulk_op() */
+
+
+
+
 /*
  * delete_array_range()
  *
@@ -1081,7 +1234,8 @@ int parse_array_request(
  *
  * @param pa - the array whose jobs are deleted
  * @param range_str - the user-given range to delete 
- * @return - the number of jobs skipped, -1 if range error 
+ * @return - the number of jobs skipped, -1 if range error, NO_JOBS_IN_ARRAY
+ * if the array has no jobs left and should be deleted
  */
 int delete_array_range(
 
@@ -1092,14 +1246,11 @@ int delete_array_range(
   tlist_head          tl;
   array_request_node *rn;
   array_request_node *to_free;
-  job                *pjob;
   char               *range;
 
   int                 i;
   int                 num_skipped = 0;
   int                 num_deleted = 0;
-  int                 deleted;
-  int                 running;
 
   /* get just the numeric range specified, '=' should
    * always be there since we put it there in qdel */
@@ -1115,54 +1266,22 @@ int delete_array_range(
     return(-1);
     }
 
+  pa->ai_bulk_ops++;
+
   rn = (array_request_node*)GET_NEXT(tl);
 
   while (rn != NULL)
     {
     for (i = rn->start; i <= rn->end; i++)
       {
-      if (pa->job_ids[i] == NULL)
-        continue;
-
       /* don't stomp on other memory */
       if (i >= pa->ai_qs.array_size)
         continue;
 
-      if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
-        {
-        free(pa->job_ids[i]);
-        pa->job_ids[i] = NULL;
-        }
-      else
-        {
-        if (pjob->ji_qs.ji_state >= JOB_STATE_EXITING)
-          {
-          /* invalid state for request,  skip */
-          unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
-          continue;
-          }
-
-        running = (pjob->ji_qs.ji_state == JOB_STATE_RUNNING);
-
-        pthread_mutex_unlock(pa->ai_mutex);
-        deleted = attempt_delete(pjob);
-
-        if (deleted == FALSE)
-          {
-          /* if the job was deleted, this mutex would be taked care of elsewhere. When it fails,
-           * release it here */
-          unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
-
-          num_skipped++;
-          }
-        else if (running == FALSE)
-          {
-          /* running jobs will increase the deleted count when their obit is reported */
-          num_deleted++;
-          }
+      if (pa->job_ids[i] == NULL)
+        continue;
 
-        pthread_mutex_lock(pa->ai_mutex);
-        }
+      delete_array_subjob(pa, i, &num_skipped, &num_deleted);
       }
 
     to_free = rn;
@@ -1174,6 +1293,9 @@ int delete_array_range(
 
   pa->ai_qs.num_failed += num_deleted;
 
+  if (end_array_bulk_op(pa) == TRUE)
+    return(NO_JOBS_IN_ARRAY);
+
   return(num_skipped);
   } /* END delete_array_range() */
 
@@ -1209,7 +1331,8 @@ int first_job_index(
  *
  * iterates over the array and deletes the whole thing
  * @param pa - the array to be deleted
- * @return - the number of jobs skipped
+ * @return - the number of jobs skipped, NO_JOBS_IN_ARRAY if the array has
+ * no jobs left and should be deleted
  */
 int delete_whole_array(
 
@@ -1220,57 +1343,22 @@ int delete_whole_array(
   int num_skipped = 0;
   int num_jobs = 0;
   int num_deleted = 0;
-  int deleted;
-  int running;
 
-  job *pjob;
+  pa->ai_bulk_ops++;
 
   for (i = 0; i < pa->ai_qs.array_size; i++)
     {
     if (pa->job_ids[i] == NULL)
       continue;
 
-    if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
-      {
-      free(pa->job_ids[i]);
-      pa->job_ids[i] = NULL;
-      }
-    else
-      {
+    if (delete_array_subjob(pa, i, &num_skipped, &num_deleted) == TRUE)
       num_jobs++;
-
-      if (pjob->ji_qs.ji_state >= JOB_STATE_EXITING)
-        {
-        /* invalid state for request,  skip */
-        unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
-        continue;
-        }
-        
-      running = (pjob->ji_qs.ji_state == JOB_STATE_RUNNING);
-
-      pthread_mutex_unlock(pa->ai_mutex);
-      deleted = attempt_delete(pjob);
-
-      if (deleted == FALSE)
-        {
-        /* if the job was deleted, this mutex would be taked care of elsewhere.
-         * When it fails, release it here */
-        unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
-        num_skipped++;
-        }
-      else if (running == FALSE)
-        {
-        /* running jobs will increase the deleted count when their obit is reported */
-        num_deleted++;
-        }
-
-      pthread_mutex_lock(pa->ai_mutex);
-      }
     }
 
   pa->ai_qs.num_failed += num_deleted;
 
-  if (num_jobs == 0)
+  if ((end_array_bulk_op(pa) == TRUE) ||
+      (num_jobs == 0))
     return(NO_JOBS_IN_ARRAY);
 
   return(num_skipped);
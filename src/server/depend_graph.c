@@ -0,0 +1,533 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * The dependency graph indexes the afterok, afternotok and afterany
+ * dependencies between jobs of this server.  Each job with such a
+ * dependency has a node keyed by its job id that lists the jobs waiting on
+ * it (dependents) and, as reverse edges, the jobs it waits on
+ * (prerequisites).  depend_on_term() releases the local dependents of a
+ * finished job from its node, without sending a Register Dependent request
+ * back to this server for each of them.
+ *
+ * The JOB_ATR_depend attribute is still what is saved and recovered.  The
+ * graph follows it: a job is indexed from its attribute when it enters an
+ * execution queue or the attribute is altered (depend_on_que()), edges are
+ * added and removed with the attribute entries in req_register(), and a
+ * purged job is dropped.  A dependency the graph does not hold is released
+ * through a request, as before.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "depend_graph.h"
+#include "pbs_job.h"
+#include "pbs_error.h"
+#include "hash_map.h"
+#include "list_link.h"
+
+typedef struct dg_edge
+  {
+  struct dg_node *de_node;   /* the job at the other end */
+  int             de_type;   /* the dependent's after* type */
+  struct dg_edge *de_next;
+  } dg_edge;
+
+typedef struct dg_node
+  {
+  char            dn_jobid[PBS_MAXSVRJOBID + 1];
+  dg_edge        *dn_dependents;   /* jobs waiting on this one */
+  dg_edge        *dn_prereqs;      /* jobs this one waits on */
+  int             dn_count;        /* number of dependents */
+  } dg_node;
+
+static hash_map        *depend_graph = NULL;
+static pthread_mutex_t  depend_graph_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+
+/*
+ * graph_type - TRUE for the dependency types the graph indexes
+ */
+
+static int graph_type(
+
+  int type)  /* I */
+
+  {
+  return((type == JOB_DEPEND_TYPE_AFTEROK) ||
+         (type == JOB_DEPEND_TYPE_AFTERNOTOK) ||
+         (type == JOB_DEPEND_TYPE_AFTERANY));
+  }  /* END graph_type() */
+
+
+
+
+/*
+ * find_node - look up a job's node, creating it if create is TRUE
+ *
+ * The caller holds depend_graph_mutex.
+ */
+
+static dg_node *find_node(
+
+  char *job_id,  /* I */
+  int   create)  /* I */
+
+  {
+  dg_node *pn;
+
+  if (depend_graph == NULL)
+    {
+    if (create == FALSE)
+      return(NULL);
+
+    depend_graph = get_hash_map(-1);
+    }
+
+  if (((pn = (dg_node *)get_from_hash_map(depend_graph, job_id)) != NULL) ||
+      (create == FALSE))
+    return(pn);
+
+  if ((pn = (dg_node *)calloc(1, sizeof(dg_node))) == NULL)
+    return(NULL);
+
+  snprintf(pn->dn_jobid, sizeof(pn->dn_jobid), "%s", job_id);
+
+  if (add_to_hash_map(depend_graph, pn, pn->dn_jobid) != PBSE_NONE)
+    {
+    free(pn);
+
+    return(NULL);
+    }
+
+  return(pn);
+  }  /* END find_node() */
+
+
+
+
+/*
+ * release_node - free a node that no longer has any edges
+ *
+ * The caller holds depend_graph_mutex.
+ */
+
+static void release_node(
+
+  dg_node *pn)  /* I (freed if unused) */
+
+  {
+  if ((pn->dn_dependents != NULL) ||
+      (pn->dn_prereqs != NULL))
+    return;
+
+  remove_from_hash_map(depend_graph, pn->dn_jobid);
+
+  free(pn);
+  }  /* END release_node() */
+
+
+
+
+/*
+ * unlink_edge - remove the edge to node of type from a list
+ *
+ * @return TRUE if an edge was removed
+ */
+
+static int unlink_edge(
+
+  dg_edge **list,  /* I/O */
+  dg_node  *node,  /* I */
+  int       type)  /* I */
+
+  {
+  dg_edge **prev;
+  dg_edge  *pe;
+
+  for (prev = list; (pe = *prev) != NULL; prev = &pe->de_next)
+    {
+    if ((pe->de_node == node) &&
+        (pe->de_type == type))
+      {
+      *prev = pe->de_next;
+
+      free(pe);
+
+      return(TRUE);
+      }
+    }
+
+  return(FALSE);
+  }  /* END unlink_edge() */
+
+
+
+
+/*
+ * add_edge - record that dependent waits on prereq
+ *
+ * The caller holds depend_graph_mutex.
+ */
+
+static int add_edge(
+
+  char *prereq_id,     /* I */
+  char *dependent_id,  /* I */
+  int   type)          /* I */
+
+  {
+  dg_node *prereq;
+  dg_node *dependent;
+  dg_edge *out;
+  dg_edge *in;
+
+  if ((prereq = find_node(prereq_id, TRUE)) == NULL)
+    return(PBSE_SYSTEM);
+
+  if ((dependent = find_node(dependent_id, TRUE)) == NULL)
+    {
+    release_node(prereq);
+
+    return(PBSE_SYSTEM);
+    }
+
+  /* an edge is recorded once however often it is registered */
+  for (in = dependent->dn_prereqs; in != NULL; in = in->de_next)
+    {
+    if ((in->de_node == prereq) &&
+        (in->de_type == type))
+      return(PBSE_NONE);
+    }
+
+  out = (dg_edge *)calloc(1, sizeof(dg_edge));
+  in = (dg_edge *)calloc(1, sizeof(dg_edge));
+
+  if ((out == NULL) ||
+      (in == NULL))
+    {
+    free(out);
+    free(in);
+
+    if (dependent != prereq)
+      release_node(dependent);
+
+    release_node(prereq);
+
+    return(PBSE_SYSTEM);
+    }
+
+  out->de_node = dependent;
+  out->de_type = type;
+  out->de_next = prereq->dn_dependents;
+  prereq->dn_dependents = out;
+  prereq->dn_count++;
+
+  in->de_node = prereq;
+  in->de_type = type;
+  in->de_next = dependent->dn_prereqs;
+  dependent->dn_prereqs = in;
+
+  return(PBSE_NONE);
+  }  /* END add_edge() */
+
+
+
+
+/*
+ * remove_edge - forget that dependent waits on prereq
+ *
+ * The caller holds depend_graph_mutex.
+ */
+
+static void remove_edge(
+
+  dg_node *prereq,     /* I (freed if unused) */
+  dg_node *dependent,  /* I (freed if unused) */
+  int      type)       /* I */
+
+  {
+  if (unlink_edge(&prereq->dn_dependents, dependent, type) == TRUE)
+    prereq->dn_count--;
+
+  unlink_edge(&dependent->dn_prereqs, prereq, type);
+
+  if (prereq != dependent)
+    release_node(prereq);
+
+  release_node(dependent);
+  }  /* END remove_edge() */
+
+
+
+
+/*
+ * depend_graph_add - record that dependent_id waits on prereq_id
+ *
+ * type is the dependent's view, e.g. JOB_DEPEND_TYPE_AFTEROK.  Other
+ * types are ignored.
+ */
+
+int depend_graph_add(
+
+  char *prereq_id,     /* I */
+  char *dependent_id,  /* I */
+  int   type)          /* I */
+
+  {
+  int rc;
+
+  if (graph_type(type) == FALSE)
+    return(PBSE_NONE);
+
+  pthread_mutex_lock(&depend_graph_mutex);
+  rc = add_edge(prereq_id, dependent_id, type);
+  pthread_mutex_unlock(&depend_graph_mutex);
+
+  return(rc);
+  }  /* END depend_graph_add() */
+
+
+
+
+/*
+ * depend_graph_remove - forget that dependent_id waits on prereq_id
+ */
+
+void depend_graph_remove(
+
+  char *prereq_id,     /* I */
+  char *dependent_id,  /* I */
+  int   type)          /* I */
+
+  {
+  dg_node *prereq;
+  dg_node *dependent;
+
+  if (graph_type(type) == FALSE)
+    return;
+
+  pthread_mutex_lock(&depend_graph_mutex);
+
+  if (((prereq = find_node(prereq_id, FALSE)) != NULL) &&
+      ((dependent = find_node(dependent_id, FALSE)) != NULL))
+    remove_edge(prereq, dependent, type);
+
+  pthread_mutex_unlock(&depend_graph_mutex);
+  }  /* END depend_graph_remove() */
+
+
+
+
+/*
+ * depend_graph_index_job - set a job's prerequisites from its depend attribute
+ *
+ * Replaces whatever the graph held for the job's prerequisites with the
+ * after* entries of pattr.
+ */
+
+void depend_graph_index_job(
+
+  char          *job_id,  /* I */
+  pbs_attribute *pattr)   /* I */
+
+  {
+  dg_node           *pn;
+  struct depend     *pdep;
+  struct depend_job *pdj;
+
+  pthread_mutex_lock(&depend_graph_mutex);
+
+  if ((pn = find_node(job_id, TRUE)) == NULL)
+    {
+    pthread_mutex_unlock(&depend_graph_mutex);
+
+    return;
+    }
+
+  while (pn->dn_prereqs != NULL)
+    {
+    dg_node *prereq = pn->dn_prereqs->de_node;
+    int      type = pn->dn_prereqs->de_type;
+
+    if (unlink_edge(&prereq->dn_dependents, pn, type) == TRUE)
+      prereq->dn_count--;
+
+    unlink_edge(&pn->dn_prereqs, prereq, type);
+
+    if (prereq != pn)
+      release_node(prereq);
+    }
+
+  if (pattr->at_flags & ATR_VFLAG_SET)
+    {
+    for (pdep = (struct depend *)GET_NEXT(pattr->at_val.at_list);
+         pdep != NULL;
+         pdep = (struct depend *)GET_NEXT(pdep->dp_link))
+      {
+      if (graph_type(pdep->dp_type) == FALSE)
+        continue;
+
+      for (pdj = (struct depend_job *)GET_NEXT(pdep->dp_jobs);
+           pdj != NULL;
+           pdj = (struct depend_job *)GET_NEXT(pdj->dc_link))
+        {
+        add_edge(pdj->dc_child, job_id, pdep->dp_type);
+        }
+      }
+    }
+
+  release_node(pn);
+
+  pthread_mutex_unlock(&depend_graph_mutex);
+  }  /* END depend_graph_index_job() */
+
+
+
+
+/*
+ * depend_graph_remove_job - drop a purged job and all of its edges
+ */
+
+void depend_graph_remove_job(
+
+  char *job_id)  /* I */
+
+  {
+  dg_node *pn;
+  dg_node *other;
+  int      type;
+
+  pthread_mutex_lock(&depend_graph_mutex);
+
+  if ((pn = find_node(job_id, FALSE)) == NULL)
+    {
+    pthread_mutex_unlock(&depend_graph_mutex);
+
+    return;
+    }
+
+  while (pn->dn_dependents != NULL)
+    {
+    other = pn->dn_dependents->de_node;
+    type = pn->dn_dependents->de_type;
+
+    unlink_edge(&pn->dn_dependents, other, type);
+    unlink_edge(&other->dn_prereqs, pn, type);
+
+    if (other != pn)
+      release_node(other);
+    }
+
+  while (pn->dn_prereqs != NULL)
+    {
+    other = pn->dn_prereqs->de_node;
+    type = pn->dn_prereqs->de_type;
+
+    unlink_edge(&pn->dn_prereqs, other, type);
+
+    if (unlink_edge(&other->dn_dependents, pn, type) == TRUE)
+      other->dn_count--;
+
+    if (other != pn)
+      release_node(other);
+    }
+
+  pn->dn_count = 0;
+
+  release_node(pn);
+
+  pthread_mutex_unlock(&depend_graph_mutex);
+  }  /* END depend_graph_remove_job() */
+
+
+
+
+/*
+ * depend_graph_has_edge - TRUE if the graph holds dependent_id waiting on prereq_id
+ *
+ * depend_on_term() releases such a dependency from the graph, others need
+ * a request.
+ */
+
+int depend_graph_has_edge(
+
+  char *prereq_id,     /* I */
+  char *dependent_id,  /* I */
+  int   type)          /* I */
+
+  {
+  dg_node *dependent;
+  dg_edge *pe;
+  int      found = FALSE;
+
+  pthread_mutex_lock(&depend_graph_mutex);
+
+  if ((dependent = find_node(dependent_id, FALSE)) != NULL)
+    {
+    for (pe = dependent->dn_prereqs; pe != NULL; pe = pe->de_next)
+      {
+      if ((pe->de_type == type) &&
+          (!strcmp(pe->de_node->dn_jobid, prereq_id)))
+        {
+        found = TRUE;
+
+        break;
+        }
+      }
+    }
+
+  pthread_mutex_unlock(&depend_graph_mutex);
+
+  return(found);
+  }  /* END depend_graph_has_edge() */
+
+
+
+
+/*
+ * depend_graph_dependents - copy out the jobs waiting on prereq_id
+ *
+ * The copy lets the caller release each dependent under its own job lock.
+ *
+ * @return the number of entries in *edges, which the caller frees, or 0
+ */
+
+int depend_graph_dependents(
+
+  char         *prereq_id,  /* I */
+  depend_edge **edges)      /* O */
+
+  {
+  dg_node *pn;
+  dg_edge *pe;
+  int      count = 0;
+
+  *edges = NULL;
+
+  pthread_mutex_lock(&depend_graph_mutex);
+
+  if (((pn = find_node(prereq_id, FALSE)) != NULL) &&
+      (pn->dn_count > 0) &&
+      ((*edges = (depend_edge *)calloc(pn->dn_count, sizeof(depend_edge))) != NULL))
+    {
+    for (pe = pn->dn_dependents; pe != NULL; pe = pe->de_next)
+      {
+      snprintf((*edges)[count].de_jobid, sizeof((*edges)[count].de_jobid), "%s",
+        pe->de_node->dn_jobid);
+      (*edges)[count].de_type = pe->de_type;
+
+      count++;
+      }
+    }
+
+  pthread_mutex_unlock(&depend_graph_mutex);
+
+  return(count);
+  }  /* END depend_graph_dependents() */
+
+/* END depend_graph.c */
@@ -0,0 +1,26 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _DEPEND_GRAPH_H
+#define _DEPEND_GRAPH_H
+
+#include "pbs_ifl.h" /* PBS_MAXSVRJOBID */
+#include "attribute.h" /* pbs_attribute */
+
+typedef struct depend_edge
+  {
+  char de_jobid[PBS_MAXSVRJOBID + 1]; /* the job at the other end */
+  int  de_type;                       /* the dependent's after* type */
+  } depend_edge;
+
+int depend_graph_add(char *prereq_id, char *dependent_id, int type);
+
+void depend_graph_remove(char *prereq_id, char *dependent_id, int type);
+
+void depend_graph_index_job(char *job_id, pbs_attribute *pattr);
+
+void depend_graph_remove_job(char *job_id);
+
+int depend_graph_has_edge(char *prereq_id, char *dependent_id, int type);
+
+int depend_graph_dependents(char *prereq_id, depend_edge **edges);
+
+#endif /* _DEPEND_GRAPH_H */
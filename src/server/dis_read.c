@@ -274,8 +274,22 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      CLEAR_HEAD(request->rq_ind.rq_queuejob.rq_attr);
+
+      rc = decode_DIS_SubmitJob(chan, request);
+
+      break;
+
 #ifndef PBS_MOM
 
+    case PBS_BATCH_WatchJobs:
+
+      rc = decode_DIS_WatchJobs(chan, request);
+
+      break;
+
     case PBS_BATCH_LocateJob:
 
       rc = decode_DIS_JobId(chan, request->rq_ind.rq_locate);
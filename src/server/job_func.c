@@ -134,6 +134,7 @@
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
 #include "../lib/Liblog/log_event.h"
+#include "../lib/Liblog/job_history.h"
 #include "pbs_error.h"
 #include "svrfunc.h"
 #include "acct.h"
@@ -148,6 +149,8 @@
 #include "issue_request.h" /* release_req */
 #include "ji_mutex.h"
 #include "user_info.h"
+#include "job_watch.h" /* notify_job_watchers */
+#include "depend_graph.h" /* depend_graph_remove_job */
 
 
 #ifndef TRUE
@@ -651,7 +654,7 @@ int conn_qsub(
 job *job_alloc(void)
 
   {
-  job *pj = (job *)calloc(1, sizeof(job));
+  job *pj = job_slab_alloc();
   
   if (pj == NULL)
     {
@@ -660,8 +663,6 @@ job *job_alloc(void)
     return(NULL);
     }
 
-  pj->ji_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
-  pthread_mutex_init(pj->ji_mutex,NULL);
   lock_ji_mutex(pj, __func__, NULL, LOGLEVEL);
 
   pj->ji_qs.qs_version = PBS_QS_VERSION;
@@ -752,9 +753,8 @@ void job_free(
     {
     sprintf(log_buf, "2: jobid = %s", pj->ji_qs.ji_jobid);
     unlock_ji_mutex(pj, __func__, log_buf, LOGLEVEL);
-    pthread_mutex_destroy(pj->ji_mutex);
     memset(pj, 254, sizeof(job));
-    free(pj);
+    job_slab_free(pj);
     }
 
   return;
@@ -1502,6 +1502,193 @@ void cleanup_restart_file(
 
 
 
+/*
+ * record_history_attr - add one of the job's attributes to its history record
+ *
+ * Resource lists become one entry per resource.  Everything else is turned
+ * into a string the way the XML job log does it, in ds which the caller
+ * reuses for every attribute.
+ */
+
+static int record_history_attr(
+
+  jh_buf          *jb,    /* M */
+  dynamic_string  *ds,    /* M - scratch */
+  attribute_def   *pdef,  /* I */
+  pbs_attribute   *pattr) /* I */
+
+  {
+  resource *pres;
+  char      buf[MAXLINE];
+  int       rc = PBSE_NONE;
+
+  if (pattr->at_type != ATR_TYPE_RESC)
+    {
+    clear_dynamic_string(ds);
+
+    if ((attr_to_str(ds, pdef, *pattr, FALSE) != PBSE_NONE) ||
+        (ds->used == 0))
+      return(PBSE_NONE);
+
+    return(jh_record_attr(jb, pdef->at_name, NULL, ds->str));
+    }
+
+  for (pres = (resource *)GET_NEXT(pattr->at_val.at_list);
+       (pres != NULL) && (rc == PBSE_NONE);
+       pres = (resource *)GET_NEXT(pres->rs_link))
+    {
+    if ((pres->rs_value.at_flags & ATR_VFLAG_SET) == 0)
+      continue;
+
+    switch (pres->rs_value.at_type)
+      {
+      case ATR_TYPE_LONG:
+
+        snprintf(buf, sizeof(buf), "%ld", pres->rs_value.at_val.at_long);
+        rc = jh_record_attr(jb, pdef->at_name, pres->rs_defin->rs_name, buf);
+
+        break;
+
+      case ATR_TYPE_STR:
+
+        if ((pres->rs_value.at_val.at_str != NULL) &&
+            (pres->rs_value.at_val.at_str[0] != '\0'))
+          rc = jh_record_attr(jb, pdef->at_name, pres->rs_defin->rs_name, pres->rs_value.at_val.at_str);
+
+        break;
+
+      case ATR_TYPE_SIZE:
+
+        clear_dynamic_string(ds);
+        size_to_dynamic_string(ds, &pres->rs_value.at_val.at_size);
+        rc = jh_record_attr(jb, pdef->at_name, pres->rs_defin->rs_name, ds->str);
+
+        break;
+
+      default:
+
+        break;
+      }
+    }
+
+  return(rc);
+  }  /* END record_history_attr() */
+
+
+
+
+/*
+ * record_job_history - record a completed job in the binary job history
+ *
+ * The job_log_binary alternative to the XML job log, see job_history.h.
+ */
+
+static int record_job_history(
+
+  job *pjob)  /* I */
+
+  {
+  pbs_attribute  *pattr;
+  jh_buf          jb;
+  dynamic_string *ds;
+  int             i;
+  int             rc;
+  char           *user = NULL;
+  time_t          qtime = 0;
+  time_t          start = 0;
+  time_t          end = 0;
+  int             exit_status = 0;
+  long            record_job_script = FALSE;
+  char            namebuf[MAXPATHLEN + 1];
+  FILE           *fp;
+  size_t          bytes_read;
+
+  memset(&jb, 0, sizeof(jb));
+
+  if (pjob->ji_wattr[JOB_ATR_euser].at_flags & ATR_VFLAG_SET)
+    user = pjob->ji_wattr[JOB_ATR_euser].at_val.at_str;
+
+  if (pjob->ji_wattr[JOB_ATR_qtime].at_flags & ATR_VFLAG_SET)
+    qtime = pjob->ji_wattr[JOB_ATR_qtime].at_val.at_long;
+
+  if (pjob->ji_wattr[JOB_ATR_start_time].at_flags & ATR_VFLAG_SET)
+    start = pjob->ji_wattr[JOB_ATR_start_time].at_val.at_long;
+
+  if (pjob->ji_wattr[JOB_ATR_comp_time].at_flags & ATR_VFLAG_SET)
+    end = pjob->ji_wattr[JOB_ATR_comp_time].at_val.at_long;
+
+  if (pjob->ji_wattr[JOB_ATR_exitstat].at_flags & ATR_VFLAG_SET)
+    exit_status = pjob->ji_wattr[JOB_ATR_exitstat].at_val.at_long;
+
+  if ((ds = get_dynamic_string(-1, NULL)) == NULL)
+    return(ENOMEM);
+
+  rc = jh_record_start(&jb, pjob->ji_qs.ji_jobid, user, qtime, start, end, exit_status);
+
+  for (i = 0; (i < JOB_ATR_LAST) && (rc == PBSE_NONE); i++)
+    {
+    pattr = &(pjob->ji_wattr[i]);
+
+    /* the dependencies show in submit_args, as in the XML job log */
+    if (((pattr->at_flags & ATR_VFLAG_SET) == 0) ||
+        (i == JOB_ATR_depend))
+      continue;
+
+    rc = record_history_attr(&jb, ds, job_attr_def + i, pattr);
+    }
+
+  get_svr_attr_l(SRV_ATR_RecordJobScript, &record_job_script);
+
+  if ((rc == PBSE_NONE) &&
+      (record_job_script))
+    {
+    snprintf(namebuf, sizeof(namebuf), "%s%s%s",
+      path_jobs, pjob->ji_qs.ji_fileprefix, JOB_SCRIPT_SUFFIX);
+
+    clear_dynamic_string(ds);
+
+    if ((fp = fopen(namebuf, "r")) != NULL)
+      {
+      while ((bytes_read = fread(namebuf, 1, sizeof(namebuf) - 1, fp)) > 0)
+        {
+        namebuf[bytes_read] = '\0';
+        append_dynamic_string(ds, namebuf);
+        }
+
+      fclose(fp);
+      }
+    else
+      {
+      append_dynamic_string(ds, "unable to open script file\n");
+      }
+
+    rc = jh_record_attr(&jb, "job_script", NULL, ds->str);
+    }
+
+  free_dynamic_string(ds);
+
+  if (rc == PBSE_NONE)
+    {
+    if (jh_write_record(&jb, path_jobinfo_log) != PBSE_NONE)
+      {
+      rc = errno;
+
+      log_err(rc, __func__, "could not write to the job history");
+      }
+    }
+  else
+    {
+    log_err(rc, __func__, "could not build the job history record");
+    }
+
+  jh_buf_free(&jb);
+
+  return(rc);
+  }  /* END record_job_history() */
+
+
+
+
 int record_jobinfo(
     
   job *pjob)
@@ -1517,6 +1704,12 @@ int record_jobinfo(
   size_t                  bytes_read = 0;
   extern pthread_mutex_t *job_log_mutex; 
   long                    record_job_script = FALSE;
+  long                    job_log_binary = FALSE;
+
+  get_svr_attr_l(SRV_ATR_JobLogBinary, &job_log_binary);
+
+  if (job_log_binary)
+    return(record_job_history(pjob));
   
   pthread_mutex_lock(job_log_mutex);
   if ((rc = job_log_open(job_log_file, path_jobinfo_log)) < 0)
@@ -1687,6 +1880,12 @@ int svr_job_purge(
   if (LOGLEVEL >= 10)
     LOG_EVENT(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, pjob->ji_qs.ji_jobid);
 
+  /* this is the last event for anyone watching the job */
+  if (pjob->ji_watched == TRUE)
+    notify_job_watchers(pjob, PBSE_UNKJOBID);
+
+  depend_graph_remove_job(pjob->ji_qs.ji_jobid);
+
   /* check to see if we are keeping a log of all jobs completed */
   get_svr_attr_l(SRV_ATR_RecordJobInfo, &record_job_info);
   if (record_job_info)
@@ -1733,7 +1932,14 @@ int svr_job_purge(
         /* if there are no more jobs in the arry,
          * then we can clean that up too */
         pa->ai_qs.num_purged++;
-        if (pa->ai_qs.num_purged == pa->ai_qs.num_jobs)
+
+        if (pa->ai_bulk_ops > 0)
+          {
+          /* a bulk operation on the array saves or deletes it once it
+           * is through all of the subjobs */
+          unlock_ai_mutex(pa, __func__, "2", LOGLEVEL);
+          }
+        else if (pa->ai_qs.num_purged == pa->ai_qs.num_jobs)
           {
           /* array_delete will unlock pa->ai_mutex */
           array_delete(pa);
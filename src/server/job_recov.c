@@ -451,10 +451,10 @@ job *job_recov(
 
 #ifndef PBS_MOM
     unlock_ji_mutex(pj, __func__, "1", LOGLEVEL);
-    free(pj->ji_mutex);
-#endif
-
+    job_slab_free(pj);
+#else
     free((char *)pj);
+#endif
 
     /* FAILURE - cannot open job file */
 
@@ -472,10 +472,10 @@ job *job_recov(
 
 #ifndef PBS_MOM
     unlock_ji_mutex(pj, __func__, "2", LOGLEVEL);
-    free(pj->ji_mutex);
-#endif
-
+    job_slab_free(pj);
+#else
     free((char *)pj);
+#endif
 
     close(fds);
 
@@ -501,10 +501,10 @@ job *job_recov(
 
 #ifndef PBS_MOM
       unlock_ji_mutex(pj, __func__, "3", LOGLEVEL);
-      free(pj->ji_mutex);
-#endif
-
+      job_slab_free(pj);
+#else
       free((char *)pj);
+#endif
 
       close(fds);
 
@@ -530,10 +530,10 @@ job *job_recov(
 
 #ifndef PBS_MOM
     unlock_ji_mutex(pj, __func__, "4", LOGLEVEL);
-    free(pj->ji_mutex);
-#endif
-
+    job_slab_free(pj);
+#else
     free((char *)pj);
+#endif
 
     close(fds);
 
@@ -78,7 +78,17 @@
 */
 
 
+/*
+ * job_recycler.c - where freed jobs wait before their memory is reused
+ *
+ * Job structures come from slabs of JOB_SLAB_JOBS at a time, each with its
+ * mutex alongside it, so creating a job is not two callocs and a slab is
+ * given back to the system whole once all of its jobs are gone.
+ */
+
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 
 #include "pbs_job.h"
 #include "utils.h"
@@ -88,6 +98,173 @@
 extern job_recycler recycler;
 extern int          LOGLEVEL;
 
+/* a job and its mutex; js_job must be first */
+typedef struct job_slot
+  {
+  job              js_job;
+  pthread_mutex_t  js_mutex;
+  struct job_slab *js_slab;
+  struct job_slot *js_next_free;
+  } job_slot;
+
+typedef struct job_slab
+  {
+  struct job_slab *jsl_next;   /* on the list of slabs with free slots */
+  struct job_slab *jsl_prev;
+  job_slot        *jsl_free;   /* free slots in this slab */
+  int              jsl_used;   /* slots handed out */
+  job_slot         jsl_slots[JOB_SLAB_JOBS];
+  } job_slab;
+
+static job_slab        *job_slabs_free = NULL; /* slabs with a free slot */
+static int              job_slabs_empty = 0;   /* of those, ones with no jobs */
+static pthread_mutex_t  job_slab_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+
+/* called with job_slab_mutex held */
+
+static void unlink_job_slab(
+
+  job_slab *slab)
+
+  {
+  if (slab->jsl_prev != NULL)
+    slab->jsl_prev->jsl_next = slab->jsl_next;
+  else
+    job_slabs_free = slab->jsl_next;
+
+  if (slab->jsl_next != NULL)
+    slab->jsl_next->jsl_prev = slab->jsl_prev;
+
+  slab->jsl_next = NULL;
+  slab->jsl_prev = NULL;
+  }  /* END unlink_job_slab() */
+
+
+
+
+/* called with job_slab_mutex held */
+
+static void link_job_slab(
+
+  job_slab *slab)
+
+  {
+  slab->jsl_prev = NULL;
+  slab->jsl_next = job_slabs_free;
+
+  if (job_slabs_free != NULL)
+    job_slabs_free->jsl_prev = slab;
+
+  job_slabs_free = slab;
+  }  /* END link_job_slab() */
+
+
+
+
+/*
+ * job_slab_alloc - get zeroed space for a job
+ *
+ * ji_mutex points at the job's own, newly initialized, mutex.
+ *
+ * Returns the job or NULL if there is no memory
+ */
+
+job *job_slab_alloc(void)
+
+  {
+  job_slab *slab;
+  job_slot *slot;
+  int       i;
+
+  pthread_mutex_lock(&job_slab_mutex);
+
+  if ((slab = job_slabs_free) == NULL)
+    {
+    if ((slab = (job_slab *)malloc(sizeof(job_slab))) == NULL)
+      {
+      pthread_mutex_unlock(&job_slab_mutex);
+
+      return(NULL);
+      }
+
+    slab->jsl_used = 0;
+    slab->jsl_free = NULL;
+
+    for (i = JOB_SLAB_JOBS - 1; i >= 0; i--)
+      {
+      slab->jsl_slots[i].js_slab = slab;
+      slab->jsl_slots[i].js_next_free = slab->jsl_free;
+      slab->jsl_free = &slab->jsl_slots[i];
+      }
+
+    link_job_slab(slab);
+
+    job_slabs_empty++;
+    }
+
+  slot = slab->jsl_free;
+  slab->jsl_free = slot->js_next_free;
+
+  if (slab->jsl_used++ == 0)
+    job_slabs_empty--;
+
+  if (slab->jsl_free == NULL)
+    unlink_job_slab(slab);
+
+  pthread_mutex_unlock(&job_slab_mutex);
+
+  memset(&slot->js_job, 0, sizeof(job));
+  pthread_mutex_init(&slot->js_mutex, NULL);
+  slot->js_job.ji_mutex = &slot->js_mutex;
+
+  return(&slot->js_job);
+  }  /* END job_slab_alloc() */
+
+
+
+
+/*
+ * job_slab_free - give a job's space back to its slab
+ *
+ * The job must be unlocked and no longer reachable.  One slab with no jobs
+ * is kept for the next burst of submissions, others are freed.
+ */
+
+void job_slab_free(
+
+  job *pjob)
+
+  {
+  job_slot *slot = (job_slot *)pjob;
+  job_slab *slab = slot->js_slab;
+
+  pthread_mutex_destroy(&slot->js_mutex);
+
+  pthread_mutex_lock(&job_slab_mutex);
+
+  if (slab->jsl_free == NULL)
+    link_job_slab(slab);
+
+  slot->js_next_free = slab->jsl_free;
+  slab->jsl_free = slot;
+
+  if (--slab->jsl_used == 0)
+    {
+    if (job_slabs_empty > 0)
+      {
+      unlink_job_slab(slab);
+      free(slab);
+      }
+    else
+      job_slabs_empty++;
+    }
+
+  pthread_mutex_unlock(&job_slab_mutex);
+  }  /* END job_slab_free() */
+
 
 void initialize_recycler()
 
@@ -147,9 +324,8 @@ void *remove_some_recycle_jobs(
 
     remove_job(&recycler.rc_jobs, pjob);
     unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
-    free(pjob->ji_mutex);
     memset(pjob, 255, sizeof(job));
-    free(pjob);
+    job_slab_free(pjob);
     }
 
   pthread_mutex_unlock(recycler.rc_mutex);
@@ -6,6 +6,10 @@
 
 void initialize_recycler();
 
+job *job_slab_alloc(void);
+
+void job_slab_free(job *pjob);
+
 void *remove_some_recycle_jobs(void *vp);
 
 int insert_into_recycler(job *pjob);
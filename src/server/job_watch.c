@@ -0,0 +1,765 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * Job watchers let a client block on job state changes instead of polling
+ * pbs_statjob().  The client sends a WatchJobs request naming the jobs, and
+ * after the ack its connection carries one status reply per event: the
+ * current state of each job, every later change of job_state, and a final
+ * PBSE_UNKJOBID event when the job is purged.
+ *
+ * Events are encoded into the watcher's queue while the job is locked, so
+ * they stay in order, but nothing is written there.  Once the ack is out the
+ * connection's thread hands the socket over (job_watch_take_conn()) and one
+ * thread writes the queues of all watchers with non-blocking sends and
+ * closes the connections their clients drop.  A watch does not hold a
+ * thread of its own, and a slow client cannot stall the job or the server.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include "job_watch.h"
+#include "libpbs.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server.h"
+#include "pbs_error.h"
+#include "dis.h"
+#include "tcp.h" /* tcp_chan */
+#include "net_connect.h" /* svr_conn, PBS_NET_CONN_NOTIMEOUT */
+#include "svrfunc.h" /* get_svr_attr_l */
+#include "svr_chk_owner.h" /* svr_authorize_jobreq */
+#include "ji_mutex.h"
+#include "../lib/Liblog/pbs_log.h"
+#include "../lib/Liblog/log_event.h"
+
+/* events a client may fall behind by before its watch is dropped */
+#define WATCH_MAX_QUEUED 1024
+
+typedef struct watch_event
+  {
+  char               *we_data;   /* encoded status reply */
+  size_t              we_len;
+  struct watch_event *we_next;
+  } watch_event;
+
+typedef struct job_watcher
+  {
+  int                  jw_sock;
+  int                  jw_owned;   /* the watch thread has the connection */
+  int                  jw_dead;    /* send nothing more, close the connection */
+  int                  jw_count;   /* job ids in jw_jobids */
+  char               **jw_jobids;
+  watch_event         *jw_head;    /* events not yet written */
+  watch_event         *jw_tail;
+  size_t               jw_sent;    /* bytes of jw_head already written */
+  int                  jw_queued;
+  int                  jw_pollidx; /* entry in the watch thread's poll set, 0 if none */
+  struct job_watcher  *jw_next;
+  } job_watcher;
+
+static job_watcher     *watchers = NULL;
+static pthread_mutex_t  watchers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t   watch_thread_once = PTHREAD_ONCE_INIT;
+static int              watch_wakeup_fds[2] = { -1, -1 };
+
+extern int                LOGLEVEL;
+extern struct connection  svr_conn[];
+extern attribute_def      job_attr_def[];
+
+
+
+
+/*
+ * wake_watch_thread - make the watch thread look at the watchers again
+ */
+
+static void wake_watch_thread(void)
+
+  {
+  char c = 0;
+
+  if (watch_wakeup_fds[1] >= 0)
+    send(watch_wakeup_fds[1], &c, 1, MSG_DONTWAIT);
+  }  /* END wake_watch_thread() */
+
+
+
+
+/*
+ * encode_job_event - encode one job event for a watching client
+ *
+ * The event is a status reply for job_id carrying job_state and, once it
+ * is set, exit_status.  pjob is NULL when the job is not known.
+ */
+
+static watch_event *encode_job_event(
+
+  job  *pjob,    /* I (optional, locked) */
+  char *job_id,  /* I */
+  int   code)    /* I */
+
+  {
+  struct batch_reply  reply;
+  struct brp_status  *pstat;
+  struct tcp_chan    *chan;
+  watch_event        *pev = NULL;
+  size_t              len;
+
+  memset(&reply, 0, sizeof(reply));
+  reply.brp_code = code;
+  reply.brp_choice = BATCH_REPLY_CHOICE_Status;
+  CLEAR_HEAD(reply.brp_un.brp_status);
+
+  if ((pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status))) == NULL)
+    return(NULL);
+
+  CLEAR_LINK(pstat->brp_stlink);
+  CLEAR_HEAD(pstat->brp_attr);
+  pstat->brp_objtype = MGR_OBJ_JOB;
+  snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s", job_id);
+
+  append_link(&reply.brp_un.brp_status, &pstat->brp_stlink, pstat);
+
+  if (pjob != NULL)
+    {
+    job_attr_def[JOB_ATR_state].at_encode(
+      &pjob->ji_wattr[JOB_ATR_state],
+      &pstat->brp_attr,
+      job_attr_def[JOB_ATR_state].at_name,
+      NULL,
+      ATR_ENCODE_CLIENT,
+      ATR_DFLAG_RDACC);
+
+    job_attr_def[JOB_ATR_exitstat].at_encode(
+      &pjob->ji_wattr[JOB_ATR_exitstat],
+      &pstat->brp_attr,
+      job_attr_def[JOB_ATR_exitstat].at_name,
+      NULL,
+      ATR_ENCODE_CLIENT,
+      ATR_DFLAG_RDACC);
+    }
+
+  /* the channel is only used as a buffer, it is never flushed */
+  if ((chan = DIS_tcp_setup(-1)) != NULL)
+    {
+    if (encode_DIS_reply(chan, &reply) == DIS_SUCCESS)
+      {
+      len = chan->writebuf.tdis_trailp - chan->writebuf.tdis_thebuf;
+
+      if ((pev = (watch_event *)calloc(1, sizeof(watch_event))) != NULL)
+        {
+        if ((pev->we_data = (char *)malloc(len + 1)) == NULL)
+          {
+          free(pev);
+          pev = NULL;
+          }
+        else
+          {
+          memcpy(pev->we_data, chan->writebuf.tdis_thebuf, len);
+          pev->we_len = len;
+          }
+        }
+      }
+
+    DIS_tcp_cleanup(chan);
+    }
+
+  reply_free(&reply);
+
+  return(pev);
+  }  /* END encode_job_event() */
+
+
+
+
+/*
+ * queue_job_event - add an event to a watcher's queue
+ *
+ * A client that falls too far behind, or an event that cannot be encoded,
+ * ends the watch.  The caller holds watchers_mutex.
+ */
+
+static void queue_job_event(
+
+  job_watcher *pw,      /* I (modified) */
+  job         *pjob,    /* I (optional, locked) */
+  char        *job_id,  /* I */
+  int          code)    /* I */
+
+  {
+  watch_event *pev;
+  char         log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if (pw->jw_dead == TRUE)
+    return;
+
+  if ((pw->jw_queued >= WATCH_MAX_QUEUED) ||
+      ((pev = encode_job_event(pjob, job_id, code)) == NULL))
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "cannot queue event for job %s on socket %d, dropping watcher",
+      job_id,
+      pw->jw_sock);
+    log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+
+    pw->jw_dead = TRUE;
+
+    wake_watch_thread();
+
+    return;
+    }
+
+  if (pw->jw_tail == NULL)
+    pw->jw_head = pev;
+  else
+    pw->jw_tail->we_next = pev;
+
+  pw->jw_tail = pev;
+  pw->jw_queued++;
+
+  /* an empty queue means the watch thread is not waiting to write */
+  if (pw->jw_head == pev)
+    wake_watch_thread();
+  }  /* END queue_job_event() */
+
+
+
+
+/*
+ * free_watcher - free a watcher that is no longer on the list
+ */
+
+static void free_watcher(
+
+  job_watcher *pw)  /* I (freed) */
+
+  {
+  watch_event *pev;
+  int          i;
+
+  while ((pev = pw->jw_head) != NULL)
+    {
+    pw->jw_head = pev->we_next;
+
+    free(pev->we_data);
+    free(pev);
+    }
+
+  for (i = 0; i < pw->jw_count; i++)
+    free(pw->jw_jobids[i]);
+
+  free(pw->jw_jobids);
+  free(pw);
+  }  /* END free_watcher() */
+
+
+
+
+/*
+ * watcher_write - write as much of a watcher's queue as the socket takes
+ *
+ * Returns FALSE if the connection failed.  The caller holds watchers_mutex.
+ */
+
+static int watcher_write(
+
+  job_watcher *pw)  /* I (modified) */
+
+  {
+  watch_event *pev;
+  ssize_t      ct;
+
+  while ((pev = pw->jw_head) != NULL)
+    {
+    ct = send(pw->jw_sock, pev->we_data + pw->jw_sent, pev->we_len - pw->jw_sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+    if (ct < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      return((errno == EAGAIN) || (errno == EWOULDBLOCK));
+      }
+
+    pw->jw_sent += ct;
+
+    if (pw->jw_sent < pev->we_len)
+      continue;
+
+    pw->jw_head = pev->we_next;
+
+    if (pw->jw_head == NULL)
+      pw->jw_tail = NULL;
+
+    pw->jw_sent = 0;
+    pw->jw_queued--;
+
+    free(pev->we_data);
+    free(pev);
+    }
+
+  return(TRUE);
+  }  /* END watcher_write() */
+
+
+
+
+/*
+ * watcher_readable - read what the client sent on a watch connection
+ *
+ * Clients send nothing after WatchJobs, so data is discarded.  Returns FALSE
+ * once the client has closed the connection.
+ */
+
+static int watcher_readable(
+
+  int sock)  /* I */
+
+  {
+  char    buf[256];
+  ssize_t ct;
+
+  while ((ct = recv(sock, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+    ;
+
+  if (ct == 0)
+    return(FALSE);
+
+  return((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+  }  /* END watcher_readable() */
+
+
+
+
+/*
+ * job_watch_thread - write queued events and close finished watch connections
+ */
+
+static void *job_watch_thread(
+
+  void *arg)
+
+  {
+  struct pollfd  *fds = NULL;
+  int             fds_size = 0;
+  int             nfds;
+  int             i;
+  int             alive;
+  char            buf[64];
+  job_watcher   **prev;
+  job_watcher    *pw;
+  job_watcher    *closed;
+
+  while (1)
+    {
+    closed = NULL;
+    nfds = 1;
+
+    pthread_mutex_lock(&watchers_mutex);
+
+    for (pw = watchers; pw != NULL; pw = pw->jw_next)
+      nfds++;
+
+    if (nfds > fds_size)
+      {
+      struct pollfd *tmp = (struct pollfd *)realloc(fds, nfds * sizeof(struct pollfd));
+
+      if (tmp == NULL)
+        {
+        pthread_mutex_unlock(&watchers_mutex);
+
+        log_err(ENOMEM, __func__, "cannot allocate poll set");
+        sleep(1);
+
+        continue;
+        }
+
+      fds = tmp;
+      fds_size = nfds;
+      }
+
+    fds[0].fd = watch_wakeup_fds[0];
+    fds[0].events = POLLIN;
+    nfds = 1;
+
+    for (pw = watchers; pw != NULL; pw = pw->jw_next)
+      {
+      pw->jw_pollidx = 0;
+
+      if (pw->jw_owned == FALSE)
+        continue;
+
+      pw->jw_pollidx = nfds;
+      fds[nfds].fd = pw->jw_sock;
+      fds[nfds].events = POLLIN;
+
+      if (pw->jw_head != NULL)
+        fds[nfds].events |= POLLOUT;
+
+      nfds++;
+      }
+
+    pthread_mutex_unlock(&watchers_mutex);
+
+    if (poll(fds, nfds, -1) < 0)
+      {
+      if (errno != EINTR)
+        {
+        log_err(errno, __func__, "poll failed");
+        sleep(1);
+        }
+
+      continue;
+      }
+
+    if (fds[0].revents != 0)
+      {
+      while (recv(watch_wakeup_fds[0], buf, sizeof(buf), MSG_DONTWAIT) > 0)
+        ;
+      }
+
+    pthread_mutex_lock(&watchers_mutex);
+
+    prev = &watchers;
+
+    while ((pw = *prev) != NULL)
+      {
+      alive = (pw->jw_dead == FALSE);
+      i = pw->jw_pollidx;
+
+      if ((alive == TRUE) &&
+          (i > 0))
+        {
+        if (fds[i].revents & (POLLERR | POLLNVAL))
+          alive = FALSE;
+        else if ((fds[i].revents & (POLLIN | POLLHUP)) &&
+                 (watcher_readable(pw->jw_sock) == FALSE))
+          alive = FALSE;
+        }
+
+      if ((alive == TRUE) &&
+          (pw->jw_owned == TRUE))
+        alive = watcher_write(pw);
+
+      if ((alive == TRUE) ||
+          (pw->jw_owned == FALSE))
+        {
+        prev = &pw->jw_next;
+
+        continue;
+        }
+
+      *prev = pw->jw_next;
+      pw->jw_next = closed;
+      closed = pw;
+      }
+
+    pthread_mutex_unlock(&watchers_mutex);
+
+    while ((pw = closed) != NULL)
+      {
+      closed = pw->jw_next;
+
+      close_conn(pw->jw_sock, FALSE);
+
+      free_watcher(pw);
+      }
+    }
+
+  return(NULL);
+  }  /* END job_watch_thread() */
+
+
+
+
+/*
+ * start_job_watch_thread - set up the wakeup socket and start the thread
+ */
+
+static void start_job_watch_thread(void)
+
+  {
+  pthread_t      tid;
+  pthread_attr_t attr;
+
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, watch_wakeup_fds) != 0)
+    {
+    log_err(errno, __func__, "cannot create the job watch wakeup socket");
+
+    watch_wakeup_fds[0] = -1;
+    watch_wakeup_fds[1] = -1;
+
+    return;
+    }
+
+  fcntl(watch_wakeup_fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(watch_wakeup_fds[1], F_SETFD, FD_CLOEXEC);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  if (pthread_create(&tid, &attr, job_watch_thread, NULL) != 0)
+    log_err(errno, __func__, "cannot start the job watch thread");
+
+  pthread_attr_destroy(&attr);
+  }  /* END start_job_watch_thread() */
+
+
+
+
+/*
+ * notify_job_watchers - queue a job's new state for every client watching it
+ *
+ * Called with the job locked.  A code other than PBSE_NONE is the job's
+ * last event and stops the watch.
+ */
+
+void notify_job_watchers(
+
+  job *pjob,  /* I (locked) */
+  int  code)  /* I */
+
+  {
+  job_watcher *pw;
+  int          i;
+
+  pthread_mutex_lock(&watchers_mutex);
+
+  for (pw = watchers; pw != NULL; pw = pw->jw_next)
+    {
+    for (i = 0; i < pw->jw_count; i++)
+      {
+      if (!strcmp(pw->jw_jobids[i], pjob->ji_qs.ji_jobid))
+        break;
+      }
+
+    if (i == pw->jw_count)
+      continue;
+
+    queue_job_event(pw, pjob, pw->jw_jobids[i], code);
+
+    if (code != PBSE_NONE)
+      {
+      free(pw->jw_jobids[i]);
+
+      pw->jw_jobids[i] = pw->jw_jobids[--pw->jw_count];
+      }
+    }
+
+  pthread_mutex_unlock(&watchers_mutex);
+  }  /* END notify_job_watchers() */
+
+
+
+
+/*
+ * job_watch_take_conn - hand a watch connection to the job watch thread
+ *
+ * Called by the connection's thread after each request.  Returns TRUE if
+ * sock now carries a watch, in which case the thread must stop reading it
+ * and must not close it.
+ */
+
+int job_watch_take_conn(
+
+  int sock)  /* I */
+
+  {
+  job_watcher *pw;
+  int          taken = FALSE;
+
+  pthread_mutex_lock(&watchers_mutex);
+
+  for (pw = watchers; pw != NULL; pw = pw->jw_next)
+    {
+    if ((pw->jw_sock == sock) &&
+        (pw->jw_owned == FALSE))
+      {
+      pw->jw_owned = TRUE;
+      taken = TRUE;
+      }
+    }
+
+  pthread_mutex_unlock(&watchers_mutex);
+
+  if (taken == TRUE)
+    wake_watch_thread();
+
+  return(taken);
+  }  /* END job_watch_take_conn() */
+
+
+
+
+/*
+ * remove_job_watchers - forget the watchers of a closing connection that
+ * was never handed to the watch thread
+ */
+
+void remove_job_watchers(
+
+  int sock)  /* I */
+
+  {
+  job_watcher **prev;
+  job_watcher  *pw;
+
+  pthread_mutex_lock(&watchers_mutex);
+
+  prev = &watchers;
+
+  while ((pw = *prev) != NULL)
+    {
+    if ((pw->jw_sock != sock) ||
+        (pw->jw_owned == TRUE))
+      {
+      prev = &pw->jw_next;
+
+      continue;
+      }
+
+    *prev = pw->jw_next;
+
+    free_watcher(pw);
+    }
+
+  pthread_mutex_unlock(&watchers_mutex);
+  }  /* END remove_job_watchers() */
+
+
+
+
+/*
+ * req_watchjobs - register the client's interest in a set of jobs
+ *
+ * Permissions follow pbs_statjob(): without query_other_jobs a client may
+ * only watch jobs it is authorized for.  Jobs that cannot be watched get a
+ * single PBSE_UNKJOBID or PBSE_PERM event right after the ack.
+ */
+
+int req_watchjobs(
+
+  struct batch_request *preq)  /* I (freed) */
+
+  {
+  int            sock = preq->rq_conn;
+  int            count = preq->rq_ind.rq_watchjobs.rq_count;
+  char         **job_ids = preq->rq_ind.rq_watchjobs.rq_jobids;
+  int           *verdict;
+  int            i;
+  long           query_others = FALSE;
+  job           *pjob;
+  job_watcher   *pw;
+
+  if (count <= 0)
+    {
+    req_reject(PBSE_IVALREQ, 0, preq, NULL, NULL);
+
+    return(PBSE_IVALREQ);
+    }
+
+  verdict = (int *)calloc(count, sizeof(int));
+  pw = (job_watcher *)calloc(1, sizeof(job_watcher));
+
+  if ((verdict == NULL) ||
+      (pw == NULL) ||
+      ((pw->jw_jobids = (char **)calloc(count, sizeof(char *))) == NULL))
+    {
+    free(verdict);
+
+    if (pw != NULL)
+      free(pw);
+
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+
+    return(PBSE_SYSTEM);
+    }
+
+  get_svr_attr_l(SRV_ATR_query_others, &query_others);
+
+  for (i = 0; i < count; i++)
+    {
+    if ((pjob = svr_find_job(job_ids[i], FALSE)) == NULL)
+      {
+      verdict[i] = PBSE_UNKJOBID;
+
+      continue;
+      }
+
+    if ((!query_others) &&
+        (svr_authorize_jobreq(preq, pjob) != 0))
+      verdict[i] = PBSE_PERM;
+
+    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+    }
+
+  /* the job ids now belong to the watcher, not the request */
+  preq->rq_ind.rq_watchjobs.rq_jobids = NULL;
+  preq->rq_ind.rq_watchjobs.rq_count = 0;
+
+  pw->jw_sock = sock;
+
+  pthread_once(&watch_thread_once, start_job_watch_thread);
+
+  /* the connection sits idle between events */
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+  svr_conn[sock].cn_authen |= PBS_NET_CONN_NOTIMEOUT;
+  pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+  /* list the watcher before the ack, nothing is written to the client
+   * until this thread hands the connection over after the ack */
+  pthread_mutex_lock(&watchers_mutex);
+  pw->jw_next = watchers;
+  watchers = pw;
+  pthread_mutex_unlock(&watchers_mutex);
+
+  reply_ack(preq);
+
+  for (i = 0; i < count; i++)
+    {
+    pjob = NULL;
+
+    if ((verdict[i] == PBSE_NONE) &&
+        ((pjob = svr_find_job(job_ids[i], FALSE)) == NULL))
+      verdict[i] = PBSE_UNKJOBID;
+
+    pthread_mutex_lock(&watchers_mutex);
+
+    if (pjob != NULL)
+      {
+      /* the job is locked, so its current state and the next change
+       * reach the client in order */
+      pjob->ji_watched = TRUE;
+
+      pw->jw_jobids[pw->jw_count++] = job_ids[i];
+      job_ids[i] = NULL;
+
+      queue_job_event(pw, pjob, pw->jw_jobids[pw->jw_count - 1], PBSE_NONE);
+      }
+    else
+      {
+      queue_job_event(pw, NULL, job_ids[i], verdict[i]);
+      }
+
+    pthread_mutex_unlock(&watchers_mutex);
+
+    if (pjob != NULL)
+      unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
+
+    if (job_ids[i] != NULL)
+      free(job_ids[i]);
+    }
+
+  free(job_ids);
+  free(verdict);
+
+  return(PBSE_NONE);
+  }  /* END req_watchjobs() */
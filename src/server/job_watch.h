@@ -0,0 +1,16 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _JOB_WATCH_H
+#define _JOB_WATCH_H
+
+#include "batch_request.h" /* batch_request */
+#include "pbs_job.h" /* job */
+
+int req_watchjobs(struct batch_request *preq);
+
+void notify_job_watchers(job *pjob, int code);
+
+int job_watch_take_conn(int sock);
+
+void remove_job_watchers(int sock);
+
+#endif /* _JOB_WATCH_H */
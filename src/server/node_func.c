@@ -69,6 +69,8 @@ extern char            *path_nodes_new;
 extern char            *path_nodes;
 extern char            *path_nodestate;
 extern char            *path_nodenote;
+extern int              node_state_records;
+extern int              node_note_records;
 extern int              LOGLEVEL;
 extern attribute_def    node_attr_def[];   /* node attributes defs */
 extern AvlTree          ipaddrs;
@@ -2309,6 +2311,10 @@ int setup_nodes(void)
 
   fclose(nin);
 
+  /* node changes are appended to the state and note files, so a later
+   * line for a node replaces an earlier one */
+  node_state_records = 0;
+
   nin = fopen(path_nodestate, "r");
 
   if (nin != NULL)
@@ -2317,44 +2323,57 @@ int setup_nodes(void)
                   line,
                   &num) == 2)
       {
-      int iter = -1;
+      node_state_records++;
 
-      while ((np = next_host(&allnodes,&iter,NULL)) != NULL)
+      if ((np = find_nodebyname(line)) != NULL)
         {
-        if (strcmp(np->nd_name, line) == 0)
-          {
-          np->nd_state = num | INUSE_NEEDS_HELLO_PING;
+        np->nd_state = num | INUSE_NEEDS_HELLO_PING;
 
-          /* exclusive bits are calculated later in set_old_nodes() */
-          np->nd_state &= ~INUSE_JOB;
-
-          unlock_node(np, __func__, "match", LOGLEVEL);
-
-          break;
-          }
+        /* exclusive bits are calculated later in set_old_nodes() */
+        np->nd_state &= ~INUSE_JOB;
 
-        unlock_node(np, __func__, "no match", LOGLEVEL);
+        unlock_node(np, __func__, "match", LOGLEVEL);
         }
       }
 
     fclose(nin);
     }
 
-  /* initialize note attributes */
+  /* initialize note attributes, a node name alone clears its note */
+  node_note_records = 0;
+
   nin = fopen(path_nodenote, "r");
 
   if (nin != NULL)
     {
-
-    while (fscanf(nin, "%s %" MAX_NOTE_STR "[^\n]",
-                  line,
-                  note) == 2)
+    while (fgets(line, sizeof(line), nin) != NULL)
       {
+      line[strcspn(line, "\n")] = '\0';
+
+      if (line[0] == '\0')
+        continue;
+
+      node_note_records++;
+
+      note[0] = '\0';
+
+      if ((val = strchr(line, ' ')) != NULL)
+        {
+        *val++ = '\0';
+
+        snprintf(note, sizeof(note), "%s", val);
+        }
+
       if ((np = find_nodebyname(line)) != NULL)
         {
-        np->nd_note = strdup(note);
-        
-        if (np->nd_note == NULL)
+        if (np->nd_note != NULL)
+          {
+          free(np->nd_note);
+          np->nd_note = NULL;
+          }
+
+        if ((note[0] != '\0') &&
+            ((np->nd_note = strdup(note)) == NULL))
           {
           snprintf(log_buf, sizeof(log_buf),
             "couldn't allocate space for note (node = %s)", np->nd_name);          
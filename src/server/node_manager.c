@@ -86,6 +86,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <stdarg.h>
@@ -206,6 +207,19 @@ job *get_job_from_jobinfo(struct jobinfo *,struct pbsnode *);
 /* marks a stream as finished being serviced */
 pthread_mutex_t        *node_state_mutex = NULL;
 
+/* serializes appends to and rewrites of the node note file */
+static pthread_mutex_t  node_note_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * A single node's offline or note change is appended to the node state or
+ * note file.  Once a file holds this many more lines than there are nodes
+ * the next change rewrites it with one line per node instead.
+ */
+#define NODE_RECORD_SLACK 1024
+
+int                     node_state_records = 0; /* lines in the node state file */
+int                     node_note_records = 0;  /* lines in the node note file */
+
 
 
 
@@ -1309,11 +1323,15 @@ void *write_node_state_work(
   ** node has been marked offline.
   */
 
+  node_state_records = 0;
+
   while ((np = next_host(&allnodes,&iter,NULL)) != NULL)
     {
     if (np->nd_state & INUSE_OFFLINE)
       {
       fprintf(nstatef, fmt, np->nd_name, np->nd_state & savemask);
+
+      node_state_records++;
       }
 
     unlock_node(np, __func__, NULL, LOGLEVEL);
@@ -1335,6 +1353,89 @@ void *write_node_state_work(
 
 
 
+/*
+ * append_node_record - append one line to the node state or note file
+ */
+
+static int append_node_record(
+
+  char *path,  /* I */
+  char *line)  /* I */
+
+  {
+  int    fd;
+  int    rc = PBSE_NONE;
+  size_t len = strlen(line);
+
+  if ((fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0)
+    {
+    log_err(errno, __func__, path);
+
+    return(-1);
+    }
+
+  if (write(fd, line, len) != (ssize_t)len)
+    {
+    log_err(errno, __func__, path);
+
+    rc = -1;
+    }
+
+  close(fd);
+
+  return(rc);
+  }  /* END append_node_record() */
+
+
+
+
+/*
+ * record_node_state - save one node's offline state without rewriting
+ * the whole node state file
+ *
+ * The caller must not hold the node's lock.
+ *
+ * Returns PBSE_NONE, or -1 if the caller should call write_node_state()
+ * instead (the file is due to be compacted, or the append failed)
+ */
+
+int record_node_state(
+
+  char *node_name)  /* I */
+
+  {
+  struct pbsnode *np;
+  char            line[PBS_MAXHOSTNAME + 32];
+  int             rc;
+
+  pthread_mutex_lock(node_state_mutex);
+
+  if ((node_state_records >= svr_totnodes + NODE_RECORD_SLACK) ||
+      ((np = find_nodebyname(node_name)) == NULL))
+    {
+    pthread_mutex_unlock(node_state_mutex);
+
+    return(-1);
+    }
+
+  /* as in write_node_state_work(), only offline and reserve are kept */
+  snprintf(line, sizeof(line), "%s %d\n",
+    np->nd_name,
+    np->nd_state & (INUSE_OFFLINE | INUSE_RESERVE));
+
+  unlock_node(np, __func__, NULL, LOGLEVEL);
+
+  if ((rc = append_node_record(path_nodestate, line)) == PBSE_NONE)
+    node_state_records++;
+
+  pthread_mutex_unlock(node_state_mutex);
+
+  return(rc);
+  }  /* END record_node_state() */
+
+
+
+
 
 void write_node_state(void)
 
@@ -1359,6 +1460,7 @@ int write_node_note(void)
   {
   struct pbsnode *np;
   int             iter = -1;
+  int             records = 0;
   FILE           *nin;
 
   if (LOGLEVEL >= 2)
@@ -1366,6 +1468,8 @@ int write_node_note(void)
     DBPRT(("%s: entered\n", __func__))
     }
 
+  pthread_mutex_lock(&node_note_mutex);
+
   if ((nin = fopen(path_nodenote_new, "w")) == NULL)
     goto err1;
 
@@ -1376,6 +1480,8 @@ int write_node_note(void)
 
     fclose(nin);
 
+    pthread_mutex_unlock(&node_note_mutex);
+
     return(-1);
     }
 
@@ -1387,6 +1493,8 @@ int write_node_note(void)
         (np->nd_note[0] != '\0'))
       {
       fprintf(nin, "%s %s\n", np->nd_name, np->nd_note);
+
+      records++;
       }
     
     unlock_node(np, __func__, NULL, LOGLEVEL);
@@ -1407,20 +1515,77 @@ int write_node_note(void)
     log_event(PBSEVENT_ADMIN, PBS_EVENTCLASS_SERVER, __func__,
       "replacing old node note file failed");
 
+    pthread_mutex_unlock(&node_note_mutex);
+
     return(-1);
     }
 
+  node_note_records = records;
+
+  pthread_mutex_unlock(&node_note_mutex);
+
   return(PBSE_NONE);
 
 err1:
   log_event(PBSEVENT_ADMIN, PBS_EVENTCLASS_SERVER, __func__,
     "Node note file update failed");
 
+  pthread_mutex_unlock(&node_note_mutex);
+
   return(-1);
   }  /* END write_node_note() */
 
 
 
+
+/*
+ * record_node_note - save one node's note without rewriting the whole
+ * node note file
+ *
+ * A line with just the node name clears its note.  The caller must not
+ * hold the node's lock.
+ *
+ * Returns PBSE_NONE, or -1 if the caller should call write_node_note()
+ * instead
+ */
+
+int record_node_note(
+
+  char *node_name)  /* I */
+
+  {
+  struct pbsnode *np;
+  char            line[PBS_MAXHOSTNAME + MAX_NOTE + 3];
+  int             rc;
+
+  pthread_mutex_lock(&node_note_mutex);
+
+  if ((node_note_records >= svr_totnodes + NODE_RECORD_SLACK) ||
+      ((np = find_nodebyname(node_name)) == NULL))
+    {
+    pthread_mutex_unlock(&node_note_mutex);
+
+    return(-1);
+    }
+
+  if ((np->nd_note != NULL) &&
+      (np->nd_note[0] != '\0'))
+    snprintf(line, sizeof(line), "%s %s\n", np->nd_name, np->nd_note);
+  else
+    snprintf(line, sizeof(line), "%s\n", np->nd_name);
+
+  unlock_node(np, __func__, NULL, LOGLEVEL);
+
+  if ((rc = append_node_record(path_nodenote, line)) == PBSE_NONE)
+    node_note_records++;
+
+  pthread_mutex_unlock(&node_note_mutex);
+
+  return(rc);
+  }  /* END record_node_note() */
+
+
+
 /*
  * free_prop - free list of prop structures created by proplist()
  */
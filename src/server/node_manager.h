@@ -43,6 +43,10 @@ void write_node_state(void);
 
 int write_node_note(void);
 
+int record_node_state(char *node_name);
+
+int record_node_note(char *node_name);
+
 /* static void free_prop(struct prop *prop); */
 
 void *node_unreserve_work(void *vp);
@@ -2130,6 +2130,11 @@ int pbsd_init(
   /* mark all nodes as needing a hello */
   add_all_nodes_to_hello_container();
 
+  /* from here on readers use the lock-free copy of the server attributes */
+  pthread_mutex_lock(server.sv_attr_mutex);
+  svr_attr_publish_all();
+  pthread_mutex_unlock(server.sv_attr_mutex);
+
   /* allow the threadpool to start processing */
   start_request_pool();
 
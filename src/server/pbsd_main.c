@@ -140,6 +140,7 @@
 #include "ji_mutex.h"
 #include "job_route.h" /* queue_route */
 #include "exiting_jobs.h"
+#include "job_watch.h" /* job_watch_take_conn, remove_job_watchers */
 
 #define TASK_CHECK_INTERVAL    10
 #define HELLO_WAIT_TIME        600
@@ -157,6 +158,7 @@ extern int  schedule_jobs(void);
 extern int  notify_listeners(void);
 extern void svr_shutdown(int);
 extern void acct_close(void);
+extern void mail_drain(void);
 extern int  svr_startjob(job *, struct batch_request *, char *, char *);
 extern int RPPConfigure(int, int);
 extern void acct_cleanup(long);
@@ -384,23 +386,26 @@ static void need_y_response(
 
 
 
+/*
+ * process_pbs_server_port
+ *
+ * Handle one request read from chan.  The caller keeps chan for the life of
+ * the connection, so requests a client sends without waiting for replies
+ * stay buffered between calls.
+ */
+
 int process_pbs_server_port(
      
-  int sock,
-  int is_scheduler_port)
+  struct tcp_chan *chan,
+  int              is_scheduler_port)
  
   {
   int              proto_type;
   int              rc = PBSE_NONE;
   int              version;
+  int              sock = chan->sock;
   char             log_buf[LOCAL_LOG_BUF_SIZE];
-  struct tcp_chan *chan = NULL;
    
-  if ((chan = DIS_tcp_setup(sock)) == NULL)
-    {
-    return(PBSE_MEM_MALLOC);
-    }
-
   proto_type = disrui_peek(chan,&rc);
   
   switch (proto_type)
@@ -469,9 +474,6 @@ int process_pbs_server_port(
       }
     }
 
-  if (chan != NULL)
-    DIS_tcp_cleanup(chan);
-
   return(rc);
   }  /* END process_pbs_server_port() */
 
@@ -493,6 +495,10 @@ void process_pbs_server_port_scheduler(
   {
   int rc = PBSE_NONE;
   int sock = *new_sock;
+  struct tcp_chan *chan;
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    rc = PBSE_MEM_MALLOC;
 
   while ((rc != PBSE_SOCKET_DATA) && 
          (rc != PBSE_SOCKET_INFORMATION) &&
@@ -502,14 +508,18 @@ void process_pbs_server_port_scheduler(
          (rc != PBSE_SOCKET_CLOSE))
     {
     netcounter_incr();
-    rc = process_pbs_server_port(sock, TRUE);
+    rc = process_pbs_server_port(chan, TRUE);
     }
 
+  DIS_tcp_cleanup(chan);
+
   /* 
    * Socket should have been closed by scheduler, except in error cases,
    * but we still need to call close_conn() to clean up connections.
    */
 
+  reply_owed_forget(sock);
+
   close_conn(sock, FALSE);
 
   scheduler_close();
@@ -526,9 +536,13 @@ void *start_process_pbs_server_port(
   {
   int sock = *(int *)new_sock;
   int rc = PBSE_NONE;
+  struct tcp_chan *chan;
  
   free(new_sock);
 
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    rc = PBSE_MEM_MALLOC;
+
   while ((rc != PBSE_SOCKET_DATA) &&
          (rc != PBSE_SOCKET_INFORMATION) &&
          (rc != PBSE_INTERNAL) &&
@@ -538,9 +552,28 @@ void *start_process_pbs_server_port(
     {
     netcounter_incr();
 
-    rc = process_pbs_server_port(sock, FALSE);
+    rc = process_pbs_server_port(chan, FALSE);
+
+    /* replies on a connection go out in the order of its requests */
+    wait_for_owed_reply(sock);
+
+    /* a watch connection now belongs to the job watch thread */
+    if (job_watch_take_conn(sock) == TRUE)
+      {
+      reply_owed_forget(sock);
+
+      DIS_tcp_cleanup(chan);
+
+      return(NULL);
+      }
     }
 
+  DIS_tcp_cleanup(chan);
+
+  remove_job_watchers(sock);
+
+  reply_owed_forget(sock);
+
   close_conn(sock, FALSE);
 
   /* Thread exit */
@@ -1319,6 +1352,7 @@ void main_loop(void)
   long          when = 0;
   long          timeout = 0;
   long          log = 0;
+  long          log_index = FALSE;
   long          scheduling = FALSE;
   long          sched_iteration = 0;
   time_t        time_now = time(NULL);
@@ -1491,6 +1525,9 @@ void main_loop(void)
       LOGLEVEL = log;
       }
 
+    get_svr_attr_l(SRV_ATR_LogFileIndex, &log_index);
+    log_set_index(log_index);
+
     /* qmgr can dynamically set the loglevel specification
      * we use the new value if PBSLOGLEVEL was not specified
      */
@@ -1984,6 +2021,9 @@ int main(
     msg_daemonname,
     msg_svrdown);
 
+  /* job mail held back for coalescing or the rate limit goes out now */
+  mail_drain();
+
   acct_close();
 
   pthread_mutex_lock(log_mutex);
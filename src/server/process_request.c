@@ -125,6 +125,7 @@
 #include "req_gpuctrl.h" /* req_gpuctrl_svr */
 #include "req_getcred.h" /* req_altauthenuer */ 
 #include "req_quejob.h" /* req_quejob, req_jobcredential, req_mvjobfile */ 
+#include "req_submitjob.h" /* req_submitjob */
 #include "req_holdjob.h" /* req_holdjob, req_checkpointjob */ 
 #include "req_holdarray.h" /* req_holdarray */ 
 #include "req_stat.h" /* req_stat_node */ 
@@ -147,6 +148,159 @@
 #include "job_func.h" /* svr_job_purge */
 #include "tcp.h" /* tcp_chan */
 #include "ji_mutex.h"
+#include "job_watch.h" /* req_watchjobs */
+
+/*
+ * A client may send several requests without waiting for the replies (see
+ * pbsD_pipeline.c) and matches the replies to its requests by their order.
+ * Most requests are answered before process_request() returns, but some
+ * are answered later from another thread (a delete of a job being started
+ * is retried from a work task, for one).  So the connection's thread does
+ * not read the next request until the last one has been answered, or freed
+ * without an answer, and replies on a connection never overtake each other.
+ *
+ * A socket number is reused once its connection closes, so each one also
+ * carries a generation that moves on whenever an owed reply is given up
+ * on.  A late answer to a request from an earlier generation leaves the
+ * flag alone.
+ */
+
+static int             reply_owed[PBS_NET_MAX_CONNECTIONS];
+static unsigned int    reply_owed_gen[PBS_NET_MAX_CONNECTIONS];
+static pthread_mutex_t reply_owed_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  reply_owed_cond = PTHREAD_COND_INITIALIZER;
+
+extern time_t pbs_tcp_timeout;
+
+
+
+
+/*
+ * reply_owed_set - note that preq's connection waits for its reply
+ */
+
+void reply_owed_set(
+
+  struct batch_request *preq)  /* I (modified) */
+
+  {
+  int sock = preq->rq_conn;
+
+  if ((sock < 0) || (sock >= PBS_NET_MAX_CONNECTIONS))
+    return;
+
+  pthread_mutex_lock(&reply_owed_mutex);
+  reply_owed[sock] = TRUE;
+  preq->rq_owed_gen = reply_owed_gen[sock];
+  pthread_mutex_unlock(&reply_owed_mutex);
+
+  preq->rq_owed_conn = sock;
+  }  /* END reply_owed_set() */
+
+
+
+
+/*
+ * reply_owed_done - preq has been answered or is being freed, let its
+ * connection read the next request
+ */
+
+void reply_owed_done(
+
+  struct batch_request *preq)  /* I (modified) */
+
+  {
+  int sock = preq->rq_owed_conn;
+
+  if (sock < 0)
+    return;
+
+  preq->rq_owed_conn = -1;
+
+  pthread_mutex_lock(&reply_owed_mutex);
+
+  if (reply_owed_gen[sock] == preq->rq_owed_gen)
+    {
+    reply_owed[sock] = FALSE;
+    pthread_cond_broadcast(&reply_owed_cond);
+    }
+
+  pthread_mutex_unlock(&reply_owed_mutex);
+  }  /* END reply_owed_done() */
+
+
+
+
+/*
+ * reply_owed_forget - sock is closing, replies still owed to it must not
+ * touch whichever connection gets the socket next
+ */
+
+void reply_owed_forget(
+
+  int sock)  /* I */
+
+  {
+  if ((sock < 0) || (sock >= PBS_NET_MAX_CONNECTIONS))
+    return;
+
+  pthread_mutex_lock(&reply_owed_mutex);
+  reply_owed[sock] = FALSE;
+  reply_owed_gen[sock]++;
+  pthread_cond_broadcast(&reply_owed_cond);
+  pthread_mutex_unlock(&reply_owed_mutex);
+  }  /* END reply_owed_forget() */
+
+
+
+
+/*
+ * wait_for_owed_reply - wait until the last request read from sock has
+ * been answered
+ *
+ * A request that is never answered only holds the connection for the tcp
+ * timeout, after which requests are read again and replies may be out of
+ * order.
+ */
+
+void wait_for_owed_reply(
+
+  int sock)  /* I */
+
+  {
+  struct timespec deadline;
+  char            log_buf[LOCAL_LOG_BUF_SIZE];
+  int             rc = 0;
+
+  if ((sock < 0) || (sock >= PBS_NET_MAX_CONNECTIONS))
+    return;
+
+  deadline.tv_sec = time(NULL) + pbs_tcp_timeout;
+  deadline.tv_nsec = 0;
+
+  pthread_mutex_lock(&reply_owed_mutex);
+
+  while ((reply_owed[sock] == TRUE) &&
+         (rc != ETIMEDOUT))
+    rc = pthread_cond_timedwait(&reply_owed_cond, &reply_owed_mutex, &deadline);
+
+  if (reply_owed[sock] == TRUE)
+    {
+    reply_owed[sock] = FALSE;
+    reply_owed_gen[sock]++;
+
+    snprintf(log_buf, sizeof(log_buf),
+      "no reply to the last request on socket %d after %ld seconds, reading the next one",
+      sock,
+      (long)pbs_tcp_timeout);
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+    }
+
+  pthread_mutex_unlock(&reply_owed_mutex);
+  }  /* END wait_for_owed_reply() */
+
+
+
 
 /*
  * process_request - this function gets, checks, and invokes the proper
@@ -641,6 +795,7 @@ int process_request(
       case PBS_BATCH_QueueJob:
       case PBS_BATCH_RunJob:
       case PBS_BATCH_StageIn:
+      case PBS_BATCH_SubmitJob:
       case PBS_BATCH_jobscript:
 
         req_reject(PBSE_SVRDOWN, 0, request, NULL, NULL);
@@ -653,6 +808,9 @@ int process_request(
       }
     }
 
+  /* the connection reads nothing more until this request is answered */
+  reply_owed_set(request);
+
   /*
    * dispatch the request to the correct processing function.
    * The processing function must call reply_send() to free
@@ -711,6 +869,11 @@ int dispatch_request(
       break;
 
 
+    case PBS_BATCH_SubmitJob:
+      rc = req_submitjob(request);
+      break;
+
+
     case PBS_BATCH_JobCred:
       rc = req_jobcredential(request);
       break;
@@ -964,6 +1127,12 @@ int dispatch_request(
       
       break;
 
+    case PBS_BATCH_WatchJobs:
+
+      rc = req_watchjobs(request);
+
+      break;
+
     default:
 
       req_reject(PBSE_UNKREQ, 0, request, NULL, NULL);
@@ -1006,6 +1175,7 @@ struct batch_request *alloc_br(
     req->rq_time = time(NULL);
     req->rq_reply.brp_choice = BATCH_REPLY_CHOICE_NULL;
     req->rq_noreply = FALSE;  /* indicate reply is needed */
+    req->rq_owed_conn = -1;
     }
 
   return(req);
@@ -1027,6 +1197,21 @@ int close_quejob_by_jobid(
     }
 
   if ((pjob = svr_find_job(job_id, FALSE)) == NULL)
+    {
+    int iter = -1;
+
+    /* a job that never reached commit is only on the new jobs list */
+
+    while ((pjob = next_job(&newjobs, &iter)) != NULL)
+      {
+      if (!strcmp(pjob->ji_qs.ji_jobid, job_id))
+        break;
+
+      unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
+      }
+    }
+
+  if (pjob == NULL)
     {
     rc = PBSE_JOBNOTFOUND;
     }
@@ -1070,6 +1255,8 @@ void free_br(
   struct batch_request *preq)
 
   {
+  reply_owed_done(preq);
+
   if (preq->rq_id != NULL)
     {
     remove_batch_request(preq->rq_id);
@@ -1093,6 +1280,18 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      free_attrlist(&preq->rq_ind.rq_queuejob.rq_attr);
+
+      if (preq->rq_ind.rq_queuejob.rq_script)
+        {
+        free(preq->rq_ind.rq_queuejob.rq_script);
+        preq->rq_ind.rq_queuejob.rq_script = NULL;
+        }
+
+      break;
+
     case PBS_BATCH_JobCred:
 
       if (preq->rq_ind.rq_jobcred.rq_data)
@@ -1157,6 +1356,21 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_WatchJobs:
+
+      if (preq->rq_ind.rq_watchjobs.rq_jobids != NULL)
+        {
+        int i;
+
+        for (i = 0; i < preq->rq_ind.rq_watchjobs.rq_count; i++)
+          free(preq->rq_ind.rq_watchjobs.rq_jobids[i]);
+
+        free(preq->rq_ind.rq_watchjobs.rq_jobids);
+        preq->rq_ind.rq_watchjobs.rq_jobids = NULL;
+        }
+
+      break;
+
     case PBS_BATCH_JobObit:
 
       free_attrlist(&preq->rq_ind.rq_jobobit.rq_attr);
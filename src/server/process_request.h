@@ -9,6 +9,14 @@
 int get_creds(int   sd, char *username, char *hostname);
 #endif
 
+void reply_owed_set(struct batch_request *preq);
+
+void reply_owed_done(struct batch_request *preq);
+
+void reply_owed_forget(int sock);
+
+void wait_for_owed_reply(int sock);
+
 int process_request(struct tcp_chan *chan);
 
 int dispatch_request(int sfds, struct batch_request *request);
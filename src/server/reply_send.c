@@ -32,6 +32,7 @@
 #include "work_task.h"
 #include "utils.h"
 #include "tcp.h" /* tcp_chan */
+#include "process_request.h" /* reply_owed_done */
 
 
 
@@ -173,7 +174,12 @@ int reply_send_svr(
     {
     /* Otherwise, the reply is to be sent to a remote client */
 
-    if (request->rq_noreply != TRUE)
+    /* steps of a SubmitJob only reply on error, the commit replies for all */
+
+    if ((request->rq_noreply != TRUE) &&
+        ((request->rq_compound != TRUE) ||
+         (request->rq_type == PBS_BATCH_Commit) ||
+         (request->rq_reply.brp_code != PBSE_NONE)))
       {
       rc = dis_reply_write(sfds, &request->rq_reply);
 
@@ -188,6 +194,9 @@ int reply_send_svr(
       }
     }
 
+  /* the connection may read its next request now */
+  reply_owed_done(request);
+
   if (((request->rq_type != PBS_BATCH_AsyModifyJob) && 
        (request->rq_type != PBS_BATCH_AsyrunJob) &&
        (request->rq_type != PBS_BATCH_AsySignalJob)) ||
@@ -211,6 +220,11 @@ int reply_send_mom(
   int      rc = 0;
   int      sfds = request->rq_conn;  /* socket */
 
+  /* steps of a SubmitJob are answered and freed by req_submitjob() */
+
+  if (request->rq_compound == TRUE)
+    return(rc);
+
   /* determine where the reply should go, remote or local */
 
   if (sfds == PBS_LOCAL_CONNECTION)
@@ -241,8 +241,12 @@ int req_deletearray(
 
   /* get the range of jobs to iterate over */
   range = preq->rq_extend;
+
   if ((range != NULL) &&
-      (strstr(range,ARRAY_RANGE) != NULL))
+      (strstr(range,ARRAY_RANGE) == NULL))
+    range = NULL;
+
+  if (range != NULL)
     {
     if (LOGLEVEL >= 5)
       {
@@ -258,7 +262,8 @@ int req_deletearray(
     /* parse the array range */
     num_skipped = delete_array_range(pa,range);
 
-    if (num_skipped < 0)
+    if ((num_skipped < 0) &&
+        (num_skipped != NO_JOBS_IN_ARRAY))
       {
       /* ERROR */
       unlock_ai_mutex(pa, __func__, "2", LOGLEVEL);
@@ -266,6 +271,9 @@ int req_deletearray(
       req_reject(PBSE_IVALREQ,0,preq,NULL,"Error in specified array range");
       return(PBSE_NONE);
       }
+
+    if (num_skipped == NO_JOBS_IN_ARRAY)
+      array_delete(pa);
     }
   else
     {
@@ -283,6 +291,15 @@ int req_deletearray(
       array_delete(pa);
     }
 
+  /* one record for the request, once it has been accepted */
+  snprintf(log_buf, sizeof(log_buf), "requestor=%s@%s%s%s",
+    preq->rq_user,
+    preq->rq_host,
+    (range != NULL) ? " " : "",
+    (range != NULL) ? range : "");
+
+  account_record_id(PBS_ACCT_DEL, preq->rq_ind.rq_delete.rq_objname, log_buf);
+
   if (num_skipped != NO_JOBS_IN_ARRAY)
     {
     unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
@@ -106,10 +106,33 @@
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
 #include "../lib/Libnet/lib_net.h" /* global_sock_add */
+#include "net_cache.h" /* get_cached_nameinfo */
 #include "req_getcred.h" /* req_altauthenuser */
+#ifdef HAVE_LIBMUNGE
+#include <pwd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <munge.h>
+#endif
 
 #define SPACE 32 /* ASCII space character */
 
+/* munge credentials already decoded, see munge_cache_lookup() */
+#define MUNGE_CACHE_SIZE 64
+
+typedef struct munge_cache_entry
+  {
+  char      mc_cred[MUNGE_SIZE];
+  pbs_net_t mc_addr;      /* the peer that presented it */
+  time_t    mc_expires;   /* 0 when the slot is free */
+  char      mc_user[PBS_MAXUSER + 1];
+  char      mc_host[PBS_MAXHOSTNAME + 1];
+  } munge_cache_entry;
+
+static munge_cache_entry munge_cache[MUNGE_CACHE_SIZE];
+static pthread_mutex_t   munge_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* External Global Data Items Referenced */
 
 
@@ -358,6 +381,13 @@ int pipe_and_read_unmunge(
     req_reject(PBSE_SYSTEM, 0, preq, NULL, "could not unmunge credentials");
     rc = -1;
     }
+  else if (((ptr = strstr(munge_buf, "STATUS:")) != NULL) &&
+           (strstr(ptr, "Success") == NULL))
+    {
+    /* unmunge prints the metadata of expired and replayed credentials too */
+    req_reject(PBSE_BADCRED, 0, preq, NULL, "munge credential invalid");
+    rc = -1;
+    }
   else if ((rc = get_encode_host(sock, munge_buf, preq)) == PBSE_NONE)
     {
     rc = get_UID(sock, munge_buf, preq);
@@ -369,6 +399,198 @@ int pipe_and_read_unmunge(
 
 
 
+/*
+ * munge_cache_lookup - find a credential this peer has already presented
+ *
+ * Clients reuse a credential for half of its lifetime (see MUNGE_CRED_TTL)
+ * instead of asking munged for one per connection.  munged rejects a
+ * reused credential as a replay, so a credential is decoded once and later
+ * connections from the same address are matched here.
+ *
+ * @return TRUE and the credential's user and host if it is known
+ */
+
+int munge_cache_lookup(
+
+  char      *cred,  /* I */
+  pbs_net_t  addr,  /* I */
+  char      *user,  /* O - PBS_MAXUSER + 1 bytes */
+  char      *host)  /* O - PBS_MAXHOSTNAME + 1 bytes */
+
+  {
+  int    i;
+  int    found = FALSE;
+  time_t now = time(NULL);
+
+  pthread_mutex_lock(&munge_cache_mutex);
+
+  for (i = 0; i < MUNGE_CACHE_SIZE; i++)
+    {
+    if ((munge_cache[i].mc_expires <= now) ||
+        (munge_cache[i].mc_addr != addr) ||
+        (strcmp(munge_cache[i].mc_cred, cred)))
+      continue;
+
+    strcpy(user, munge_cache[i].mc_user);
+    strcpy(host, munge_cache[i].mc_host);
+
+    found = TRUE;
+
+    break;
+    }
+
+  pthread_mutex_unlock(&munge_cache_mutex);
+
+  return(found);
+  } /* END munge_cache_lookup() */
+
+
+
+
+/*
+ * munge_cache_add - remember a decoded credential until expires
+ *
+ * A free or expired slot is used if there is one, otherwise the entry
+ * closest to expiring is replaced.
+ */
+
+void munge_cache_add(
+
+  char      *cred,     /* I */
+  pbs_net_t  addr,     /* I */
+  char      *user,     /* I */
+  char      *host,     /* I */
+  time_t     expires)  /* I */
+
+  {
+  int    i;
+  int    slot = 0;
+  time_t now = time(NULL);
+
+  if ((strlen(cred) >= sizeof(munge_cache[0].mc_cred)) ||
+      (expires <= now))
+    return;
+
+  pthread_mutex_lock(&munge_cache_mutex);
+
+  for (i = 0; i < MUNGE_CACHE_SIZE; i++)
+    {
+    if (munge_cache[i].mc_expires <= now)
+      {
+      slot = i;
+
+      break;
+      }
+
+    if (munge_cache[i].mc_expires < munge_cache[slot].mc_expires)
+      slot = i;
+    }
+
+  strcpy(munge_cache[slot].mc_cred, cred);
+  munge_cache[slot].mc_addr = addr;
+  munge_cache[slot].mc_expires = expires;
+  snprintf(munge_cache[slot].mc_user, sizeof(munge_cache[slot].mc_user), "%s", user);
+  snprintf(munge_cache[slot].mc_host, sizeof(munge_cache[slot].mc_host), "%s", host);
+
+  pthread_mutex_unlock(&munge_cache_mutex);
+  } /* END munge_cache_add() */
+
+
+
+#ifdef HAVE_LIBMUNGE
+
+/*
+ * decode_munge_cred - check the request's credential with libmunge
+ *
+ * Sets the connection's user and host like the unmunge output does and
+ * *expires to the end of the credential's lifetime.
+ */
+
+int decode_munge_cred(
+
+  int                   sock,     /* I */
+  struct batch_request *preq,     /* I */
+  time_t               *expires)  /* O */
+
+  {
+  munge_ctx_t         ctx;
+  munge_err_t         err;
+  uid_t               uid;
+  gid_t               gid;
+  struct in_addr      encode_addr;
+  time_t              encode_time = 0;
+  int                 ttl = 0;
+  struct passwd       pwent;
+  struct passwd      *pwent_ptr = NULL;
+  char                pwbuf[1024];
+  struct sockaddr_in  sai;
+  char               *host_name;
+  char                log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((ctx = munge_ctx_create()) == NULL)
+    {
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, "could not create munge context");
+    return(-1);
+    }
+
+  err = munge_decode(preq->rq_ind.rq_authen.rq_cred, ctx, NULL, NULL, &uid, &gid);
+
+  if ((err != EMUNGE_SUCCESS) ||
+      (munge_ctx_get(ctx, MUNGE_OPT_ADDR4, &encode_addr) != EMUNGE_SUCCESS) ||
+      (munge_ctx_get(ctx, MUNGE_OPT_ENCODE_TIME, &encode_time) != EMUNGE_SUCCESS) ||
+      (munge_ctx_get(ctx, MUNGE_OPT_TTL, &ttl) != EMUNGE_SUCCESS))
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "could not decode munge credential: %s",
+      (err != EMUNGE_SUCCESS) ? munge_strerror(err) : munge_ctx_strerror(ctx));
+    log_err(-1, __func__, log_buf);
+
+    munge_ctx_destroy(ctx);
+
+    req_reject((err == EMUNGE_SOCKET) ? PBSE_SYSTEM : PBSE_BADCRED, 0, preq, NULL, "munge credential invalid");
+    return(-1);
+    }
+
+  munge_ctx_destroy(ctx);
+
+  if ((getpwuid_r(uid, &pwent, pwbuf, sizeof(pwbuf), &pwent_ptr) != 0) ||
+      (pwent_ptr == NULL))
+    {
+    req_reject(PBSE_BADCRED, 0, preq, NULL, "unknown user in munge credential");
+    return(-1);
+    }
+
+  snprintf(conn_credent[sock].username, sizeof(conn_credent[sock].username),
+    "%s", pwent.pw_name);
+
+  memset(&sai, 0, sizeof(sai));
+  sai.sin_family = AF_INET;
+  sai.sin_addr = encode_addr;
+
+  if ((host_name = get_cached_nameinfo(&sai)) != NULL)
+    {
+    snprintf(conn_credent[sock].hostname, sizeof(conn_credent[sock].hostname),
+      "%s", host_name);
+    }
+  else if (getnameinfo((struct sockaddr *)&sai, sizeof(sai),
+             conn_credent[sock].hostname, sizeof(conn_credent[sock].hostname),
+             NULL, 0, NI_NAMEREQD) != 0)
+    {
+    /* unmunge falls back to the address as well */
+    snprintf(conn_credent[sock].hostname, sizeof(conn_credent[sock].hostname),
+      "%s", inet_ntoa(encode_addr));
+    }
+
+  *expires = encode_time + ttl;
+
+  return(PBSE_NONE);
+  } /* END decode_munge_cred() */
+
+#endif /* HAVE_LIBMUNGE */
+
+
+
+
 
 int unmunge_request(
     
@@ -376,13 +598,31 @@ int unmunge_request(
   struct batch_request *preq) /* M */
  
   {
+  int             rc = PBSE_NONE;
+  pbs_net_t       addr;
+  time_t          expires;
+#ifndef HAVE_LIBMUNGE
   time_t          myTime;
   struct timeval  tv;
   suseconds_t     millisecs;
   struct tm       timeinfo;
   char            mungeFileName[MAXPATHLEN + MAXNAMLEN+1];
-  int             rc = PBSE_NONE;
+#endif
+
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+  addr = svr_conn[sock].cn_addr;
+  pthread_mutex_unlock(svr_conn[sock].cn_mutex);
 
+  if (munge_cache_lookup(preq->rq_ind.rq_authen.rq_cred,
+                         addr,
+                         conn_credent[sock].username,
+                         conn_credent[sock].hostname) == TRUE)
+    return(PBSE_NONE);
+
+#ifdef HAVE_LIBMUNGE
+  if ((rc = decode_munge_cred(sock, preq, &expires)) != PBSE_NONE)
+    return(rc);
+#else
   /* create a sudo random file name */
   gettimeofday(&tv, NULL);
   myTime = tv.tv_sec;
@@ -403,6 +643,20 @@ int unmunge_request(
   /* delete the old file */
   unlink(mungeFileName);
 
+  if (rc != PBSE_NONE)
+    return(rc);
+
+  /* unmunge's output does not say when the credential expires, trust it
+   * as long as the client reuses it */
+  expires = myTime + MUNGE_CRED_TTL / 2;
+#endif /* HAVE_LIBMUNGE */
+
+  munge_cache_add(preq->rq_ind.rq_authen.rq_cred,
+                  addr,
+                  conn_credent[sock].username,
+                  conn_credent[sock].hostname,
+                  expires);
+
   return(rc);
   } /* END unmunge_request */
 
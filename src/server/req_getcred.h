@@ -3,6 +3,7 @@
 #define _REQ_GETCRED_H
 
 #include "batch_request.h" /* batch_request */
+#include "net_connect.h" /* pbs_net_t */
 
 void req_connect(struct batch_request *preq);
 
@@ -14,6 +15,12 @@ int write_munge_temp_file(struct batch_request *preq, char *mungeFileName);
 
 int pipe_and_read_unmunge(char *mungeFileName, struct batch_request *preq, int sock);
 
+int munge_cache_lookup(char *cred, pbs_net_t addr, char *user, char *host);
+
+void munge_cache_add(char *cred, pbs_net_t addr, char *user, char *host, time_t expires);
+
+int decode_munge_cred(int sock, struct batch_request *preq, time_t *expires);
+
 int unmunge_request(int sock, struct batch_request *preq);
 
 int req_authenuser(struct batch_request *preq);
@@ -1205,6 +1205,7 @@ void mgr_server_set(
          &bad_attr,
          (void *) & server,
          ATR_ACTION_ALTER);
+  svr_attr_publish_all();
   pthread_mutex_unlock(server.sv_attr_mutex);
 
   /* PBSE_BADACLHOST - lets show the user the first bad host in the ACL  */
@@ -1372,6 +1373,7 @@ void mgr_server_unset(
          plist,
          preq->rq_perm,
          &bad_attr);
+  svr_attr_publish_all();
   pthread_mutex_unlock(server.sv_attr_mutex);
 
   if (rc != 0)
@@ -1630,6 +1632,7 @@ void mgr_node_set(
   char             *nodename = NULL;
   char             *problem_names;
   char              log_buf[LOCAL_LOG_BUF_SIZE];
+  char              node_name[PBS_MAXHOSTNAME + 1];
 
   svrattrl         *plist;
   node_check_info   nci;
@@ -1795,7 +1798,18 @@ void mgr_node_set(
       mgr_log_attr(msg_man_set, plist, PBS_EVENTCLASS_NODE, pnode->nd_name);
       }
 
+    snprintf(node_name, sizeof(node_name), "%s", pnode->nd_name);
+
     unlock_node(pnode, "mgr_node_set", "single_node", LOGLEVEL);
+
+    /* one node changed, append its line rather than rewrite every node's */
+    if ((need_todo & WRITENODE_STATE) &&
+        (record_node_state(node_name) == PBSE_NONE))
+      need_todo &= ~(WRITENODE_STATE);
+
+    if ((need_todo & WRITENODE_NOTE) &&
+        (record_node_note(node_name) == PBSE_NONE))
+      need_todo &= ~(WRITENODE_NOTE);
     } /* END single node case */
 
   if (need_todo & WRITENODE_STATE)
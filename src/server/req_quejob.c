@@ -602,6 +602,7 @@ int req_quejob(
     pthread_mutex_lock(server.sv_attr_mutex);
     server.sv_attr[SRV_ATR_NextJobNumber].at_val.at_long = jobid_number;
     server.sv_attr[SRV_ATR_NextJobNumber].at_flags |= ATR_VFLAG_SET | ATR_VFLAG_MODIFY;
+    svr_attr_publish(SRV_ATR_NextJobNumber);
     pthread_mutex_unlock(server.sv_attr_mutex);
 
     /* Change - do not fail if the server can't be saved - the job file is saved */
@@ -2002,13 +2003,14 @@ int req_commit(
   char                  *rq_destin = NULL;
 #endif /* AUTORUN_JOBS */
 
-#ifdef QUICKCOMMIT
-  int                    OrigState;
-  int                    OrigSState;
-  char                   OrigSChar;
-  long                   OrigFlags;
-
+  int                    quick_commit;
   char                   namebuf[MAXPATHLEN+1];
+
+#ifdef QUICKCOMMIT
+  quick_commit = TRUE;
+#else
+  /* a SubmitJob skips ready to commit, so the job is only saved once */
+  quick_commit = preq->rq_compound;
 #endif /* QUICKCOMMIT */
 
   pj = locate_new_job(preq->rq_conn, preq->rq_ind.rq_commit);
@@ -2032,40 +2034,34 @@ int req_commit(
   if (LOGLEVEL >= 10)
     LOG_EVENT(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, pj->ji_qs.ji_jobid);
 
-#ifdef QUICKCOMMIT
-  if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSIN)
+  if (quick_commit == TRUE)
     {
-    rc = PBSE_IVALREQ;
-    snprint(log_buf, LOCAL_LOG_BUF_SIZE,
-        "cannot commit job in unexpected state (%d - %s)",
-        errno, strerror(errno));
-    log_err(rc, __func__, log_buf);
-    req_reject(PBSE_IVALREQ, 0, preq, NULL, log_buf);
-    unlock_ji_mutex(pj, __func__, "5", LOGLEVEL);
-    return(rc);
-    }
+    if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSIN)
+      {
+      rc = PBSE_IVALREQ;
+      snprintf(log_buf, LOCAL_LOG_BUF_SIZE,
+          "cannot commit job in unexpected state (%d - %s)",
+          errno, strerror(errno));
+      log_err(rc, __func__, log_buf);
+      req_reject(PBSE_IVALREQ, 0, preq, NULL, log_buf);
+      unlock_ji_mutex(pj, __func__, "5", LOGLEVEL);
+      return(rc);
+      }
 
-  OrigState  = pj->ji_qs.ji_state;
+    pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
+    pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
+    pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
+    pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
 
-  OrigSState = pj->ji_qs.ji_substate;
-  OrigSChar  = pj->ji_wattr[JOB_ATR_state].at_val.at_char;
-  OrigFlags  = pj->ji_wattr[JOB_ATR_state].at_flags;
-
-  pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
-  pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
-  pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
-  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
+    if (pj->ji_wattr[JOB_ATR_job_array_request].at_flags & ATR_VFLAG_SET)
+      {
+      pj->ji_is_array_template = TRUE;
 
-  if (pj->ji_wattr[JOB_ATR_job_array_request].at_flags & ATR_VFLAG_SET)
-    {
-    pj->ji_is_array_template = TRUE;
-    
-    snprintf(namebuf, sizeof(namebuf), "%s%s%s", path_jobs, pj->ji_qs.ji_fileprefix, JOB_FILE_SUFFIX);
-    unlink(namebuf);
+      snprintf(namebuf, sizeof(namebuf), "%s%s%s", path_jobs, pj->ji_qs.ji_fileprefix, JOB_FILE_SUFFIX);
+      unlink(namebuf);
+      }
     }
 
-#endif /* QUICKCOMMIT */
-
   if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSICM)
     {
     rc = PBSE_IVALREQ;
@@ -2301,6 +2297,7 @@ int req_commit(
 
 
 
+
 /*
  * locate_new_job - locate a "new" job which has been set up req_quejob on
  * the servers new job list.
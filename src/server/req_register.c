@@ -103,6 +103,7 @@
 #include "array.h"
 #include "svr_func.h" /* get_svr_attr_* */
 #include "ji_mutex.h"
+#include "depend_graph.h"
 
 #define SYNC_SCHED_HINT_NULL 0
 #define SYNC_SCHED_HINT_FIRST 1
@@ -126,6 +127,7 @@ static int register_sync(struct depend *,  char *child, char *host, long);
 static int register_dep(pbs_attribute *, struct batch_request *, int, int *);
 static int unregister_dep(pbs_attribute *, struct batch_request *);
 static int unregister_sync(pbs_attribute *, struct batch_request *);
+static int release_depend(job *, int, char *);
 
 static struct depend *find_depend(int type, pbs_attribute *pattr);
 
@@ -442,32 +444,7 @@ int req_register(
           /* predecessor sent release-reduce "on", */
           /* see if this job can now run    */
 
-          type ^= (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART);
-
-          if ((pdep = find_depend(type, pattr)))
-            {
-            if ((pdj = find_dependjob(pdep, preq->rq_ind.rq_register.rq_child)))
-              {
-              del_depend_job(pdj);
-
-              sprintf(log_buf, msg_registerrel, preq->rq_ind.rq_register.rq_child);
-
-              log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
-
-              if (GET_NEXT(pdep->dp_jobs) == 0)
-                {
-                /* no more dependencies of this type */
-
-                del_depend(pdep);
-
-                set_depend_hold(pjob, pattr);
-                }
-
-              break;
-              }
-            }    /* END if ((pdep = find_depend(type,pattr))) */
-
-          rc = PBSE_IVALREQ;
+          rc = release_depend(pjob, type, preq->rq_ind.rq_register.rq_child);
 
           break;
 
@@ -587,6 +564,24 @@ int req_register(
       break;
     }  /* END switch (preq->rq_ind.rq_register.rq_op) */
 
+  if ((rc == PBSE_NONE) &&
+      (pjob != NULL))
+    {
+    /* keep the dependency graph in step with the attribute */
+
+    if (preq->rq_ind.rq_register.rq_op == JOB_DEPEND_OP_REGISTER)
+      {
+      depend_graph_add(
+        preq->rq_ind.rq_register.rq_child,
+        pjob->ji_qs.ji_jobid,
+        type ^ (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART));
+      }
+    else if (preq->rq_ind.rq_register.rq_op == JOB_DEPEND_OP_UNREG)
+      {
+      depend_graph_index_job(pjob->ji_qs.ji_jobid, pattr);
+      }
+    }
+
   if (rc)
     {
     if (pjob != NULL)
@@ -1159,6 +1154,9 @@ int depend_on_que(
   else
     unlock_queue(pque, __func__, NULL, LOGLEVEL);
 
+  /* index the jobs this one waits on, replacing them on an alter */
+  depend_graph_index_job(job_id, pattr);
+
   if (mode == ATR_ACTION_ALTER)
     {
     /* if there are dependencies being removed, unregister them */
@@ -1366,21 +1364,21 @@ int depend_on_exec(
 
 
 
-/* depend_on_term - Perform actions if job has "afterany, afterok, afternotok"
- * dependencies, send "register-release" or register-delete" as
- * appropriate.
+/*
+ * send_term_depend_reqs - send "register-release" or "register-delete" to
+ * the jobs depending on a finished job that the dependency graph does not
+ * hold, see depend_on_term()
  *
- * This function is invoked from on_job_exit() in req_jobobit.c.
- * When there are no depends to deal with, free the pbs_attribute and
- * recall on_job_exit().
+ * pjob is locked on entry and unlocked on exit.
  */
 
-int depend_on_term(
+static int send_term_depend_reqs(
 
-  char *job_id)
+  job  *pjob,      /* I */
+  char *job_id,    /* I */
+  int   exitstat)  /* I */
 
   {
-  int                exitstat;
   int                op;
   pbs_attribute     *pattr;
 
@@ -1391,13 +1389,7 @@ int depend_on_term(
   int                shouldkill = 0;
   int                type;
   int                job_unlocked = 0;
-  job                *pjob;
- 
-  pjob = svr_find_job(job_id, FALSE);
-  if (pjob == NULL)
-    return(PBSE_JOBNOTFOUND);
 
-  exitstat = pjob->ji_qs.ji_un.ji_exect.ji_exitstat;
   pattr = &pjob->ji_wattr[JOB_ATR_depend];
 
   pdep = (struct depend *)GET_NEXT(pattr->at_val.at_list);
@@ -1498,6 +1490,17 @@ int depend_on_term(
 
       while (pparent)
         {
+        /* depend_on_term() releases the jobs the graph holds */
+        if (depend_graph_has_edge(
+              job_id,
+              pparent->dc_child,
+              type ^ (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART)) == TRUE)
+          {
+          pparent = (struct depend_job *)GET_NEXT(pparent->dc_link);
+
+          continue;
+          }
+
         if (job_unlocked == 1)
           {
           pjob = svr_find_job(job_id, TRUE);
@@ -1524,6 +1527,136 @@ int depend_on_term(
     unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
 
   return(0);
+  }  /* END send_term_depend_reqs() */
+
+
+
+
+/*
+ * release_graph_dependents - release or delete the jobs of this server that
+ * wait on a finished job, as listed by the dependency graph
+ *
+ * Each dependent is handled as req_register() would handle the request
+ * depend_on_term() used to send for it.
+ */
+
+static void release_graph_dependents(
+
+  char        *job_id,     /* I - the finished job */
+  depend_edge *dependents, /* I */
+  int          count,      /* I */
+  int          exitstat,   /* I */
+  int          aborted)    /* I */
+
+  {
+  int   i;
+  int   op;
+  job  *pjob;
+  char  log_buf[LOCAL_LOG_BUF_SIZE];
+
+  for (i = 0; i < count; i++)
+    {
+    /* a job that depends on itself is left to req_register() to refuse */
+    if (!strcmp(dependents[i].de_jobid, job_id))
+      continue;
+
+    switch (dependents[i].de_type)
+      {
+
+      case JOB_DEPEND_TYPE_AFTEROK:
+
+        if ((aborted == FALSE) && (exitstat == 0))
+          op = JOB_DEPEND_OP_RELEASE;
+        else
+          op = JOB_DEPEND_OP_DELETE;
+
+        break;
+
+      case JOB_DEPEND_TYPE_AFTERNOTOK:
+
+        if (exitstat != 0)
+          op = JOB_DEPEND_OP_RELEASE;
+        else
+          op = JOB_DEPEND_OP_DELETE;
+
+        break;
+
+      default:
+
+        op = JOB_DEPEND_OP_RELEASE;
+
+        break;
+      }
+
+    if ((pjob = svr_find_job(dependents[i].de_jobid, TRUE)) == NULL)
+      continue;
+
+    if (op == JOB_DEPEND_OP_DELETE)
+      {
+      snprintf(log_buf, sizeof(log_buf), msg_registerdel, job_id);
+
+      log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
+
+      job_abt(&pjob, log_buf);
+      }
+    else if (release_depend(
+               pjob,
+               dependents[i].de_type ^ (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART),
+               job_id) == PBSE_NONE)
+      {
+      job_save(pjob, SAVEJOB_FULL, 0);
+      }
+
+    if (pjob != NULL)
+      unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+    }
+  }  /* END release_graph_dependents() */
+
+
+
+
+/* depend_on_term - Perform actions if job has "afterany, afterok, afternotok"
+ * dependencies, send "register-release" or register-delete" as
+ * appropriate.
+ *
+ * Dependents on this server that the dependency graph holds are released
+ * directly, in time proportional to their number.  The others get a
+ * request as before.
+ *
+ * This function is invoked from on_job_exit() in req_jobobit.c.
+ * When there are no depends to deal with, free the pbs_attribute and
+ * recall on_job_exit().
+ */
+
+int depend_on_term(
+
+  char *job_id)
+
+  {
+  int          exitstat;
+  int          aborted;
+  int          count;
+  int          rc;
+  depend_edge *dependents;
+  job         *pjob;
+
+  pjob = svr_find_job(job_id, FALSE);
+  if (pjob == NULL)
+    return(PBSE_JOBNOTFOUND);
+
+  exitstat = pjob->ji_qs.ji_un.ji_exect.ji_exitstat;
+  aborted = (pjob->ji_qs.ji_substate == JOB_SUBSTATE_ABORT);
+
+  count = depend_graph_dependents(job_id, &dependents);
+
+  rc = send_term_depend_reqs(pjob, job_id, exitstat);
+
+  /* job_id is no longer locked, its dependents can be */
+  release_graph_dependents(job_id, dependents, count, exitstat, aborted);
+
+  free(dependents);
+
+  return(rc);
   }  /* END depend_on_term() */
 
 
@@ -1953,6 +2086,57 @@ static int register_dep(
 
 
 
+/*
+ * release_depend - a job that pjob waits on has finished, drop it from the
+ * dependency and clear the hold once nothing of that type is left
+ *
+ * @param type - the finished job's before* type, as sent in the request
+ * @param prereq_id - the finished job
+ * @return PBSE_NONE, or PBSE_IVALREQ if pjob did not wait on prereq_id
+ */
+
+static int release_depend(
+
+  job  *pjob,       /* I (modified) */
+  int   type,       /* I */
+  char *prereq_id)  /* I */
+
+  {
+  pbs_attribute     *pattr = &pjob->ji_wattr[JOB_ATR_depend];
+  struct depend     *pdep;
+  struct depend_job *pdj;
+  char               log_buf[LOCAL_LOG_BUF_SIZE];
+
+  type ^= (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART);
+
+  if (((pdep = find_depend(type, pattr)) == NULL) ||
+      ((pdj = find_dependjob(pdep, prereq_id)) == NULL))
+    return(PBSE_IVALREQ);
+
+  depend_graph_remove(pdj->dc_child, pjob->ji_qs.ji_jobid, type);
+
+  del_depend_job(pdj);
+
+  snprintf(log_buf, sizeof(log_buf), msg_registerrel, prereq_id);
+
+  log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
+
+  if (GET_NEXT(pdep->dp_jobs) == 0)
+    {
+    /* no more dependencies of this type */
+
+    del_depend(pdep);
+
+    set_depend_hold(pjob, pattr);
+    }
+
+  return(PBSE_NONE);
+  }  /* END release_depend() */
+
+
+
+
+
 /**
  * unregister_dep - remove a registered dependency
  * Results from a qalter call to remove existing dependencies
@@ -124,7 +124,7 @@
 
 /* External Functions Called: */
 
-extern int   send_job_work(char *job_id,char *,int,int *,struct batch_request *);
+extern int   send_job_work(char *job_id,char *,int,int *,struct batch_request *,int);
 extern void  set_resc_assigned(job *, enum batch_op);
 
 extern struct batch_request *cpy_stage(struct batch_request *, job *, enum job_atr, int);
@@ -1125,6 +1125,7 @@ int send_job_to_mom(
   unsigned long    job_momaddr = -1;
   char             job_id[PBS_MAXSVRJOBID+1];
   int              my_err = 0;
+  int              rc;
   int              external = FALSE;
   char             tmpLine[MAXLINE];
   char            *mail_text = NULL;
@@ -1161,7 +1162,25 @@ int send_job_to_mom(
       (preq->rq_reply.brp_un.brp_txt.brp_str != NULL))
     mail_text = strdup(preq->rq_reply.brp_un.brp_txt.brp_str);
 
-  if (send_job_work(job_id, NULL, MOVE_TYPE_Exec, &my_err, preq) == PBSE_NONE)
+  /* heterogeneous launches need to know whether both halves started */
+  rc = send_job_work(job_id, NULL, MOVE_TYPE_Exec, &my_err, preq, (parent_job == NULL));
+
+  if (rc == LOCUTION_RETRY)
+    {
+    /* the send is retried from a timed task, which replies to preq and
+     * mails the owner once the job is started */
+    DIS_tcp_settimeout(tcp_timeout);
+
+    if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
+      *pjob_ptr = pjob;
+
+    if (mail_text != NULL)
+      free(mail_text);
+
+    return(PBSE_NONE);
+    }
+
+  if (rc == PBSE_NONE)
     {
     /* SUCCESS */
     DIS_tcp_settimeout(tcp_timeout);
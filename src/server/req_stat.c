@@ -118,10 +118,12 @@
 #include "queue_func.h" /* find_queuebyname */
 #include "reply_send.h" /* reply_send_svr */
 #include "svr_func.h" /* get_svr_attr_* */
+#include "svr_mail.h" /* mail_queue_length */
 #include "alps_functions.h"
 #include "node_manager.h" /* tfind_addr */
 #include "ji_mutex.h"
 #include "unistd.h"
+#include "dis.h" /* encode_DIS_reply */
 
 /* Global Data Items: */
 
@@ -163,6 +165,9 @@ static void req_stat_job_step2(struct stat_cntl *);
 #define TMAX_JOB 999999999
 #endif /* TMAX_JOB */
 
+/* jobs per reply when a client asks for STATSTREAM */
+#define STAT_STREAM_CHUNK 256
+
 
 
 
@@ -348,6 +353,63 @@ int req_stat_job(
 
 
 
+/*
+ * send_status_chunk - send the job records gathered so far and start over
+ *
+ * The reply goes out marked STATUS_STREAM_MORE, the final reply_send_svr()
+ * ends the stream.  A client that stops reading blocks the write, so the
+ * server never holds more than STAT_STREAM_CHUNK records for it.  No job,
+ * queue or array lock may be held by the caller.
+ */
+
+static int send_status_chunk(
+
+  struct batch_request *preq)  /* I/O */
+
+  {
+  int                 rc;
+  struct batch_reply *preply = &preq->rq_reply;
+  struct tcp_chan    *chan;
+  char                log_buf[LOCAL_LOG_BUF_SIZE];
+
+  preply->brp_code = PBSE_NONE;
+  preply->brp_auxcode = STATUS_STREAM_MORE;
+
+  if ((chan = DIS_tcp_setup(preq->rq_conn)) == NULL)
+    rc = PBSE_MEM_MALLOC;
+  else
+    {
+    if ((rc = encode_DIS_reply(chan, preply)) == DIS_SUCCESS)
+      rc = DIS_tcp_wflush(chan);
+
+    DIS_tcp_cleanup(chan);
+    }
+
+  reply_free(preply);
+
+  preply->brp_auxcode = 0;
+  preply->brp_choice = BATCH_REPLY_CHOICE_Status;
+  CLEAR_HEAD(preply->brp_un.brp_status);
+
+  if (rc != PBSE_NONE)
+    {
+    snprintf(log_buf, sizeof(log_buf),
+      "cannot stream job status on socket %d (%d), dropping the request",
+      preq->rq_conn,
+      rc);
+    log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+
+    /* nothing more can be sent, the connection is closed on its next read */
+    preq->rq_noreply = TRUE;
+    }
+
+  return(rc);
+  }  /* END send_status_chunk() */
+
+
+
+
+
 /*
  * req_stat_job_step2 - continue with statusing of jobs
  *
@@ -362,6 +424,9 @@ int req_stat_job(
  *  Note, the funny initialization/advance of pjob in the "while" loop
  *  comes from the fact we want to look at the "next" job on re-entry.
  *
+ *  A status of every job at the server with STATSTREAM in the extension is
+ *  sent STAT_STREAM_CHUNK jobs at a time instead of in one reply.
+ *
  * @see req_stat_job() - parent
  * @see status_job() - child - build job record
  */
@@ -393,6 +458,8 @@ static void req_stat_job_step2(
   char                   job_id[PBS_MAXSVRJOBID+1];
   int                    job_substate = -1;
   time_t                 job_momstattime = -1;
+  int                    stream = FALSE;
+  int                    chunk_count = 0;
 
   preq   = cntl->sc_origrq;
   type   = (enum TJobStatTypeEnum)cntl->sc_type;
@@ -629,6 +696,13 @@ static void req_stat_job_step2(
     if (strstr(preq->rq_extend, EXECQUEONLY))
       exec_only = 1;
 
+    /* only server wide statuses, they hold no queue or array lock */
+    if ((strstr(preq->rq_extend, STATSTREAM) != NULL) &&
+        (preq->rq_conn >= 0) &&
+        ((type == tjstServer) ||
+         (type == tjstSummarizeArraysServer)))
+      stream = TRUE;
+
     ptr = strstr(preq->rq_extend, "DELTA:");
 
     if (ptr != NULL)
@@ -806,6 +880,9 @@ static void req_stat_job_step2(
       return;
       }
 
+    if (rc == PBSE_NONE)
+      chunk_count++;
+
     /* get next job */
 
 nextjob:
@@ -813,6 +890,15 @@ nextjob:
     if (pjob != NULL)
       unlock_ji_mutex(pjob, __func__, "10", LOGLEVEL);
 
+    if ((stream == TRUE) &&
+        (chunk_count >= STAT_STREAM_CHUNK))
+      {
+      if (send_status_chunk(preq) != PBSE_NONE)
+        break;
+
+      chunk_count = 0;
+      }
+
     if (type == tjstJob)
       break;
 
@@ -1642,6 +1728,11 @@ int req_stat_svr(
   pthread_mutex_lock(server.sv_attr_mutex);
   server.sv_attr[SRV_ATR_TotalJobs].at_val.at_long = numjobs;
   server.sv_attr[SRV_ATR_TotalJobs].at_flags |= ATR_VFLAG_SET;
+  svr_attr_publish(SRV_ATR_TotalJobs);
+
+  server.sv_attr[SRV_ATR_MailQueueDepth].at_val.at_long = mail_queue_length();
+  server.sv_attr[SRV_ATR_MailQueueDepth].at_flags |= ATR_VFLAG_SET;
+  svr_attr_publish(SRV_ATR_MailQueueDepth);
 
   pthread_mutex_lock(server.sv_jobstates_mutex);
 
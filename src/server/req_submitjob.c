@@ -0,0 +1,147 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * req_submitjob.c - the SubmitJob batch request
+ *
+ * A SubmitJob carries what Queue Job, Job Script and Commit would send in
+ * three requests.  The steps are run through the usual handlers in
+ * req_quejob.c.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libpbs.h"
+#include "batch_request.h"
+#include "pbs_error.h"
+#include "req_submitjob.h"
+#include "req_quejob.h" /* req_quejob, req_jobscript, req_commit */
+#include "process_request.h" /* alloc_br, free_br, close_quejob_by_jobid */
+#include "reply_send.h" /* req_reject */
+
+
+/*
+ * alloc_submit_step - allocate the request for one step of a SubmitJob
+ *
+ * The step inherits the connection and credentials of the SubmitJob and is
+ * marked compound so that it only replies on error.
+ */
+
+static struct batch_request *alloc_submit_step(
+
+  struct batch_request *preq,  /* I */
+  int                   type)  /* I */
+
+  {
+  struct batch_request *pstep;
+
+  if ((pstep = alloc_br(type)) == NULL)
+    return(NULL);
+
+  pstep->rq_perm     = preq->rq_perm;
+  pstep->rq_fromsvr  = preq->rq_fromsvr;
+  pstep->rq_conn     = preq->rq_conn;
+  pstep->rq_orgconn  = preq->rq_orgconn;
+  pstep->rq_compound = TRUE;
+
+  strcpy(pstep->rq_user, preq->rq_user);
+  strcpy(pstep->rq_host, preq->rq_host);
+
+  return(pstep);
+  }  /* END alloc_submit_step() */
+
+
+
+
+/*
+ * req_submitjob - Submit Job Batch Request
+ *
+ * Queue Job, Job Script and Commit carried in one request.  Each step runs
+ * through its usual handler so the checks stay in one place, but the client
+ * gets a single reply and the job is saved once, at commit.
+ */
+
+int req_submitjob(
+
+  struct batch_request *preq)  /* I (freed) */
+
+  {
+  struct batch_request *preq_script;
+  struct batch_request *preq_commit;
+  char                 *job_id = NULL;
+  int                   rc = PBSE_NONE;
+
+  preq_script = alloc_submit_step(preq, PBS_BATCH_jobscript);
+  preq_commit = alloc_submit_step(preq, PBS_BATCH_Commit);
+
+  if ((preq_script == NULL) ||
+      (preq_commit == NULL))
+    {
+    if (preq_script != NULL)
+      free_br(preq_script);
+
+    if (preq_commit != NULL)
+      free_br(preq_commit);
+
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+
+    return(PBSE_SYSTEM);
+    }
+
+  /* hand the script to the Job Script step before the request is freed */
+
+  preq_script->rq_ind.rq_jobfile.rq_type = JScript;
+  preq_script->rq_ind.rq_jobfile.rq_size = preq->rq_ind.rq_queuejob.rq_scriptsz;
+  preq_script->rq_ind.rq_jobfile.rq_data = preq->rq_ind.rq_queuejob.rq_script;
+
+  preq->rq_ind.rq_queuejob.rq_script = NULL;
+
+  /* the request itself becomes the Queue Job step */
+
+  preq->rq_type = PBS_BATCH_QueueJob;
+  preq->rq_compound = TRUE;
+
+  if ((rc = req_quejob(preq, &job_id)) == PBSE_NONE)
+    {
+    if (preq_script->rq_ind.rq_jobfile.rq_size > 0)
+      {
+      snprintf(preq_script->rq_ind.rq_jobfile.rq_jobid,
+        sizeof(preq_script->rq_ind.rq_jobfile.rq_jobid), "%s", job_id);
+
+      rc = req_jobscript(preq_script);
+      }
+    else
+      free_br(preq_script);
+
+    preq_script = NULL;
+
+    if (rc == PBSE_NONE)
+      {
+      snprintf(preq_commit->rq_ind.rq_commit,
+        sizeof(preq_commit->rq_ind.rq_commit), "%s", job_id);
+
+      rc = req_commit(preq_commit);
+
+      preq_commit = NULL;
+      }
+    }
+
+  /* the handlers free the steps they were given */
+
+  if (preq_script != NULL)
+    free_br(preq_script);
+
+  if (preq_commit != NULL)
+    free_br(preq_commit);
+
+  if ((rc != PBSE_NONE) && (job_id != NULL))
+    close_quejob_by_jobid(job_id);
+
+  if (job_id != NULL)
+    free(job_id);
+
+  return(rc);
+  }  /* END req_submitjob() */
+
+/* END req_submitjob.c */
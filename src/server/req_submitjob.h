@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _REQ_SUBMITJOB_H
+#define _REQ_SUBMITJOB_H
+
+#include "batch_request.h" /* batch_request */
+
+int req_submitjob(struct batch_request *preq);
+
+#endif /* _REQ_SUBMITJOB_H */
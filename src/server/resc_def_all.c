@@ -98,6 +98,7 @@
 #include "array.h"
 #include "utils.h"
 #include "svrfunc.h" /* get_svr_attr_* */
+#include "../lib/Libattr/attr_name_index.h" /* forget_name_index */
 
 extern struct server server;
 
@@ -785,15 +786,19 @@ int init_resc_defs(void)
   int                   rindex = 0;
   int                   dindex = 0;
   int                   unkindex = 0;
+  int                   const_size;
+  resource_def         *rdefs;
+  resource_def         *old_defs;
 #ifndef PBS_MOM
 
   resource_def         *tmpresc = NULL;
   struct array_strings *resc_arst = NULL;
   char                 *extra_resc;
   int                   resc_num = 0;
+  int                   i;
 #endif
 
-  svr_resc_size = sizeof(svr_resc_def_const) / sizeof(resource_def);
+  const_size = sizeof(svr_resc_def_const) / sizeof(resource_def);
 
 #ifndef PBS_MOM
   /* build up a temporary list of string resources */
@@ -829,17 +834,19 @@ int init_resc_defs(void)
 
 #endif
 
-  svr_resc_def = calloc(svr_resc_size + dindex, sizeof(resource_def));
+  /* fill in a new array and only publish it once it is complete */
 
-  if (svr_resc_def == NULL)
+  rdefs = calloc(const_size + dindex, sizeof(resource_def));
+
+  if (rdefs == NULL)
      {
      return(-1);
      }
 
   /* copy all const resources, except for the last "unknown" */
-  for (rindex = 0; rindex < (svr_resc_size - 1); rindex++)
+  for (rindex = 0; rindex < (const_size - 1); rindex++)
     {
-    memcpy(svr_resc_def + rindex, svr_resc_def_const + rindex, sizeof(resource_def));
+    memcpy(rdefs + rindex, svr_resc_def_const + rindex, sizeof(resource_def));
     }
 
   unkindex = rindex;
@@ -850,11 +857,22 @@ int init_resc_defs(void)
     {
     for (dindex = 0; (tmpresc + dindex)->rs_decode; dindex++)
       {
-      if (find_resc_def(svr_resc_def, (tmpresc + dindex)->rs_name, rindex) == NULL)
+      /* a plain scan, find_resc_def() would index the half built array */
+      for (i = 0; i < rindex; i++)
+        {
+        if (!strcmp(rdefs[i].rs_name, (tmpresc + dindex)->rs_name))
+          break;
+        }
+
+      if (i == rindex)
         {
-        memcpy(svr_resc_def + rindex, tmpresc + dindex, sizeof(resource_def));
+        memcpy(rdefs + rindex, tmpresc + dindex, sizeof(resource_def));
         rindex++;
         }
+      else
+        {
+        free((tmpresc + dindex)->rs_name);
+        }
       }
 
     free(tmpresc);
@@ -862,10 +880,17 @@ int init_resc_defs(void)
 #endif
 
   /* copy the last "unknown" resource */
-  memcpy(svr_resc_def + rindex, svr_resc_def_const + unkindex, sizeof(resource_def));
+  memcpy(rdefs + rindex, svr_resc_def_const + unkindex, sizeof(resource_def));
 
+  old_defs = svr_resc_def;
+
+  svr_resc_def = rdefs;
   svr_resc_size = rindex + 1;
 
+  /* the old array is not freed, a lookup may still be using it */
+  if (old_defs != NULL)
+    forget_name_index(old_defs);
+
   return(PBSE_NONE);
   } /* END init_resc_defs() */
 
@@ -1331,6 +1331,90 @@ attribute_def svr_attr_def[] =
    ATR_TYPE_LONG,
    PARENT_TYPE_SERVER},
 
+  /* SRV_ATR_AcctFsync */
+  {ATTR_acctfsync,   /* "accounting_fsync" */
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
+  /* SRV_ATR_AcctJson */
+  {ATTR_acctjson,    /* "accounting_json" */
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
+  /* SRV_ATR_LogFileIndex */
+  {ATTR_logfileindex,    /* "log_file_index" */
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
+  /* SRV_ATR_JobLogBinary */
+  {ATTR_joblogbinary,    /* "job_log_binary" */
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
+  /* SRV_ATR_MailRateLimit */
+  {ATTR_mailratelimit,   /* "mail_rate_limit" */
+   decode_l,
+   encode_l,
+   set_l,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
+  /* SRV_ATR_MailCoalesceDelay */
+  {ATTR_mailcoalescedelay, /* "mail_coalesce_delay" */
+   decode_l,
+   encode_l,
+   set_l,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
+  /* SRV_ATR_MailQueueDepth */
+  {ATTR_mailqueuedepth,  /* "mail_queue_depth" */
+   decode_null,
+   encode_l,
+   set_null,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   READ_ONLY,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER},
+
   /* site supplied server pbs_attribute definitions if any, see site_svr_attr_*.h  */
 #include "site_svr_attr_def.h"
 
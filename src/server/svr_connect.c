@@ -97,6 +97,9 @@
  *    believed to be temporary, ie retry.
  *
  * svr_disconnect() closes the above connection.
+ *
+ * svr_connect_pooled() and svr_disconnect_pooled() keep connections to
+ * MOMs open between job starts instead.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -106,6 +109,8 @@
 #include <stdio.h>
 #include <signal.h>
 #include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
 #include "libpbs.h"
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
@@ -136,6 +141,22 @@ extern void    bad_node_warning(pbs_net_t, struct pbsnode *);
 extern ssize_t read_blocking_socket(int, void *, ssize_t);
 extern int get_num_connections();
 
+#define SVR_CONN_POOL_SIZE  256 /* idle connections to MOMs kept open */
+#define SVR_CONN_POOL_IDLE  (PBS_NET_MAXCONNECTIDLE / 2) /* drop before the MOM does */
+
+/* connections made by svr_connect() kept for the next request to the same host */
+typedef struct svr_pooled_conn
+  {
+  pbs_net_t    pc_addr;
+  unsigned int pc_port;
+  int          pc_handle;
+  time_t       pc_last_used;
+  } svr_pooled_conn;
+
+static svr_pooled_conn svr_conn_pool[SVR_CONN_POOL_SIZE];
+static int             svr_conn_pool_count = 0;
+static pthread_mutex_t svr_conn_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 
 
 int svr_connect(
@@ -413,6 +434,189 @@ void svr_disconnect(
 
 
 
+/*
+ * pooled_conn_ok - check that an idle pooled connection can be reused
+ *
+ * Nothing should arrive on a connection while it sits in the pool, so
+ * anything readable means the other end closed it or it is out of step.
+ */
+
+static int pooled_conn_ok(
+
+  int handle)  /* I */
+
+  {
+  struct pollfd pfd;
+
+  pthread_mutex_lock(connection[handle].ch_mutex);
+  pfd.fd = connection[handle].ch_socket;
+  pthread_mutex_unlock(connection[handle].ch_mutex);
+
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  if ((pfd.fd < 0) ||
+      (poll(&pfd, 1, 0) != 0))
+    return(FALSE);
+
+  return(TRUE);
+  }  /* END pooled_conn_ok() */
+
+
+
+
+/*
+ * svr_connect_pooled - get a connection to a MOM for a job start
+ *
+ * Takes an idle connection to hostaddr:port from the pool if there is one
+ * and allow_reuse is set, otherwise opens a new one with svr_connect().
+ * *reused tells the caller whether the MOM may have dropped the connection
+ * while it sat in the pool, in which case a failure on it is worth one
+ * more try with allow_reuse off.
+ *
+ * Returns the same values as svr_connect()
+ */
+
+int svr_connect_pooled(
+
+  pbs_net_t     hostaddr,    /* I (host order) */
+  unsigned int  port,        /* I */
+  int          *my_err,      /* O */
+  int           allow_reuse, /* I */
+  int          *reused)      /* O */
+
+  {
+  int    handle = -1;
+  int    stale[SVR_CONN_POOL_SIZE];
+  int    stale_count = 0;
+  int    i;
+  time_t now = time(NULL);
+
+  *reused = FALSE;
+
+  if ((allow_reuse == TRUE) &&
+      (addr_ok(hostaddr, NULL)))
+    {
+    pthread_mutex_lock(&svr_conn_pool_mutex);
+
+    for (i = svr_conn_pool_count - 1; i >= 0; i--)
+      {
+      if ((svr_conn_pool[i].pc_addr != hostaddr) ||
+          (svr_conn_pool[i].pc_port != port))
+        continue;
+
+      handle = svr_conn_pool[i].pc_handle;
+
+      if ((now - svr_conn_pool[i].pc_last_used > SVR_CONN_POOL_IDLE) ||
+          (pooled_conn_ok(handle) == FALSE))
+        {
+        stale[stale_count++] = handle;
+        handle = -1;
+        }
+
+      svr_conn_pool[i] = svr_conn_pool[--svr_conn_pool_count];
+
+      if (handle >= 0)
+        break;
+      }
+
+    pthread_mutex_unlock(&svr_conn_pool_mutex);
+
+    for (i = 0; i < stale_count; i++)
+      svr_disconnect(stale[i]);
+    }
+
+  if (handle >= 0)
+    {
+    int sock;
+
+    pthread_mutex_lock(connection[handle].ch_mutex);
+    sock = connection[handle].ch_socket;
+    connection[handle].ch_errno = 0;
+    pthread_mutex_unlock(connection[handle].ch_mutex);
+
+    /* back under wait_request() like any other svr_connect() connection */
+    globalset_add_sock(sock);
+
+    if (LOGLEVEL >= 6)
+      {
+      char  log_buf[LOCAL_LOG_BUF_SIZE];
+      char *tmp = netaddr_pbs_net_t(hostaddr);
+
+      snprintf(log_buf, sizeof(log_buf), "reusing connection to host %s port %d",
+        tmp,
+        port);
+
+      log_event(PBSEVENT_ADMIN, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+
+      free(tmp);
+      }
+
+    *reused = TRUE;
+
+    return(handle);
+    }
+
+  return(svr_connect(hostaddr, port, my_err, NULL, NULL, ToServerDIS));
+  }  /* END svr_connect_pooled() */
+
+
+
+
+/*
+ * svr_disconnect_pooled - done with a connection from svr_connect_pooled()
+ *
+ * Only call this after a complete, successful exchange.  The connection
+ * goes back to the pool, or is closed if the pool is full.
+ */
+
+void svr_disconnect_pooled(
+
+  int handle)  /* I */
+
+  {
+  svr_pooled_conn *pconn;
+  int              sock;
+
+  if ((handle < 0) ||
+      (handle >= PBS_LOCAL_CONNECTION))
+    return;
+
+  pthread_mutex_lock(connection[handle].ch_mutex);
+  sock = connection[handle].ch_socket;
+  pthread_mutex_unlock(connection[handle].ch_mutex);
+
+  pthread_mutex_lock(&svr_conn_pool_mutex);
+
+  if ((sock >= 0) &&
+      (svr_conn_pool_count < SVR_CONN_POOL_SIZE))
+    {
+    /* an idle connection must not wake up wait_request() */
+    globalset_del_sock(sock);
+
+    pconn = &svr_conn_pool[svr_conn_pool_count++];
+
+    pthread_mutex_lock(svr_conn[sock].cn_mutex);
+    pconn->pc_addr = svr_conn[sock].cn_addr;
+    pconn->pc_port = svr_conn[sock].cn_port;
+    pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+    pconn->pc_handle = handle;
+    pconn->pc_last_used = time(NULL);
+
+    pthread_mutex_unlock(&svr_conn_pool_mutex);
+
+    return;
+    }
+
+  pthread_mutex_unlock(&svr_conn_pool_mutex);
+
+  svr_disconnect(handle);
+  }  /* END svr_disconnect_pooled() */
+
+
+
+
 /*
  * socket_to_handle() - turn a socket into a connection handle
  * as used by the libpbs.a routines.
@@ -10,6 +10,8 @@ void connection_clear(int con_pos);
 int svr_connect(pbs_net_t hostaddr, unsigned int port, int *local_errno, struct pbsnode *pnode, void *(*func)(void *), enum conn_type cntype);
 void svr_disconnect_sock(int handle);
 void svr_disconnect(int handle);
+int svr_connect_pooled(pbs_net_t hostaddr, unsigned int port, int *my_err, int allow_reuse, int *reused);
+void svr_disconnect_pooled(int handle);
 int get_connection_entry(int *conn_pos);
 char *parse_servername(char *name, unsigned int *service);
 #endif /* _SVR_CONNECT_H */
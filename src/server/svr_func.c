@@ -448,22 +448,177 @@ int set_null(
 
 
 
+/*
+ * The server's long and char attributes are also kept in svr_snapshot so
+ * the get_svr_attr_*() calls made for every request, MOM update and job
+ * lookup do not all take sv_attr_mutex.  Writers already hold the mutex
+ * and publish each change with svr_attr_publish(); readers use the
+ * version as a sequence lock, retrying if a write was in progress.
+ * Until pbsd_init() publishes the whole set the version is 0 and readers
+ * take the mutex as before.
+ */
+
+typedef struct svr_attr_snapshot
+  {
+  volatile unsigned long ss_version; /* odd while a write is in progress */
+  int                    ss_set[SRV_ATR_LAST];
+  union attr_val         ss_val[SRV_ATR_LAST];
+  } svr_attr_snapshot;
+
+static svr_attr_snapshot svr_snapshot;
+
+
+
+
+static void snapshot_attr(
+
+  int attr_index)
+
+  {
+  svr_snapshot.ss_set[attr_index] = ((server.sv_attr[attr_index].at_flags & ATR_VFLAG_SET) != 0);
+
+  switch (svr_attr_def[attr_index].at_type)
+    {
+    case ATR_TYPE_LONG:
+
+      svr_snapshot.ss_val[attr_index].at_long = server.sv_attr[attr_index].at_val.at_long;
+
+      break;
+
+    case ATR_TYPE_CHAR:
+
+      svr_snapshot.ss_val[attr_index].at_char = server.sv_attr[attr_index].at_val.at_char;
+
+      break;
+
+    default:
+
+      /* strings and lists can be freed under a reader, they stay locked */
+
+      break;
+    }
+  }  /* END snapshot_attr() */
+
+
+
+
+/*
+ * svr_attr_publish_all - copy every server attribute into the snapshot
+ *
+ * The caller must hold server.sv_attr_mutex.
+ */
+
+void svr_attr_publish_all(void)
+
+  {
+  int i;
+
+  svr_snapshot.ss_version++;
+  __sync_synchronize();
+
+  for (i = 0; i < SRV_ATR_LAST; i++)
+    snapshot_attr(i);
+
+  __sync_synchronize();
+  svr_snapshot.ss_version++;
+  }  /* END svr_attr_publish_all() */
+
+
+
+
+/*
+ * svr_attr_publish - copy one changed server attribute into the snapshot
+ *
+ * The caller must hold server.sv_attr_mutex.
+ */
+
+void svr_attr_publish(
+
+  int attr_index)
+
+  {
+  /* nothing is read from the snapshot until pbsd_init() fills it */
+  if ((svr_snapshot.ss_version == 0) ||
+      (attr_index < 0) ||
+      (attr_index >= SRV_ATR_LAST))
+    return;
+
+  svr_snapshot.ss_version++;
+  __sync_synchronize();
+
+  snapshot_attr(attr_index);
+
+  __sync_synchronize();
+  svr_snapshot.ss_version++;
+  }  /* END svr_attr_publish() */
+
+
+
+
+/*
+ * read_svr_attr - read a long or char server attribute
+ *
+ * Returns TRUE if the attribute is set, FALSE if not
+ */
+
+static int read_svr_attr(
+
+  int              attr_index,
+  union attr_val  *val)
+
+  {
+  unsigned long version;
+  int           is_set;
+
+  while ((version = svr_snapshot.ss_version) != 0)
+    {
+    __sync_synchronize();
+
+    if ((version & 1) == 0)
+      {
+      is_set = svr_snapshot.ss_set[attr_index];
+      *val = svr_snapshot.ss_val[attr_index];
+
+      __sync_synchronize();
+
+      if (version == svr_snapshot.ss_version)
+        return(is_set);
+      }
+    }
+
+  pthread_mutex_lock(server.sv_attr_mutex);
+  is_set = ((server.sv_attr[attr_index].at_flags & ATR_VFLAG_SET) != 0);
+  *val = server.sv_attr[attr_index].at_val;
+  pthread_mutex_unlock(server.sv_attr_mutex);
+
+  return(is_set);
+  }  /* END read_svr_attr() */
+
+
+
+
 int is_svr_attr_set(
 
   int attr_index)
 
   {
-  int is_set = FALSE;
+  union attr_val val;
 
   if (SRV_ATR_LAST <= attr_index)
-    return(is_set);
+    return(FALSE);
+
+  if ((svr_attr_def[attr_index].at_type == ATR_TYPE_LONG) ||
+      (svr_attr_def[attr_index].at_type == ATR_TYPE_CHAR))
+    return(read_svr_attr(attr_index, &val));
 
   pthread_mutex_lock(server.sv_attr_mutex);
   if (server.sv_attr[attr_index].at_flags & ATR_VFLAG_SET)
-    is_set = TRUE;
+    val.at_long = TRUE;
+  else
+    val.at_long = FALSE;
   pthread_mutex_unlock(server.sv_attr_mutex);
 
-  return(is_set);
+  return((int)val.at_long);
   } /* END is_svr_attr_set() */
 
 
@@ -524,6 +679,8 @@ int set_svr_attr(
       break;
     }
 
+  svr_attr_publish(attr_index);
+
   pthread_mutex_unlock(server.sv_attr_mutex);
 
   return(PBSE_NONE);
@@ -536,23 +693,18 @@ int get_svr_attr_l(
   long *l)
 
   {
-  int rc = PBSE_NONE;
-  pthread_mutex_lock(server.sv_attr_mutex);
+  union attr_val val;
+
   if ((attr_index >= SRV_ATR_LAST) ||
-      ((server.sv_attr[attr_index].at_flags & ATR_VFLAG_SET) == FALSE))
-    {
-    rc = -1;
-    }
-  else if (svr_attr_def[attr_index].at_type == ATR_TYPE_LONG)
-    {
-    *l = server.sv_attr[attr_index].at_val.at_long;
-    }
-  else
-    {
-    rc = -2;
-    }
-  pthread_mutex_unlock(server.sv_attr_mutex);
-  return rc;
+      (read_svr_attr(attr_index, &val) == FALSE))
+    return(-1);
+
+  if (svr_attr_def[attr_index].at_type != ATR_TYPE_LONG)
+    return(-2);
+
+  *l = val.at_long;
+
+  return(PBSE_NONE);
   }
 
 
@@ -562,23 +714,18 @@ int get_svr_attr_c(
   char *c)
 
   {
-  int rc = PBSE_NONE;
-  pthread_mutex_lock(server.sv_attr_mutex);
+  union attr_val val;
+
   if ((attr_index >= SRV_ATR_LAST) ||
-      ((server.sv_attr[attr_index].at_flags & ATR_VFLAG_SET) == FALSE))
-    {
-    rc = -1;
-    }
-  else if (svr_attr_def[attr_index].at_type == ATR_TYPE_CHAR)
-    {
-    *c = server.sv_attr[attr_index].at_val.at_char;
-    }
-  else
-    {
-    rc = -2;
-    }
-  pthread_mutex_unlock(server.sv_attr_mutex);
-  return rc;
+      (read_svr_attr(attr_index, &val) == FALSE))
+    return(-1);
+
+  if (svr_attr_def[attr_index].at_type != ATR_TYPE_CHAR)
+    return(-2);
+
+  *c = val.at_char;
+
+  return(PBSE_NONE);
   }
 
 int get_svr_attr_str(
@@ -140,6 +140,7 @@
 #include "ji_mutex.h"
 #include "user_info.h"
 #include "svr_jobfunc.h"
+#include "job_watch.h" /* notify_job_watchers */
 
 #define MSG_LEN_LONG 160
 
@@ -818,6 +819,7 @@ int svr_setjobstate(
   {
   int          changed = 0;
   int          oldstate;
+  int          state_changed = (pjob->ji_qs.ji_state != newstate);
 
   pbs_queue   *pque;
   char         log_buf[LOCAL_LOG_BUF_SIZE];
@@ -933,6 +935,10 @@ int svr_setjobstate(
 
   set_statechar(pjob);
 
+  if ((state_changed) &&
+      (pjob->ji_watched == TRUE))
+    notify_job_watchers(pjob, PBSE_NONE);
+
   /* update the job file */
 
   if (pjob->ji_modified)
@@ -1114,6 +1120,8 @@ int chk_svr_resc_limit(
   resource     *qurc;
   resource     *svrc;
   resource     *cmpwith;
+  resc_vector   qu_max;
+  resc_vector   svr_max;
 
   int           LimitIsFromQueue = FALSE;
   char         *LimitName;
@@ -1181,6 +1189,14 @@ int chk_svr_resc_limit(
   /* return values via global comp_resc_gt and comp_resc_lt */
   comp_resc_gt = 0;
 
+  /* index the queue and server maximums once instead of searching both
+   * lists for every job resource.  The server's stays locked while its
+   * entries are in use. */
+
+  pthread_mutex_lock(server.sv_attr_mutex);
+
+  resc_vector_init(&qu_max, &pque->qu_attr[QA_ATR_ResourceMax]);
+  resc_vector_init(&svr_max, &server.sv_attr[SRV_ATR_ResourceMax]);
 
   jbrc = (resource *)GET_NEXT(jobatr->at_val.at_list);
 
@@ -1190,16 +1206,25 @@ int chk_svr_resc_limit(
 
     if ((jbrc->rs_value.at_flags & (ATR_VFLAG_SET | ATR_VFLAG_DEFLT)) == ATR_VFLAG_SET)
       {
-      qurc = find_resc_entry(&pque->qu_attr[QA_ATR_ResourceMax], jbrc->rs_defin);
+      qurc = resc_vector_find(&qu_max, jbrc->rs_defin);
 
       LimitName = (jbrc->rs_defin->rs_name == NULL)?"resource":jbrc->rs_defin->rs_name;
 
-      pthread_mutex_lock(server.sv_attr_mutex);
-      cmpwith = get_resource(&pque->qu_attr[QA_ATR_ResourceMax],
-          &server.sv_attr[SRV_ATR_ResourceMax],
-          jbrc->rs_defin,
-          &LimitIsFromQueue);
-      pthread_mutex_unlock(server.sv_attr_mutex);
+      /* same as get_resource(): the queue's limit if set, else the server's */
+      if ((qurc != NULL) &&
+          (qurc->rs_value.at_flags & ATR_VFLAG_SET))
+        {
+        cmpwith = qurc;
+        LimitIsFromQueue = 1;
+        }
+      else
+        {
+        cmpwith = resc_vector_find(&svr_max, jbrc->rs_defin);
+
+        if ((cmpwith != NULL) &&
+            (cmpwith->rs_value.at_flags & ATR_VFLAG_SET))
+          LimitIsFromQueue = 0;
+        }
 
       if (strcmp(LimitName,"mppnppn") == 0)
         {
@@ -1302,6 +1327,11 @@ int chk_svr_resc_limit(
     jbrc = (resource *)GET_NEXT(jbrc->rs_link);
     }  /* END while (jbrc != NULL) */
 
+  resc_vector_free(&qu_max);
+  resc_vector_free(&svr_max);
+
+  pthread_mutex_unlock(server.sv_attr_mutex);
+
   if (mppnodect_resource != NULL)
     {
     /*
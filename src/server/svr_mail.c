@@ -79,6 +79,13 @@
 /*
  * svr_mail.c - send mail to mail list or owner of job on
  * job begin, job end, and/or job abort
+ *
+ * Notifications are queued for a single mail worker thread rather than
+ * each forking sendmail from the thread pool.  The server attribute
+ * mail_rate_limit paces the messages, and setting mail_coalesce_delay turns
+ * on coalescing: the worker then folds everything queued for one address
+ * into one message, so a burst (a job array ending, say) builds up into
+ * fewer messages.  Whatever is queued at shutdown is sent by mail_drain().
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -89,6 +96,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "list_link.h"
 #include "attribute.h"
 #include "server_limits.h"
@@ -112,6 +122,21 @@ extern struct server server;
 
 extern int LOGLEVEL;
 
+/* Local Data */
+
+/* at most this many notifications are written out in a summary */
+#define MAIL_SUMMARY_MAX 100
+
+static mail_info       *mail_queue_head = NULL;
+static mail_info       *mail_queue_tail = NULL;
+static long             mail_queue_depth = 0;
+static int              mail_sending = FALSE;   /* the worker has a group out */
+static int              mail_draining = FALSE;  /* send now, ignore the delay and limit */
+static pid_t            mail_worker_pid = 0;
+static pthread_mutex_t  mail_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   mail_queue_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   mail_drained_cond = PTHREAD_COND_INITIALIZER;
+
 
 
 void free_mail_info(
@@ -137,18 +162,85 @@ void free_mail_info(
 
 
 
+static void free_mail_list(
+
+  mail_info *mi)
+
+  {
+  mail_info *next;
+
+  for (; mi != NULL; mi = next)
+    {
+    next = mi->next;
+
+    free_mail_info(mi);
+    }
+  } /* END free_mail_list() */
+
 
-void *send_the_mail(
 
-  void *vp)
+
+
+/*
+ * mail_body_fmt - the body format for one notification
+ *
+ * Returns the server's mail_body_fmt or a default built in buf
+ */
+
+static char *mail_body_fmt(
+
+  mail_info *mi,   /* I */
+  char      *buf)  /* O - MAXLINE bytes */
 
   {
-  mail_info *mi = (mail_info *)vp;
+  char *bodyfmt = NULL;
+
+  get_svr_attr_str(SRV_ATR_MailBodyFmt, &bodyfmt);
+
+  if (bodyfmt != NULL)
+    return(bodyfmt);
+
+  bodyfmt = strcpy(buf, "PBS Job Id: %i\n"
+                        "Job Name:   %j\n");
+  if (mi->exec_host != NULL)
+    {
+    strcat(bodyfmt, "Exec host:  %h\n");
+    }
+
+  strcat(bodyfmt, "%m\n");
+
+  if (mi->text != NULL)
+    {
+    strcat(bodyfmt, "%d\n");
+    }
+
+  return(bodyfmt);
+  }  /* END mail_body_fmt() */
+
 
+
+
+/*
+ * send_mail_group - pipe one message to sendmail for a list of notifications
+ *
+ * All of the notifications go to the same address.  A single notification
+ * is sent as it always has been; several are sent as one summary listing
+ * each of them (up to MAIL_SUMMARY_MAX) with the body format.
+ *
+ * The list is freed.
+ */
+
+static void send_mail_group(
+
+  mail_info *group,  /* I (freed) */
+  int        count)  /* I - notifications in group */
+
+  {
+  mail_info *mi = group;
   int        i;
+  int        listed;
   char      *mailfrom = NULL;
   char      *subjectfmt = NULL;
-  char      *bodyfmt = NULL;
   char      *cmdbuf = NULL;
   char       bodyfmtbuf[MAXLINE];
   FILE      *outmail;
@@ -180,25 +272,6 @@ void *send_the_mail(
     subjectfmt = "PBS JOB %i";
     }
 
-  /* mail body formating statement */
-  get_svr_attr_str(SRV_ATR_MailBodyFmt, &bodyfmt);
-  if (bodyfmt == NULL)
-    {
-    bodyfmt =  strcpy(bodyfmtbuf, "PBS Job Id: %i\n"
-                                  "Job Name:   %j\n");
-    if (mi->exec_host != NULL)
-      {
-      strcat(bodyfmt, "Exec host:  %h\n");
-      }
-
-    strcat(bodyfmt, "%m\n");
-
-    if (mi->text != NULL)
-      {
-      strcat(bodyfmt, "%d\n");
-      }
-    }
-
   /* setup sendmail command line with -f from_whom */
   i = strlen(SENDMAIL_CMD) + strlen(mailfrom) + strlen(mi->mailto) + 6;
 
@@ -216,9 +289,9 @@ void *send_the_mail(
       mi->jobid,
       tmpBuf);
   
-    free_mail_info(mi);
+    free_mail_list(group);
 
-    return(NULL);
+    return;
     }
 
   sprintf(cmdbuf, "%s -f %s %s",
@@ -242,24 +315,38 @@ void *send_the_mail(
       mi->jobid,
       tmpBuf);
 
-    free_mail_info(mi);
+    free_mail_list(group);
     free(cmdbuf);
 
-    return(NULL);
+    return;
     }
 
   /* Pipe in mail headers: To: and Subject: */
   fprintf(outmail, "To: %s\n", mi->mailto);
 
   fprintf(outmail, "Subject: ");
-  svr_format_job(outmail, mi, subjectfmt);
+  if (count == 1)
+    svr_format_job(outmail, mi, subjectfmt);
+  else
+    fprintf(outmail, "PBS: %d job notifications", count);
   fprintf(outmail, "\n");
 
   /* Set "Precedence: bulk" to avoid vacation messages, etc */
   fprintf(outmail, "Precedence: bulk\n\n");
 
   /* Now pipe in the email body */
-  svr_format_job(outmail, mi, bodyfmt);
+  for (listed = 0; (mi != NULL) && (listed < MAIL_SUMMARY_MAX); mi = mi->next, listed++)
+    {
+    if (listed > 0)
+      fprintf(outmail, "\n");
+
+    svr_format_job(outmail, mi, mail_body_fmt(mi, bodyfmtbuf));
+    }
+
+  if (count > listed)
+    fprintf(outmail, "\n... and %d more\n", count - listed);
+
+  mi = group;
 
   errno = 0;
   if ((i = pclose(outmail)) != 0)
@@ -282,14 +369,32 @@ void *send_the_mail(
     }
   else if (LOGLEVEL >= 4)
     {
-    log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
-      PBS_EVENTCLASS_JOB,
-      mi->jobid,
-      "Email sent successfully\n");
+    for (; mi != NULL; mi = mi->next)
+      {
+      log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
+        PBS_EVENTCLASS_JOB,
+        mi->jobid,
+        (count == 1) ? "Email sent successfully\n" : "Email sent successfully in a summary\n");
+      }
     }
 
-  free_mail_info(mi);
+  free_mail_list(group);
   free(cmdbuf);
+  } /* END send_mail_group() */
+
+
+
+
+void *send_the_mail(
+
+  void *vp)
+
+  {
+  mail_info *mi = (mail_info *)vp;
+
+  mi->next = NULL;
+
+  send_mail_group(mi, 1);
     
   return(NULL);
   } /* END send_the_mail() */
@@ -297,6 +402,328 @@ void *send_the_mail(
 
 
 
+/*
+ * take_mail_group - unlink the first queued notification and, when
+ * coalescing, every later one for the same address
+ *
+ * Returns the group, in queue order, with its size in *count
+ */
+
+mail_info *take_mail_group(
+
+  mail_info **head,      /* M */
+  mail_info **tail,      /* M */
+  int         coalesce,  /* I */
+  int        *count)     /* O */
+
+  {
+  mail_info  *group = *head;
+  mail_info  *group_tail;
+  mail_info **prev;
+  mail_info  *mi;
+
+  *count = 0;
+
+  if (group == NULL)
+    return(NULL);
+
+  *head = group->next;
+  group->next = NULL;
+  group_tail = group;
+  *count = 1;
+
+  if (coalesce == FALSE)
+    {
+    if (*head == NULL)
+      *tail = NULL;
+
+    return(group);
+    }
+
+  *tail = NULL;
+  prev = head;
+
+  while ((mi = *prev) != NULL)
+    {
+    if (!strcmp(mi->mailto, group->mailto))
+      {
+      *prev = mi->next;
+
+      mi->next = NULL;
+      group_tail->next = mi;
+      group_tail = mi;
+      (*count)++;
+      }
+    else
+      {
+      *tail = mi;
+      prev = &mi->next;
+      }
+    }
+
+  return(group);
+  }  /* END take_mail_group() */
+
+
+
+
+/*
+ * mail_wait_until - wait on the queue until when, or until mail_drain()
+ * or a new notification wakes the worker.  mail_queue_mutex held.
+ */
+
+static void mail_wait_until(
+
+  time_t when)  /* I */
+
+  {
+  struct timespec ts;
+
+  ts.tv_sec = when;
+  ts.tv_nsec = 0;
+
+  pthread_cond_timedwait(&mail_queue_cond, &mail_queue_mutex, &ts);
+  }  /* END mail_wait_until() */
+
+
+
+
+/*
+ * mail_worker - the thread that delivers queued notifications
+ *
+ * With mail_coalesce_delay set, everything queued for an address while
+ * sendmail runs, while the oldest notification waits out the delay, or
+ * while mail_rate_limit messages have already gone out this minute, goes
+ * out as one message.  Otherwise each notification is its own message.
+ */
+
+static void *mail_worker(
+
+  void *vp)
+
+  {
+  mail_info *group;
+  int        count;
+  long       delay;
+  long       limit;
+  time_t     now;
+  time_t     window_start = 0;
+  long       window_sent = 0;
+
+  pthread_mutex_lock(&mail_queue_mutex);
+
+  while (TRUE)
+    {
+    while (mail_queue_head == NULL)
+      pthread_cond_wait(&mail_queue_cond, &mail_queue_mutex);
+
+    delay = 0;
+    limit = 0;
+    get_svr_attr_l(SRV_ATR_MailCoalesceDelay, &delay);
+    get_svr_attr_l(SRV_ATR_MailRateLimit, &limit);
+
+    now = time(NULL);
+
+    if ((mail_draining == FALSE) &&
+        (delay > 0) &&
+        (mail_queue_head->queued + delay > now))
+      {
+      mail_wait_until(mail_queue_head->queued + delay);
+
+      continue;
+      }
+
+    if (now - window_start >= 60)
+      {
+      window_start = now;
+      window_sent = 0;
+      }
+
+    if ((mail_draining == FALSE) &&
+        (limit > 0) &&
+        (window_sent >= limit))
+      {
+      mail_wait_until(window_start + 60);
+
+      continue;
+      }
+
+    group = take_mail_group(&mail_queue_head, &mail_queue_tail, (delay > 0), &count);
+    mail_sending = TRUE;
+
+    pthread_mutex_unlock(&mail_queue_mutex);
+
+    send_mail_group(group, count);
+    window_sent++;
+
+    pthread_mutex_lock(&mail_queue_mutex);
+
+    mail_queue_depth -= count;
+    mail_sending = FALSE;
+
+    if (mail_queue_head == NULL)
+      pthread_cond_broadcast(&mail_drained_cond);
+    }
+
+  /*NOTREACHED*/
+  return(NULL);
+  }  /* END mail_worker() */
+
+
+
+
+/*
+ * mail_worker_running - start the mail worker if this process does not
+ * have one
+ *
+ * Called with mail_queue_mutex held.
+ *
+ * Returns TRUE if there is a worker
+ */
+
+static int mail_worker_running(void)
+
+  {
+  pthread_t      tid;
+  pthread_attr_t attr;
+  int            rc;
+
+  if (mail_worker_pid == getpid())
+    return(TRUE);
+
+  if (pthread_attr_init(&attr) != 0)
+    return(FALSE);
+
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  rc = pthread_create(&tid, &attr, mail_worker, NULL);
+
+  pthread_attr_destroy(&attr);
+
+  if (rc != 0)
+    {
+    log_err(rc, __func__, "cannot start the mail worker, sending mail from the thread pool");
+
+    return(FALSE);
+    }
+
+  mail_worker_pid = getpid();
+
+  return(TRUE);
+  }  /* END mail_worker_running() */
+
+
+
+
+/*
+ * queue_mail - hand a notification to the mail worker
+ */
+
+static void queue_mail(
+
+  mail_info *mi)  /* I (freed) */
+
+  {
+  mi->queued = time(NULL);
+  mi->next = NULL;
+
+  pthread_mutex_lock(&mail_queue_mutex);
+
+  if (!mail_worker_running())
+    {
+    pthread_mutex_unlock(&mail_queue_mutex);
+
+    enqueue_threadpool_request(send_the_mail, mi);
+
+    return;
+    }
+
+  if (mail_queue_tail != NULL)
+    mail_queue_tail->next = mi;
+  else
+    mail_queue_head = mi;
+
+  mail_queue_tail = mi;
+  mail_queue_depth++;
+
+  pthread_cond_signal(&mail_queue_cond);
+
+  pthread_mutex_unlock(&mail_queue_mutex);
+  }  /* END queue_mail() */
+
+
+
+
+/*
+ * mail_drain - send everything queued now, ignoring mail_coalesce_delay and
+ * mail_rate_limit, and return once it has gone out
+ *
+ * Called at shutdown so held notifications are not lost.
+ */
+
+void mail_drain(void)
+
+  {
+  mail_info *group;
+  int        count;
+  long       delay = 0;
+
+  get_svr_attr_l(SRV_ATR_MailCoalesceDelay, &delay);
+
+  pthread_mutex_lock(&mail_queue_mutex);
+
+  mail_draining = TRUE;
+
+  if (mail_worker_pid != getpid())
+    {
+    /* no worker, send what is queued here */
+    while ((group = take_mail_group(&mail_queue_head, &mail_queue_tail, (delay > 0), &count)) != NULL)
+      {
+      pthread_mutex_unlock(&mail_queue_mutex);
+
+      send_mail_group(group, count);
+
+      pthread_mutex_lock(&mail_queue_mutex);
+
+      mail_queue_depth -= count;
+      }
+    }
+  else
+    {
+    pthread_cond_signal(&mail_queue_cond);
+
+    while ((mail_queue_head != NULL) ||
+           (mail_sending == TRUE))
+      pthread_cond_wait(&mail_drained_cond, &mail_queue_mutex);
+    }
+
+  mail_draining = FALSE;
+
+  pthread_mutex_unlock(&mail_queue_mutex);
+  }  /* END mail_drain() */
+
+
+
+
+/*
+ * mail_queue_length - notifications waiting for or being delivered
+ */
+
+long mail_queue_length(void)
+
+  {
+  long depth;
+
+  pthread_mutex_lock(&mail_queue_mutex);
+  depth = mail_queue_depth;
+  pthread_mutex_unlock(&mail_queue_mutex);
+
+  return(depth);
+  }  /* END mail_queue_length() */
+
+
+
+
 void svr_mailowner(
 
   job   *pjob,      /* I */
@@ -525,8 +952,8 @@ void svr_mailowner(
   else
     mi->text = NULL;
 
-  /* have a thread do the work of sending the mail */
-  enqueue_threadpool_request(send_the_mail,mi);
+  /* have the mail worker send it, with whatever else is going to mailto */
+  queue_mail(mi);
 
   return;
   }  /* END svr_mailowner() */
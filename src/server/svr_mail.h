@@ -7,4 +7,10 @@
 
 void svr_mailowner(job *pjob, int mailpoint, int force, char *text);
 
+mail_info *take_mail_group(mail_info **head, mail_info **tail, int coalesce, int *count);
+
+void mail_drain(void);
+
+long mail_queue_length(void);
+
 #endif /* _SVR_MAIL_H */
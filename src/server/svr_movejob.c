@@ -89,6 +89,8 @@
 #include <signal.h>
 #include <sys/param.h>
 #include <semaphore.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
@@ -97,6 +99,7 @@
 #include "list_link.h"
 #include "attribute.h"
 #include "server_limits.h"
+#include "server.h"
 #include "work_task.h"
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
@@ -108,6 +111,7 @@
 #include "batch_request.h"
 #include "net_connect.h"
 #include "svrfunc.h"
+#include "dis.h" /* DIS_tcp_settimeout */
 #include "mcom.h"
 #include "array.h"
 #include "threadpool.h"
@@ -115,6 +119,7 @@
 #include "queue_func.h" /* find_queuebyname */
 #include "req_runjob.h" /* finish_sendmom */
 #include "ji_mutex.h"
+#include "svr_func.h" /* get_svr_attr_* */
 
 #if __STDC__ != 1
 #include <memory.h>
@@ -168,6 +173,60 @@ extern int               LOGLEVEL;
 
 int net_move(job *, struct batch_request *);
 
+/* how long a MOM that rejected SubmitJob gets the multi-step protocol */
+#define SUBMIT_MOM_RECHECK 3600
+#define SUBMIT_MOM_MAX     64
+
+/* what the driver in send_job_attempts() does after one attempt */
+enum send_job_step
+  {
+  SEND_JOB_DONE,      /* finished, sjs_rc is the result */
+  SEND_JOB_STOP,      /* gave up, sjs_rc is worked out from the errors */
+  SEND_JOB_AGAIN,     /* failed, retry after a backoff */
+  SEND_JOB_RECONNECT  /* retry now, the connection went stale */
+  };
+
+/* a job send in progress, kept across attempts and deferred retries */
+typedef struct send_job_state
+  {
+  char                  sjs_jobid[PBS_MAXSVRJOBID + 1];
+  char                 *sjs_node_name;
+  int                   sjs_type;
+  struct batch_request *sjs_preq;
+  long                  sjs_start_time;
+  int                   sjs_attempts;
+  int                   sjs_rc;
+  int                   sjs_my_err;
+  int                   sjs_mom_err;
+  mbool_t               sjs_timeout;
+  mbool_t               sjs_deferred;     /* running from send_job_retry_task() */
+  mbool_t               sjs_fresh_conn;   /* do not use a pooled connection */
+  mbool_t               sjs_multi_step;   /* do not use SubmitJob */
+  mbool_t               sjs_queue_job;
+  mbool_t               sjs_set_trnout;
+  mbool_t               sjs_has_script;
+  mbool_t               sjs_has_run;
+  tlist_head            sjs_attrl;
+  char                  sjs_destin[PBS_MAXROUTEDEST + 1];
+  unsigned long         sjs_momaddr;
+  unsigned short        sjs_momport;
+  char                  sjs_script[MAXPATHLEN + 1];
+  char                  sjs_stdout[MAXPATHLEN + 1];
+  char                  sjs_stderr[MAXPATHLEN + 1];
+  char                  sjs_chkpt[MAXPATHLEN + 1];
+  } send_job_state;
+
+typedef struct submit_mom
+  {
+  pbs_net_t      sm_addr;
+  unsigned short sm_port;
+  time_t         sm_since;
+  } submit_mom;
+
+static submit_mom      submit_moms[SUBMIT_MOM_MAX];
+static int             submit_mom_count = 0;
+static pthread_mutex_t submit_mom_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /*
  * svr_movejob
  *
@@ -652,47 +711,781 @@ void free_server_attrs(
 
 
 
+static void free_send_job_state(
+
+  send_job_state *sjs)
+
+  {
+  free_server_attrs(&sjs->sjs_attrl);
+
+  if (sjs->sjs_node_name != NULL)
+    free(sjs->sjs_node_name);
+
+  free(sjs);
+  }  /* END free_send_job_state() */
+
+
+
+
+/*
+ * mom_takes_submitjob - should a job start to this MOM use SubmitJob
+ *
+ * MOMs that rejected a SubmitJob as an unknown request are remembered for
+ * SUBMIT_MOM_RECHECK seconds and sent the multi-step Queue Job protocol.
+ */
+
+static int mom_takes_submitjob(
+
+  pbs_net_t      addr,  /* I */
+  unsigned short port)  /* I */
+
+  {
+  int    i;
+  int    rc = TRUE;
+  time_t now = time(NULL);
+
+  pthread_mutex_lock(&submit_mom_mutex);
+
+  for (i = 0; i < submit_mom_count; i++)
+    {
+    if ((submit_moms[i].sm_addr == addr) &&
+        (submit_moms[i].sm_port == port))
+      {
+      if (now - submit_moms[i].sm_since < SUBMIT_MOM_RECHECK)
+        rc = FALSE;
+      else
+        submit_moms[i] = submit_moms[--submit_mom_count];
+
+      break;
+      }
+    }
+
+  pthread_mutex_unlock(&submit_mom_mutex);
+
+  return(rc);
+  }  /* END mom_takes_submitjob() */
+
+
+
+
+/*
+ * mom_skip_submitjob - remember that a MOM does not understand SubmitJob
+ *
+ * When the table is full the oldest entry is replaced.
+ */
+
+static void mom_skip_submitjob(
+
+  pbs_net_t      addr,  /* I */
+  unsigned short port)  /* I */
+
+  {
+  int i;
+  int slot = 0;
+
+  pthread_mutex_lock(&submit_mom_mutex);
+
+  for (i = 0; i < submit_mom_count; i++)
+    {
+    if ((submit_moms[i].sm_addr == addr) &&
+        (submit_moms[i].sm_port == port))
+      break;
+
+    if (submit_moms[i].sm_since < submit_moms[slot].sm_since)
+      slot = i;
+    }
+
+  if (i < submit_mom_count)
+    slot = i;
+  else if (submit_mom_count < SUBMIT_MOM_MAX)
+    slot = submit_mom_count++;
+
+  submit_moms[slot].sm_addr = addr;
+  submit_moms[slot].sm_port = port;
+  submit_moms[slot].sm_since = time(NULL);
+
+  pthread_mutex_unlock(&submit_mom_mutex);
+  }  /* END mom_skip_submitjob() */
+
+
+
+
+/*
+ * read_job_script - read a job script that fits in one SubmitJob
+ *
+ * Returns the script in a malloc'd buffer, or NULL if it cannot be read or
+ * is larger than SCRIPT_CHUNK_Z and has to go in Job Script pieces.
+ */
+
+static char *read_job_script(
+
+  char *path,  /* I */
+  int  *len)   /* O */
+
+  {
+  struct stat  sb;
+  char        *buf;
+  FILE        *fp;
+
+  if ((fp = fopen(path, "r")) == NULL)
+    return(NULL);
+
+  if ((fstat(fileno(fp), &sb) != 0) ||
+      (sb.st_size > SCRIPT_CHUNK_Z) ||
+      ((buf = calloc(1, sb.st_size + 1)) == NULL))
+    {
+    fclose(fp);
+
+    return(NULL);
+    }
+
+  if (fread(buf, 1, sb.st_size, fp) != (size_t)sb.st_size)
+    {
+    free(buf);
+    fclose(fp);
+
+    return(NULL);
+    }
+
+  fclose(fp);
+
+  *len = (int)sb.st_size;
+
+  return(buf);
+  }  /* END read_job_script() */
+
+
+
+
+/*
+ * send_job_submit - start a job on a MOM with a single SubmitJob request
+ *
+ * The MOM queues the job, writes the script and commits it, and only
+ * replies once.  A rejected SubmitJob is handled like a failed commit and
+ * is not retried, since the MOM may have got as far as starting the job.
+ */
+
+static enum send_job_step send_job_submit(
+
+  send_job_state *sjs,         /* M */
+  int             con,         /* I */
+  int             reused,      /* I */
+  char           *script,      /* I */
+  int             script_len)  /* I */
+
+  {
+  char            *job_id = sjs->sjs_jobid;
+  char             log_buf[LOCAL_LOG_BUF_SIZE];
+  char            *err_text;
+  struct attropl  *pqjatr;
+  job             *pjob;
+  long             sid = -1;
+  int              rc;
+
+  pqjatr = &((svrattrl *)GET_NEXT(sjs->sjs_attrl))->al_atopl;
+
+  rc = PBSD_submitjob_get_sid(con, &sid, job_id, sjs->sjs_destin, pqjatr, script, script_len);
+
+  if (rc == PBSE_NONE)
+    {
+    if ((pjob = svr_find_job(job_id, TRUE)) == NULL)
+      return(SEND_JOB_STOP);
+
+    pjob->ji_qs.ji_substate = JOB_SUBSTATE_TRNOUTCM;
+
+    if (sid != -1)
+      {
+      pjob->ji_wattr[JOB_ATR_session_id].at_val.at_long = sid;
+      pjob->ji_wattr[JOB_ATR_session_id].at_flags |= ATR_VFLAG_SET;
+      }
+
+    job_save(pjob, SAVEJOB_QUICK, 0);
+    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+
+    sjs->sjs_queue_job = FALSE;
+
+    /* SUCCESS */
+    sjs->sjs_rc = PBSE_NONE;
+
+    return(SEND_JOB_DONE);
+    }
+
+  if (rc == PBSE_UNKREQ)
+    {
+    /* an older MOM, it closes the connection after rejecting the request */
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, job_id,
+      "MOM does not support SubmitJob, using the multi-step protocol");
+
+    mom_skip_submitjob(sjs->sjs_momaddr, sjs->sjs_momport);
+
+    sjs->sjs_multi_step = TRUE;
+    sjs->sjs_fresh_conn = TRUE;
+
+    return(SEND_JOB_RECONNECT);
+    }
+
+  if ((rc == PBSE_PROTOCOL) &&
+      (reused == TRUE))
+    {
+    /* the MOM closed the pooled connection, nothing was processed */
+    sjs->sjs_fresh_conn = TRUE;
+
+    return(SEND_JOB_RECONNECT);
+    }
+
+  if (rc == PBSE_JOBEXIST)
+    {
+    /* already running, mark it so */
+    log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_JOB, job_id,
+      "MOM reports job already running");
+
+    sjs->sjs_my_err = rc;
+    sjs->sjs_rc = PBSE_NONE;
+
+    return(SEND_JOB_STOP);
+    }
+
+  if ((rc == PBSE_TIMEOUT) ||
+      (rc == PBSE_EXPIRED))
+    sjs->sjs_timeout = TRUE;
+
+  pthread_mutex_lock(connection[con].ch_mutex);
+  err_text = connection[con].ch_errtxt;
+  pthread_mutex_unlock(connection[con].ch_mutex);
+
+  snprintf(log_buf, sizeof(log_buf), "send_job submit failed, rc=%d (%s: %s)",
+    rc, pbse_to_txt(rc), (err_text != NULL) ? err_text : "N/A");
+
+  log_ext(rc, __func__, log_buf, LOG_WARNING);
+
+  sjs->sjs_my_err = rc;
+  sjs->sjs_mom_err = rc;
+
+  return(SEND_JOB_STOP);
+  }  /* END send_job_submit() */
+
+
+
+
+/*
+ * send_job_exchange - go through the protocol to transfer a job on con
+ *
+ * One pass of the transfer: Queue Job, Job Script, the files of a prior
+ * run, Ready To Commit and Commit, or a single SubmitJob for a job start
+ * where the MOM supports it.
+ */
+
+static enum send_job_step send_job_exchange(
+
+  send_job_state *sjs,     /* M */
+  int             con,     /* I */
+  int             reused)  /* I */
+
+  {
+  char                 *job_id = sjs->sjs_jobid;
+  char                  log_buf[LOCAL_LOG_BUF_SIZE];
+  char                 *pc;
+  char                 *script = NULL;
+  int                   script_len = 0;
+  int                   queued_now = FALSE;
+  int                   rc;
+  enum send_job_step    step;
+  long                  sid = -1;
+  job                  *pjob;
+  struct attropl       *pqjatr;      /* list (single) of attropl for quejob */
+
+  if (sjs->sjs_queue_job == TRUE)
+    {
+    if (sjs->sjs_set_trnout == TRUE)
+      {
+      if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
+        {
+        pjob->ji_qs.ji_substate = JOB_SUBSTATE_TRNOUT;
+        job_save(pjob, SAVEJOB_QUICK, 0);
+        unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+        }
+      else
+        return(SEND_JOB_STOP);
+      }
+
+    /* a job start goes as one request unless files from a prior run have
+     * to be moved as well */
+    if ((sjs->sjs_type == MOVE_TYPE_Exec) &&
+        (sjs->sjs_multi_step == FALSE) &&
+        ((sjs->sjs_has_run == FALSE) ||
+         (sjs->sjs_momaddr == pbs_server_addr)) &&
+        (mom_takes_submitjob(sjs->sjs_momaddr, sjs->sjs_momport) == TRUE) &&
+        ((sjs->sjs_has_script == FALSE) ||
+         ((script = read_job_script(sjs->sjs_script, &script_len)) != NULL)))
+      {
+      step = send_job_submit(sjs, con, reused, script, script_len);
+
+      if (script != NULL)
+        free(script);
+
+      return(step);
+      }
+
+    pqjatr = &((svrattrl *)GET_NEXT(sjs->sjs_attrl))->al_atopl;
+
+    if ((pc = PBSD_queuejob(con, &sjs->sjs_my_err, job_id, sjs->sjs_destin, pqjatr, NULL)) == NULL)
+      {
+      if ((sjs->sjs_my_err == PBSE_PROTOCOL) &&
+          (reused == TRUE))
+        {
+        /* the MOM closed the pooled connection */
+        sjs->sjs_fresh_conn = TRUE;
+
+        return(SEND_JOB_RECONNECT);
+        }
+
+      if (sjs->sjs_my_err == PBSE_EXPIRED)
+        {
+        /* queue job timeout based on pbs_tcp_timeout */
+
+        sjs->sjs_timeout = TRUE;
+        }
+
+      if ((sjs->sjs_my_err == PBSE_JOBEXIST) &&
+          (sjs->sjs_type == MOVE_TYPE_Exec))
+        {
+        /* already running, mark it so */
+        log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_JOB, job_id,
+          "MOM reports job already running");
+        sjs->sjs_rc = PBSE_NONE; /* Equivalent to LOCUTION_SUCCESS */
+
+        return(SEND_JOB_STOP);
+        }
+
+      sprintf(log_buf, "send of job to %s failed error = %d",
+        (sjs->sjs_destin[0] != '\0') ? sjs->sjs_destin : "unknown host",
+        sjs->sjs_my_err);
+
+      log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, job_id, log_buf);
+
+      return(SEND_JOB_AGAIN);
+      }  /* END if ((pc = PBSD_queuejob() == NULL) */
+
+    free(pc);
+
+    queued_now = TRUE;
+
+    if (sjs->sjs_has_script == TRUE)
+      {
+      if (PBSD_jscript(con, sjs->sjs_script, job_id) != 0)
+        return(SEND_JOB_AGAIN);
+      }
+
+    /* XXX may need to change the logic below, if we are sending the job to
+       a mom on the same host and the mom and server are not sharing the same
+       spool directory, then we still need to move the file */
+
+    if ((sjs->sjs_type == MOVE_TYPE_Exec) &&
+        (sjs->sjs_has_run == TRUE) &&
+        (sjs->sjs_momaddr != pbs_server_addr))
+      {
+      /* send files created on prior run */
+      if ((PBSD_jobfile(con, PBS_BATCH_MvJobFile, sjs->sjs_stdout, job_id, StdOut) != PBSE_NONE) ||
+          (PBSD_jobfile(con, PBS_BATCH_MvJobFile, sjs->sjs_stderr, job_id, StdErr) != PBSE_NONE) ||
+          (PBSD_jobfile(con, PBS_BATCH_MvJobFile, sjs->sjs_chkpt, job_id, Checkpoint) != PBSE_NONE))
+        {
+        return(SEND_JOB_AGAIN);
+        }
+      }
+
+    if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
+      {
+      pjob->ji_qs.ji_substate = JOB_SUBSTATE_TRNOUTCM;      
+      job_save(pjob, SAVEJOB_QUICK, 0);
+      unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
+      }
+    else
+      return(SEND_JOB_STOP);
+
+    sjs->sjs_queue_job = FALSE;
+    }
+
+  if ((rc = PBSD_rdytocmt(con, job_id)) != 0)
+    {
+    if ((rc == PBSE_PROTOCOL) &&
+        (reused == TRUE) &&
+        (queued_now == FALSE))
+      {
+      sjs->sjs_fresh_conn = TRUE;
+
+      return(SEND_JOB_RECONNECT);
+      }
+
+    return(SEND_JOB_AGAIN);
+    }
+
+  if ((sjs->sjs_mom_err = PBSD_commit_get_sid(con, &sid, job_id)) != PBSE_NONE)
+    {
+    int   errno2;
+    char *err_text;
+
+    pthread_mutex_lock(connection[con].ch_mutex);
+    err_text = connection[con].ch_errtxt;
+    pthread_mutex_unlock(connection[con].ch_mutex);
+
+    /* NOTE:  errno is modified by log_err */
+    if (sjs->sjs_mom_err > PBSE_FLOOR)
+      {
+      sprintf(log_buf, "send_job commit failed, rc=%d (%s: %s)",
+        sjs->sjs_mom_err, pbse_to_txt(sjs->sjs_mom_err), (err_text != NULL) ? err_text : "N/A");
+      errno2 = sjs->sjs_mom_err;
+      }
+    else
+      {
+      sprintf(log_buf, "send_job commit failed, rc=%d (%s)",
+        sjs->sjs_mom_err, (err_text != NULL) ? err_text : "N/A");
+      errno2 = errno;
+      }
+
+    log_ext(errno2, __func__, log_buf, LOG_WARNING);
+
+    /* if failure occurs, pbs_mom should purge job and pbs_server should set *
+       job state to idle w/error msg */
+
+    if (errno2 == EINPROGRESS)
+      {
+      /* request is still being processed */
+
+      /* increase tcp_timeout in qmgr? */
+
+      sjs->sjs_timeout = TRUE;
+
+      /* do we need a continue here? */
+
+      sprintf(log_buf, "child commit request timed-out for job %s, increase tcp_timeout?",
+        job_id);
+
+      log_ext(errno2, __func__, log_buf, LOG_WARNING);
+
+      /* don't retry on timeout--break out and report error! */
+      sjs->sjs_rc = LOCUTION_FAIL;
+      }
+    else
+      {
+      sprintf(log_buf, "child failed in commit request for job %s", job_id);
+
+      log_ext(errno2, __func__, log_buf, LOG_CRIT);
+
+      /* FAILURE */
+      sjs->sjs_rc = LOCUTION_FAIL;
+      }
+
+    return(SEND_JOB_STOP);
+    } /* END if ((rc = PBSD_commit(con,job_id)) != 0) */
+  else if (sid != -1)
+    {
+    /* save the sid */
+    if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
+      {
+      pjob->ji_wattr[JOB_ATR_session_id].at_val.at_long = sid;
+      pjob->ji_wattr[JOB_ATR_session_id].at_flags |= ATR_VFLAG_SET;
+      unlock_ji_mutex(pjob, __func__, "3", LOGLEVEL);
+      }
+    else
+      {
+      sjs->sjs_rc = LOCUTION_FAIL;
+
+      return(SEND_JOB_STOP);
+      }
+    }
+
+  /* SUCCESS */
+  sjs->sjs_rc = PBSE_NONE;  /* Equivalent value to LOCUTION_SUCCESS */
+
+  return(SEND_JOB_DONE);
+  }  /* END send_job_exchange() */
+
+
+
+
+/*
+ * send_job_attempt - connect to the receiving server or MOM and send the job
+ *
+ * Job starts reuse pooled connections to the MOM, and a connection goes
+ * back to the pool only after a successful transfer.
+ */
+
+static enum send_job_step send_job_attempt(
+
+  send_job_state *sjs)  /* M */
+
+  {
+  char                log_buf[LOCAL_LOG_BUF_SIZE];
+  int                 con;
+  int                 reused = FALSE;
+  enum send_job_step  step;
+
+  if (sjs->sjs_type == MOVE_TYPE_Exec)
+    {
+    con = svr_connect_pooled(sjs->sjs_momaddr, sjs->sjs_momport, &sjs->sjs_my_err,
+            (sjs->sjs_fresh_conn == FALSE), &reused);
+    }
+  else
+    {
+    con = svr_connect(sjs->sjs_momaddr, sjs->sjs_momport, &sjs->sjs_my_err, NULL, NULL, ToServerDIS);
+    }
+
+  sjs->sjs_fresh_conn = FALSE;
+
+  if (con == PBS_NET_RC_FATAL)
+    {
+    sprintf(log_buf, "send_job failed to host %s, %lx port %d",
+      (sjs->sjs_destin[0] != '\0') ? sjs->sjs_destin : "unknown host",
+      sjs->sjs_momaddr,
+      sjs->sjs_momport);
+
+    log_err(sjs->sjs_my_err, __func__, log_buf);
+
+    return(SEND_JOB_DONE);
+    }
+
+  if (con == PBS_NET_RC_RETRY)
+    {
+    sjs->sjs_my_err = 0; /* should retry */
+
+    return(SEND_JOB_AGAIN);
+    }
+
+  if (con == PBS_LOCAL_CONNECTION)
+    {
+    log_err(-1, __func__, "attempting to run the job on pbs_server???");
+
+    return(SEND_JOB_DONE);
+    }
+
+  step = send_job_exchange(sjs, con, reused);
+
+  if ((step == SEND_JOB_DONE) &&
+      (sjs->sjs_rc == PBSE_NONE) &&
+      (sjs->sjs_type == MOVE_TYPE_Exec))
+    svr_disconnect_pooled(con);
+  else
+    svr_disconnect(con);
+
+  return(step);
+  }  /* END send_job_attempt() */
+
+
+
+
+/*
+ * send_job_deferred_exec - what send_job_to_mom() does after a job start
+ * for a start that was finished by send_job_retry_task()
+ */
+
+static void send_job_deferred_exec(
+
+  char *job_id,     /* I */
+  int   rc,         /* I */
+  char *mail_text)  /* I (optional) */
+
+  {
+  job *pjob;
+
+  if ((pjob = svr_find_job(job_id, TRUE)) == NULL)
+    return;
+
+  if (rc == PBSE_NONE)
+    {
+    svr_mailowner(pjob, MAIL_BEGIN, MAIL_NORMAL, mail_text);
+    }
+  else if (pjob->ji_qs.ji_state != JOB_STATE_RUNNING)
+    {
+    pjob->ji_qs.ji_destin[0] = '\0';
+    }
+
+  unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+  }  /* END send_job_deferred_exec() */
+
+
+
+
+static void send_job_retry_task(struct work_task *);
+
+/*
+ * send_job_attempts - send a job, retrying after transient failures
+ *
+ * With defer set a retry is left to a timed task so no thread sleeps
+ * through the backoff, and LOCUTION_RETRY is returned.  Otherwise (and if
+ * the task cannot be created) the calling thread waits and retries itself.
+ * Either way, once the send is finished finish_move_process() reports the
+ * outcome and sjs is freed.
+ */
+
+static int send_job_attempts(
+
+  send_job_state *sjs,    /* I (freed unless LOCUTION_RETRY is returned) */
+  int             defer,  /* I */
+  int            *my_err) /* O (optional) */
+
+  {
+  char                log_buf[LOCAL_LOG_BUF_SIZE];
+  char               *job_id = sjs->sjs_jobid;
+  char               *mail_text = NULL;
+  enum send_job_step  step;
+  int                 rc;
+
+  while (TRUE)
+    {
+    step = send_job_attempt(sjs);
+
+    if (step == SEND_JOB_RECONNECT)
+      continue;
+
+    if (step != SEND_JOB_AGAIN)
+      break;
+
+    if (++sjs->sjs_attempts >= RETRY)
+      {
+      step = SEND_JOB_STOP;
+      break;
+      }
+
+    /* check my_err from previous attempt */
+    if (should_retry_route(sjs->sjs_my_err) == -1)
+      {
+      sprintf(log_buf, "child failed in previous commit request for job %s", job_id);
+
+      log_err(sjs->sjs_my_err, __func__, log_buf);
+
+      sjs->sjs_rc = LOCUTION_FAIL;
+      step = SEND_JOB_DONE;
+      break;
+      }
+
+    /* recycle after an error */
+    if ((defer == TRUE) &&
+        (set_task(WORK_Timed, time(NULL) + (1 << sjs->sjs_attempts), send_job_retry_task, sjs, FALSE) != NULL))
+      {
+      if (my_err != NULL)
+        *my_err = sjs->sjs_my_err;
+
+      return(LOCUTION_RETRY);
+      }
+
+    sleep(1 << sjs->sjs_attempts);
+    }  /* END while (TRUE) */
+
+  if (step == SEND_JOB_STOP)
+    {
+    if (sjs->sjs_timeout == TRUE)
+      {
+      /* 10 indicates that job migrate timed out, server will mark node down *
+            and abort the job - see post_sendmom() */
+      sprintf(log_buf, "child timed-out attempting to start job %s", job_id);
+      log_ext(sjs->sjs_my_err, __func__, log_buf, LOG_WARNING);
+      sjs->sjs_rc = LOCUTION_REQUEUE;
+      }
+    else if (should_retry_route(sjs->sjs_my_err) == -1)
+      {
+      sprintf(log_buf, "child failed and will not retry job %s", job_id);
+      log_err(sjs->sjs_my_err, __func__, log_buf);
+      sjs->sjs_rc = LOCUTION_FAIL;
+      }
+    else
+      sjs->sjs_rc = LOCUTION_REQUEUE;
+    }
+
+  rc = sjs->sjs_rc;
+
+  if (my_err != NULL)
+    *my_err = sjs->sjs_my_err;
+
+  /* finish_move_process() answers and frees the request */
+  if ((sjs->sjs_deferred == TRUE) &&
+      (sjs->sjs_type == MOVE_TYPE_Exec) &&
+      (sjs->sjs_preq != NULL) &&
+      (sjs->sjs_preq->rq_reply.brp_un.brp_txt.brp_str != NULL))
+    mail_text = strdup(sjs->sjs_preq->rq_reply.brp_un.brp_txt.brp_str);
+
+  finish_move_process(job_id, sjs->sjs_preq, sjs->sjs_start_time, sjs->sjs_node_name, rc, sjs->sjs_type, sjs->sjs_mom_err);
+
+  if ((sjs->sjs_deferred == TRUE) &&
+      (sjs->sjs_type == MOVE_TYPE_Exec))
+    send_job_deferred_exec(job_id, rc, mail_text);
+
+  if (mail_text != NULL)
+    free(mail_text);
+
+  free_send_job_state(sjs);
+
+  return(rc);
+  }  /* END send_job_attempts() */
+
+
+
+
+/*
+ * send_job_retry_task - the next attempt at a send that failed earlier
+ */
+
+static void send_job_retry_task(
+
+  struct work_task *ptask)  /* I (freed) */
+
+  {
+  send_job_state *sjs = (send_job_state *)ptask->wt_parm1;
+  long            job_timeout = 0;
+  long            tcp_timeout = 0;
+
+  free(ptask->wt_mutex);
+  free(ptask);
+
+  sjs->sjs_deferred = TRUE;
+
+  /* same as send_job_to_mom() */
+  if (sjs->sjs_type == MOVE_TYPE_Exec)
+    {
+    get_svr_attr_l(SRV_ATR_tcp_timeout, &tcp_timeout);
+    get_svr_attr_l(SRV_ATR_JobStartTimeout, &job_timeout);
+
+    if (job_timeout > 0)
+      DIS_tcp_settimeout(job_timeout);
+    }
+
+  send_job_attempts(sjs, TRUE, NULL);
+
+  if (job_timeout > 0)
+    DIS_tcp_settimeout(tcp_timeout);
+  }  /* END send_job_retry_task() */
+
+
+
+
+/*
+ * send_job_work - transfer a job to another server or to its MOM
+ *
+ * The job's attributes are encoded once and the transfer is handed to
+ * send_job_attempts().  With defer_retry set, a failed attempt is retried
+ * from a timed task and LOCUTION_RETRY is returned; the outcome is then
+ * reported by finish_move_process() when the send finishes.
+ */
+
 int send_job_work(
 
   char                  *job_id,
-  char                  *node_name, /* I */
-  int                    type,      /* I */
-  int                   *my_err,    /* O */
-  struct batch_request  *preq)      /* M */
+  char                  *node_name,   /* I */
+  int                    type,        /* I */
+  int                   *my_err,      /* O */
+  struct batch_request  *preq,        /* M */
+  int                    defer_retry) /* I */
 
   {
-  int                   rc = LOCUTION_FAIL;
   int                   ret = PBSE_NONE;
   int                   local_errno = 0;
-  tlist_head            attrl;
-  enum conn_type        cntype = ToServerDIS;
-  int                   con = PBS_NET_RC_UNSET;
   int                   encode_type;
-  int                   mom_err = PBSE_NONE;
   int                   i;
-  int                   NumRetries;
   int                   resc_access_perm;
-  char                  script_name[MAXPATHLEN + 1];
+  int                   rc;
   char                 *pc;
-  char                  stdout_path[MAXPATHLEN + 1];
-  char                  stderr_path[MAXPATHLEN + 1];
-  char                  chkpt_path[MAXPATHLEN + 1];
-  char                  log_buf[LOCAL_LOG_BUF_SIZE];
-  long                  start_time = time(NULL);
-  long                  sid;
-  unsigned char         attempt_to_queue_job = FALSE;
-  unsigned char         change_substate_on_attempt_to_queue = FALSE;
-  unsigned char         has_job_script = FALSE;
-  unsigned char         job_has_run = FALSE;
   job                  *pjob = NULL;
-  char                  job_destin[PBS_MAXROUTEDEST+1];
-
-  struct attropl       *pqjatr;      /* list (single) of attropl for quejob */
+  send_job_state       *sjs;
   pbs_attribute        *pattr;
-  mbool_t               Timeout = FALSE;
-  
-  unsigned long         job_momaddr = -1;
-  unsigned short        job_momport = -1;
 
   if ((pjob = svr_find_job(job_id, TRUE)) == NULL)
     {
@@ -701,32 +1494,49 @@ int send_job_work(
     return(PBSE_JOBNOTFOUND);
     }
 
+  if ((sjs = calloc(1, sizeof(send_job_state))) == NULL)
+    {
+    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+    *my_err = PBSE_SYSTEM;
+    finish_move_process(job_id, preq, time(NULL), node_name, LOCUTION_FAIL, type, PBSE_NONE);
+    return(LOCUTION_FAIL);
+    }
+
+  snprintf(sjs->sjs_jobid, sizeof(sjs->sjs_jobid), "%s", job_id);
+  job_id = sjs->sjs_jobid;
+
+  if (node_name != NULL)
+    sjs->sjs_node_name = strdup(node_name);
+
+  sjs->sjs_type = type;
+  sjs->sjs_preq = preq;
+  sjs->sjs_start_time = time(NULL);
+  sjs->sjs_rc = LOCUTION_FAIL;
+
   if (strlen(pjob->ji_qs.ji_destin) != 0)
-    strcpy(job_destin, pjob->ji_qs.ji_destin);
-  else
-    job_destin[0] = '\0';
+    strcpy(sjs->sjs_destin, pjob->ji_qs.ji_destin);
 
-  job_momaddr = pjob->ji_qs.ji_un.ji_exect.ji_momaddr;
-  job_momport = pjob->ji_qs.ji_un.ji_exect.ji_momport;
+  sjs->sjs_momaddr = pjob->ji_qs.ji_un.ji_exect.ji_momaddr;
+  sjs->sjs_momport = pjob->ji_qs.ji_un.ji_exect.ji_momport;
 
   if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_SCRIPT)
-    has_job_script = TRUE;
+    sjs->sjs_has_script = TRUE;
 
   if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HASRUN)
-    job_has_run = TRUE;
+    sjs->sjs_has_run = TRUE;
 
-  if ((job_destin[0] != '\0') && 
+  if ((sjs->sjs_destin[0] != '\0') && 
       (type != MOVE_TYPE_Exec))
     {
-    if ((pc = strchr(job_destin, '@')) != NULL)
+    if ((pc = strchr(sjs->sjs_destin, '@')) != NULL)
       {
-      job_momaddr = get_hostaddr(&local_errno, pc + 1);
-      job_momport = pbs_server_port_dis;
+      sjs->sjs_momaddr = get_hostaddr(&local_errno, pc + 1);
+      sjs->sjs_momport = pbs_server_port_dis;
       }
     }
 
   /* encode job attributes to be moved */
-  CLEAR_HEAD(attrl);
+  CLEAR_HEAD(sjs->sjs_attrl);
 
   /* select attributes/resources to send based on move type */
   if (type == MOVE_TYPE_Exec)
@@ -735,7 +1545,6 @@ int send_job_work(
 
     resc_access_perm = ATR_DFLAG_MOM;
     encode_type = ATR_ENCODE_MOM;
-    cntype = ToServerDIS;
     }
   else
     {
@@ -749,10 +1558,13 @@ int send_job_work(
     encode_type = ATR_ENCODE_SVR;
 
     /* clear default resource settings */
-    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+    unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
     ret = svr_dequejob(job_id, FALSE);
     if (ret)
+      {
+      free_send_job_state(sjs);
       return(ret);
+      }
     }
 
   pattr = pjob->ji_wattr;
@@ -765,7 +1577,7 @@ int send_job_work(
       {
       (job_attr_def + i)->at_encode(
         pattr + i,
-        &attrl,
+        &sjs->sjs_attrl,
         (job_attr_def + i)->at_name,
         NULL,
         encode_type,
@@ -773,7 +1585,7 @@ int send_job_work(
       }
     }    /* END for (i) */
 
-  attrl_fixlink(&attrl);
+  attrl_fixlink(&sjs->sjs_attrl);
 
   /* put together the job script file name */
   if (pjob->ji_arraystructid[0] != '\0')
@@ -782,27 +1594,35 @@ int send_job_work(
 
     if (pa != NULL)
       {
-      snprintf(script_name, sizeof(script_name), "%s%s%s",
+      snprintf(sjs->sjs_script, sizeof(sjs->sjs_script), "%s%s%s",
         path_jobs, pa->ai_qs.fileprefix, JOB_SCRIPT_SUFFIX);
       unlock_ai_mutex(pa, __func__, NULL, LOGLEVEL);
       }
     else if (pjob == NULL)
+      {
+      free_send_job_state(sjs);
       return(PBSE_JOB_RECYCLED);
+      }
     }
   else
     {
-    snprintf(script_name, sizeof(script_name), "%s%s%s",
+    snprintf(sjs->sjs_script, sizeof(sjs->sjs_script), "%s%s%s",
       path_jobs, pjob->ji_qs.ji_fileprefix, JOB_SCRIPT_SUFFIX);
     }
   
-  if (job_has_run)
+  if (sjs->sjs_has_run)
     {
-    if ((get_job_file_path(pjob, StdOut, stdout_path, sizeof(stdout_path)) != 0) ||
-        (get_job_file_path(pjob ,StdErr, stderr_path, sizeof(stderr_path)) != 0) ||
-        (get_job_file_path(pjob, Checkpoint, chkpt_path, sizeof(chkpt_path)) != 0))
+    if ((get_job_file_path(pjob, StdOut, sjs->sjs_stdout, sizeof(sjs->sjs_stdout)) != 0) ||
+        (get_job_file_path(pjob ,StdErr, sjs->sjs_stderr, sizeof(sjs->sjs_stderr)) != 0) ||
+        (get_job_file_path(pjob, Checkpoint, sjs->sjs_chkpt, sizeof(sjs->sjs_chkpt)) != 0))
       {
-      unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
-      goto send_job_work_end;
+      unlock_ji_mutex(pjob, __func__, "3", LOGLEVEL);
+
+      rc = sjs->sjs_rc;
+      finish_move_process(job_id, preq, sjs->sjs_start_time, node_name, rc, type, PBSE_NONE);
+      free_send_job_state(sjs);
+
+      return(rc);
       }
     }
 
@@ -811,260 +1631,15 @@ int send_job_work(
    * to send the "ready-to-commit/commit" */
   if (pjob->ji_qs.ji_substate != JOB_SUBSTATE_TRNOUTCM)
     {
-    attempt_to_queue_job = TRUE;
+    sjs->sjs_queue_job = TRUE;
 
     if (pjob->ji_qs.ji_substate != JOB_SUBSTATE_TRNOUT)
-      change_substate_on_attempt_to_queue = TRUE;
+      sjs->sjs_set_trnout = TRUE;
     }
   
-  unlock_ji_mutex(pjob, __func__, "3", LOGLEVEL);
-
-  for (NumRetries = 0;NumRetries < RETRY;NumRetries++)
-    {
-    /* connect to receiving server with retries */
-    if (NumRetries > 0)
-      {
-      /* recycle after an error */
-      if (con >= 0)
-        {
-        svr_disconnect(con);
-        con = PBS_NET_RC_UNSET;
-        }
+  unlock_ji_mutex(pjob, __func__, "4", LOGLEVEL);
 
-      /* check my_err from previous attempt */
-      if (should_retry_route(*my_err) == -1)
-        {
-        sprintf(log_buf, "child failed in previous commit request for job %s", job_id);
-
-        log_err(*my_err, __func__, log_buf);
-        goto send_job_work_end;
-        }
-
-      sleep(1 << NumRetries);
-      }
-
-    if ((con = svr_connect(job_momaddr, job_momport, my_err, NULL, NULL, cntype)) == PBS_NET_RC_FATAL)
-      {
-      sprintf(log_buf, "send_job failed to host %s, %lx port %d",
-        (job_destin[0] != '\0') ? job_destin : "unknown host",
-        job_momaddr,
-        job_momport);
-
-      log_err(*my_err, __func__, log_buf);
-      goto send_job_work_end;
-      }
-
-    if (con == PBS_NET_RC_RETRY)
-      {
-      *my_err = 0; /* should retry */
-
-      continue;
-      }
-
-    if (con == PBS_LOCAL_CONNECTION)
-      {
-      log_err(-1, __func__, "attempting to run the job on pbs_server???");
-      return(PBSE_SYSTEM);
-      }
-
-    pthread_mutex_lock(connection[con].ch_mutex);
-    pthread_mutex_unlock(connection[con].ch_mutex);
-
-    if (attempt_to_queue_job == TRUE)
-      {
-      if (change_substate_on_attempt_to_queue == TRUE)
-        {
-        if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
-          {
-          pjob->ji_qs.ji_substate = JOB_SUBSTATE_TRNOUT;
-          job_save(pjob, SAVEJOB_QUICK, 0);
-          unlock_ji_mutex(pjob, __func__, "4", LOGLEVEL);
-          }
-        else
-          break;
-        }
-
-      pqjatr = &((svrattrl *)GET_NEXT(attrl))->al_atopl;
-
-      if ((pc = PBSD_queuejob(con, my_err, job_id, job_destin, pqjatr, NULL)) == NULL)
-        {
-        if (*my_err == PBSE_EXPIRED)
-          {
-          /* queue job timeout based on pbs_tcp_timeout */
-
-          Timeout = TRUE;
-          }
-
-        if ((*my_err == PBSE_JOBEXIST) && (type == MOVE_TYPE_Exec))
-          {
-          /* already running, mark it so */
-          log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_JOB, job_id,
-            "MOM reports job already running");
-          rc = PBSE_NONE; /* Equivalent to LOCUTION_SUCCESS */
-          break;
-          }
-
-        sprintf(log_buf, "send of job to %s failed error = %d",
-          (job_destin[0] != '\0') ? job_destin : "unknown host",
-          *my_err);
-
-        log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, job_id, log_buf);
-
-        continue;
-        }  /* END if ((pc = PBSD_queuejob() == NULL) */
-
-      free(pc);
-
-      if (has_job_script == TRUE)
-        {
-        if (PBSD_jscript(con, script_name, job_id) != 0)
-          continue;
-        }
-
-      /* XXX may need to change the logic below, if we are sending the job to
-         a mom on the same host and the mom and server are not sharing the same
-         spool directory, then we still need to move the file */
-
-      if ((type == MOVE_TYPE_Exec) &&
-          (job_has_run == TRUE) &&
-          (job_momaddr != pbs_server_addr))
-        {
-        /* send files created on prior run */
-        if ((PBSD_jobfile(con, PBS_BATCH_MvJobFile, stdout_path, job_id, StdOut) != PBSE_NONE) ||
-            (PBSD_jobfile(con, PBS_BATCH_MvJobFile, stderr_path, job_id, StdErr) != PBSE_NONE) ||
-            (PBSD_jobfile(con, PBS_BATCH_MvJobFile, chkpt_path, job_id, Checkpoint) != PBSE_NONE))
-          {
-          continue;
-          }
-        }
-
-      if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
-        {
-        pjob->ji_qs.ji_substate = JOB_SUBSTATE_TRNOUTCM;      
-        job_save(pjob, SAVEJOB_QUICK, 0);
-        unlock_ji_mutex(pjob, __func__, "5", LOGLEVEL);
-        }
-      else
-        break;
-
-      attempt_to_queue_job = FALSE;
-      }
-
-    if (PBSD_rdytocmt(con, job_id) != 0)
-      {
-      continue;
-      }
-
-    if ((mom_err = PBSD_commit_get_sid(con, &sid, job_id)) != PBSE_NONE)
-      {
-      int   errno2;
-      char *err_text;
-
-      pthread_mutex_lock(connection[con].ch_mutex);
-      err_text = connection[con].ch_errtxt;
-      pthread_mutex_unlock(connection[con].ch_mutex);
-
-      /* NOTE:  errno is modified by log_err */
-      if (mom_err > PBSE_FLOOR)
-        {
-        sprintf(log_buf, "send_job commit failed, rc=%d (%s: %s)",
-          mom_err, pbse_to_txt(mom_err), (err_text != NULL) ? err_text : "N/A");
-        errno2 = mom_err;
-        }
-      else
-        {
-        sprintf(log_buf, "send_job commit failed, rc=%d (%s)",
-          mom_err, (err_text != NULL) ? err_text : "N/A");
-        errno2 = errno;
-        }
-
-      log_ext(errno2, __func__, log_buf, LOG_WARNING);
-
-      /* if failure occurs, pbs_mom should purge job and pbs_server should set *
-         job state to idle w/error msg */
-
-      if (errno2 == EINPROGRESS)
-        {
-        /* request is still being processed */
-
-        /* increase tcp_timeout in qmgr? */
-
-        Timeout = TRUE;
-
-        /* do we need a continue here? */
-
-        sprintf(log_buf, "child commit request timed-out for job %s, increase tcp_timeout?",
-          job_id);
-
-        log_ext(errno2, __func__, log_buf, LOG_WARNING);
-
-        /* don't retry on timeout--break out and report error! */
-        rc = LOCUTION_FAIL;
-        break;
-        }
-      else
-        {
-        sprintf(log_buf, "child failed in commit request for job %s", job_id);
-
-        log_ext(errno2, __func__, log_buf, LOG_CRIT);
-
-        /* FAILURE */
-        rc = LOCUTION_FAIL;
-        break;
-        }
-      } /* END if ((rc = PBSD_commit(con,job_id)) != 0) */
-    else if (sid != -1)
-      {
-      /* save the sid */
-      if ((pjob = svr_find_job(job_id, TRUE)) != NULL)
-        {
-        pjob->ji_wattr[JOB_ATR_session_id].at_val.at_long = sid;
-        pjob->ji_wattr[JOB_ATR_session_id].at_flags |= ATR_VFLAG_SET;
-        unlock_ji_mutex(pjob, __func__, "6", LOGLEVEL);
-        }
-      else
-        {
-        rc = LOCUTION_FAIL;
-        break;
-        }
-      }
-
-    svr_disconnect(con);
-    con = PBS_NET_RC_UNSET;
-
-    /* SUCCESS */
-    rc = PBSE_NONE;  /* Equivalent value to LOCUTION_SUCCESS */
-    goto send_job_work_end;
-    }  /* END for (NumRetries) */
-        
-  if (con >= 0)
-    {
-    svr_disconnect(con);
-    }
-
-  if (Timeout == TRUE)
-    {
-    /* 10 indicates that job migrate timed out, server will mark node down *
-          and abort the job - see post_sendmom() */
-    sprintf(log_buf, "child timed-out attempting to start job %s", job_id);
-    log_ext(*my_err, __func__, log_buf, LOG_WARNING);
-    rc = LOCUTION_REQUEUE;
-    }
-  else if (should_retry_route(*my_err) == -1)
-    {
-    sprintf(log_buf, "child failed and will not retry job %s", job_id);
-    log_err(*my_err, __func__, log_buf);
-    rc = LOCUTION_FAIL;
-    }
-  else
-    rc = LOCUTION_REQUEUE;
-
-send_job_work_end:
-
-  finish_move_process(job_id, preq, start_time, node_name, rc, type, mom_err);
-  free_server_attrs(&attrl);
-
-  return(rc);
+  return(send_job_attempts(sjs, defer_retry, my_err));
   } /* END send_job_work() */
 
 
@@ -1123,7 +1698,7 @@ void *send_job(
       unlock_node(np, "send_job", NULL, LOGLEVEL);
       }
     
-    send_job_work(job_id,node_name,type,&local_errno,preq);
+    send_job_work(job_id, node_name, type, &local_errno, preq, TRUE);
     }
 
   free(vp);
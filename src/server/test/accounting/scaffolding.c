@@ -7,6 +7,7 @@
 #include "dynamic_string.h" /* dynamic_string */
 #include "pbs_job.h"
 #include "queue.h"
+#include "server.h" /* SRV_ATR_* */
 
 
 char path_acct[_POSIX_PATH_MAX];
@@ -59,8 +60,15 @@ pbs_queue *get_jobs_queue(job **pjob)
   return((*pjob)->ji_qhdr);
   }
 
+long acct_json_enabled = 0;
+
 int get_svr_attr_l(int index, long *l)
   {
+  if (index == SRV_ATR_AcctJson)
+    *l = acct_json_enabled;
+
   return(0);
   }
 
+
+void log_record(int eventtype, int objclass, const char *objname, char *text) {}
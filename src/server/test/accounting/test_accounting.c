@@ -3,18 +3,160 @@
 #include "test_accounting.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "pbs_error.h"
+#include "acct.h"
+
+extern pthread_mutex_t *acctfile_mutex;
+extern long             acct_json_enabled;
+
+
+/* open an accounting file in the current directory */
+
+static void open_test_acct(
+
+  char   *path,
+  size_t  size)
+
+  {
+  char cwd[MAXPATHLEN];
+
+  if (acctfile_mutex == NULL)
+    {
+    acctfile_mutex = calloc(1, sizeof(pthread_mutex_t));
+    pthread_mutex_init(acctfile_mutex, NULL);
+    }
+
+  fail_unless(getcwd(cwd, sizeof(cwd)) != NULL);
+  snprintf(path, size, "%s/acct_test_file", cwd);
+  unlink(path);
+
+  fail_unless(acct_open(path) == 0);
+  }
+
+
+static int read_file(
+
+  char *path,
+  char *buf,
+  int   size)
+
+  {
+  FILE *fp;
+  int   len;
+
+  if ((fp = fopen(path, "r")) == NULL)
+    return(-1);
+
+  len = fread(buf, 1, size - 1, fp);
+  buf[len] = '\0';
+  fclose(fp);
+
+  return(len);
+  }
+
+
 START_TEST(test_one)
   {
+  char path[MAXPATHLEN];
+  char buf[16384];
+  int  i;
+
+  acct_json_enabled = 0;
+  open_test_acct(path, sizeof(path));
+
+  for (i = 0; i < 100; i++)
+    account_record_id(PBS_ACCT_QUEUE, "1.napali", "queue=batch");
 
+  account_record_id(PBS_ACCT_DEL, "2.napali", NULL);
 
+  /* closing writes out everything queued, in order */
+  acct_close();
+
+  fail_unless(read_file(path, buf, sizeof(buf)) > 0);
+  fail_unless(strstr(buf, ";Q;1.napali;queue=batch\n") != NULL);
+  fail_unless(strstr(buf, ";Q;1.napali;queue=batch\n") < strstr(buf, ";D;2.napali;\n"));
+  fail_unless(strlen(strstr(buf, ";D;2.napali;\n")) == strlen(";D;2.napali;\n"));
+
+  unlink(path);
+
+  strcat(path, ".json");
+  fail_unless(access(path, F_OK) != 0);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  char  path[MAXPATHLEN];
+  char  jsonpath[MAXPATHLEN + 8];
+  char  buf[4096];
+  char *line;
+
+  acct_json_enabled = 1;
+  open_test_acct(path, sizeof(path));
+  snprintf(jsonpath, sizeof(jsonpath), "%s.json", path);
+  unlink(jsonpath);
+
+  account_record_id(PBS_ACCT_END, "3.napali", "user=bob jobname=say \"hi\" there Resource_List.nodes=2:ppn=4 exec_host=n1/0+n1/1 ");
+  account_record_id(PBS_ACCT_DEL, "4.napali", "requestor=root@napali");
+  account_record_id(PBS_ACCT_ABT, "5.napali", "Job aborted by server");
+
+  acct_flush();
+
+  fail_unless(read_file(jsonpath, buf, sizeof(buf)) > 0);
+
+  line = strstr(buf, "\"type\":\"E\",\"id\":\"3.napali\",\"user\":\"bob\",\"jobname\":\"say \\\"hi\\\" there\",\"Resource_List.nodes\":\"2:ppn=4\",\"exec_host\":\"n1/0+n1/1\"}\n");
+  fail_unless(line != NULL, buf);
+  fail_unless(strstr(buf, "\"id\":\"4.napali\",\"requestor\":\"root@napali\"}\n") != NULL);
+  fail_unless(strstr(buf, "\"id\":\"5.napali\",\"text\":\"Job aborted by server\"}\n") != NULL);
+  fail_unless(strncmp(buf, "{\"time\":", 8) == 0);
+
+  acct_close();
+
+  /* the classic file is unchanged */
+  fail_unless(read_file(path, buf, sizeof(buf)) > 0);
+  fail_unless(strstr(buf, ";E;3.napali;user=bob jobname=say \"hi\" there ") != NULL);
+
+  unlink(jsonpath);
+  unlink(path);
+  acct_json_enabled = 0;
+  }
+END_TEST
+
+/* records queued before each close/reopen (as on SIGHUP) all reach the file */
+START_TEST(test_reopen)
+  {
+  char  path[MAXPATHLEN];
+  char  buf[16384];
+  char *line;
+  int   i;
+  int   count = 0;
+
+  acct_json_enabled = 0;
+  open_test_acct(path, sizeof(path));
+
+  for (i = 0; i < 50; i++)
+    {
+    account_record_id(PBS_ACCT_QUEUE, "6.napali", "queue=batch");
+    account_record_id(PBS_ACCT_RUN, "6.napali", "user=bob");
+
+    acct_close();
 
+    fail_unless(acct_open(path) == 0);
+    }
 
+  acct_close();
+
+  fail_unless(read_file(path, buf, sizeof(buf)) > 0);
+
+  for (line = buf; (line = strstr(line, ";6.napali;")) != NULL; line++)
+    count++;
+
+  fail_unless(count == 100, "%d records", count);
+
+  unlink(path);
   }
 END_TEST
 
@@ -29,6 +171,10 @@ Suite *accounting_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_reopen");
+  tcase_add_test(tc_core, test_reopen);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -237,13 +237,30 @@ int is_svr_attr_set(int attr_index)
   return(0);
   }
 
+job       *found_job = NULL;
+job_array *purged_array = NULL;
+int        purge_count = 0;
+
 job *svr_find_job(char *name, int get_subjob)
   {
-  return(NULL);
+  return(found_job);
   }
 
 int svr_job_purge(job *pjob)
   {
+  purge_count++;
+
+  if (purged_array != NULL)
+    {
+    if (purged_array->ai_bulk_ops == 0)
+      {
+      fprintf(stderr, "a subjob was purged outside of the bulk operation\n");
+      exit(1);
+      }
+
+    purged_array->ai_qs.num_purged++;
+    }
+
   return(0);
   }
 
@@ -327,3 +344,14 @@ void *next_from_hash_map(
   return(NULL);
   }
 
+
+long attr_ifelse_long(pbs_attribute *attr1, pbs_attribute *attr2, long deflong)
+  {
+  return(deflong);
+  }
+
+int relay_to_mom(job **pjob_ptr, struct batch_request *request, void (*func)())
+  {
+  fprintf(stderr, "The call to relay_to_mom needs to be mocked!!\n");
+  exit(1);
+  }
@@ -4,12 +4,21 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "pbs_error.h"
+#include "queue.h"
+#include "server.h"
+#include <string.h>
+#include <pthread.h>
 
 int is_num(const char *);
 int array_request_token_count(const char *);
 int array_request_parse_token(char *, int *, int *);
 int num_array_jobs(const char *str);
 
+extern job       *found_job;
+extern job_array *purged_array;
+extern int        purge_count;
+extern struct server server;
+
 
 START_TEST(set_slot_limit_test)
   {
@@ -139,6 +148,50 @@ END_TEST
 
 
 
+START_TEST(delete_whole_array_test)
+  {
+  job_array  pa;
+  job        pjob;
+  pbs_queue  pque;
+  int        rc;
+  char       buf[4096];
+
+  memset(&pa, 0, sizeof(pa));
+  memset(&pjob, 0, sizeof(pjob));
+  memset(&pque, 0, sizeof(pque));
+
+  server.sv_attr_mutex = calloc(1, sizeof(pthread_mutex_t));
+  pa.ai_mutex = calloc(1, sizeof(pthread_mutex_t));
+  pa.job_ids = calloc(3, sizeof(char *));
+  pa.job_ids[0] = strdup("0");
+  pa.job_ids[1] = strdup("1");
+  pa.job_ids[2] = strdup("2");
+  pa.ai_qs.array_size = 3;
+  pa.ai_qs.num_jobs = 3;
+
+  /* queued subjobs are purged in place, no work task per subjob */
+  pjob.ji_qs.ji_state = JOB_STATE_QUEUED;
+  pjob.ji_qs.ji_substate = JOB_SUBSTATE_QUEUED;
+  pjob.ji_qhdr = &pque;
+
+  found_job = &pjob;
+  purged_array = &pa;
+  purge_count = 0;
+
+  rc = delete_whole_array(&pa);
+  snprintf(buf, sizeof(buf), "expected NO_JOBS_IN_ARRAY but got %d", rc);
+  fail_unless(rc == NO_JOBS_IN_ARRAY, buf);
+  fail_unless(purge_count == 3, "all three subjobs should be purged");
+  fail_unless(pa.ai_bulk_ops == 0, "bulk operation left open");
+
+  found_job = NULL;
+  purged_array = NULL;
+  }
+END_TEST
+
+
+
+
 Suite *array_func_suite(void)
   {
   Suite *s = suite_create("array_func_suite methods");
@@ -164,6 +217,7 @@ Suite *array_func_suite(void)
 
   tc_core = tcase_create("first_job_index_test");
   tcase_add_test(tc_core, first_job_index_test);
+  tcase_add_test(tc_core, delete_whole_array_test);
   suite_add_tcase(s, tc_core);
 
   return s;
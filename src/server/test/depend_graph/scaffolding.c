@@ -0,0 +1,87 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hash_map.h"
+#include "list_link.h"
+#include "pbs_error.h"
+
+/* a list stands in for the hash map, the tests hold a handful of jobs */
+typedef struct stub_entry
+  {
+  char              *key;
+  void              *obj;
+  struct stub_entry *next;
+  } stub_entry;
+
+hash_map *get_hash_map(int size)
+  {
+  return((hash_map *)calloc(1, sizeof(hash_map)));
+  }
+
+int add_to_hash_map(hash_map *hm, void *obj, char *key)
+  {
+  stub_entry *pe = (stub_entry *)calloc(1, sizeof(stub_entry));
+
+  pe->key = key;
+  pe->obj = obj;
+  pe->next = (stub_entry *)hm->hm_ra;
+  hm->hm_ra = (resizable_array *)pe;
+
+  return(PBSE_NONE);
+  }
+
+void *get_from_hash_map(hash_map *hm, char *key)
+  {
+  stub_entry *pe;
+
+  for (pe = (stub_entry *)hm->hm_ra; pe != NULL; pe = pe->next)
+    {
+    if (!strcmp(pe->key, key))
+      return(pe->obj);
+    }
+
+  return(NULL);
+  }
+
+int remove_from_hash_map(hash_map *hm, char *key)
+  {
+  stub_entry **prev;
+  stub_entry  *pe;
+
+  for (prev = (stub_entry **)&hm->hm_ra; (pe = *prev) != NULL; prev = &pe->next)
+    {
+    if (!strcmp(pe->key, key))
+      {
+      *prev = pe->next;
+      free(pe);
+
+      return(PBSE_NONE);
+      }
+    }
+
+  return(KEY_NOT_FOUND);
+  }
+
+void append_link(tlist_head *head, list_link *new_link, void *pobj)
+  {
+  new_link->ll_struct = pobj;
+  new_link->ll_prior = head->ll_prior;
+  new_link->ll_next = head;
+  head->ll_prior = new_link;
+  new_link->ll_prior->ll_next = new_link;
+  }
+
+void delete_link(list_link *old)
+  {
+  old->ll_prior->ll_next = old->ll_next;
+  old->ll_next->ll_prior = old->ll_prior;
+  old->ll_next = old;
+  old->ll_prior = old;
+  }
+
+void *get_next(list_link pl, char *file, int line)
+  {
+  return(pl.ll_next->ll_struct);
+  }
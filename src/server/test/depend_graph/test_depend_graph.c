@@ -0,0 +1,149 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <check.h>
+
+#include "depend_graph.h"
+#include "pbs_job.h"
+#include "pbs_error.h"
+
+
+START_TEST(depend_graph_edges_test)
+  {
+  depend_edge *edges;
+  int          count;
+
+  fail_unless(depend_graph_dependents("1.napali", &edges) == 0, "empty graph has dependents");
+  fail_unless(edges == NULL);
+
+  fail_unless(depend_graph_add("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK) == PBSE_NONE);
+  fail_unless(depend_graph_add("1.napali", "3.napali", JOB_DEPEND_TYPE_AFTERANY) == PBSE_NONE);
+
+  /* registering again does not add a second edge */
+  fail_unless(depend_graph_add("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK) == PBSE_NONE);
+
+  /* before* and afterstart dependencies are not indexed */
+  fail_unless(depend_graph_add("1.napali", "4.napali", JOB_DEPEND_TYPE_BEFOREOK) == PBSE_NONE);
+  fail_unless(depend_graph_add("1.napali", "5.napali", JOB_DEPEND_TYPE_AFTERSTART) == PBSE_NONE);
+
+  count = depend_graph_dependents("1.napali", &edges);
+  fail_unless(count == 2, "expected 2 dependents, got %d", count);
+  fail_unless(!strcmp(edges[0].de_jobid, "3.napali"));
+  fail_unless(edges[0].de_type == JOB_DEPEND_TYPE_AFTERANY);
+  fail_unless(!strcmp(edges[1].de_jobid, "2.napali"));
+  fail_unless(edges[1].de_type == JOB_DEPEND_TYPE_AFTEROK);
+  free(edges);
+
+  fail_unless(depend_graph_has_edge("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK) == TRUE);
+  fail_unless(depend_graph_has_edge("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTERANY) == FALSE);
+  fail_unless(depend_graph_has_edge("2.napali", "1.napali", JOB_DEPEND_TYPE_AFTEROK) == FALSE);
+
+  depend_graph_remove("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK);
+  fail_unless(depend_graph_has_edge("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK) == FALSE);
+
+  count = depend_graph_dependents("1.napali", &edges);
+  fail_unless(count == 1, "expected 1 dependent, got %d", count);
+  free(edges);
+
+  /* purging the dependent drops its reverse edge from the prerequisite */
+  depend_graph_remove_job("3.napali");
+  fail_unless(depend_graph_dependents("1.napali", &edges) == 0);
+  }
+END_TEST
+
+
+
+
+START_TEST(depend_graph_index_job_test)
+  {
+  pbs_attribute      attr;
+  struct depend      dep_ok;
+  struct depend      dep_on;
+  struct depend_job  job_a;
+  struct depend_job  job_b;
+  depend_edge       *edges;
+  int                count;
+
+  memset(&attr, 0, sizeof(attr));
+  memset(&dep_ok, 0, sizeof(dep_ok));
+  memset(&dep_on, 0, sizeof(dep_on));
+  memset(&job_a, 0, sizeof(job_a));
+  memset(&job_b, 0, sizeof(job_b));
+
+  CLEAR_HEAD(attr.at_val.at_list);
+  CLEAR_LINK(dep_ok.dp_link);
+  CLEAR_HEAD(dep_ok.dp_jobs);
+  CLEAR_LINK(dep_on.dp_link);
+  CLEAR_HEAD(dep_on.dp_jobs);
+  CLEAR_LINK(job_a.dc_link);
+  CLEAR_LINK(job_b.dc_link);
+
+  dep_on.dp_type = JOB_DEPEND_TYPE_ON;
+  dep_on.dp_numexp = 1;
+  dep_ok.dp_type = JOB_DEPEND_TYPE_AFTEROK;
+  strcpy(job_a.dc_child, "10.napali");
+  strcpy(job_b.dc_child, "11.napali");
+
+  append_link(&attr.at_val.at_list, &dep_on.dp_link, &dep_on);
+  append_link(&attr.at_val.at_list, &dep_ok.dp_link, &dep_ok);
+  append_link(&dep_ok.dp_jobs, &job_a.dc_link, &job_a);
+  append_link(&dep_ok.dp_jobs, &job_b.dc_link, &job_b);
+  attr.at_flags = ATR_VFLAG_SET;
+
+  depend_graph_index_job("12.napali", &attr);
+
+  fail_unless(depend_graph_has_edge("10.napali", "12.napali", JOB_DEPEND_TYPE_AFTEROK) == TRUE);
+  fail_unless(depend_graph_has_edge("11.napali", "12.napali", JOB_DEPEND_TYPE_AFTEROK) == TRUE);
+
+  /* an alter that drops 10 replaces the old prerequisites */
+  delete_link(&job_a.dc_link);
+  depend_graph_index_job("12.napali", &attr);
+
+  fail_unless(depend_graph_has_edge("10.napali", "12.napali", JOB_DEPEND_TYPE_AFTEROK) == FALSE);
+  fail_unless(depend_graph_dependents("10.napali", &edges) == 0);
+
+  count = depend_graph_dependents("11.napali", &edges);
+  fail_unless(count == 1, "expected 1 dependent, got %d", count);
+  fail_unless(!strcmp(edges[0].de_jobid, "12.napali"));
+  free(edges);
+
+  /* purging the prerequisite drops the dependent's reverse edge */
+  depend_graph_remove_job("11.napali");
+  fail_unless(depend_graph_has_edge("11.napali", "12.napali", JOB_DEPEND_TYPE_AFTEROK) == FALSE);
+  }
+END_TEST
+
+
+
+
+Suite *depend_graph_suite(void)
+  {
+  Suite *s = suite_create("depend_graph test suite methods");
+  TCase *tc_core = tcase_create("depend_graph_edges_test");
+  tcase_add_test(tc_core, depend_graph_edges_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("depend_graph_index_job_test");
+  tcase_add_test(tc_core, depend_graph_index_job_test);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(depend_graph_suite());
+  srunner_set_log(sr, "depend_graph_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -157,3 +157,15 @@ int decode_DIS_ShutDown(struct tcp_chan *chan, struct batch_request *preq)
   fprintf(stderr, "The call to decode_DIS_ShutDown needs to be mocked!!\n");
   exit(1);
   }
+
+int decode_DIS_SubmitJob(struct tcp_chan *chan, struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to decode_DIS_SubmitJob needs to be mocked!!\n");
+  exit(1);
+  }
+
+int decode_DIS_WatchJobs(struct tcp_chan *chan, struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to decode_DIS_WatchJobs needs to be mocked!!\n");
+  exit(1);
+  }
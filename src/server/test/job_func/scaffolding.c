@@ -15,6 +15,7 @@
 #include "work_task.h" /* all_tasks */
 #include "array.h" /* ArrayEventsEnum */
 #include "dynamic_string.h" /* dynamic_string */
+#include "../../../lib/Liblog/job_history.h" /* jh_buf */
 
 /* This section is for manipulting function return values */
 #include "test_job_func.h" /* *_SUITE */
@@ -305,6 +306,21 @@ int insert_into_recycler(job *pjob)
   exit(1);
   }
 
+job *job_slab_alloc(void)
+  {
+  job *pjob = calloc(1, sizeof(job));
+
+  pjob->ji_mutex = calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(pjob->ji_mutex, NULL);
+
+  return(pjob);
+  }
+
+void job_slab_free(job *pjob)
+  {
+  free(pjob);
+  }
+
 int attr_to_str(struct dynamic_string *ds, attribute_def *attr_def,struct pbs_attribute attr,int XML)
   {
   int rc = 0;
@@ -691,3 +707,36 @@ int get_jobs_index(struct all_jobs *aj, job             *pjob)
   return(0);
   }
   
+
+void notify_job_watchers(job *pjob, int code) {}
+void depend_graph_remove_job(char *job_id) {}
+
+int size_to_dynamic_string(dynamic_string *ds, struct size_value *szv)
+  {
+  fprintf(stderr, "The call to size_to_dynamic_string needs to be mocked!!\n");
+  exit(1);
+  }
+
+int jh_record_start(jh_buf *jb, char *jobid, char *user, time_t qtime, time_t start, time_t end, int exit_status)
+  {
+  fprintf(stderr, "The call to jh_record_start needs to be mocked!!\n");
+  exit(1);
+  }
+
+int jh_record_attr(jh_buf *jb, const char *name, const char *resc, const char *value)
+  {
+  fprintf(stderr, "The call to jh_record_attr needs to be mocked!!\n");
+  exit(1);
+  }
+
+int jh_write_record(jh_buf *jb, char *directory)
+  {
+  fprintf(stderr, "The call to jh_write_record needs to be mocked!!\n");
+  exit(1);
+  }
+
+void jh_buf_free(jh_buf *jb)
+  {
+  fprintf(stderr, "The call to jh_buf_free needs to be mocked!!\n");
+  exit(1);
+  }
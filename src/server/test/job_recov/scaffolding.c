@@ -75,6 +75,12 @@ job *job_alloc(void)
   exit(1);
   }
 
+void job_slab_free(job *pjob)
+  {
+  fprintf(stderr, "The call to job_slab_free needs to be mocked!!\n");
+  exit(1);
+  }
+
 int save_struct(char *pobj, unsigned int objsize, int fds, char *buf_ptr, size_t *space_remaining, size_t buf_size)
   {
   fprintf(stderr, "The call to save_struct needs to be mocked!!\n");
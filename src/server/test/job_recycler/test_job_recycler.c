@@ -3,18 +3,74 @@
 #include "test_job_recycler.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "pbs_error.h"
+
+#define TEST_JOBS (JOB_SLAB_JOBS * 2 + 1)
+
 START_TEST(test_one)
   {
+  job *jobs[TEST_JOBS];
+  job *pjob;
+  int  i;
+  int  j;
+
+  for (i = 0; i < TEST_JOBS; i++)
+    {
+    jobs[i] = job_slab_alloc();
+
+    fail_unless(jobs[i] != NULL);
+    fail_unless(jobs[i]->ji_mutex != NULL);
+    fail_unless(jobs[i]->ji_qs.ji_jobid[0] == '\0');
+    fail_unless(pthread_mutex_trylock(jobs[i]->ji_mutex) == 0);
+    pthread_mutex_unlock(jobs[i]->ji_mutex);
+
+    for (j = 0; j < i; j++)
+      {
+      fail_unless(jobs[i] != jobs[j]);
+      fail_unless(jobs[i]->ji_mutex != jobs[j]->ji_mutex);
+      }
 
+    strcpy(jobs[i]->ji_qs.ji_jobid, "1.host");
+    }
 
+  /* a freed job's space is handed out again, cleared */
+  job_slab_free(jobs[3]);
+  pjob = job_slab_alloc();
+  fail_unless(pjob == jobs[3]);
+  fail_unless(pjob->ji_qs.ji_jobid[0] == '\0');
+  fail_unless(pjob->ji_mutex != NULL);
+
+  for (i = 0; i < TEST_JOBS; i++)
+    job_slab_free(jobs[i]);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  job *jobs[TEST_JOBS];
+  job *pjob;
+  int  i;
+
+  /* emptying every slab and filling them again works */
+  for (i = 0; i < TEST_JOBS; i++)
+    jobs[i] = job_slab_alloc();
+
+  for (i = TEST_JOBS - 1; i >= 0; i--)
+    job_slab_free(jobs[i]);
+
+  for (i = 0; i < TEST_JOBS; i++)
+    {
+    jobs[i] = job_slab_alloc();
+    fail_unless(jobs[i] != NULL);
+    }
 
+  for (i = 0; i < TEST_JOBS; i++)
+    job_slab_free(jobs[i]);
 
+  pjob = job_slab_alloc();
+  fail_unless(pjob != NULL);
+  job_slab_free(pjob);
   }
 END_TEST
 
@@ -0,0 +1,204 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <check.h>
+
+#include "job_watch.h"
+#include "pbs_error.h"
+#include "net_connect.h"
+
+extern int              events_sent;
+extern int              acks_sent;
+extern volatile int     closed_sock;
+extern struct connection svr_conn[];
+extern attribute_def     job_attr_def[];
+
+int encode_stub(pbs_attribute *pattr, tlist_head *phead, char *aname, char *rsname, int mode, int perm);
+
+static pthread_mutex_t  conn_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static struct batch_request *watch_request(
+
+  int   sock,
+  char *id1,
+  char *id2)
+
+  {
+  struct batch_request *preq = (struct batch_request *)calloc(1, sizeof(struct batch_request));
+
+  job_attr_def[JOB_ATR_state].at_encode = encode_stub;
+  job_attr_def[JOB_ATR_exitstat].at_encode = encode_stub;
+
+  preq->rq_type = PBS_BATCH_WatchJobs;
+  preq->rq_conn = sock;
+  preq->rq_ind.rq_watchjobs.rq_count = 2;
+  preq->rq_ind.rq_watchjobs.rq_jobids = (char **)calloc(3, sizeof(char *));
+  preq->rq_ind.rq_watchjobs.rq_jobids[0] = strdup(id1);
+  preq->rq_ind.rq_watchjobs.rq_jobids[1] = strdup(id2);
+
+  return(preq);
+  }
+
+
+START_TEST(req_watchjobs_test)
+  {
+  svr_conn[3].cn_mutex = &conn_mutex;
+  events_sent = 0;
+  acks_sent = 0;
+
+  /* 1.napali exists, 2.napali does not: one ack, then one event each */
+  fail_unless(req_watchjobs(watch_request(3, "1.napali", "2.napali")) == PBSE_NONE);
+  fail_unless(acks_sent == 1);
+  fail_unless(events_sent == 2);
+  fail_unless((svr_conn[3].cn_authen & PBS_NET_CONN_NOTIMEOUT) != 0);
+
+  remove_job_watchers(3);
+  }
+END_TEST
+
+
+START_TEST(notify_job_watchers_test)
+  {
+  job pjob;
+
+  memset(&pjob, 0, sizeof(pjob));
+  strcpy(pjob.ji_qs.ji_jobid, "1.napali");
+
+  svr_conn[3].cn_mutex = &conn_mutex;
+  req_watchjobs(watch_request(3, "1.napali", "2.napali"));
+
+  /* a state change reaches the watcher */
+  events_sent = 0;
+  notify_job_watchers(&pjob, PBSE_NONE);
+  fail_unless(events_sent == 1);
+
+  /* the purge event is the last one */
+  notify_job_watchers(&pjob, PBSE_UNKJOBID);
+  fail_unless(events_sent == 2);
+  notify_job_watchers(&pjob, PBSE_NONE);
+  fail_unless(events_sent == 2);
+
+  /* nothing is sent once the connection is gone */
+  req_watchjobs(watch_request(3, "1.napali", "2.napali"));
+  remove_job_watchers(3);
+  events_sent = 0;
+  notify_job_watchers(&pjob, PBSE_NONE);
+  fail_unless(events_sent == 0);
+  }
+END_TEST
+
+
+/* read len bytes from sock, waiting up to 5 seconds */
+static int read_events(
+
+  int   sock,
+  char *buf,
+  int   len)
+
+  {
+  struct pollfd pfd;
+  int           got = 0;
+  int           ct;
+
+  pfd.fd = sock;
+  pfd.events = POLLIN;
+
+  while ((got < len) &&
+         (poll(&pfd, 1, 5000) > 0) &&
+         ((ct = read(sock, buf + got, len - got)) > 0))
+    got += ct;
+
+  buf[got] = '\0';
+
+  return(got);
+  }
+
+
+START_TEST(job_watch_thread_test)
+  {
+  job  pjob;
+  int  socks[2];
+  int  i;
+  char buf[64];
+
+  memset(&pjob, 0, sizeof(pjob));
+  strcpy(pjob.ji_qs.ji_jobid, "1.napali");
+
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, socks) == 0);
+  svr_conn[socks[0]].cn_mutex = &conn_mutex;
+  closed_sock = -1;
+
+  /* events queue up but nothing is written until the connection is handed over */
+  fail_unless(req_watchjobs(watch_request(socks[0], "1.napali", "2.napali")) == PBSE_NONE);
+  notify_job_watchers(&pjob, PBSE_NONE);
+
+  usleep(100000);
+  fail_unless(recv(socks[1], buf, sizeof(buf), MSG_DONTWAIT) < 0);
+
+  fail_unless(job_watch_take_conn(socks[0]) == TRUE);
+  fail_unless(job_watch_take_conn(socks[0]) == FALSE);
+  fail_unless(job_watch_take_conn(socks[0] + 100) == FALSE);
+
+  fail_unless(read_events(socks[1], buf, 9) == 9);
+  fail_unless(!strcmp(buf, "ev\nev\nev\n"));
+
+  /* later events go out from the watch thread as well */
+  notify_job_watchers(&pjob, PBSE_NONE);
+  fail_unless(read_events(socks[1], buf, 3) == 3);
+
+  /* the watch thread closes the connection once the client goes away */
+  close(socks[1]);
+
+  for (i = 0; (i < 50) && (closed_sock != socks[0]); i++)
+    usleep(100000);
+
+  fail_unless(closed_sock == socks[0]);
+
+  /* and the watcher is gone */
+  events_sent = 0;
+  notify_job_watchers(&pjob, PBSE_NONE);
+  fail_unless(events_sent == 0);
+  }
+END_TEST
+
+
+Suite *job_watch_suite(void)
+  {
+  Suite *s = suite_create("job_watch test suite methods");
+  TCase *tc_core = tcase_create("req_watchjobs_test");
+  tcase_add_test(tc_core, req_watchjobs_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("notify_job_watchers_test");
+  tcase_add_test(tc_core, notify_job_watchers_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("job_watch_thread_test");
+  tcase_add_test(tc_core, job_watch_thread_test);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_watch_suite());
+  srunner_set_log(sr, "job_watch_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
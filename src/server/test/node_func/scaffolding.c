@@ -25,6 +25,8 @@ all_nodes allnodes;
 char *path_nodes;
 char *path_nodestate;
 char *path_nodenote;
+int node_state_records = 0;
+int node_note_records = 0;
 struct addrinfo hints;
 char *path_nodes_new;
 attribute_def node_attr_def[2];
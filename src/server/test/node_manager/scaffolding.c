@@ -1,6 +1,7 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <unistd.h> /* write */
 #include <netinet/in.h> /* sockaddr_in */
 
 #include "attribute.h" /* attribute_def, pbs_attribute, svrattrl */
@@ -99,11 +100,17 @@ int enqueue_threadpool_request(void *(*func)(void *), void *arg)
   exit(1);
   }
 
+int   bob_state = 0;
+char *bob_note = NULL;
+
 struct pbsnode *find_nodebyname(char *nodename)
   {
   static struct pbsnode bob;
 
   memset(&bob, 0, sizeof(bob));
+  bob.nd_name = (char *)"bob";
+  bob.nd_state = bob_state;
+  bob.nd_note = bob_note;
 
   if (!strcmp(nodename, "bob"))
     return(&bob);
@@ -463,3 +470,8 @@ int append_char_to_dynamic_string(dynamic_string *ds, char c)
   {
   return(0);
   }
+
+ssize_t write_nonblocking_socket(int fd, const void *buf, ssize_t count)
+  {
+  return(write(fd, buf, count));
+  }
@@ -3,7 +3,11 @@
 #include "test_node_manager.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "pbs_error.h"
+#include "pbs_nodes.h"
 
 char *exec_hosts = "napali/0+napali/1+napali/2+napali/50+napali/4+l11/0+l11/1+l11/2+l11/3";
 char  buf[4096];
@@ -16,6 +20,15 @@ int   job_should_be_on_node(char *, struct pbsnode *);
 int   check_for_node_type(complete_spec_data *, enum node_types);
 int   record_external_node(job *, struct pbsnode *);
 
+extern char            *path_nodestate;
+extern char            *path_nodenote;
+extern pthread_mutex_t *node_state_mutex;
+extern int              node_state_records;
+extern int              node_note_records;
+extern int              svr_totnodes;
+extern int              bob_state;
+extern char            *bob_note;
+
 START_TEST(get_next_exec_host_test)
   {
   char *exec = strdup(exec_hosts);
@@ -176,6 +189,79 @@ END_TEST
 
 
 
+START_TEST(record_node_state_test)
+  {
+  char  path[] = "/tmp/test_node_stateXXXXXX";
+  char  line[256];
+  char  expect[256];
+  FILE *fp;
+  int   fd;
+
+  fail_unless((fd = mkstemp(path)) >= 0);
+  close(fd);
+
+  path_nodestate = path;
+  node_state_mutex = calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(node_state_mutex, NULL);
+  node_state_records = 0;
+
+  bob_state = INUSE_OFFLINE | INUSE_DOWN;
+  fail_unless(record_node_state((char *)"bob") == PBSE_NONE);
+  bob_state = INUSE_FREE;
+  fail_unless(record_node_state((char *)"bob") == PBSE_NONE);
+  fail_unless(node_state_records == 2);
+
+  /* unknown nodes and a full file go to write_node_state() */
+  fail_unless(record_node_state((char *)"tom") != PBSE_NONE);
+  node_state_records = svr_totnodes + 1024;
+  fail_unless(record_node_state((char *)"bob") != PBSE_NONE);
+
+  fail_unless((fp = fopen(path, "r")) != NULL);
+  fail_unless(fgets(line, sizeof(line), fp) != NULL);
+  snprintf(expect, sizeof(expect), "bob %d\n", INUSE_OFFLINE);
+  fail_unless(!strcmp(line, expect));
+  fail_unless(fgets(line, sizeof(line), fp) != NULL);
+  fail_unless(!strcmp(line, "bob 0\n"));
+  fail_unless(fgets(line, sizeof(line), fp) == NULL);
+  fclose(fp);
+  unlink(path);
+  }
+END_TEST
+
+
+
+
+START_TEST(record_node_note_test)
+  {
+  char  path[] = "/tmp/test_node_noteXXXXXX";
+  char  line[256];
+  FILE *fp;
+  int   fd;
+
+  fail_unless((fd = mkstemp(path)) >= 0);
+  close(fd);
+
+  path_nodenote = path;
+  node_note_records = 0;
+
+  bob_note = (char *)"disk failing";
+  fail_unless(record_node_note((char *)"bob") == PBSE_NONE);
+  bob_note = NULL;
+  fail_unless(record_node_note((char *)"bob") == PBSE_NONE);
+  fail_unless(node_note_records == 2);
+
+  fail_unless((fp = fopen(path, "r")) != NULL);
+  unlink(path);
+  fail_unless(fgets(line, sizeof(line), fp) != NULL);
+  fail_unless(!strcmp(line, "bob disk failing\n"));
+  fail_unless(fgets(line, sizeof(line), fp) != NULL);
+  fail_unless(!strcmp(line, "bob\n"));
+  fclose(fp);
+  }
+END_TEST
+
+
+
 
 Suite *node_manager_suite(void)
   {
@@ -200,6 +286,14 @@ Suite *node_manager_suite(void)
   tcase_add_test(tc_core, record_external_node_test);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("record_node_state_test");
+  tcase_add_test(tc_core, record_node_state_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("record_node_note_test");
+  tcase_add_test(tc_core, record_node_note_test);
+  suite_add_tcase(s, tc_core);
+
   return(s);
   }
 
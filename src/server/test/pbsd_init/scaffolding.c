@@ -631,3 +631,7 @@ job_array *get_array(
   {
   return(NULL);
   }
+
+void svr_attr_publish(int attr_index) {}
+
+void svr_attr_publish_all(void) {}
@@ -261,6 +261,10 @@ long log_size(void)
   exit(1);
   }
 
+void log_set_index(int enable)
+  {
+  }
+
 void close_conn(int sd, int has_mutex)
   {
   fprintf(stderr, "The call to close_conn needs to be mocked!!\n");
@@ -285,6 +289,12 @@ void acct_close(void)
   exit(1);
   }
 
+void mail_drain(void)
+  {
+  fprintf(stderr, "The call to mail_drain needs to be mocked!!\n");
+  exit(1);
+  }
+
 int svr_save(struct server *ps, int mode)
   {
   fprintf(stderr, "The call to svr_save needs to be mocked!!\n");
@@ -499,3 +509,14 @@ void *inspect_exiting_jobs(void *vp)
   {
   return(NULL);
   }
+
+void remove_job_watchers(int sock) {}
+
+int job_watch_take_conn(int sock)
+  {
+  return(0);
+  }
+
+void wait_for_owed_reply(int sock) {}
+
+void reply_owed_forget(int sock) {}
@@ -479,3 +479,17 @@ int unlock_ji_mutex(job *pjob, const char *id, char *msg, int logging)
   {
   return(0);
   }
+
+int req_submitjob(struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_submitjob needs to be mocked!!\n");
+  exit(1);
+  }
+
+int req_watchjobs(struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_watchjobs needs to be mocked!!\n");
+  exit(1);
+  }
+
+time_t pbs_tcp_timeout = 300;
@@ -3,18 +3,96 @@
 #include "test_process_request.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "pbs_error.h"
+
+
+static void *answer_later(
+
+  void *preq)
+
+  {
+  usleep(200000);
+  reply_owed_done((struct batch_request *)preq);
+
+  return(NULL);
+  }
+
+
 START_TEST(test_one)
   {
+  struct batch_request *preq = alloc_br(PBS_BATCH_DeleteJob);
+  pthread_t             tid;
+  time_t                start;
+
+  fail_unless(preq->rq_owed_conn == -1);
+
+  /* nothing owed, no wait */
+  wait_for_owed_reply(5);
 
+  /* the connection waits for a reply sent from another thread */
+  preq->rq_conn = 5;
+  reply_owed_set(preq);
+  fail_unless(preq->rq_owed_conn == 5);
 
+  pthread_create(&tid, NULL, answer_later, preq);
+  start = time(NULL);
+  wait_for_owed_reply(5);
+  fail_unless(time(NULL) - start < 5);
+  fail_unless(preq->rq_owed_conn == -1);
+  pthread_join(tid, NULL);
+
+  /* answered twice, or answered and then freed, is harmless */
+  reply_owed_done(preq);
+  wait_for_owed_reply(5);
+
+  free(preq);
   }
 END_TEST
 
+static void *answer_much_later(
+
+  void *preq)
+
+  {
+  usleep(1500000);
+  reply_owed_done((struct batch_request *)preq);
+
+  return(NULL);
+  }
+
+
 START_TEST(test_two)
   {
+  struct batch_request *old_preq = alloc_br(PBS_BATCH_DeleteJob);
+  struct batch_request *preq = alloc_br(PBS_BATCH_DeleteJob);
+  pthread_t             tid;
+  time_t                start;
+
+  /* the connection closes while its reply is still owed */
+  old_preq->rq_conn = 6;
+  reply_owed_set(old_preq);
+  reply_owed_forget(6);
+  wait_for_owed_reply(6);
+
+  /* the socket is reused, the late answer for the old connection must
+   * not let the new one read past its own unanswered request */
+  preq->rq_conn = 6;
+  reply_owed_set(preq);
+  reply_owed_done(old_preq);
+  fail_unless(old_preq->rq_owed_conn == -1);
 
+  pthread_create(&tid, NULL, answer_much_later, preq);
+  start = time(NULL);
+  wait_for_owed_reply(6);
+  fail_unless(time(NULL) - start >= 1);
+  fail_unless(preq->rq_owed_conn == -1);
+  pthread_join(tid, NULL);
 
+  free(old_preq);
+  free(preq);
   }
 END_TEST
 
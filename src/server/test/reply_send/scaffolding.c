@@ -6,10 +6,12 @@
 #include "libpbs.h" /* batch_reply */
 #include "batch_request.h" /* batach_request */
 #include "list_link.h" /* list_link */
+#include "tcp.h" /* tcp_chan */
 
 char *msg_daemonname = "unset";
 int LOGLEVEL = 0;
 all_tasks task_list_event;
+int replies_written = 0;
 
 
 int encode_DIS_reply(struct tcp_chan *chan, struct batch_reply *reply)
@@ -20,14 +22,15 @@ int encode_DIS_reply(struct tcp_chan *chan, struct batch_reply *reply)
 
 void free_br(struct batch_request *preq)
   {
-  fprintf(stderr, "The call to free_br needs to be mocked!!\n");
-  exit(1);
+  free(preq);
   }
 
-void DIS_tcp_setup(int fd)
+/* a reply being written starts with setting up the channel */
+struct tcp_chan *DIS_tcp_setup(int fd)
   {
-  fprintf(stderr, "The call to DIS_tcp_setup needs to be mocked!!\n");
-  exit(1);
+  replies_written++;
+
+  return(NULL);
   }
 
 int DIS_tcp_wflush(int fd)
@@ -84,3 +87,5 @@ int safe_strncat(char *str, char *to_append, size_t space_remaining)
   }
 
 void DIS_tcp_cleanup(struct tcp_chan *chan) {}
+
+void reply_owed_done(struct batch_request *preq) {}
@@ -3,11 +3,44 @@
 #include "test_reply_send.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "pbs_error.h"
-START_TEST(test_one)
+#include "batch_request.h"
+
+extern int replies_written;
+
+
+static int replied(
+
+  int type,
+  int compound,
+  int code)
+
   {
+  struct batch_request *preq = (struct batch_request *)calloc(1, sizeof(struct batch_request));
+
+  preq->rq_type = type;
+  preq->rq_conn = 10;
+  preq->rq_compound = compound;
+  preq->rq_reply.brp_code = code;
 
+  replies_written = 0;
 
+  reply_send_svr(preq);
+
+  return(replies_written);
+  }
+
+
+/* the steps of a SubmitJob only answer the client on error or at commit */
+START_TEST(test_one)
+  {
+  fail_unless(replied(PBS_BATCH_QueueJob, FALSE, PBSE_NONE) == 1);
+  fail_unless(replied(PBS_BATCH_QueueJob, TRUE, PBSE_NONE) == 0);
+  fail_unless(replied(PBS_BATCH_jobscript, TRUE, PBSE_NONE) == 0);
+  fail_unless(replied(PBS_BATCH_jobscript, TRUE, PBSE_SYSTEM) == 1);
+  fail_unless(replied(PBS_BATCH_Commit, TRUE, PBSE_NONE) == 1);
+  fail_unless(replied(PBS_BATCH_Commit, TRUE, PBSE_IVALREQ) == 1);
   }
 END_TEST
 
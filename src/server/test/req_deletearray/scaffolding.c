@@ -1,6 +1,7 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
 
 #include "server.h" /* server */
 #include "batch_request.h" /* batch_request */
@@ -14,10 +15,15 @@ char *msg_permlog = "Unauthorized Request, request type: %d, Object: %s, Name: %
 struct server server;
 int LOGLEVEL = 0;
 
+int  range_rc = 0;
+int  rejected = 0;
+int  acked = 0;
+int  acct_records = 0;
+char acct_text[1024];
+
 int svr_authorize_req(struct batch_request *preq, char *owner, char *submit_host)
   {
-  fprintf(stderr, "The call to svr_authorize_req needs to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 int has_job_delete_nanny(struct job *pjob)
@@ -52,8 +58,7 @@ pbs_queue *get_jobs_queue(job **pjob)
 
 void reply_ack(struct batch_request *preq)
   {
-  fprintf(stderr, "The call to reply_ack needs to be mocked!!\n");
-  exit(1);
+  acked++;
   }
 
 struct work_task *apply_job_delete_nanny(struct job *pjob, int delay)
@@ -64,8 +69,7 @@ struct work_task *apply_job_delete_nanny(struct job *pjob, int delay)
 
  int delete_array_range(job_array *pa, char *range_str)
   {
-  fprintf(stderr, "The call to delete_array_range needs to be mocked!!\n");
-  exit(1);
+  return(range_rc);
   }
 
 struct work_task *set_task(enum work_type type, long event_id, void (*func)(), void *parm, int get_lock)
@@ -76,14 +80,14 @@ struct work_task *set_task(enum work_type type, long event_id, void (*func)(), v
 
 job_array *get_array(char *id)
   {
-  fprintf(stderr, "The call to get_array needs to be mocked!!\n");
-  exit(1);
+  static job_array pa;
+
+  return(&pa);
   }
 
 void req_reject(int code, int aux, struct batch_request *preq, char *HostName, char *Msg)
   {
-  fprintf(stderr, "The call to req_reject needs to be mocked!!\n");
-  exit(1);
+  rejected = code;
   }
 
 int job_abt(job **pjobp, char *text)
@@ -130,8 +134,7 @@ int insert_task(all_tasks *at, work_task *wt)
 
 void get_jobowner(char *from, char *to)
   {
-  fprintf(stderr, "The call to get_jobowner needs to be mocked!!\n");
-  exit(1);
+  strcpy(to, "dbeer");
   }
 
 int delete_whole_array(job_array *pa)
@@ -187,3 +190,9 @@ int lock_ai_mutex(job_array *pa, const char *id, char *msg, int logging)
 void free_br(struct batch_request *preq) {}
 
 void on_job_exit_task(struct work_task *ptask) {} 
+
+void account_record_id(int acctype, char *id, char *text)
+  {
+  acct_records++;
+  snprintf(acct_text, sizeof(acct_text), "%s", text);
+  }
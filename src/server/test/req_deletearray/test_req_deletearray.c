@@ -3,11 +3,39 @@
 #include "test_req_deletearray.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "pbs_error.h"
+#include "array.h"
+
+extern int  range_rc;
+extern int  rejected;
+extern int  acked;
+extern int  acct_records;
+extern char acct_text[];
+
 START_TEST(test_one)
   {
+  struct batch_request preq;
+
+  memset(&preq, 0, sizeof(preq));
+  strcpy(preq.rq_ind.rq_delete.rq_objname, "1[].napali");
+  strcpy(preq.rq_user, "dbeer");
+  strcpy(preq.rq_host, "napali");
+  preq.rq_extend = (char *)"array_range=1-3";
 
+  /* a range that does not parse is rejected without a 'D' record */
+  range_rc = -1;
+  fail_unless(req_deletearray(&preq) == PBSE_NONE);
+  fail_unless(rejected == PBSE_IVALREQ);
+  fail_unless(acct_records == 0);
+  fail_unless(acked == 0);
 
+  /* one record for the request once the range is deleted */
+  range_rc = NO_JOBS_IN_ARRAY;
+  fail_unless(req_deletearray(&preq) == PBSE_NONE);
+  fail_unless(acked == 1);
+  fail_unless(acct_records == 1);
+  fail_unless(!strcmp(acct_text, "requestor=dbeer@napali array_range=1-3"), acct_text);
   }
 END_TEST
 
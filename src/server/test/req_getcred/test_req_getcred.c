@@ -3,11 +3,32 @@
 #include "test_req_getcred.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include "pbs_error.h"
+#include "libpbs.h"
+#include "credential.h"
+
 START_TEST(test_one)
   {
+  char user[PBS_MAXUSER + 1];
+  char host[PBS_MAXHOSTNAME + 1];
+
+  fail_unless(munge_cache_lookup((char *)"cred1", 1, user, host) == FALSE);
+
+  munge_cache_add((char *)"cred1", 1, (char *)"dbeer", (char *)"napali", time(NULL) + 60);
+
+  fail_unless(munge_cache_lookup((char *)"cred1", 1, user, host) == TRUE);
+  fail_unless(!strcmp(user, "dbeer"));
+  fail_unless(!strcmp(host, "napali"));
 
+  /* a credential is bound to the peer that presented it */
+  fail_unless(munge_cache_lookup((char *)"cred1", 2, user, host) == FALSE);
+  fail_unless(munge_cache_lookup((char *)"cred2", 1, user, host) == FALSE);
 
+  /* expired credentials are not remembered */
+  munge_cache_add((char *)"cred3", 1, (char *)"dbeer", (char *)"napali", time(NULL) - 1);
+  fail_unless(munge_cache_lookup((char *)"cred3", 1, user, host) == FALSE);
   }
 END_TEST
 
@@ -35,6 +35,18 @@ int svr_chngNodesfile = 0;
 int svr_totnodes = 0;
 
 
+int record_node_state(char *node_name)
+  {
+  fprintf(stderr, "The call to record_node_state to be mocked!!\n");
+  exit(1);
+  }
+
+int record_node_note(char *node_name)
+  {
+  fprintf(stderr, "The call to record_node_note to be mocked!!\n");
+  exit(1);
+  }
+
 int write_node_note(void)
   {
   fprintf(stderr, "The call to write_node_note to be mocked!!\n");
@@ -319,3 +331,7 @@ int lock_sv_qs_mutex(pthread_mutex_t *sv_qs_mutex, const char *msg_string)
   {
   return(0);
   }
+
+void svr_attr_publish(int attr_index) {}
+
+void svr_attr_publish_all(void) {}
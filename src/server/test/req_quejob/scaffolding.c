@@ -360,3 +360,7 @@ int  increment_queued_jobs(user_info_holder *uih, char *user_name, job *pjob)
   {
   return(0);
   }
+
+void svr_attr_publish(int attr_index) {}
+
+void svr_attr_publish_all(void) {}
@@ -10,6 +10,7 @@
 #include "array.h" /* job_array */
 #include "work_task.h" /* work_task */
 #include "queue.h"
+#include "depend_graph.h" /* depend_edge */
 
 char *msg_illregister = "Illegal op in register request received for job %s";
 char *msg_registerdel = "Job deleted as result of dependency on job %s";
@@ -185,3 +186,23 @@ int unlock_ai_mutex(job_array *pa, const char *id, char *msg, int logging)
   {
   return(0);
   }
+
+int depend_graph_add(char *prereq_id, char *dependent_id, int type)
+  {
+  return(0);
+  }
+
+void depend_graph_remove(char *prereq_id, char *dependent_id, int type) {}
+
+void depend_graph_index_job(char *job_id, pbs_attribute *pattr) {}
+
+int depend_graph_has_edge(char *prereq_id, char *dependent_id, int type)
+  {
+  return(0);
+  }
+
+int depend_graph_dependents(char *prereq_id, depend_edge **edges)
+  {
+  *edges = NULL;
+  return(0);
+  }
@@ -52,6 +52,11 @@ void svr_mailowner(job *pjob, int mailpoint, int force, char *text)
   exit(1);
   }
 
+long mail_queue_length(void)
+  {
+  return(0);
+  }
+
 svrattrl *attrlist_create(char *aname, char *rname, int vsize)
   {
   fprintf(stderr, "The call to attrlist_create to be mocked!!\n");
@@ -321,3 +326,31 @@ int unlock_ai_mutex(job_array *pa, const char *id, char *msg, int logging)
   {
   return(0);
   }
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+  {
+  fprintf(stderr, "The call to DIS_tcp_setup to be mocked!!\n");
+  exit(1);
+  }
+
+int encode_DIS_reply(struct tcp_chan *chan, struct batch_reply *reply)
+  {
+  fprintf(stderr, "The call to encode_DIS_reply to be mocked!!\n");
+  exit(1);
+  }
+
+int DIS_tcp_wflush(struct tcp_chan *chan)
+  {
+  fprintf(stderr, "The call to DIS_tcp_wflush to be mocked!!\n");
+  exit(1);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+  {
+  fprintf(stderr, "The call to DIS_tcp_cleanup to be mocked!!\n");
+  exit(1);
+  }
+
+void svr_attr_publish(int attr_index) {}
+
+void svr_attr_publish_all(void) {}
@@ -0,0 +1,110 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h> /* fprintf */
+#include <string.h>
+
+#include "batch_request.h" /* batch_request */
+#include "pbs_error.h"
+
+int   quejob_rc = PBSE_NONE;
+int   jobscript_rc = PBSE_NONE;
+int   commit_rc = PBSE_NONE;
+int   alloc_fails = FALSE;
+
+int   quejob_calls;
+int   jobscript_calls;
+int   commit_calls;
+int   freed;
+int   rejected;
+int   steps_compound;
+char  closed_jobid[PBS_MAXSVRJOBID + 1];
+char  script_jobid[PBS_MAXSVRJOBID + 1];
+char  commit_jobid[PBS_MAXSVRJOBID + 1];
+int   script_matched;
+long  script_size;
+
+
+struct batch_request *alloc_br(int type)
+  {
+  struct batch_request *preq;
+
+  if (alloc_fails)
+    return(NULL);
+
+  preq = (struct batch_request *)calloc(1, sizeof(struct batch_request));
+  preq->rq_type = type;
+  preq->rq_conn = -1;
+
+  return(preq);
+  }
+
+void free_br(struct batch_request *preq)
+  {
+  if (preq->rq_type == PBS_BATCH_jobscript)
+    free(preq->rq_ind.rq_jobfile.rq_data);
+  else if (preq->rq_type == PBS_BATCH_QueueJob)
+    free(preq->rq_ind.rq_queuejob.rq_script);
+
+  freed++;
+  free(preq);
+  }
+
+void req_reject(int code, int aux, struct batch_request *preq, char *HostName, char *Msg)
+  {
+  rejected = code;
+  free_br(preq);
+  }
+
+int close_quejob_by_jobid(char *job_id)
+  {
+  snprintf(closed_jobid, sizeof(closed_jobid), "%s", job_id);
+  return(PBSE_NONE);
+  }
+
+/* the handlers reply (and free the request) whether they succeed or not */
+
+int req_quejob(struct batch_request *preq, char **pjob_id)
+  {
+  quejob_calls++;
+
+  if (preq->rq_compound == TRUE)
+    steps_compound++;
+
+  if (quejob_rc == PBSE_NONE)
+    *pjob_id = strdup("1.host");
+
+  free_br(preq);
+
+  return(quejob_rc);
+  }
+
+int req_jobscript(struct batch_request *preq)
+  {
+  jobscript_calls++;
+
+  if (preq->rq_compound == TRUE)
+    steps_compound++;
+
+  snprintf(script_jobid, sizeof(script_jobid), "%s", preq->rq_ind.rq_jobfile.rq_jobid);
+  script_size = preq->rq_ind.rq_jobfile.rq_size;
+  script_matched = ((preq->rq_ind.rq_jobfile.rq_data != NULL) &&
+                    (!strncmp(preq->rq_ind.rq_jobfile.rq_data, "sleep 1\n", script_size)));
+
+  free_br(preq);
+
+  return(jobscript_rc);
+  }
+
+int req_commit(struct batch_request *preq)
+  {
+  commit_calls++;
+
+  if (preq->rq_compound == TRUE)
+    steps_compound++;
+
+  snprintf(commit_jobid, sizeof(commit_jobid), "%s", preq->rq_ind.rq_commit);
+
+  free_br(preq);
+
+  return(commit_rc);
+  }
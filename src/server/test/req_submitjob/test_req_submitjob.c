@@ -0,0 +1,163 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "req_submitjob.h"
+#include "test_req_submitjob.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "pbs_error.h"
+
+extern int   quejob_rc;
+extern int   jobscript_rc;
+extern int   commit_rc;
+extern int   alloc_fails;
+extern int   quejob_calls;
+extern int   jobscript_calls;
+extern int   commit_calls;
+extern int   freed;
+extern int   rejected;
+extern int   steps_compound;
+extern char  closed_jobid[];
+extern char  script_jobid[];
+extern char  commit_jobid[];
+extern int   script_matched;
+extern long  script_size;
+
+
+static struct batch_request *submit_request(
+
+  const char *script)
+
+  {
+  struct batch_request *preq = (struct batch_request *)calloc(1, sizeof(struct batch_request));
+
+  quejob_rc = PBSE_NONE;
+  jobscript_rc = PBSE_NONE;
+  commit_rc = PBSE_NONE;
+  alloc_fails = FALSE;
+  quejob_calls = 0;
+  jobscript_calls = 0;
+  commit_calls = 0;
+  freed = 0;
+  rejected = 0;
+  steps_compound = 0;
+  closed_jobid[0] = '\0';
+  script_jobid[0] = '\0';
+  commit_jobid[0] = '\0';
+  script_matched = FALSE;
+  script_size = 0;
+
+  preq->rq_type = PBS_BATCH_SubmitJob;
+  preq->rq_conn = 10;
+  strcpy(preq->rq_user, "dbeer");
+  strcpy(preq->rq_host, "napali");
+
+  if (script != NULL)
+    {
+    preq->rq_ind.rq_queuejob.rq_script = strdup(script);
+    preq->rq_ind.rq_queuejob.rq_scriptsz = strlen(script);
+    }
+
+  return(preq);
+  }
+
+
+/* every step runs in order, as a compound step, and nothing is cleaned up */
+START_TEST(test_submit)
+  {
+  struct batch_request *preq = submit_request("sleep 1\n");
+
+  fail_unless(req_submitjob(preq) == PBSE_NONE);
+
+  fail_unless(quejob_calls == 1);
+  fail_unless(jobscript_calls == 1);
+  fail_unless(commit_calls == 1);
+  fail_unless(steps_compound == 3);
+  fail_unless(!strcmp(script_jobid, "1.host"));
+  fail_unless(script_matched == TRUE);
+  fail_unless(script_size == 8);
+  fail_unless(!strcmp(commit_jobid, "1.host"));
+  fail_unless(closed_jobid[0] == '\0');
+  fail_unless(freed == 3);
+
+  /* no script, no Job Script step */
+  preq = submit_request(NULL);
+
+  fail_unless(req_submitjob(preq) == PBSE_NONE);
+  fail_unless(jobscript_calls == 0);
+  fail_unless(commit_calls == 1);
+  fail_unless(freed == 3);
+  }
+END_TEST
+
+
+/* a step failing after the job was queued removes the half-made job */
+START_TEST(test_submit_fails)
+  {
+  struct batch_request *preq = submit_request("sleep 1\n");
+
+  jobscript_rc = PBSE_CAN_NOT_SAVE_FILE;
+
+  fail_unless(req_submitjob(preq) == PBSE_CAN_NOT_SAVE_FILE);
+  fail_unless(commit_calls == 0);
+  fail_unless(!strcmp(closed_jobid, "1.host"));
+  fail_unless(freed == 3);
+
+  preq = submit_request("sleep 1\n");
+  commit_rc = PBSE_IVALREQ;
+
+  fail_unless(req_submitjob(preq) == PBSE_IVALREQ);
+  fail_unless(commit_calls == 1);
+  fail_unless(!strcmp(closed_jobid, "1.host"));
+  fail_unless(freed == 3);
+
+  /* no job was made, so there is nothing to close */
+  preq = submit_request("sleep 1\n");
+  quejob_rc = PBSE_UNKQUE;
+
+  fail_unless(req_submitjob(preq) == PBSE_UNKQUE);
+  fail_unless(jobscript_calls == 0);
+  fail_unless(commit_calls == 0);
+  fail_unless(closed_jobid[0] == '\0');
+  fail_unless(freed == 3);
+
+  preq = submit_request("sleep 1\n");
+  alloc_fails = TRUE;
+
+  fail_unless(req_submitjob(preq) == PBSE_SYSTEM);
+  fail_unless(quejob_calls == 0);
+  fail_unless(rejected == PBSE_SYSTEM);
+  fail_unless(freed == 1);
+  }
+END_TEST
+
+
+Suite *req_submitjob_suite(void)
+  {
+  Suite *s = suite_create("req_submitjob_suite methods");
+  TCase *tc_core = tcase_create("test_submit");
+  tcase_add_test(tc_core, test_submit);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_submit_fails");
+  tcase_add_test(tc_core, test_submit_fails);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(req_submitjob_suite());
+  srunner_set_log(sr, "req_submitjob_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
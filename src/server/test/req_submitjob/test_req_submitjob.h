@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _REQ_SUBMITJOB_CT_H
+#define _REQ_SUBMITJOB_CT_H
+#include <check.h>
+
+#define REQ_SUBMITJOB_SUITE 1
+Suite *req_submitjob_suite();
+
+#endif /* _REQ_SUBMITJOB_CT_H */
@@ -207,11 +207,24 @@ int decode_tokens(pbs_attribute *patr, char *name, char *rescn, char *val, int p
   exit(1);
   }
 
+struct array_strings *extra_resc_arst = NULL;
+int forgotten = 0;
+
 int get_svr_attr_arst(int index, struct array_strings **arst)
   {
+  if (extra_resc_arst == NULL)
+    return(-1);
+
+  *arst = extra_resc_arst;
+
   return(0);
   }
 
+void forget_name_index(void *defs)
+  {
+  forgotten++;
+  }
+
 char *threadsafe_tokenizer(char **str, char *delims)
   {
   fprintf(stderr, "The call to threadsafe_tokenizer needs to be mocked!!\n");
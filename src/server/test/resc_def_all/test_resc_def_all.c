@@ -3,11 +3,55 @@
 #include "test_resc_def_all.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "pbs_error.h"
+#include "resource.h"
+#include "attribute.h"
+extern struct array_strings *extra_resc_arst;
+extern int forgotten;
+
 START_TEST(test_one)
   {
+  struct array_strings *arst;
+  char                 *names[] = { "foo", "gres", "foo", "walltime", "bar" };
+  int                   count = sizeof(names) / sizeof(names[0]);
+  resource_def         *first;
+  int                   const_size = 0;
+  int                   i;
+
+  while (strcmp(svr_resc_def_const[const_size].rs_name, "|unknown|"))
+    const_size++;
+
+  fail_unless(init_resc_defs() == PBSE_NONE);
+  fail_unless(svr_resc_size == const_size + 1);
+  fail_unless(forgotten == 0);
+
+  first = svr_resc_def;
+
+  /* duplicates of each other and of the built in resources are dropped */
+  arst = calloc(1, sizeof(struct array_strings) + count * sizeof(char *));
+  arst->as_usedptr = count;
+
+  for (i = 0; i < count; i++)
+    arst->as_string[i] = names[i];
+
+  extra_resc_arst = arst;
+
+  fail_unless(init_resc_defs() == PBSE_NONE);
+  extra_resc_arst = NULL;
+
+  fail_unless(svr_resc_def != first);
+  fail_unless(forgotten == 1);
+  fail_unless(svr_resc_size == const_size + 3);
+
+  for (i = 0; i < const_size; i++)
+    fail_unless(!strcmp(svr_resc_def[i].rs_name, svr_resc_def_const[i].rs_name));
 
+  fail_unless(!strcmp(svr_resc_def[const_size].rs_name, "foo"));
+  fail_unless(!strcmp(svr_resc_def[const_size + 1].rs_name, "bar"));
+  fail_unless(!strcmp(svr_resc_def[const_size + 2].rs_name, "|unknown|"));
 
+  free(arst);
   }
 END_TEST
 
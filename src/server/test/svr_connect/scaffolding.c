@@ -20,8 +20,7 @@ int LOGLEVEL = 0;
 
 int addr_ok(pbs_net_t addr, struct pbsnode *pnode)
   {
-  fprintf(stderr, "The call to addr_ok to be mocked!!\n");
-  exit(1);
+  return(1);
   }
 
 int get_connection_entry(int *conn_pos)
@@ -113,3 +112,7 @@ int unlock_node(
   {
   return(0);
   }
+
+void globalset_add_sock(int sock) {}
+
+void globalset_del_sock(int sock) {}
@@ -3,18 +3,91 @@
 #include "test_svr_connect.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "pbs_error.h"
+#include "libpbs.h"
+#include "net_connect.h"
+
+extern struct connect_handle connection[];
+extern struct connection     svr_conn[];
+extern pbs_net_t             pbs_server_addr;
+extern unsigned int          pbs_server_port_dis;
+
+static pthread_mutex_t ch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t cn_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* a connection to addr 10, port 15002 on handle 1 */
+
+static int pooled_handle(
+
+  int *sv)
+
+  {
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+  connection[1].ch_mutex = &ch_mutex;
+  connection[1].ch_socket = sv[0];
+
+  svr_conn[sv[0]].cn_mutex = &cn_mutex;
+  svr_conn[sv[0]].cn_addr = 10;
+  svr_conn[sv[0]].cn_port = 15002;
+
+  /* a new connection to addr 10 reports itself as the local one */
+  pbs_server_addr = 10;
+  pbs_server_port_dis = 15002;
+
+  return(1);
+  }
+
+
 START_TEST(test_one)
   {
+  int sv[2];
+  int my_err = 0;
+  int reused = FALSE;
+  int handle = pooled_handle(sv);
+
+  svr_disconnect_pooled(handle);
 
+  /* the pooled connection comes back once */
+  fail_unless(svr_connect_pooled(10, 15002, &my_err, TRUE, &reused) == handle);
+  fail_unless(reused == TRUE);
 
+  fail_unless(svr_connect_pooled(10, 15002, &my_err, TRUE, &reused) == PBS_LOCAL_CONNECTION);
+  fail_unless(reused == FALSE);
+
+  close(sv[0]);
+  close(sv[1]);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  int sv[2];
+  int my_err = 0;
+  int reused = FALSE;
+  int handle = pooled_handle(sv);
+
+  svr_disconnect_pooled(handle);
+
+  /* a caller wanting a fresh connection leaves it alone */
+  fail_unless(svr_connect_pooled(10, 15002, &my_err, FALSE, &reused) == PBS_LOCAL_CONNECTION);
+  fail_unless(reused == FALSE);
+
+  fail_unless(svr_connect_pooled(10, 15002, &my_err, TRUE, &reused) == handle);
+  fail_unless(reused == TRUE);
+
+  /* invalid handles are ignored */
+  svr_disconnect_pooled(-1);
+  svr_disconnect_pooled(PBS_LOCAL_CONNECTION);
 
+  fail_unless(svr_connect_pooled(10, 15002, &my_err, TRUE, &reused) == PBS_LOCAL_CONNECTION);
 
+  close(sv[0]);
+  close(sv[1]);
   }
 END_TEST
 
@@ -22,7 +22,7 @@ pthread_mutex_t *listener_command_mutex;
 
 int encode_svrstate(pbs_attribute *pattr, tlist_head *phead, char *atname, char *rsname, int mode, int perm);
 
-attribute_def svr_attr_def[] =
+attribute_def svr_attr_def[SRV_ATR_LAST] =
   {
   /* SRV_ATR_State */
     { ATTR_status,  /* "server_state" */
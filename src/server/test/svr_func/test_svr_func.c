@@ -4,6 +4,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "pbs_error.h"
+#include "server.h"
+#include "svrfunc.h"
+
+extern struct server server;
+
 START_TEST(test_one)
   {
 
@@ -18,6 +23,49 @@ START_TEST(test_two)
   }
 END_TEST
 
+START_TEST(svr_attr_snapshot_test)
+  {
+  long l = 0;
+
+  server.sv_attr_mutex = calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(server.sv_attr_mutex, NULL);
+
+  server.sv_attr[SRV_ATR_State].at_val.at_long = SV_STATE_RUN;
+  server.sv_attr[SRV_ATR_State].at_flags = ATR_VFLAG_SET;
+
+  /* nothing is published yet, so this reads the attribute itself */
+  svr_attr_publish(SRV_ATR_State);
+  server.sv_attr[SRV_ATR_State].at_val.at_long = SV_STATE_INIT;
+  fail_unless(get_svr_attr_l(SRV_ATR_State, &l) == PBSE_NONE);
+  fail_unless(l == SV_STATE_INIT);
+
+  svr_attr_publish_all();
+  fail_unless(get_svr_attr_l(SRV_ATR_State, &l) == PBSE_NONE);
+  fail_unless(l == SV_STATE_INIT);
+
+  /* readers see the published value until the next publish */
+  server.sv_attr[SRV_ATR_State].at_val.at_long = SV_STATE_RUN;
+  fail_unless(get_svr_attr_l(SRV_ATR_State, &l) == PBSE_NONE);
+  fail_unless(l == SV_STATE_INIT);
+
+  svr_attr_publish(SRV_ATR_State);
+  fail_unless(get_svr_attr_l(SRV_ATR_State, &l) == PBSE_NONE);
+  fail_unless(l == SV_STATE_RUN);
+  fail_unless(is_svr_attr_set(SRV_ATR_State) == TRUE);
+
+  l = SV_STATE_SHUTIMM;
+  fail_unless(set_svr_attr(SRV_ATR_State, &l) == PBSE_NONE);
+  l = 0;
+  fail_unless(get_svr_attr_l(SRV_ATR_State, &l) == PBSE_NONE);
+  fail_unless(l == SV_STATE_SHUTIMM);
+
+  server.sv_attr[SRV_ATR_State].at_flags = 0;
+  svr_attr_publish(SRV_ATR_State);
+  fail_unless(get_svr_attr_l(SRV_ATR_State, &l) == -1);
+  fail_unless(is_svr_attr_set(SRV_ATR_State) == FALSE);
+  }
+END_TEST
+
 Suite *svr_func_suite(void)
   {
   Suite *s = suite_create("svr_func_suite methods");
@@ -29,6 +77,10 @@ Suite *svr_func_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("svr_attr_snapshot_test");
+  tcase_add_test(tc_core, svr_attr_snapshot_test);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -201,6 +201,24 @@ resource *find_resc_entry(pbs_attribute *pattr, resource_def *rscdf)
   exit(1);
   }
 
+void resc_vector_init(resc_vector *rv, pbs_attribute *pattr)
+  {
+  fprintf(stderr, "The call to resc_vector_init to be mocked!!\n");
+  exit(1);
+  }
+
+resource *resc_vector_find(resc_vector *rv, resource_def *rscdf)
+  {
+  fprintf(stderr, "The call to resc_vector_find to be mocked!!\n");
+  exit(1);
+  }
+
+void resc_vector_free(resc_vector *rv)
+  {
+  fprintf(stderr, "The call to resc_vector_free to be mocked!!\n");
+  exit(1);
+  }
+
 job *svr_find_job(char *jobid, int get_subjob)
   {
   fprintf(stderr, "The call to find_job to be mocked!!\n");
@@ -301,3 +319,5 @@ int decrement_queued_jobs(
   {
   return(0);
   }
+
+void notify_job_watchers(job *pjob, int code) {}
@@ -1,12 +1,22 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
+#include <pthread.h>
 
 #include "server.h" /* server mail_info*/
 
 struct server server;
 int LOGLEVEL = 0;
 
+long            mail_delay = 0;
+long            mail_limit = 0;
+
+/* what the mail worker piped to sendmail, one message each */
+char            sent_mail[16][1024];
+int             sent_count = 0;
+pthread_mutex_t sent_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 int enqueue_threadpool_request(void *(*func)(void *),void *arg)
   {
   fprintf(stderr, "The call to enqueue_threadpool_request to be mocked!!\n");
@@ -15,12 +25,44 @@ int enqueue_threadpool_request(void *(*func)(void *),void *arg)
 
 void svr_format_job(FILE *fh, mail_info *mi, char *fmt)
   {
-  fprintf(stderr, "The call to svr_format_job to be mocked!!\n");
-  exit(1);
+  fprintf(fh, "%s", mi->jobid);
   }
 
 int get_svr_attr_l(int index, long *l)
   {
+  if (index == SRV_ATR_MailCoalesceDelay)
+    *l = mail_delay;
+  else if (index == SRV_ATR_MailRateLimit)
+    *l = mail_limit;
+
+  return(0);
+  }
+
+FILE *popen(const char *command, const char *type)
+  {
+  return(tmpfile());
+  }
+
+int pclose(FILE *stream)
+  {
+  size_t len;
+
+  pthread_mutex_lock(&sent_mutex);
+
+  rewind(stream);
+
+  if (sent_count < 16)
+    {
+    len = fread(sent_mail[sent_count], 1, sizeof(sent_mail[0]) - 1, stream);
+    sent_mail[sent_count][len] = '\0';
+    }
+
+  sent_count++;
+
+  pthread_mutex_unlock(&sent_mutex);
+
+  fclose(stream);
+
   return(0);
   }
   
@@ -3,18 +3,206 @@
 #include "test_svr_mail.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "pbs_error.h"
+
+extern long            mail_delay;
+extern long            mail_limit;
+extern char            sent_mail[16][1024];
+extern int             sent_count;
+extern pthread_mutex_t sent_mutex;
+
+static mail_info *make_mail(char *mailto, char *jobid)
+  {
+  mail_info *mi = calloc(1, sizeof(mail_info));
+
+  mi->mailto = mailto;
+  mi->jobid = jobid;
+
+  return(mi);
+  }
+
 START_TEST(test_one)
   {
+  mail_info *mail[5];
+  mail_info *head;
+  mail_info *tail;
+  mail_info *group;
+  int        count;
+  int        i;
 
+  mail[0] = make_mail((char *)"alice", (char *)"1[1].host");
+  mail[1] = make_mail((char *)"bob", (char *)"2.host");
+  mail[2] = make_mail((char *)"alice", (char *)"1[2].host");
+  mail[3] = make_mail((char *)"carol", (char *)"3.host");
+  mail[4] = make_mail((char *)"alice", (char *)"1[3].host");
 
+  for (i = 0; i < 4; i++)
+    mail[i]->next = mail[i + 1];
+
+  head = mail[0];
+  tail = mail[4];
+
+  /* every notification for alice, in order, leaving bob and carol */
+  group = take_mail_group(&head, &tail, TRUE, &count);
+  fail_unless(count == 3);
+  fail_unless(group == mail[0]);
+  fail_unless(group->next == mail[2]);
+  fail_unless(mail[2]->next == mail[4]);
+  fail_unless(mail[4]->next == NULL);
+  fail_unless(head == mail[1]);
+  fail_unless(mail[1]->next == mail[3]);
+  fail_unless(tail == mail[3]);
+  fail_unless(mail[3]->next == NULL);
+
+  group = take_mail_group(&head, &tail, TRUE, &count);
+  fail_unless(count == 1);
+  fail_unless(group == mail[1]);
+  fail_unless(group->next == NULL);
+  fail_unless(head == mail[3]);
+  fail_unless(tail == mail[3]);
+
+  group = take_mail_group(&head, &tail, TRUE, &count);
+  fail_unless(count == 1);
+  fail_unless(group == mail[3]);
+  fail_unless(head == NULL);
+  fail_unless(tail == NULL);
+
+  fail_unless(take_mail_group(&head, &tail, TRUE, &count) == NULL);
+  fail_unless(count == 0);
+
+  for (i = 0; i < 5; i++)
+    free(mail[i]);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  mail_info *mail[3];
+  mail_info *head;
+  mail_info *tail;
+  mail_info *group;
+  int        count;
+  int        i;
+
+  mail[0] = make_mail((char *)"alice", (char *)"1.host");
+  mail[1] = make_mail((char *)"alice", (char *)"2.host");
+  mail[2] = make_mail((char *)"bob", (char *)"3.host");
+  mail[0]->next = mail[1];
+  mail[1]->next = mail[2];
+
+  head = mail[0];
+  tail = mail[2];
+
+  /* without coalescing each notification goes on its own */
+  group = take_mail_group(&head, &tail, FALSE, &count);
+  fail_unless(count == 1);
+  fail_unless(group == mail[0]);
+  fail_unless(group->next == NULL);
+  fail_unless(head == mail[1]);
+  fail_unless(tail == mail[2]);
+
+  group = take_mail_group(&head, &tail, FALSE, &count);
+  group = take_mail_group(&head, &tail, FALSE, &count);
+  fail_unless(group == mail[2]);
+  fail_unless(head == NULL);
+  fail_unless(tail == NULL);
+
+  for (i = 0; i < 3; i++)
+    free(mail[i]);
+  }
+END_TEST
+
+
+/* queue a forced notification for jobid, owned by owner */
+static void mail_job(char *jobid, char *owner)
+  {
+  job pjob;
+
+  memset(&pjob, 0, sizeof(pjob));
+  strcpy(pjob.ji_qs.ji_jobid, jobid);
+  pjob.ji_wattr[JOB_ATR_job_owner].at_val.at_str = owner;
+
+  svr_mailowner(&pjob, MAIL_END, MAIL_FORCE, NULL);
+  }
+
+static int mails_sent(void)
+  {
+  int count;
+
+  pthread_mutex_lock(&sent_mutex);
+  count = sent_count;
+  pthread_mutex_unlock(&sent_mutex);
+
+  return(count);
+  }
+
+static void reset_sent(void)
+  {
+  pthread_mutex_lock(&sent_mutex);
+  sent_count = 0;
+  pthread_mutex_unlock(&sent_mutex);
+  }
+
+/* mail held for coalescing goes out, combined, as soon as it is drained */
+START_TEST(test_coalesce_drain)
+  {
+  mail_delay = 3600;
+  mail_limit = 0;
+  reset_sent();
+
+  mail_job((char *)"1[1].host", (char *)"bob@host");
+  mail_job((char *)"1[2].host", (char *)"bob@host");
+  mail_job((char *)"2.host", (char *)"alice@host");
+  mail_job((char *)"1[3].host", (char *)"bob@host");
+
+  usleep(100000);
+  fail_unless(mails_sent() == 0);
+  fail_unless(mail_queue_length() == 4);
 
+  mail_drain();
 
+  fail_unless(mail_queue_length() == 0);
+  fail_unless(sent_count == 2, "%d sent", sent_count);
+  fail_unless(strstr(sent_mail[0], "To: bob@host\nSubject: PBS: 3 job notifications\n") != NULL);
+  fail_unless(strstr(sent_mail[0], "1[1].host\n1[2].host\n1[3].host") != NULL);
+  fail_unless(strstr(sent_mail[1], "To: alice@host\nSubject: 2.host\n") != NULL);
+  mail_delay = 0;
+  }
+END_TEST
+
+/* past the rate limit mail waits, uncombined, until it is drained */
+START_TEST(test_rate_limit)
+  {
+  int i;
+
+  mail_delay = 0;
+  mail_limit = 1;
+  reset_sent();
+
+  mail_job((char *)"3.host", (char *)"bob@host");
+  mail_job((char *)"4.host", (char *)"bob@host");
+  mail_job((char *)"5.host", (char *)"bob@host");
+
+  for (i = 0; (i < 50) && (mails_sent() < 1); i++)
+    usleep(100000);
+
+  usleep(100000);
+  fail_unless(mails_sent() == 1, "%d sent", mails_sent());
+  fail_unless(mail_queue_length() == 2);
+
+  mail_drain();
+
+  fail_unless(mail_queue_length() == 0);
+  fail_unless(sent_count == 3, "%d sent", sent_count);
+
+  for (i = 0; i < 3; i++)
+    fail_unless(strstr(sent_mail[i], "Subject: PBS: ") == NULL);
+
+  fail_unless(strstr(sent_mail[2], "Subject: 5.host\n") != NULL);
+  mail_limit = 0;
   }
 END_TEST
 
@@ -29,6 +217,14 @@ Suite *svr_mail_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_rate_limit");
+  tcase_add_test(tc_core, test_rate_limit);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_coalesce_drain");
+  tcase_add_test(tc_core, test_coalesce_drain);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -11,6 +11,7 @@
 #include "pbs_nodes.h" /* pbsnode */
 #include "list_link.h" /* tlist_head, list_link */
 #include "array.h"
+#include "work_task.h" /* work_task */
 
 char *path_jobs;
 struct connect_handle connection[10];
@@ -293,3 +294,34 @@ int unlock_ai_mutex(
   {
   return(0);
   }
+
+int svr_connect_pooled(pbs_net_t hostaddr, unsigned int port, int *my_err, int allow_reuse, int *reused)
+  {
+  fprintf(stderr, "The call to svr_connect_pooled to be mocked!!\n");
+  exit(1);
+  }
+
+void svr_disconnect_pooled(int handle)
+  {
+  fprintf(stderr, "The call to svr_disconnect_pooled to be mocked!!\n");
+  exit(1);
+  }
+
+int PBSD_submitjob_get_sid(int connect, long *sid, char *jobid, char *destin, struct attropl *attrib, char *script_buf, int script_len)
+  {
+  fprintf(stderr, "The call to PBSD_submitjob_get_sid to be mocked!!\n");
+  exit(1);
+  }
+
+struct work_task *set_task(enum work_type type, long event_id, void (*func)(struct work_task *), void *parm, int get_lock)
+  {
+  fprintf(stderr, "The call to set_task to be mocked!!\n");
+  exit(1);
+  }
+
+int get_svr_attr_l(int index, long *l)
+  {
+  return(0);
+  }
+
+void DIS_tcp_settimeout(long timeout) {}
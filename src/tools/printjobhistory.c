@@ -0,0 +1,386 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+/*
+ * printjobhistory - print completed jobs from the binary job history
+ *
+ * pbs_server writes the history (job_logs/YYYYMMDD.jh under its home) when
+ * record_job_info and job_log_binary are set.  Jobs can
+ * be picked by user, job id and completion time; the time range only maps
+ * the days it covers and each day's index skips the records written before
+ * it starts.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pbs_ifl.h"
+#include "server_limits.h" /* PBS_JOBINFOLOGDIR */
+#include "printjobhistory.h"
+
+
+
+
+/*
+ * parse_history_time - YYYYMMDD, YYYYMMDDhhmm or seconds since the epoch
+ *
+ * returns the time or -1 if str is none of those
+ */
+
+time_t parse_history_time(
+
+  char *str)  /* I */
+
+  {
+  struct tm  tm;
+  char      *ptr;
+  size_t     len = strlen(str);
+  long       value;
+
+  for (ptr = str; *ptr != '\0'; ptr++)
+    {
+    if (!isdigit((int)*ptr))
+      return(-1);
+    }
+
+  if ((len != 8) && (len != 12))
+    {
+    if (len == 0)
+      return(-1);
+
+    value = strtol(str, NULL, 10);
+
+    return((time_t)value);
+    }
+
+  memset(&tm, 0, sizeof(tm));
+
+  if (sscanf(str, "%4d%2d%2d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday) != 3)
+    return(-1);
+
+  if ((len == 12) &&
+      (sscanf(str + 8, "%2d%2d", &tm.tm_hour, &tm.tm_min) != 2))
+    return(-1);
+
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  tm.tm_isdst = -1;
+
+  return(mktime(&tm));
+  }  /* END parse_history_time() */
+
+
+
+
+/*
+ * history_match - does the record pass the filter
+ *
+ * Jobs that never completed are placed by when they were recorded.  A job
+ * given by number matches "12.server" and "12[3].server" but not
+ * "123.server", as with tracejob.
+ */
+
+int history_match(
+
+  jh_record      *jr,  /* I */
+  history_filter *hf)  /* I */
+
+  {
+  time_t  when = (jr->jr_end != 0) ? jr->jr_end : jr->jr_time;
+  char   *id;
+  size_t  len;
+
+  if ((hf->hf_begin != 0) && (when < hf->hf_begin))
+    return(FALSE);
+
+  if ((hf->hf_end != 0) && (when > hf->hf_end))
+    return(FALSE);
+
+  if ((hf->hf_user != NULL) &&
+      (strcmp(hf->hf_user, jh_record_user(jr))))
+    return(FALSE);
+
+  if (hf->hf_job != NULL)
+    {
+    id = jh_record_id(jr);
+    len = strlen(hf->hf_job);
+
+    if ((strncmp(hf->hf_job, id, len)) ||
+        (isdigit((int)id[len])))
+      return(FALSE);
+    }
+
+  return(TRUE);
+  }  /* END history_match() */
+
+
+
+
+static void print_history_time(
+
+  FILE    *out,
+  int64_t  when)
+
+  {
+  time_t    t = (time_t)when;
+  struct tm tm;
+  char      buf[64];
+
+  if (when == 0)
+    {
+    fprintf(out, " %-19s", "-");
+
+    return;
+    }
+
+  localtime_r(&t, &tm);
+  strftime(buf, sizeof(buf), "%m/%d/%Y %H:%M:%S", &tm);
+
+  fprintf(out, " %-19s", buf);
+  }  /* END print_history_time() */
+
+
+
+
+void print_history_record(
+
+  FILE      *out,  /* I */
+  jh_record *jr,   /* I */
+  int        all)  /* I - print the attributes too */
+
+  {
+  char *cursor = NULL;
+  char *name;
+  char *resc;
+  char *value;
+
+  fprintf(out, "%-24s %-12s",
+    jh_record_id(jr),
+    jh_record_user(jr));
+
+  print_history_time(out, jr->jr_qtime);
+  print_history_time(out, jr->jr_start);
+  print_history_time(out, jr->jr_end);
+
+  fprintf(out, " %d\n", (int)jr->jr_exit);
+
+  if (!all)
+    return;
+
+  while (jh_record_next_attr(jr, &cursor, &name, &resc, &value))
+    {
+    if (*resc != '\0')
+      fprintf(out, "    %s.%s = %s\n", name, resc, value);
+    else
+      fprintf(out, "    %s = %s\n", name, value);
+    }
+
+  fprintf(out, "\n");
+  }  /* END print_history_record() */
+
+
+
+
+/*
+ * print_history_file - print the records in one history file that pass hf
+ *
+ * returns the number printed or -1 if path is not a job history
+ */
+
+int print_history_file(
+
+  FILE           *out,  /* I */
+  char           *path, /* I */
+  history_filter *hf)   /* I */
+
+  {
+  jh_file    jf;
+  jh_record *jr;
+  int        count = 0;
+
+  if (jh_map(path, &jf) != 0)
+    return(-1);
+
+  for (jr = jh_first(&jf, hf->hf_begin); jr != NULL; jr = jh_next(&jf, jr))
+    {
+    if (history_match(jr, hf))
+      {
+      print_history_record(out, jr, hf->hf_all);
+
+      count++;
+      }
+    }
+
+  jh_unmap(&jf);
+
+  return(count);
+  }  /* END print_history_file() */
+
+
+
+
+static void usage(
+
+  char *prog)
+
+  {
+  fprintf(stderr,
+    "USAGE: %s [-a] [-p path] [-n days] [-b begin] [-e end] [-u user] [-j jobid] [file ...]\n"
+    "   -a : print every attribute of each job\n"
+    "   -p : path to PBS_SERVER_HOME\n"
+    "   -n : number of days in the past to look at [default 1]\n"
+    "   -b : jobs completed at or after begin\n"
+    "   -e : jobs completed at or before end\n"
+    "   -u : jobs run by user\n"
+    "   -j : the job with this id\n"
+    "   times are YYYYMMDD, YYYYMMDDhhmm or seconds since the epoch\n"
+    "default prefix path = %s\n",
+    prog,
+    PBS_SERVER_HOME);
+  }  /* END usage() */
+
+
+
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  history_filter  hf;
+  char           *prefix_path = PBS_SERVER_HOME;
+  char            path[1024];
+  int             number_of_days = 1;
+  int             error = 0;
+  int             c;
+  int             i;
+  int             found = 0;
+  char           *endp;
+  time_t          t;
+  time_t          now = time(NULL);
+  struct tm       tm;
+
+  memset(&hf, 0, sizeof(hf));
+
+  while ((c = getopt(argc, argv, "ap:n:b:e:u:j:")) != EOF)
+    {
+    switch (c)
+      {
+      case 'a':
+
+        hf.hf_all = TRUE;
+
+        break;
+
+      case 'p':
+
+        prefix_path = optarg;
+
+        break;
+
+      case 'n':
+
+        number_of_days = strtol(optarg, &endp, 10);
+
+        if ((*endp != '\0') || (number_of_days < 1))
+          error = 1;
+
+        break;
+
+      case 'b':
+
+        if ((hf.hf_begin = parse_history_time(optarg)) < 0)
+          error = 1;
+
+        break;
+
+      case 'e':
+
+        if ((hf.hf_end = parse_history_time(optarg)) < 0)
+          error = 1;
+
+        break;
+
+      case 'u':
+
+        hf.hf_user = optarg;
+
+        break;
+
+      case 'j':
+
+        hf.hf_job = optarg;
+
+        break;
+
+      default:
+
+        error = 1;
+
+        break;
+      }
+    }
+
+  if (error != 0)
+    {
+    usage(argv[0]);
+
+    return(1);
+    }
+
+  if (optind < argc)
+    {
+    for (i = optind; i < argc; i++)
+      {
+      if (print_history_file(stdout, argv[i], &hf) < 0)
+        {
+        fprintf(stderr, "%s: not a job history\n", argv[i]);
+
+        error = 1;
+        }
+      }
+
+    return(error);
+    }
+
+  /* a job is recorded when it is purged, on or after the day it completed */
+  if ((hf.hf_begin != 0) &&
+      (hf.hf_begin < now))
+    number_of_days = ((now - hf.hf_begin) / SECONDS_IN_DAY) + 2;
+
+  for (i = number_of_days - 1; i >= 0; i--)
+    {
+    t = now - (i * SECONDS_IN_DAY);
+
+    localtime_r(&t, &tm);
+
+    snprintf(path, sizeof(path), "%s/%s/%04d%02d%02d" JH_SUFFIX,
+      prefix_path,
+      PBS_JOBINFOLOGDIR,
+      tm.tm_year + 1900,
+      tm.tm_mon + 1,
+      tm.tm_mday);
+
+    if (access(path, R_OK) != 0)
+      continue;
+
+    if ((c = print_history_file(stdout, path, &hf)) > 0)
+      found += c;
+    }
+
+  if (found == 0)
+    {
+    fprintf(stderr, "no matching jobs found\n");
+
+    return(1);
+    }
+
+  return(0);
+  }  /* END main() */
+
+/* END printjobhistory.c */
@@ -0,0 +1,27 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef PRINTJOBHISTORY_H
+#define PRINTJOBHISTORY_H
+
+#include <stdio.h> /* FILE */
+#include <time.h> /* time_t */
+
+#include "../lib/Liblog/job_history.h"
+
+#define SECONDS_IN_DAY 86400
+
+/* which records to print */
+typedef struct history_filter
+  {
+  char   *hf_user;   /* execution user, NULL for any */
+  char   *hf_job;    /* job id or just its number, NULL for any */
+  time_t  hf_begin;  /* completed at or after, 0 for any */
+  time_t  hf_end;    /* completed at or before, 0 for any */
+  int     hf_all;    /* print every attribute */
+  } history_filter;
+
+time_t parse_history_time(char *str);
+int    history_match(jh_record *jr, history_filter *hf);
+void   print_history_record(FILE *out, jh_record *jr, int all);
+int    print_history_file(FILE *out, char *path, history_filter *hf);
+
+#endif /* PRINTJOBHISTORY_H */
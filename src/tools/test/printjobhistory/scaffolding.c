@@ -0,0 +1,48 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../../lib/Liblog/job_history.h"
+
+int jh_map(char *path, jh_file *jf)
+  {
+  fprintf(stderr, "The call to jh_map needs to be mocked!!\n");
+  exit(1);
+  }
+
+void jh_unmap(jh_file *jf)
+  {
+  fprintf(stderr, "The call to jh_unmap needs to be mocked!!\n");
+  exit(1);
+  }
+
+jh_record *jh_first(jh_file *jf, time_t since)
+  {
+  fprintf(stderr, "The call to jh_first needs to be mocked!!\n");
+  exit(1);
+  }
+
+jh_record *jh_next(jh_file *jf, jh_record *jr)
+  {
+  fprintf(stderr, "The call to jh_next needs to be mocked!!\n");
+  exit(1);
+  }
+
+int jh_record_next_attr(jh_record *jr, char **cursor, char **name, char **resc, char **value)
+  {
+  fprintf(stderr, "The call to jh_record_next_attr needs to be mocked!!\n");
+  exit(1);
+  }
+
+char *jh_record_id(jh_record *jr)
+  {
+  return((char *)(jr + 1));
+  }
+
+char *jh_record_user(jh_record *jr)
+  {
+  char *id = jh_record_id(jr);
+
+  return(id + strlen(id) + 1);
+  }
@@ -0,0 +1,127 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "printjobhistory.h"
+#include "test_printjobhistory.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+#include "pbs_error.h"
+
+/* a record header followed by the job id and user */
+static jh_record *make_record(char *buf, const char *jobid, const char *user, time_t written, time_t end)
+  {
+  jh_record *jr = (jh_record *)buf;
+
+  memset(jr, 0, sizeof(jh_record));
+  jr->jr_time = written;
+  jr->jr_end = end;
+
+  strcpy((char *)(jr + 1), jobid);
+  strcpy((char *)(jr + 1) + strlen(jobid) + 1, user);
+
+  return(jr);
+  }
+
+START_TEST(test_one)
+  {
+  struct tm tm;
+  time_t    t;
+
+  fail_unless(parse_history_time((char *)"") == -1);
+  fail_unless(parse_history_time((char *)"2013-01-02") == -1);
+  fail_unless(parse_history_time((char *)"12ab") == -1);
+  fail_unless(parse_history_time((char *)"1357000000") == 1357000000);
+
+  t = parse_history_time((char *)"20130102");
+  localtime_r(&t, &tm);
+  fail_unless(tm.tm_year == 113);
+  fail_unless(tm.tm_mon == 0);
+  fail_unless(tm.tm_mday == 2);
+  fail_unless(tm.tm_hour == 0);
+
+  t = parse_history_time((char *)"201301021530");
+  localtime_r(&t, &tm);
+  fail_unless(tm.tm_mday == 2);
+  fail_unless(tm.tm_hour == 15);
+  fail_unless(tm.tm_min == 30);
+  }
+END_TEST
+
+START_TEST(test_two)
+  {
+  char            buf[256];
+  jh_record      *jr;
+  history_filter  hf;
+
+  memset(&hf, 0, sizeof(hf));
+
+  jr = make_record(buf, "12.host", "alice", 2000, 1500);
+  fail_unless(history_match(jr, &hf) == TRUE);
+
+  /* the completion time is used when there is one */
+  hf.hf_begin = 1600;
+  fail_unless(history_match(jr, &hf) == FALSE);
+  hf.hf_begin = 1000;
+  hf.hf_end = 1400;
+  fail_unless(history_match(jr, &hf) == FALSE);
+  hf.hf_end = 1500;
+  fail_unless(history_match(jr, &hf) == TRUE);
+
+  jr = make_record(buf, "12.host", "alice", 2000, 0);
+  fail_unless(history_match(jr, &hf) == FALSE);
+  hf.hf_end = 0;
+  fail_unless(history_match(jr, &hf) == TRUE);
+
+  hf.hf_user = (char *)"bob";
+  fail_unless(history_match(jr, &hf) == FALSE);
+  hf.hf_user = (char *)"alice";
+  fail_unless(history_match(jr, &hf) == TRUE);
+
+  hf.hf_job = (char *)"12";
+  fail_unless(history_match(jr, &hf) == TRUE);
+  hf.hf_job = (char *)"12.host";
+  fail_unless(history_match(jr, &hf) == TRUE);
+  hf.hf_job = (char *)"1";
+  fail_unless(history_match(jr, &hf) == FALSE);
+
+  jr = make_record(buf, "12[3].host", "alice", 2000, 0);
+  hf.hf_job = (char *)"12";
+  fail_unless(history_match(jr, &hf) == TRUE);
+
+  jr = make_record(buf, "123.host", "alice", 2000, 0);
+  fail_unless(history_match(jr, &hf) == FALSE);
+  }
+END_TEST
+
+Suite *printjobhistory_suite(void)
+  {
+  Suite *s = suite_create("printjobhistory_suite methods");
+  TCase *tc_core = tcase_create("test_one");
+  tcase_add_test(tc_core, test_one);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_two");
+  tcase_add_test(tc_core, test_two);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(printjobhistory_suite());
+  srunner_set_log(sr, "printjobhistory_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -0,0 +1,11 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _PRINTJOBHISTORY_CT_H
+#define _PRINTJOBHISTORY_CT_H
+#include <check.h>
+
+#define PRINTJOBHISTORY_SUITE 1
+Suite *printjobhistory_suite();
+#define METH_2 2
+Suite *meth_2_suite();
+
+#endif /* _PRINTJOBHISTORY_CT_H */
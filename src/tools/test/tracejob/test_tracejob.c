@@ -3,18 +3,142 @@
 #include "test_tracejob.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include "pbs_error.h"
+
+extern struct log_entry *log_lines;
+extern int ll_cur_amm;
+
+static char log_dir[] = "/tmp/test_tracejob_XXXXXX";
+static char log_name[256];
+
+static const char *log_text[] =
+  {
+  "10/19/2012 10:00:00;0008;PBS_Server.1;Job;1.host;before the index\n",
+  "10/19/2012 10:00:01;0008;PBS_Server.1;Job;2.host;not this job\n",
+  "10/19/2012 10:00:02;0008;PBS_Server.1;Job;1.host;Job Queued\n",
+  "10/19/2012 10:00:03;0002;PBS_Server.1;Svr;PBS_Server;not a job\n",
+  "10/19/2012 10:00:04;0008;PBS_Server.1;Job;1.host;Job Run\n",
+  NULL
+  };
+
+/* write the test log and an index of its lines after the first two */
+static FILE *write_test_log(const char *index_text)
+  {
+  FILE *fp;
+  char  index_name[256];
+  int   i;
+
+  if (log_name[0] == '\0')
+    {
+    fail_unless(mkdtemp(log_dir) != NULL);
+    snprintf(log_name, sizeof(log_name), "%s/20121019", log_dir);
+    }
+
+  fail_unless((fp = fopen(log_name, "w")) != NULL);
+
+  for (i = 0; log_text[i] != NULL; i++)
+    fputs(log_text[i], fp);
+
+  fclose(fp);
+
+  snprintf(index_name, sizeof(index_name), "%s.idx", log_name);
+  unlink(index_name);
+
+  if (index_text != NULL)
+    {
+    fail_unless((fp = fopen(index_name, "w")) != NULL);
+    fputs(index_text, fp);
+    fclose(fp);
+    }
+
+  ll_cur_amm = 0;
+
+  return(fopen(log_name, "r"));
+  }
+
+/* "#open <offset of line 2>" plus entries for lines 2, 3 and 5 */
+static void make_index(char *buf, size_t size, int bad_offset)
+  {
+  long off[5];
+  int  i;
+
+  off[0] = 0;
+
+  for (i = 1; i < 5; i++)
+    off[i] = off[i - 1] + strlen(log_text[i - 1]);
+
+  snprintf(buf, size, "#open %ld\n2.host %ld %ld\n1.host %ld %ld\n#open %ld\n1.host %ld %ld\n",
+    off[1],
+    off[1], (long)strlen(log_text[1]),
+    off[2], (long)strlen(log_text[2]),
+    off[4],
+    bad_offset ? off[3] : off[4], (long)strlen(log_text[4]));
+  }
+
 START_TEST(test_one)
   {
+  FILE *fp;
+  char  index_text[512];
 
+  make_index(index_text, sizeof(index_text), FALSE);
 
+  fail_unless((fp = write_test_log(index_text)) != NULL);
+  fail_unless(parse_log_index(fp, log_name, (char *)"1", IND_SERVER) == 0);
+  fclose(fp);
+
+  /* the scanned head plus the two indexed records */
+  fail_unless(ll_cur_amm == 3, "%d entries", ll_cur_amm);
+  fail_unless(!strcmp(log_lines[0].msg, "before the index"));
+  fail_unless(!strcmp(log_lines[1].msg, "Job Queued"));
+  fail_unless(!strcmp(log_lines[2].msg, "Job Run"));
+  fail_unless(log_lines[2].log_file == 'S');
+  fail_unless(log_lines[1].lineno < log_lines[2].lineno);
+
+  fail_unless((fp = write_test_log(index_text)) != NULL);
+  fail_unless(parse_log_index(fp, log_name, (char *)"3", IND_SERVER) == -1);
+  fclose(fp);
+  fail_unless(ll_cur_amm == 0);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  FILE *fp;
+  char  index_text[512];
+
+  /* no index, the caller scans */
+  fail_unless((fp = write_test_log(NULL)) != NULL);
+  fail_unless(parse_log_index(fp, log_name, (char *)"1", IND_SERVER) == LOG_INDEX_NONE);
+  fail_unless(parse_log(fp, (char *)"1", IND_SERVER) == 0);
+  fclose(fp);
+  fail_unless(ll_cur_amm == 3, "%d entries", ll_cur_amm);
+
+  /* an entry pointing at someone else's record means the index is stale */
+  make_index(index_text, sizeof(index_text), TRUE);
+
+  fail_unless((fp = write_test_log(index_text)) != NULL);
+  fail_unless(parse_log_index(fp, log_name, (char *)"1", IND_SERVER) == LOG_INDEX_NONE);
+  fail_unless(ll_cur_amm == 0, "%d entries", ll_cur_amm);
+
+  /* and the log is back at its start for parse_log() */
+  fail_unless(parse_log(fp, (char *)"1", IND_SERVER) == 0);
+  fclose(fp);
+  fail_unless(ll_cur_amm == 3, "%d entries", ll_cur_amm);
+
+  /* only names that start with a digit are indexed, so any other is scanned */
+  make_index(index_text, sizeof(index_text), FALSE);
 
+  fail_unless((fp = write_test_log(index_text)) != NULL);
+  fail_unless(parse_log_index(fp, log_name, (char *)"PBS_Server", IND_SERVER) == LOG_INDEX_NONE);
+  fail_unless(ll_cur_amm == 0, "%d entries", ll_cur_amm);
+  fclose(fp);
 
+  /* an index past the end of the log is ignored */
+  fail_unless((fp = write_test_log("#open 100000\n")) != NULL);
+  fail_unless(parse_log_index(fp, log_name, (char *)"1", IND_SERVER) == LOG_INDEX_NONE);
+  fclose(fp);
   }
 END_TEST
 
@@ -86,6 +86,7 @@
 #include <unistd.h>
 #include <termios.h>
 #include <ctype.h>
+#include <sys/stat.h>
 #if defined(HAVE_SYS_IOCTL_H)
 #include <sys/ioctl.h>
 #endif
@@ -108,6 +109,9 @@ struct log_entry *log_lines;
 int ll_cur_amm;
 int ll_max_amm;
 
+/* placeholder for missing fields, not to be freed */
+static char none[1] = { '\0' };
+
 
 int main(
 
@@ -118,6 +122,7 @@ int main(
   /* Array for the log entries for the specified job */
   FILE *fp;
   int i, j;
+  int rc;
   int file_count;
   char *filenames[MAX_LOG_FILES_PER_DAY];  /* full path of logfiles to read */
 
@@ -341,7 +346,12 @@ int main(
             continue;
             }
 
-          if (parse_log(fp, argv[opt], j) < 0)
+          rc = parse_log_index(fp, filenames[file_count-1], argv[opt], j);
+
+          if (rc == LOG_INDEX_NONE)
+            rc = parse_log(fp, argv[opt], j);
+
+          if (rc < 0)
             {
             /* no valid entries located in file */
 
@@ -399,196 +409,240 @@ int main(
 
 
 /*
+ * job_matches - does a log entry's object name belong to job
  *
- * parse_log - parse out entires of a log file for a specific job
- *      and return them in log_entry structures
+ * job may be just the number, so "12" matches "12.server" and "12[3].server"
+ * but not "123.server".
+ */
+
+static int job_matches(
+
+  char *name,  /* I */
+  char *job)   /* I */
+
+  {
+  size_t len = strlen(job);
+
+  return((name != NULL) &&
+         !strncmp(job, name, len) &&
+         !isdigit(name[len]));
+  }  /* END job_matches() */
+
+
+
+
+/*
+ * parse_line - split one log line and keep it if it is about job
  *
- *        fp    - the log file
- *        job   - the name of the job
- *        ind   - which log file - index in enum index
+ * buf is modified.
  *
- * returns nothing
+ * returns TRUE if the line was added to log_lines
  * modifies global variables: loglines, ll_cur_amm, ll_max_amm
- *
  */
 
-int parse_log(
+static int parse_line(
 
-  FILE *fp,   /* I */
-  char *job,  /* I */
-  int   ind)  /* I */
+  char *buf,    /* I/O */
+  char *job,    /* I */
+  int   ind,    /* I */
+  int   lineno) /* I */
 
   {
-
   struct log_entry tmp; /* temporary log entry */
-  char buf[32768]; /* buffer to read in from file */
   char *pa, *pe;   /* pointers to use for splitting */
   int field_count; /* which field in log entry */
-  int j = 0;
 
   struct tm tms; /* used to convert date to unix date */
-  static char none[1] = { '\0' };
-  int lineno = 0;
-
-  int logcount = 0;
 
   tms.tm_isdst = -1; /* mktime() will attempt to figure it out */
 
-  while (fgets(buf, sizeof(buf), fp) != NULL)
-    {
-    lineno++;
-    j++;
+  buf[strlen(buf) - 1] = '\0';
 
-    buf[strlen(buf) - 1] = '\0';
+  field_count = 0;
+  pa = buf;
+  memset(&tmp, 0, sizeof(struct log_entry));
 
-    field_count = 0;
-    pa = buf;
-    memset(&tmp, 0, sizeof(struct log_entry));
+  for(field_count = 0; (pa != NULL) && (field_count <= FLD_MSG); field_count++) 
+    {
 
-    for(field_count = 0; (pa != NULL) && (field_count <= FLD_MSG); field_count++) 
+    /* instead of using strtok every time, conditionally advance the pa (the field pointer)
+     * on semicolons. This prevents data from getting cut out of messages with semicolons in
+     * them */
+    if(field_count < FLD_MSG) 
+      {
+      if((pe = strchr(pa, ';')))
+        *pe = '\0';
+      } 
+    else 
       {
+      pe = NULL;
+      }
 
-      /* instead of using strtok every time, conditionally advance the pa (the field pointer)
-       * on semicolons. This prevents data from getting cut out of messages with semicolons in
-       * them */
-      if(field_count < FLD_MSG) 
-        {
-        if((pe = strchr(pa, ';')))
-          *pe = '\0';
-        } 
-      else 
-        {
-        pe = NULL;
-        }
+    switch (field_count) 
+      
+      {
+      case FLD_DATE:
 
-      switch (field_count) 
-        
-        {
-        case FLD_DATE:
+        tmp.date = pa;
+        if(ind == IND_ACCT)
+          field_count += 2;
 
-          tmp.date = pa;
-          if(ind == IND_ACCT)
-            field_count += 2;
+        break;
 
-          break;
+    case FLD_EVENT:
+      
+        tmp.event = pa;
+      
+        break;
 
-      case FLD_EVENT:
-        
-          tmp.event = pa;
-        
-          break;
+    case FLD_OBJ:
+      
+        tmp.obj = pa;
+      
+        break;
 
-      case FLD_OBJ:
-        
-          tmp.obj = pa;
-        
-          break;
+    case FLD_TYPE:
+      
+        tmp.type = pa;
+      
+      
+        break;
 
-      case FLD_TYPE:
-        
-          tmp.type = pa;
-        
-        
-          break;
+    case FLD_NAME:
+      
+        tmp.name = pa;
+      
+        break;
 
-      case FLD_NAME:
-        
-          tmp.name = pa;
-        
-          break;
+    case FLD_MSG:
+      
+        tmp.msg = pa;
+      
+        break;
+    }
 
-      case FLD_MSG:
-        
-          tmp.msg = pa;
-        
-          break;
-      }
+    if(pe)
+      pa = pe + 1;
+    else
+      pa = NULL;
+
+  } /* END for (field_count) */
+
+  if (job_matches(tmp.name, job))
+    {
+    if (ll_cur_amm >= ll_max_amm)
+      alloc_more_space();
 
-      if(pe)
-        pa = pe + 1;
+    free_log_entry(&log_lines[ll_cur_amm]);
+
+    if (tmp.date != NULL)
+      {
+      log_lines[ll_cur_amm].date = strdup(tmp.date);
+
+      if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6)
+        log_lines[ll_cur_amm].date_time = -1; /* error in date field */
       else
-        pa = NULL;
+        {
+        if (tms.tm_year > 1900)
+          tms.tm_year -= 1900;
 
-    } /* END for (field_count) */
+        log_lines[ll_cur_amm].date_time = mktime(&tms);
+        }
+      }
 
-    if ((tmp.name != NULL) &&
-        !strncmp(job, tmp.name, strlen(job)) &&
-        !isdigit(tmp.name[strlen(job)]))
+    if (tmp.event != NULL)
+      log_lines[ll_cur_amm].event = strdup(tmp.event);
+    else
+      log_lines[ll_cur_amm].event = none;
+
+    if (tmp.obj != NULL)
+      log_lines[ll_cur_amm].obj = strdup(tmp.obj);
+    else
+      log_lines[ll_cur_amm].obj = none;
+
+    if (tmp.type != NULL)
+      log_lines[ll_cur_amm].type = strdup(tmp.type);
+    else
+      log_lines[ll_cur_amm].type = none;
+
+    if (tmp.name != NULL)
+      log_lines[ll_cur_amm].name = strdup(tmp.name);
+    else
+      log_lines[ll_cur_amm].name = none;
+
+    if (tmp.msg != NULL)
+      log_lines[ll_cur_amm].msg = strdup(tmp.msg);
+    else
+      log_lines[ll_cur_amm].msg = none;
+
+    switch (ind)
       {
-      if (ll_cur_amm >= ll_max_amm)
-        alloc_more_space();
 
-      free_log_entry(&log_lines[ll_cur_amm]);
+      case IND_SERVER:
+        log_lines[ll_cur_amm].log_file = 'S';
+        break;
 
-      if (tmp.date != NULL)
-        {
-        log_lines[ll_cur_amm].date = strdup(tmp.date);
+      case IND_SCHED:
+        log_lines[ll_cur_amm].log_file = 'L';
+        break;
 
-        if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6)
-          log_lines[ll_cur_amm].date_time = -1; /* error in date field */
-        else
-          {
-          if (tms.tm_year > 1900)
-            tms.tm_year -= 1900;
+      case IND_ACCT:
+        log_lines[ll_cur_amm].log_file = 'A';
+        break;
 
-          log_lines[ll_cur_amm].date_time = mktime(&tms);
-          }
-        }
+      case IND_MOM:
+        log_lines[ll_cur_amm].log_file = 'M';
+        break;
 
-      if (tmp.event != NULL)
-        log_lines[ll_cur_amm].event = strdup(tmp.event);
-      else
-        log_lines[ll_cur_amm].event = none;
+      default:
+        log_lines[ll_cur_amm].log_file = 'U'; /* undefined */
+      }
 
-      if (tmp.obj != NULL)
-        log_lines[ll_cur_amm].obj = strdup(tmp.obj);
-      else
-        log_lines[ll_cur_amm].obj = none;
+    log_lines[ll_cur_amm].lineno = lineno;
 
-      if (tmp.type != NULL)
-        log_lines[ll_cur_amm].type = strdup(tmp.type);
-      else
-        log_lines[ll_cur_amm].type = none;
+    ll_cur_amm++;
 
-      if (tmp.name != NULL)
-        log_lines[ll_cur_amm].name = strdup(tmp.name);
-      else
-        log_lines[ll_cur_amm].name = none;
+    return(TRUE);
+    }
 
-      if (tmp.msg != NULL)
-        log_lines[ll_cur_amm].msg = strdup(tmp.msg);
-      else
-        log_lines[ll_cur_amm].msg = none;
+  return(FALSE);
+  }  /* END parse_line() */
 
-      switch (ind)
-        {
 
-        case IND_SERVER:
-          log_lines[ll_cur_amm].log_file = 'S';
-          break;
 
-        case IND_SCHED:
-          log_lines[ll_cur_amm].log_file = 'L';
-          break;
 
-        case IND_ACCT:
-          log_lines[ll_cur_amm].log_file = 'A';
-          break;
+/*
+ *
+ * parse_log - parse out entires of a log file for a specific job
+ *      and return them in log_entry structures
+ *
+ *        fp    - the log file
+ *        job   - the name of the job
+ *        ind   - which log file - index in enum index
+ *
+ * returns nothing
+ * modifies global variables: loglines, ll_cur_amm, ll_max_amm
+ *
+ */
 
-        case IND_MOM:
-          log_lines[ll_cur_amm].log_file = 'M';
-          break;
+int parse_log(
 
-        default:
-          log_lines[ll_cur_amm].log_file = 'U'; /* undefined */
-        }
+  FILE *fp,   /* I */
+  char *job,  /* I */
+  int   ind)  /* I */
 
-      log_lines[ll_cur_amm].lineno = lineno;
+  {
+  char buf[32768]; /* buffer to read in from file */
+  int lineno = 0;
 
-      ll_cur_amm++;
+  int logcount = 0;
 
+  while (fgets(buf, sizeof(buf), fp) != NULL)
+    {
+    lineno++;
+
+    if (parse_line(buf, job, ind, lineno))
       logcount++;
-      }
     }    /* END while (fgets(buf,sizeof(buf),fp) != NULL) */
 
   if (logcount == 0)
@@ -606,6 +660,143 @@ int parse_log(
 
 
 
+/*
+ * parse_log_index - parse a job's entries out of a log file using the job
+ *      index the daemon wrote next to it (see log_set_index())
+ *
+ * The index lists "<job id> <offset> <length>" for every record written
+ * after its first "#open <offset>" line whose object name starts with a
+ * digit; whatever is before that offset is scanned.  Only a job that starts
+ * with a digit can be looked up, as any other could match unindexed names.  An index that does not fit the log (the log was replaced or
+ * truncated) is ignored and anything taken from it is thrown away.
+ *
+ *        fp       - the log file, at its start
+ *        filename - the log file's name
+ *        job      - the name of the job
+ *        ind      - which log file - index in enum index
+ *
+ * returns 0 if entries were found, -1 if none were, LOG_INDEX_NONE if there
+ *   is no usable index and the log must be scanned with parse_log()
+ * modifies global variables: loglines, ll_cur_amm, ll_max_amm
+ */
+
+int parse_log_index(
+
+  FILE *fp,        /* I */
+  char *filename,  /* I */
+  char *job,       /* I */
+  int   ind)       /* I */
+
+  {
+  char        idxname[1024];
+  char        buf[32768];
+  char        id[1024];
+  FILE       *idx;
+  struct stat sb;
+  long long   start;
+  long long   offset;
+  long long   length;
+  long long   got;
+  int         lineno = 0;
+  int         logcount = 0;
+  int         first_entry = ll_cur_amm;
+  int         rc = 0;
+
+  if (!isdigit((unsigned char)*job))
+    return(LOG_INDEX_NONE);
+
+  snprintf(idxname, sizeof(idxname), "%s.idx", filename);
+
+  if ((idx = fopen(idxname, "r")) == NULL)
+    return(LOG_INDEX_NONE);
+
+  if ((fstat(fileno(fp), &sb) != 0) ||
+      (fgets(buf, sizeof(buf), idx) == NULL) ||
+      (sscanf(buf, "#open %lld", &start) != 1) ||
+      (start < 0) ||
+      (start > (long long)sb.st_size))
+    {
+    fclose(idx);
+
+    return(LOG_INDEX_NONE);
+    }
+
+  /* records from before the index was started */
+  while ((ftell(fp) < start) &&
+         (fgets(buf, sizeof(buf), fp) != NULL))
+    {
+    lineno++;
+
+    if (parse_line(buf, job, ind, lineno))
+      logcount++;
+    }
+
+  while (fgets(buf, sizeof(buf), idx) != NULL)
+    {
+    if (buf[0] == '#')
+      continue;
+
+    if (sscanf(buf, "%1023s %lld %lld", id, &offset, &length) != 3)
+      continue;
+
+    if (!job_matches(id, job))
+      continue;
+
+    if ((offset < start) ||
+        (length <= 0) ||
+        (offset + length > (long long)sb.st_size) ||
+        (fseek(fp, (long)offset, SEEK_SET) != 0))
+      {
+      rc = LOG_INDEX_NONE;
+
+      break;
+      }
+
+    for (got = 0; got < length;)
+      {
+      if (fgets(buf, sizeof(buf), fp) == NULL)
+        break;
+
+      lineno++;
+
+      /* a record the index points at must be about the job it names */
+      if (parse_line(buf, job, ind, lineno))
+        logcount++;
+      else if (got == 0)
+        rc = LOG_INDEX_NONE;
+
+      got = ftell(fp) - offset;
+      }
+
+    if (rc != 0)
+      break;
+    }
+
+  fclose(idx);
+
+  if (rc == LOG_INDEX_NONE)
+    {
+    while (ll_cur_amm > first_entry)
+      {
+      ll_cur_amm--;
+
+      free_log_entry(&log_lines[ll_cur_amm]);
+      }
+
+    rewind(fp);
+
+    return(LOG_INDEX_NONE);
+    }
+
+  if (logcount == 0)
+    return(-1);
+
+  return(0);
+  }  /* END parse_log_index() */
+
+
+
+
 /*
  *
  * sort_by_date - compare function for qsort.  It compares two time_t
@@ -698,32 +889,32 @@ char *strip_path(char *path)
  */
 void free_log_entry(struct log_entry *lg)
   {
-  if (lg -> date != NULL)
+  if ((lg -> date != NULL) && (lg -> date != none))
     free(lg -> date);
 
   lg -> date = NULL;
 
-  if (lg -> event != NULL)
+  if ((lg -> event != NULL) && (lg -> event != none))
     free(lg -> event);
 
   lg -> event = NULL;
 
-  if (lg -> obj != NULL)
+  if ((lg -> obj != NULL) && (lg -> obj != none))
     free(lg -> obj);
 
   lg -> obj = NULL;
 
-  if (lg -> type != NULL)
+  if ((lg -> type != NULL) && (lg -> type != none))
     free(lg -> type);
 
   lg -> type = NULL;
 
-  if (lg -> name != NULL)
+  if ((lg -> name != NULL) && (lg -> name != none))
     free(lg -> name);
 
   lg -> name = NULL;
 
-  if (lg -> msg != NULL)
+  if ((lg -> msg != NULL) && (lg -> msg != none))
     free(lg -> msg);
 
   lg -> msg = NULL;
@@ -854,6 +1045,16 @@ int log_path(
     {
     while (fgets(pbuf, 512, fp) != NULL)
       {
+      if (isspace(pbuf[strlen(pbuf)-1]))
+        {
+        pbuf[strlen(pbuf)-1] = '\0';
+        }
+
+      /* job indexes are read along with their logs */
+      if ((strlen(pbuf) > 4) &&
+          (!strcmp(pbuf + strlen(pbuf) - 4, ".idx")))
+        continue;
+
       filenames[filecount] = malloc(strlen(pbuf)+1);
 
       if (filenames[filecount] == NULL)
@@ -863,10 +1064,6 @@ int log_path(
         return(-1);
         }
 
-      if (isspace(pbuf[strlen(pbuf)-1]))
-        {
-        pbuf[strlen(pbuf)-1] = '\0';
-        }
       strcpy(filenames[filecount],pbuf);
       filecount++;
       }
@@ -117,6 +117,9 @@
 
 #define SECONDS_IN_DAY 86400
 
+/* parse_log_index() found no usable job index, scan the log */
+#define LOG_INDEX_NONE -2
+
 /* indicies into the mid_path array */
 enum index
   {
@@ -159,6 +162,7 @@ unsigned no_print:
 /* prototypes */
 int sort_by_date(const void *v1, const void *v2);
 int parse_log(FILE *, char *, int);
+int parse_log_index(FILE *, char *, char *, int);
 char *strip_path(char *path);
 void free_log_entry(struct log_entry *lg);
 void line_wrap(char *line, int start, int end);